@@ -51,6 +51,7 @@ ProcArgs::ProcArgs( const char * paramStr )
   , excludeXform(false)
   , subdIterations(0)
   , proceduralNode(0)
+  , cullHidden(false)
 {
     // TODO, grab the shutter a camera attached to AiUniverse if present
     
@@ -147,6 +148,18 @@ ProcArgs::ProcArgs( const char * paramStr )
         {
             makeInstance = true;
         }
+        else if ( token == "-cullcamera" )
+        {
+            ++i;
+            if ( i < tokens.size() )
+            {
+                cullCamera = tokens[i];
+            }
+        }
+        else if ( token == "-cullhidden" )
+        {
+            cullHidden = true;
+        }
         
     }
 }
@@ -257,6 +270,26 @@ void ProcArgs::usage()
                  "that of the calling \"procedural\" node.";
     
     std::cerr << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "-cullcamera /path/to/camera" << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "If specified, the path of a camera within the archive. "
+                 "Objects whose bounds are outside its view over the shutter "
+                 "window are skipped along with everything below them, as "
+                 "are hidden objects. The view is taken from the archive's "
+                 "own transformations, even with -excludexform.";
+    std::cerr << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "-cullhidden" << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "If specified, objects whose visibility property says they "
+                 "are hidden, or whose nearest ancestor with one says so, "
+                 "are skipped. This is implied by -cullcamera.";
+    std::cerr << std::endl;
 
     
 }
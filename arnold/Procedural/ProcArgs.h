@@ -61,6 +61,8 @@ struct ProcArgs
     , makeInstance( rhs.makeInstance )
     , subdIterations ( rhs.subdIterations )
     , proceduralNode( rhs.proceduralNode )
+    , cullCamera( rhs.cullCamera )
+    , cullHidden( rhs.cullHidden )
     {}
 
     //member variables
@@ -79,6 +81,9 @@ struct ProcArgs
     int subdIterations;
     
     AtNode * proceduralNode;
+
+    std::string cullCamera;
+    bool cullHidden;
     
     std::vector<struct AtNode *> createdNodes;
     
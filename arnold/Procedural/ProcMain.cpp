@@ -54,8 +54,26 @@ using namespace Alembic::AbcGeom;
 
 void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
              PathList::const_iterator I, PathList::const_iterator E,
-                    MatrixSampleMap * xformSamples)
+                    MatrixSampleMap * xformSamples,
+                    ObjectCuller * culler,
+                    const ObjectCuller::State & cullState)
 {
+    // Skip what's out of view before reading anything for it. Hidden
+    // objects are still walked, for any explicitly visible children.
+    ObjectCuller::State nextCullState = cullState;
+    bool emit = true;
+    if ( culler )
+    {
+        ObjectCuller::CullResult cullResult = culler->cull(
+            IObject( parent, ohead.getName() ), cullState, nextCullState );
+
+        if ( cullResult == ObjectCuller::kCullSubtree )
+        {
+            return;
+        }
+        emit = cullResult == ObjectCuller::kKeep;
+    }
+
     //Accumulate transformation samples and pass along as an argument
     //to WalkObject
     
@@ -145,7 +163,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             }
         }
         
-        ProcessSubD( subd, args, xformSamples, faceSetName );
+        if ( emit )
+        {
+            ProcessSubD( subd, args, xformSamples, faceSetName );
+        }
         
         //if we found a matching faceset, don't traverse below
         if ( faceSetName.empty() )
@@ -171,7 +192,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             }
         }
         
-        ProcessPolyMesh( polymesh, args, xformSamples, faceSetName );
+        if ( emit )
+        {
+            ProcessPolyMesh( polymesh, args, xformSamples, faceSetName );
+        }
         
         //if we found a matching faceset, don't traverse below
         if ( faceSetName.empty() )
@@ -225,7 +249,7 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             {
                 WalkObject( nextParentObject,
                             nextParentObject.getChildHeader( i ),
-                            args, I, E, xformSamples);
+                            args, I, E, xformSamples, culler, nextCullState);
             }
         }
         else
@@ -236,7 +260,7 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             if ( nextChildHeader != NULL )
             {
                 WalkObject( nextParentObject, *nextChildHeader, args, I+1, E,
-                    xformSamples);
+                    xformSamples, culler, nextCullState);
             }
         }
     }
@@ -245,6 +269,48 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
     
 }
 
+//-*************************************************************************
+// The culler asked for by -cullcamera or -cullhidden, if either was.
+std::auto_ptr<ObjectCuller> MakeCuller( IObject root, const ProcArgs &args )
+{
+    std::auto_ptr<ObjectCuller> culler;
+    chrono_t frameTime = args.frame / args.fps;
+
+    if ( !args.cullCamera.empty() )
+    {
+        PathList cameraPath;
+        TokenizePath( args.cullCamera, cameraPath );
+
+        IObject cameraObject = root;
+        for ( PathList::const_iterator I = cameraPath.begin();
+              I != cameraPath.end() && cameraObject.valid(); ++I )
+        {
+            cameraObject = cameraObject.getChild( *I );
+        }
+
+        if ( cameraObject.valid() &&
+             ICamera::matches( cameraObject.getHeader() ) )
+        {
+            ICamera camera( cameraObject, kWrapExisting );
+            culler.reset( new ObjectCuller(
+                GetWorldFrustum( camera, ISampleSelector( frameTime ) ),
+                ( args.frame + args.shutterOpen ) / args.fps,
+                ( args.frame + args.shutterClose ) / args.fps ) );
+            return culler;
+        }
+
+        std::cerr << "could not find a camera at " << args.cullCamera
+                  << ", culling hidden objects only" << std::endl;
+    }
+
+    if ( !args.cullCamera.empty() || args.cullHidden )
+    {
+        culler.reset( new ObjectCuller( frameTime ) );
+    }
+
+    return culler;
+}
+
 //-*************************************************************************
 
 int ProcInit( struct AtNode *node, void **user_ptr )
@@ -269,12 +335,20 @@ int ProcInit( struct AtNode *node, void **user_ptr )
 
     try
     {
+        std::auto_ptr<ObjectCuller> culler = MakeCuller( root, *args );
+        ObjectCuller::State cullState;
+        if ( culler.get() )
+        {
+            cullState = culler->getTopState();
+        }
+
         if ( path.empty() ) //walk the entire scene
         {
             for ( size_t i = 0; i < root.getNumChildren(); ++i )
             {
                 WalkObject( root, root.getChildHeader(i), *args,
-                            path.end(), path.end(), 0 );
+                            path.end(), path.end(), 0, culler.get(),
+                            cullState );
             }
         }
         else //walk to a location + its children
@@ -286,9 +360,18 @@ int ProcInit( struct AtNode *node, void **user_ptr )
             if ( nextChildHeader != NULL )
             {
                 WalkObject( root, *nextChildHeader, *args, I+1,
-                        path.end(), 0);
+                        path.end(), 0, culler.get(), cullState );
             }
         }
+
+        if ( culler.get() )
+        {
+            std::cerr << "AlembicArnoldProcedural: " << args->filename
+                      << " culled " << culler->getNumOutside()
+                      << " out of view and " << culler->getNumHidden()
+                      << " hidden, kept " << culler->getNumKept()
+                      << std::endl;
+        }
     }
     catch ( const std::exception &e )
     {
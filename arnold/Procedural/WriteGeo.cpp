@@ -258,17 +258,16 @@ AtNode * ProcessPolyMeshBase(
     if ( args.makeInstance )
     {
         std::ostringstream buffer;
-        AbcA::ArraySampleKey sampleKey;
-        
         
+        // all of the geometry, not just the positions, so that meshes
+        // which differ only in their uvs or topology aren't shared
         for ( SampleTimeSet::iterator I = sampleTimes.begin();
                 I != sampleTimes.end(); ++I )
         {
             ISampleSelector sampleSelector( *I );
-            ps.getPositionsProperty().getKey(sampleKey, sampleSelector);
             
             buffer << GetRelativeSampleTime( args, (*I) ) << ":";
-            sampleKey.digest.print(buffer);
+            buffer << GetGeometrySignature( prim, sampleSelector );
             buffer << ":";
         }
         
@@ -0,0 +1,82 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include <iostream>
+#include <set>
+
+//-*****************************************************************************
+// Rewrites an archive with its samples in time order and a frame index,
+// so that it can be streamed a frame at a time. See
+// Alembic/AbcCoreHDF5/Repack.h.
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    if ( argc != 3 )
+    {
+        std::cerr << "USAGE: " << argv[0] << " inFile.abc outFile.abc"
+                  << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        Alembic::AbcCoreHDF5::RepackArchive( argv[1], argv[2] );
+    }
+    catch ( std::exception &e )
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    Alembic::AbcCoreHDF5::FrameIndex index;
+    Alembic::AbcCoreHDF5::ReadFrameIndex( argv[2], index );
+
+    std::set<Alembic::AbcCoreAbstract::chrono_t> times;
+    Alembic::Util::uint64_t bytes = 0;
+    for ( size_t i = 0; i < index.size(); ++i )
+    {
+        times.insert( index[i].time );
+        bytes += index[i].size;
+    }
+
+    std::cout << argv[2] << ": " << times.size() << " frames indexed in "
+              << index.size() << " extents, " << bytes << " bytes"
+              << std::endl;
+
+    return 0;
+}
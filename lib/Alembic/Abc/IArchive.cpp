@@ -138,6 +138,52 @@ void IArchive::setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
     ALEMBIC_ABC_SAFE_CALL_END();
 }
 
+//-*****************************************************************************
+AbcA::ArchiveStats IArchive::getStats()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::getStats" );
+
+    return m_archive->getStats();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw,
+    // so return a NO-OP value
+    return AbcA::ArchiveStats();
+}
+
+//-*****************************************************************************
+void IArchive::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::getObjectStats" );
+
+    m_archive->getObjectStats( oStats );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void IArchive::resetStats()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::resetStats" );
+
+    m_archive->resetStats();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void IArchive::printHotObjects( std::ostream &ioStream, size_t iMaxObjects )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::printHotObjects" );
+
+    AbcA::ObjectStatsVec stats;
+    m_archive->getObjectStats( stats );
+    AbcA::PrintHotObjects( ioStream, stats, iMaxObjects );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Abc
 } // End namespace Alembic
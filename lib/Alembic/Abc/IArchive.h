@@ -131,6 +131,20 @@ public:
     //! will be disabled if a NULL cache is passed here.
     void setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr );
 
+    //! What has been read from this archive since it was opened or the
+    //! stats were last reset: bytes, samples, cache hits and misses, and
+    //! the time spent in storage, decompression, hashing and decoding.
+    AbcA::ArchiveStats getStats();
+
+    //! The same counts for each object with samples read, hottest first.
+    void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    //! Starts counting again from zero.
+    void resetStats();
+
+    //! Prints the hottest iMaxObjects objects, or all of them if it's 0.
+    void printHotObjects( std::ostream &ioStream, size_t iMaxObjects = 0 );
+
     //-*************************************************************************
     // ABC BASE MECHANISMS
     // These functions are used by Abc to deal with errors, rewrapping,
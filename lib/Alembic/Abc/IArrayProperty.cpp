@@ -113,6 +113,38 @@ void IArrayProperty::get( AbcA::ArraySamplePtr& oSamp,
     ALEMBIC_ABC_SAFE_CALL_END();
 }
 
+//-*****************************************************************************
+void IArrayProperty::get( AbcA::ArraySamplePtr& oSamp,
+                          PlainOldDataType iPod,
+                          const ISampleSelector &iSS )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArrayProperty::get( pod )" );
+
+    m_property->getSampleAs(
+        iSS.getIndex( m_property->getTimeSampling(),
+                      m_property->getNumSamples() ),
+        iPod, oSamp );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void IArrayProperty::getWindow( std::vector<AbcA::ArraySamplePtr> & oSamples,
+                                std::vector<chrono_t> & oTimes,
+                                const ISampleWindow &iWindow )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArrayProperty::getWindow()" );
+
+    std::pair<index_t, index_t> range =
+        iWindow.getIndexRange( m_property->getTimeSampling(),
+                               m_property->getNumSamples(),
+                               oTimes );
+
+    m_property->getSamples( range.first, range.second, oSamples );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
 //-*****************************************************************************
 bool IArrayProperty::getKey( AbcA::ArraySampleKey& oKey,
                              const ISampleSelector &iSS )
@@ -129,6 +129,21 @@ public:
     void get( AbcA::ArraySamplePtr& oSample,
               const ISampleSelector &iSS = ISampleSelector() );
 
+    //! Get a sample with its values converted to iPod, for instance
+    //! float32 positions from a property stored as float64. The converted
+    //! sample is cached, so reading it again doesn't convert it again.
+    //! Only integer and floating point PODs convert, see
+    //! AbcA::CanConvertPOD.
+    void get( AbcA::ArraySamplePtr& oSample,
+              PlainOldDataType iPod,
+              const ISampleSelector &iSS = ISampleSelector() );
+
+    //! Get every sample in iWindow with one call, along with the time
+    //! of each of them. See ISampleWindow.
+    void getWindow( std::vector<AbcA::ArraySamplePtr> & oSamples,
+                    std::vector<chrono_t> & oTimes,
+                    const ISampleWindow &iWindow );
+
     //! Get a key from an address of a datum.
     //! ...
     bool getKey( AbcA::ArraySampleKey& oKey,
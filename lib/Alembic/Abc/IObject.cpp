@@ -171,6 +171,107 @@ IObject IObject::getChild( const std::string &iChildName )
     return IObject();
 }
 
+//-*****************************************************************************
+bool IObject::isInstanceRoot()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::isInstanceRoot()" );
+
+    return m_object->isInstanceRoot();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, have a default.
+    return false;
+}
+
+//-*****************************************************************************
+bool IObject::isInstanceDescendant()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::isInstanceDescendant()" );
+
+    return m_object->isInstanceDescendant();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, have a default.
+    return false;
+}
+
+//-*****************************************************************************
+std::string IObject::getInstanceSourcePath()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::getInstanceSourcePath()" );
+
+    return m_object->getInstanceSourcePath();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, have a default.
+    return std::string();
+}
+
+//-*****************************************************************************
+IObject IObject::getInstanceSource()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::getInstanceSource()" );
+
+    std::string path = m_object->getInstanceSourcePath();
+    if ( path.empty() )
+    {
+        return IObject();
+    }
+
+    // Walk down from the top, one name at a time.
+    AbcA::ObjectReaderPtr obj = m_object->getArchive()->getTop();
+    size_t start = 1;
+    while ( obj && start < path.size() )
+    {
+        size_t end = path.find( '/', start );
+        if ( end == std::string::npos )
+        {
+            end = path.size();
+        }
+
+        obj = obj->getChild( path.substr( start, end - start ) );
+        start = end + 1;
+    }
+
+    ABCA_ASSERT( obj, "Could not find instance source: " << path );
+
+    return IObject( obj, kWrapExisting, getErrorHandlerPolicy() );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, return something in case.
+    return IObject();
+}
+
+//-*****************************************************************************
+bool IObject::isChildInstance( size_t iChildIndex )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::isChildInstance( index )" );
+
+    return m_object->isChildInstance( iChildIndex );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, have a default.
+    return false;
+}
+
+//-*****************************************************************************
+bool IObject::isChildInstance( const std::string &iChildName )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IObject::isChildInstance( name )" );
+
+    return m_object->isChildInstance( iChildName );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, have a default.
+    return false;
+}
+
 //-*****************************************************************************
 ICompoundProperty IObject::getProperties()
 {
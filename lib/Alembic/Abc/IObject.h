@@ -191,6 +191,34 @@ public:
     //! equivalent constructor was called.
     IObject getChild( const std::string &iChildName );
 
+    //-*************************************************************************
+    // INSTANCES
+    // An instance was written with OObject::addChildInstance, and reads the
+    // same properties and children as the object it is an instance of.
+    //-*************************************************************************
+
+    //! This function returns whether this object is an instance.
+    bool isInstanceRoot();
+
+    //! This function returns whether this object, or one of its
+    //! ancestors, is an instance.
+    bool isInstanceDescendant();
+
+    //! This function returns the full name of the object this one is
+    //! an instance of, or an empty string if it isn't an instance.
+    std::string getInstanceSourcePath();
+
+    //! This function returns the object this one is an instance of,
+    //! found from the top of the archive. If this object isn't an
+    //! instance, the IObject returned will be NULL.
+    IObject getInstanceSource();
+
+    //! This function returns whether the indexed child is an instance.
+    bool isChildInstance( size_t iChildIndex );
+
+    //! This function returns whether the named child is an instance.
+    bool isChildInstance( const std::string &iChildName );
+
     //-*************************************************************************
     // ABC BASE MECHANISMS
     // These functions are used by Abc to deal with errors, rewrapping,
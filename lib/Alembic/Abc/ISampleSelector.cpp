@@ -67,6 +67,55 @@ index_t ISampleSelector::getIndex( const AbcA::TimeSamplingPtr & iTsmp,
     return retIdx < 0 ? 0 : ( retIdx < iNumSamples ? retIdx : iNumSamples-1 );
 }
 
+//-*****************************************************************************
+ISampleWindow::ISampleWindow( chrono_t iStartTime, chrono_t iEndTime )
+  : m_startTime( iStartTime )
+  , m_endTime( iEndTime )
+{
+    ABCA_ASSERT( m_startTime <= m_endTime,
+                 "Invalid sample window, start time: " << m_startTime
+                 << " is after end time: " << m_endTime );
+}
+
+//-*****************************************************************************
+std::pair<index_t, index_t>
+ISampleWindow::getIndexRange( const AbcA::TimeSamplingPtr & iTsmp,
+                              index_t iNumSamples ) const
+{
+    if ( iNumSamples < 1 )
+    {
+        return std::pair<index_t, index_t>( 0, -1 );
+    }
+
+    // The floor of the start and the ceiling of the end bracket the
+    // window, which clamp to the first and last sample when the window
+    // hangs off either end.
+    index_t first = iTsmp->getFloorIndex( m_startTime, iNumSamples ).first;
+    index_t last = iTsmp->getCeilIndex( m_endTime, iNumSamples ).first;
+
+    first = first < 0 ? 0 : ( first < iNumSamples ? first : iNumSamples-1 );
+    last = last < first ? first : ( last < iNumSamples ? last : iNumSamples-1 );
+
+    return std::pair<index_t, index_t>( first, last );
+}
+
+//-*****************************************************************************
+std::pair<index_t, index_t>
+ISampleWindow::getIndexRange( const AbcA::TimeSamplingPtr & iTsmp,
+                              index_t iNumSamples,
+                              std::vector<chrono_t> & oTimes ) const
+{
+    std::pair<index_t, index_t> range = getIndexRange( iTsmp, iNumSamples );
+
+    oTimes.clear();
+    for ( index_t i = range.first; i <= range.second; ++i )
+    {
+        oTimes.push_back( iTsmp->getSampleTime( i ) );
+    }
+
+    return range;
+}
+
 
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Abc
@@ -84,6 +84,38 @@ private:
     TimeIndexType m_requestedTimeIndexType;
 };
 
+//-*****************************************************************************
+//! An ISampleWindow selects all the samples relevant to a span of time,
+//! such as a shutter interval, where an ISampleSelector selects just one.
+//! Those are the samples whose times fall inside [start, end], along with
+//! the closest sample on either side of it, so that a value anywhere in
+//! the window can be interpolated from what's returned.
+class ISampleWindow
+{
+public:
+    ISampleWindow( chrono_t iStartTime, chrono_t iEndTime );
+
+    chrono_t getStartTime() const { return m_startTime; }
+    chrono_t getEndTime() const { return m_endTime; }
+
+    //! Returns the first and last sample index in the window, inclusive.
+    //! If there are no samples the last index is less than the first.
+    std::pair<index_t, index_t>
+    getIndexRange( const AbcA::TimeSamplingPtr & iTsmp,
+                   index_t iNumSamples ) const;
+
+    //! As above, and also fills oTimes with the time of each of those
+    //! samples.
+    std::pair<index_t, index_t>
+    getIndexRange( const AbcA::TimeSamplingPtr & iTsmp,
+                   index_t iNumSamples,
+                   std::vector<chrono_t> & oTimes ) const;
+
+private:
+    chrono_t m_startTime;
+    chrono_t m_endTime;
+};
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
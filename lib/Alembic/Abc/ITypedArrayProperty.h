@@ -138,6 +138,23 @@ public:
         iVal = boost::static_pointer_cast<sample_type, AbcA::ArraySample>( ptr );
     }
 
+    //! Get every typed sample in iWindow with one call, along with the
+    //! time of each of them. See ISampleWindow.
+    void getWindow( std::vector<sample_ptr_type> & oVals,
+                    std::vector<chrono_t> & oTimes,
+                    const ISampleWindow &iWindow )
+    {
+        std::vector<AbcA::ArraySamplePtr> ptrs;
+        IArrayProperty::getWindow( ptrs, oTimes, iWindow );
+
+        oVals.resize( ptrs.size() );
+        for ( size_t i = 0; i < ptrs.size(); ++i )
+        {
+            oVals[i] = boost::static_pointer_cast<sample_type,
+                AbcA::ArraySample>( ptrs[i] );
+        }
+    }
+
     //! Return the typed sample by value.
     //! ...
     sample_ptr_type getValue( const ISampleSelector &iSS = ISampleSelector() )
@@ -133,6 +133,29 @@ public:
         IScalarProperty::get( reinterpret_cast<void*>( &iVal ), iSS );
     }
 
+    //! Get every typed sample in iWindow with one call, along with the
+    //! time of each of them. See ISampleWindow.
+    void getWindow( std::vector<value_type> & oVals,
+                    std::vector<chrono_t> & oTimes,
+                    const ISampleWindow &iWindow )
+    {
+        ALEMBIC_ABC_SAFE_CALL_BEGIN( "ITypedScalarProperty::getWindow()" );
+
+        std::pair<index_t, index_t> range =
+            iWindow.getIndexRange( this->m_property->getTimeSampling(),
+                                   this->m_property->getNumSamples(),
+                                   oTimes );
+
+        oVals.resize( oTimes.size() );
+        for ( index_t i = range.first; i <= range.second; ++i )
+        {
+            this->m_property->getSample( i, reinterpret_cast<void*>(
+                &( oVals[i - range.first] ) ) );
+        }
+
+        ALEMBIC_ABC_SAFE_CALL_END();
+    }
+
     //! Return the typed sample by value.
     //! ...
     value_type getValue( const ISampleSelector &iSS = ISampleSelector() )
@@ -146,6 +146,52 @@ OObject OArchive::getTop()
     return OObject();
 }
 
+//-*****************************************************************************
+AbcA::ArchiveStats OArchive::getStats()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArchive::getStats" );
+
+    return m_archive->getStats();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw,
+    // so return a NO-OP value
+    return AbcA::ArchiveStats();
+}
+
+//-*****************************************************************************
+void OArchive::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArchive::getObjectStats" );
+
+    m_archive->getObjectStats( oStats );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void OArchive::resetStats()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArchive::resetStats" );
+
+    m_archive->resetStats();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void OArchive::printHotObjects( std::ostream &ioStream, size_t iMaxObjects )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArchive::printHotObjects" );
+
+    AbcA::ObjectStatsVec stats;
+    m_archive->getObjectStats( stats );
+    AbcA::PrintHotObjects( ioStream, stats, iMaxObjects );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Abc
 } // End namespace Alembic
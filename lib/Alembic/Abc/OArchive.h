@@ -149,6 +149,20 @@ public:
     //! TimeSampling pool.
     uint32_t getNumTimeSamplings();
 
+    //! What has been written to this archive since it was opened or the
+    //! stats were last reset: bytes, samples, cache hits and misses, and
+    //! the time spent in storage, decompression, hashing and decoding.
+    AbcA::ArchiveStats getStats();
+
+    //! The same counts for each object with samples written, hottest first.
+    void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    //! Starts counting again from zero.
+    void resetStats();
+
+    //! Prints the hottest iMaxObjects objects, or all of them if it's 0.
+    void printHotObjects( std::ostream &ioStream, size_t iMaxObjects = 0 );
+
     //-*************************************************************************
     // ABC BASE MECHANISMS
     // These functions are used by Abc to deal with errors, rewrapping,
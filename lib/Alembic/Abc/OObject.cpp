@@ -168,6 +168,18 @@ OObject OObject::getChild( const std::string &iName )
     return OObject();
 }
 
+//-*****************************************************************************
+void OObject::addChildInstance( OObject iTarget, const std::string &iName )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OObject::addChildInstance()" );
+
+    ABCA_ASSERT( iTarget.valid(), "Invalid instance target for: " << iName );
+
+    m_object->addChildInstance( iTarget.getPtr(), iName );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
 //-*****************************************************************************
 OCompoundProperty OObject::getProperties()
 {
@@ -197,6 +197,17 @@ public:
     //! exists, this function will return an empty OObject.
     OObject getChild( const std::string &iChildName );
 
+    //-*************************************************************************
+    // INSTANCES
+    //-*************************************************************************
+
+    //! This function adds a child named iName that is an instance of
+    //! iTarget, an object already created in the same archive. The
+    //! instance has no properties or children of its own, when read it
+    //! has those of iTarget. iTarget can't be this object or one of its
+    //! ancestors.
+    void addChildInstance( OObject iTarget, const std::string &iName );
+
     //-*************************************************************************
     // ABC BASE MECHANISMS
     // These functions are used by Abc to deal with errors, rewrapping,
@@ -0,0 +1,194 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Abc/All.h>
+
+#include <Alembic/Abc/Tests/Assert.h>
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace Abc = Alembic::Abc;
+using namespace Abc;
+
+//-*****************************************************************************
+// Reads converted to another POD must match converting the stored values
+// by hand, and reading the same conversion twice must share one sample.
+//-*****************************************************************************
+
+static const size_t g_numValues = 7;
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    OObject child( archive.getTop(), "child" );
+
+    std::vector<V3d> points;
+    std::vector<float16_t> halfs;
+    std::vector<int64_t> ids;
+    std::vector<std::string> names;
+    for ( size_t i = 0; i < g_numValues; ++i )
+    {
+        points.push_back( V3d( i * 0.5, -( double ) i, i * 1.0e6 ) );
+        halfs.push_back( float16_t( i * 0.25f ) );
+        ids.push_back( ( int64_t ) i * 1000 - 3000 );
+        names.push_back( "name" );
+    }
+
+    OP3dArrayProperty pointsProp( child.getProperties(), "points" );
+    pointsProp.set( P3dArraySample( points ) );
+
+    OHalfArrayProperty halfProp( child.getProperties(), "halfs" );
+    halfProp.set( HalfArraySample( halfs ) );
+
+    OInt64ArrayProperty idProp( child.getProperties(), "ids" );
+    idProp.set( Int64ArraySample( ids ) );
+
+    OStringArrayProperty nameProp( child.getProperties(), "names" );
+    nameProp.set( StringArraySample( names ) );
+}
+
+//-*****************************************************************************
+void readArchive( const std::string &iName )
+{
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), iName );
+    IObject child( archive.getTop(), "child" );
+    ICompoundProperty props = child.getProperties();
+
+    // float64 points as float32, keeping the extent
+    IArrayProperty pointsProp( props, "points" );
+    AbcA::ArraySamplePtr stored;
+    pointsProp.get( stored );
+    AbcA::ArraySamplePtr converted;
+    pointsProp.get( converted, kFloat32POD );
+
+    TESTING_ASSERT( converted->getDataType() ==
+                    AbcA::DataType( kFloat32POD, 3 ) );
+    TESTING_ASSERT( converted->size() == g_numValues );
+
+    const float64_t *d = static_cast<const float64_t *>( stored->getData() );
+    const float32_t *f =
+        static_cast<const float32_t *>( converted->getData() );
+    for ( size_t i = 0; i < g_numValues * 3; ++i )
+    {
+        TESTING_ASSERT( f[i] == ( float32_t ) d[i] );
+    }
+
+    // the second read comes from the cache
+    AbcA::ArraySamplePtr again;
+    pointsProp.get( again, kFloat32POD );
+    TESTING_ASSERT( again->getData() == converted->getData() );
+
+    // and the stored sample is still there as it was
+    AbcA::ArraySamplePtr storedAgain;
+    pointsProp.get( storedAgain );
+    TESTING_ASSERT( storedAgain->getDataType() ==
+                    AbcA::DataType( kFloat64POD, 3 ) );
+
+    // float16 expanded to float32
+    IArrayProperty halfProp( props, "halfs" );
+    AbcA::ArraySamplePtr expanded;
+    halfProp.get( expanded, kFloat32POD );
+    f = static_cast<const float32_t *>( expanded->getData() );
+    for ( size_t i = 0; i < g_numValues; ++i )
+    {
+        TESTING_ASSERT( f[i] == i * 0.25f );
+    }
+
+    // int64 narrowed to int32
+    IArrayProperty idProp( props, "ids" );
+    AbcA::ArraySamplePtr narrowed;
+    idProp.get( narrowed, kInt32POD );
+    const int32_t *ids = static_cast<const int32_t *>( narrowed->getData() );
+    for ( size_t i = 0; i < g_numValues; ++i )
+    {
+        TESTING_ASSERT( ids[i] == ( int32_t ) i * 1000 - 3000 );
+    }
+
+    // floats that don't fit in an integer POD are clamped, and NaNs are 0
+    float64_t wide[] = { 1.0e6, -1.0e6, -0.5, 200.75,
+                         std::numeric_limits<float64_t>::quiet_NaN(),
+                         std::numeric_limits<float64_t>::infinity(),
+                         1.0e30, -1.0e30 };
+    AbcA::ArraySample wideSamp( wide, AbcA::DataType( kFloat64POD, 1 ),
+                                AbcA::Dimensions( 8 ) );
+
+    AbcA::ArraySamplePtr bytes = AbcA::ConvertArraySample( wideSamp,
+                                                           kUint8POD );
+    const uint8_t *b = static_cast<const uint8_t *>( bytes->getData() );
+    TESTING_ASSERT( b[0] == 255 && b[1] == 0 && b[2] == 0 && b[3] == 200 );
+    TESTING_ASSERT( b[4] == 0 && b[5] == 255 && b[6] == 255 && b[7] == 0 );
+
+    AbcA::ArraySamplePtr longs = AbcA::ConvertArraySample( wideSamp,
+                                                           kInt64POD );
+    const int64_t *l = static_cast<const int64_t *>( longs->getData() );
+    TESTING_ASSERT( l[0] == 1000000 && l[1] == -1000000 && l[2] == 0 );
+    TESTING_ASSERT( l[4] == 0 );
+    TESTING_ASSERT( l[5] == std::numeric_limits<int64_t>::max() );
+    TESTING_ASSERT( l[6] == std::numeric_limits<int64_t>::max() );
+    TESTING_ASSERT( l[7] == std::numeric_limits<int64_t>::min() );
+
+    // asking for the stored POD is the same as a plain read
+    AbcA::ArraySamplePtr same;
+    idProp.get( same, kInt64POD );
+    TESTING_ASSERT( same->getDataType().getPod() == kInt64POD );
+
+    // strings don't convert
+    IArrayProperty nameProp( props, "names" );
+    bool threw = false;
+    try
+    {
+        AbcA::ArraySamplePtr nope;
+        nameProp.get( nope, kInt32POD );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "convertedReadTest.abc";
+    writeArchive( name );
+    readArchive( name );
+    return 0;
+}
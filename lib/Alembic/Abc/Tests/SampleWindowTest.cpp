@@ -0,0 +1,204 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Abc/All.h>
+
+#include <Alembic/Abc/Tests/Assert.h>
+
+#include <iostream>
+#include <vector>
+
+namespace Abc = Alembic::Abc;
+using namespace Abc;
+
+//-*****************************************************************************
+// Reads through ISampleWindow must match reading the same indices one by
+// one with ISampleSelector.
+//-*****************************************************************************
+
+static const chrono_t g_dt = 1.0 / 24.0;
+static const size_t g_numSamples = 10;
+
+//-*****************************************************************************
+// The first two samples are the same and so are the last three, so that
+// the held samples are exercised.
+float32_t sampleValue( size_t iIndex )
+{
+    if ( iIndex < 2 ) { return 0.0f; }
+    if ( iIndex > 6 ) { return 6.0f; }
+    return ( float32_t ) iIndex;
+}
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    OObject child( archive.getTop(), "child" );
+
+    TimeSamplingPtr ts( new TimeSampling( g_dt, 0.0 ) );
+
+    OFloatArrayProperty arrayProp( child.getProperties(), "floats", ts );
+    ODoubleProperty scalarProp( child.getProperties(), "double", ts );
+
+    std::vector<float32_t> vals( 5 );
+    for ( size_t i = 0; i < g_numSamples; ++i )
+    {
+        std::fill( vals.begin(), vals.end(), sampleValue( i ) );
+        arrayProp.set( FloatArraySample( vals ) );
+        scalarProp.set( sampleValue( i ) * 2.0 );
+    }
+}
+
+//-*****************************************************************************
+void checkWindow( IFloatArrayProperty &iArray, IDoubleProperty &iScalar,
+                  chrono_t iStart, chrono_t iEnd,
+                  index_t iExpectedFirst, index_t iExpectedLast )
+{
+    ISampleWindow window( iStart, iEnd );
+
+    std::pair<index_t, index_t> range =
+        window.getIndexRange( iArray.getTimeSampling(),
+                              iArray.getNumSamples() );
+    TESTING_ASSERT( range.first == iExpectedFirst );
+    TESTING_ASSERT( range.second == iExpectedLast );
+
+    size_t expectedCount = iExpectedLast - iExpectedFirst + 1;
+
+    std::vector<FloatArraySamplePtr> samps;
+    std::vector<chrono_t> times;
+    iArray.getWindow( samps, times, window );
+    TESTING_ASSERT( samps.size() == expectedCount );
+    TESTING_ASSERT( times.size() == expectedCount );
+
+    std::vector<float64_t> scalars;
+    std::vector<chrono_t> scalarTimes;
+    iScalar.getWindow( scalars, scalarTimes, window );
+    TESTING_ASSERT( scalars.size() == expectedCount );
+    TESTING_ASSERT( scalarTimes == times );
+
+    for ( size_t i = 0; i < expectedCount; ++i )
+    {
+        index_t index = iExpectedFirst + i;
+        TESTING_ASSERT( times[i] ==
+                        iArray.getTimeSampling()->getSampleTime( index ) );
+
+        FloatArraySamplePtr single = iArray.getValue( ISampleSelector( index ) );
+        TESTING_ASSERT( samps[i]->size() == single->size() );
+        for ( size_t j = 0; j < single->size(); ++j )
+        {
+            TESTING_ASSERT( ( *samps[i] )[j] == ( *single )[j] );
+            TESTING_ASSERT( ( *samps[i] )[j] == sampleValue( index ) );
+        }
+
+        TESTING_ASSERT( scalars[i] == sampleValue( index ) * 2.0 );
+    }
+}
+
+//-*****************************************************************************
+void readArchive( const std::string &iName )
+{
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), iName );
+    IObject child( archive.getTop(), "child" );
+
+    IFloatArrayProperty arrayProp( child.getProperties(), "floats" );
+    IDoubleProperty scalarProp( child.getProperties(), "double" );
+
+    TESTING_ASSERT( arrayProp.getNumSamples() == g_numSamples );
+
+    // a shutter between frames 3 and 4 brackets with both of them
+    checkWindow( arrayProp, scalarProp, 3.25 * g_dt, 3.75 * g_dt, 3, 4 );
+
+    // a window spanning several samples, not landing on any
+    checkWindow( arrayProp, scalarProp, 1.5 * g_dt, 4.2 * g_dt, 1, 5 );
+
+    // landing exactly on samples doesn't pull in any neighbors
+    checkWindow( arrayProp, scalarProp, 2.0 * g_dt, 5.0 * g_dt, 2, 5 );
+
+    // a zero length window on a sample is just that sample
+    checkWindow( arrayProp, scalarProp, 4.0 * g_dt, 4.0 * g_dt, 4, 4 );
+
+    // windows hanging off either end clamp
+    checkWindow( arrayProp, scalarProp, -10.0, -5.0, 0, 0 );
+    checkWindow( arrayProp, scalarProp, -10.0, 1.5 * g_dt, 0, 2 );
+    checkWindow( arrayProp, scalarProp, 8.5 * g_dt, 100.0, 8, 9 );
+    checkWindow( arrayProp, scalarProp, 50.0, 100.0, 9, 9 );
+
+    // everything
+    checkWindow( arrayProp, scalarProp, -1.0, 100.0, 0, 9 );
+
+    // the held samples are read once and shared
+    std::vector<FloatArraySamplePtr> samps;
+    std::vector<chrono_t> times;
+    arrayProp.getWindow( samps, times, ISampleWindow( -1.0, 100.0 ) );
+    TESTING_ASSERT( samps[0] == samps[1] );
+    TESTING_ASSERT( samps[7] == samps[8] && samps[8] == samps[9] );
+    TESTING_ASSERT( samps[2] != samps[3] );
+
+    TESTING_ASSERT_THROW( ISampleWindow( 2.0, 1.0 ),
+                          Alembic::Util::Exception );
+}
+
+//-*****************************************************************************
+void testEmptyProperty()
+{
+    std::string name = "sampleWindowEmpty.abc";
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OObject child( archive.getTop(), "child" );
+        OFloatArrayProperty arrayProp( child.getProperties(), "floats" );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject child( archive.getTop(), "child" );
+    IFloatArrayProperty arrayProp( child.getProperties(), "floats" );
+
+    std::vector<FloatArraySamplePtr> samps( 3 );
+    std::vector<chrono_t> times( 3 );
+    arrayProp.getWindow( samps, times, ISampleWindow( 0.0, 1.0 ) );
+    TESTING_ASSERT( samps.empty() );
+    TESTING_ASSERT( times.empty() );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "sampleWindow.abc";
+    writeArchive( name );
+    readArchive( name );
+    testEmptyProperty();
+    return 0;
+}
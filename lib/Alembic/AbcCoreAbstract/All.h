@@ -38,6 +38,7 @@
 #define _Alembic_AbcCoreAbstract_All_h_
 
 #include <Alembic/AbcCoreAbstract/ArchiveReader.h>
+#include <Alembic/AbcCoreAbstract/ArchiveStats.h>
 #include <Alembic/AbcCoreAbstract/ArchiveWriter.h>
 #include <Alembic/AbcCoreAbstract/ArrayPropertyReader.h>
 #include <Alembic/AbcCoreAbstract/ArrayPropertyWriter.h>
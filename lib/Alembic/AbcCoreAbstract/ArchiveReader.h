@@ -40,6 +40,7 @@
 #include <Alembic/AbcCoreAbstract/Foundation.h>
 #include <Alembic/AbcCoreAbstract/ForwardDeclarations.h>
 #include <Alembic/AbcCoreAbstract/ReadArraySampleCache.h>
+#include <Alembic/AbcCoreAbstract/ArchiveStats.h>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
@@ -116,6 +117,17 @@ public:
     //! of this archive file.
     virtual int32_t getArchiveVersion() = 0;
 
+    //! Returns what the archive has read so far, added up over all of
+    //! the threads that read from it.
+    virtual ArchiveStats getStats() = 0;
+
+    //! Returns what was read for each object that anything was read
+    //! for, most bytes first.
+    virtual void getObjectStats( ObjectStatsVec &oStats ) = 0;
+
+    //! Starts counting again from zero.
+    virtual void resetStats() = 0;
+
     //! Return self
     //! ...
     virtual ArchiveReaderPtr asArchivePtr() = 0;
@@ -0,0 +1,133 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/ArchiveStats.h>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+ArchiveStats::ArchiveStats()
+  : bytesRead( 0 )
+  , bytesWritten( 0 )
+  , scalarSamplesRead( 0 )
+  , arraySamplesRead( 0 )
+  , scalarSamplesWritten( 0 )
+  , arraySamplesWritten( 0 )
+  , cacheHits( 0 )
+  , cacheMisses( 0 )
+  , storageCalls( 0 )
+  , storageSeconds( 0.0 )
+  , decompressSeconds( 0.0 )
+  , hashSeconds( 0.0 )
+  , stringDecodeSeconds( 0.0 )
+{
+    // Nothing
+}
+
+//-*****************************************************************************
+ArchiveStats &ArchiveStats::operator+=( const ArchiveStats &iStats )
+{
+    bytesRead += iStats.bytesRead;
+    bytesWritten += iStats.bytesWritten;
+    scalarSamplesRead += iStats.scalarSamplesRead;
+    arraySamplesRead += iStats.arraySamplesRead;
+    scalarSamplesWritten += iStats.scalarSamplesWritten;
+    arraySamplesWritten += iStats.arraySamplesWritten;
+    cacheHits += iStats.cacheHits;
+    cacheMisses += iStats.cacheMisses;
+    storageCalls += iStats.storageCalls;
+    storageSeconds += iStats.storageSeconds;
+    decompressSeconds += iStats.decompressSeconds;
+    hashSeconds += iStats.hashSeconds;
+    stringDecodeSeconds += iStats.stringDecodeSeconds;
+    return *this;
+}
+
+//-*****************************************************************************
+static bool MoreBytes( const ObjectStats &iA, const ObjectStats &iB )
+{
+    return iA.stats.totalBytes() > iB.stats.totalBytes();
+}
+
+//-*****************************************************************************
+void SortHotObjects( ObjectStatsVec &ioStats )
+{
+    std::stable_sort( ioStats.begin(), ioStats.end(), MoreBytes );
+}
+
+//-*****************************************************************************
+void PrintHotObjects( std::ostream &ioStream, const ObjectStatsVec &iStats,
+                      size_t iMaxObjects )
+{
+    size_t numObjects = iStats.size();
+    if ( iMaxObjects > 0 && iMaxObjects < numObjects )
+    {
+        numObjects = iMaxObjects;
+    }
+
+    for ( size_t i = 0; i < numObjects; ++i )
+    {
+        ioStream << iStats[i].fullName << ": " << iStats[i].stats
+                 << std::endl;
+    }
+}
+
+//-*****************************************************************************
+std::ostream &operator<<( std::ostream &ioStream, const ArchiveStats &iStats )
+{
+    ioStream << "read " << iStats.bytesRead << " bytes, "
+             << iStats.scalarSamplesRead << " scalar and "
+             << iStats.arraySamplesRead << " array samples; "
+             << "wrote " << iStats.bytesWritten << " bytes, "
+             << iStats.scalarSamplesWritten << " scalar and "
+             << iStats.arraySamplesWritten << " array samples; "
+             << "cache " << iStats.cacheHits << " hits, "
+             << iStats.cacheMisses << " misses; "
+             << iStats.storageCalls << " storage calls, "
+             << iStats.storageSeconds << "s; "
+             << "decompress " << iStats.decompressSeconds << "s, "
+             << "hash " << iStats.hashSeconds << "s, "
+             << "strings " << iStats.stringDecodeSeconds << "s";
+    return ioStream;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
@@ -0,0 +1,124 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreAbstract_ArchiveStats_h_
+#define _Alembic_AbcCoreAbstract_ArchiveStats_h_
+
+#include <Alembic/AbcCoreAbstract/Foundation.h>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Counts of the work an archive has done reading or writing samples,
+//! since it was opened or its counts were last reset. Implementations
+//! count whichever of these they can, the rest stay zero.
+struct ArchiveStats
+{
+    ArchiveStats();
+
+    //! Bytes of sample data read from the file, as they are stored there,
+    //! and handed to it to be written, which it may compress further.
+    //! Samples found in a cache aren't read.
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+
+    //! Samples asked for, and set, by the type of property they are of.
+    uint64_t scalarSamplesRead;
+    uint64_t arraySamplesRead;
+    uint64_t scalarSamplesWritten;
+    uint64_t arraySamplesWritten;
+
+    //! Array samples looked for in the read cache, found or not.
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+
+    //! Calls into the storage library that read or write sample data,
+    //! and the seconds spent in them.
+    uint64_t storageCalls;
+    float64_t storageSeconds;
+
+    //! Seconds spent decompressing or decoding array samples after they
+    //! were read, hashing array samples to get their keys, and turning
+    //! the characters read for string samples into strings.
+    float64_t decompressSeconds;
+    float64_t hashSeconds;
+    float64_t stringDecodeSeconds;
+
+    //! Bytes read and written together, which is what sorts the hot list.
+    uint64_t totalBytes() const { return bytesRead + bytesWritten; }
+
+    ArchiveStats &operator+=( const ArchiveStats &iStats );
+};
+
+//-*****************************************************************************
+//! The counts of one object's properties.
+struct ObjectStats
+{
+    ObjectStats() {}
+
+    ObjectStats( const std::string &iFullName, const ArchiveStats &iStats )
+      : fullName( iFullName ), stats( iStats ) {}
+
+    std::string fullName;
+    ArchiveStats stats;
+};
+
+typedef std::vector<ObjectStats> ObjectStatsVec;
+
+//-*****************************************************************************
+//! Sorts iStats, most bytes first.
+void SortHotObjects( ObjectStatsVec &ioStats );
+
+//-*****************************************************************************
+//! Writes the first iMaxObjects of iStats, one per line, with their
+//! bytes read and written, samples and time spent. All of them, if
+//! iMaxObjects is 0.
+void PrintHotObjects( std::ostream &ioStream, const ObjectStatsVec &iStats,
+                      size_t iMaxObjects = 0 );
+
+//-*****************************************************************************
+std::ostream &operator<<( std::ostream &ioStream, const ArchiveStats &iStats );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
+
+#endif
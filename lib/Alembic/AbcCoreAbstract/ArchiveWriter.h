@@ -40,6 +40,7 @@
 #include <Alembic/AbcCoreAbstract/Foundation.h>
 #include <Alembic/AbcCoreAbstract/MetaData.h>
 #include <Alembic/AbcCoreAbstract/ForwardDeclarations.h>
+#include <Alembic/AbcCoreAbstract/ArchiveStats.h>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
@@ -127,6 +128,17 @@ public:
     //! TimeSampling pool.
     virtual uint32_t getNumTimeSamplings() = 0;
 
+    //! Returns what the archive has written so far, added up over all
+    //! of the threads that wrote to it.
+    virtual ArchiveStats getStats() = 0;
+
+    //! Returns what was written for each object that anything was
+    //! written for, most bytes first.
+    virtual void getObjectStats( ObjectStatsVec &oStats ) = 0;
+
+    //! Starts counting again from zero.
+    virtual void resetStats() = 0;
+
 private:
     int8_t m_compressionHint;
 };
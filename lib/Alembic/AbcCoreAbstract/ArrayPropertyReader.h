@@ -91,6 +91,26 @@ public:
     virtual void getSample( index_t iSampleIndex,
                             ArraySamplePtr &oSample ) = 0;
 
+    //! The same as getSample, but with the values converted to iPod,
+    //! keeping the extent and dimensions. Implementations should cache the
+    //! converted sample under its own key, with readPOD set to iPod, so
+    //! that the conversion happens once per stored sample.
+    //! It will throw if CanConvertPOD doesn't allow the conversion, unless
+    //! iPod is the property's own POD.
+    virtual void getSampleAs( index_t iSampleIndex,
+                              PlainOldDataType iPod,
+                              ArraySamplePtr &oSample ) = 0;
+
+    //! Fills oSamples with samples iFirstIndex through iLastIndex,
+    //! inclusive. The result is the same as calling getSample for each
+    //! index, but implementations can share work across the range,
+    //! for instance by reading a repeated sample only once.
+    //! oSamples is left empty if iLastIndex < iFirstIndex.
+    //! It will throw an exception on an out-of-range access.
+    virtual void getSamples( index_t iFirstIndex,
+                             index_t iLastIndex,
+                             std::vector<ArraySamplePtr> &oSamples ) = 0;
+
     //! Find the largest valid index that has a time less than or equal
     //! to the given time. Invalid to call this with zero samples.
     //! If the minimum sample time is greater than iTime, index
@@ -37,10 +37,116 @@
 #include <Alembic/AbcCoreAbstract/ArraySample.h>
 #include <Alembic/Util/Murmur3.h>
 
+#include <limits>
+
 namespace Alembic {
 namespace AbcCoreAbstract {
 namespace ALEMBIC_VERSION_NS {
 
+namespace {
+
+//-*****************************************************************************
+// Converts one value as static_cast does.
+template <class FROM, class TO, bool FLOAT_TO_INT>
+struct ConvertValue
+{
+    static TO apply( FROM iVal ) { return static_cast<TO>( iVal ); }
+};
+
+//-*****************************************************************************
+// Casting a float that doesn't fit in an integer type is undefined, so
+// those are clamped to the type's range first, and NaNs become 0. The
+// top of a 64 bit range rounds up to a power of two as a double, which is
+// already out of range, so >= is right for it too.
+template <class FROM, class TO>
+struct ConvertValue<FROM, TO, true>
+{
+    static TO apply( FROM iVal )
+    {
+        float64_t val = static_cast<float64_t>( iVal );
+        const float64_t lowest =
+            static_cast<float64_t>( std::numeric_limits<TO>::min() );
+        const float64_t highest =
+            static_cast<float64_t>( std::numeric_limits<TO>::max() );
+
+        return val != val ? TO( 0 ) :
+            val <= lowest ? std::numeric_limits<TO>::min() :
+            val >= highest ? std::numeric_limits<TO>::max() :
+            static_cast<TO>( val );
+    }
+};
+
+//-*****************************************************************************
+// A plain loop with no aliasing between iFrom and oTo, which the compiler
+// turns into packed conversions for every pairing of the integer and
+// float types. Halfs go through the half class, which converts from a
+// table.
+template <class FROM, class TO>
+void ConvertValues( const FROM *iFrom, TO *oTo, size_t iNumValues )
+{
+    typedef ConvertValue<FROM, TO,
+        std::numeric_limits<TO>::is_integer &&
+        !std::numeric_limits<FROM>::is_integer> Converter;
+
+    for ( size_t i = 0; i < iNumValues; ++i )
+    {
+        oTo[i] = Converter::apply( iFrom[i] );
+    }
+}
+
+//-*****************************************************************************
+template <class FROM>
+void ConvertFrom( const FROM *iFrom, PlainOldDataType iPod, void *oTo,
+                  size_t iNumValues )
+{
+    switch ( iPod )
+    {
+    case kUint8POD:
+        ConvertValues( iFrom, static_cast<uint8_t *>( oTo ), iNumValues );
+        break;
+    case kInt8POD:
+        ConvertValues( iFrom, static_cast<int8_t *>( oTo ), iNumValues );
+        break;
+    case kUint16POD:
+        ConvertValues( iFrom, static_cast<uint16_t *>( oTo ), iNumValues );
+        break;
+    case kInt16POD:
+        ConvertValues( iFrom, static_cast<int16_t *>( oTo ), iNumValues );
+        break;
+    case kUint32POD:
+        ConvertValues( iFrom, static_cast<uint32_t *>( oTo ), iNumValues );
+        break;
+    case kInt32POD:
+        ConvertValues( iFrom, static_cast<int32_t *>( oTo ), iNumValues );
+        break;
+    case kUint64POD:
+        ConvertValues( iFrom, static_cast<uint64_t *>( oTo ), iNumValues );
+        break;
+    case kInt64POD:
+        ConvertValues( iFrom, static_cast<int64_t *>( oTo ), iNumValues );
+        break;
+    case kFloat16POD:
+        ConvertValues( iFrom, static_cast<float16_t *>( oTo ), iNumValues );
+        break;
+    case kFloat32POD:
+        ConvertValues( iFrom, static_cast<float32_t *>( oTo ), iNumValues );
+        break;
+    case kFloat64POD:
+        ConvertValues( iFrom, static_cast<float64_t *>( oTo ), iNumValues );
+        break;
+    default:
+        ABCA_THROW( "Can't convert to: " << PODName( iPod ) ); break;
+    }
+}
+
+//-*****************************************************************************
+bool IsNumericPOD( PlainOldDataType iPod )
+{
+    return iPod >= kUint8POD && iPod <= kFloat64POD;
+}
+
+} // End anonymous namespace
+
 //-*****************************************************************************
 ArraySample::Key ArraySample::getKey() const
 {
@@ -182,6 +288,86 @@ ArraySamplePtr AllocateArraySample( const DataType &iDtype,
     }
 }
 
+//-*****************************************************************************
+bool CanConvertPOD( PlainOldDataType iFrom, PlainOldDataType iTo )
+{
+    return IsNumericPOD( iFrom ) && IsNumericPOD( iTo );
+}
+
+//-*****************************************************************************
+ArraySamplePtr ConvertArraySample( const ArraySample &iSample,
+                                   PlainOldDataType iPod )
+{
+    const DataType &dataType = iSample.getDataType();
+    ABCA_ASSERT( CanConvertPOD( dataType.getPod(), iPod ),
+                 "Can't convert " << dataType << " to "
+                 << PODName( iPod ) );
+
+    ArraySamplePtr ret = AllocateArraySample(
+        DataType( iPod, dataType.getExtent() ), iSample.getDimensions() );
+
+    size_t numValues = iSample.size() * dataType.getExtent();
+    if ( numValues == 0 )
+    {
+        return ret;
+    }
+
+    const void *from = iSample.getData();
+    void *to = const_cast<void *>( ret->getData() );
+
+    switch ( dataType.getPod() )
+    {
+    case kUint8POD:
+        ConvertFrom( static_cast<const uint8_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kInt8POD:
+        ConvertFrom( static_cast<const int8_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kUint16POD:
+        ConvertFrom( static_cast<const uint16_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kInt16POD:
+        ConvertFrom( static_cast<const int16_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kUint32POD:
+        ConvertFrom( static_cast<const uint32_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kInt32POD:
+        ConvertFrom( static_cast<const int32_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kUint64POD:
+        ConvertFrom( static_cast<const uint64_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kInt64POD:
+        ConvertFrom( static_cast<const int64_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kFloat16POD:
+        ConvertFrom( static_cast<const float16_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kFloat32POD:
+        ConvertFrom( static_cast<const float32_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    case kFloat64POD:
+        ConvertFrom( static_cast<const float64_t *>( from ), iPod, to,
+                     numValues );
+        break;
+    default:
+        break;
+    }
+
+    return ret;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
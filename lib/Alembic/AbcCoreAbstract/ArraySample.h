@@ -147,6 +147,22 @@ typedef boost::shared_ptr<ArraySample> ArraySamplePtr;
 ArraySamplePtr AllocateArraySample( const DataType &iDtype,
                                     const Dimensions &iDims );
 
+//-*****************************************************************************
+//! Whether ConvertArraySample can turn values of iFrom into values of iTo.
+//! Any of the integer and floating point PODs converts to any other.
+//! Booleans and strings don't convert at all.
+bool CanConvertPOD( PlainOldDataType iFrom, PlainOldDataType iTo );
+
+//! Returns a newly allocated sample holding iSample's values converted
+//! to iPod, with the same extent and dimensions. Each value is converted
+//! as by static_cast, except that floating point values going to an
+//! integer POD are clamped to its range, and NaNs become 0. Integers
+//! that don't fit in a narrower integer POD wrap around, and floats that
+//! don't fit in a narrower float POD become infinite.
+//! It will throw if the conversion isn't one CanConvertPOD allows.
+ArraySamplePtr ConvertArraySample( const ArraySample &iSample,
+                                   PlainOldDataType iPod );
+
 //-*****************************************************************************
 //-*****************************************************************************
 //-*****************************************************************************
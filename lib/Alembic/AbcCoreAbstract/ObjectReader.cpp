@@ -53,6 +53,25 @@ ObjectReaderPtr ObjectReader::getChild( size_t i )
     return getChild( header.getName() );
 }
 
+//-*****************************************************************************
+bool ObjectReader::isInstanceDescendant()
+{
+    if ( isInstanceRoot() )
+    {
+        return true;
+    }
+
+    ObjectReaderPtr parent = getParent();
+    return parent && parent->isInstanceDescendant();
+}
+
+//-*****************************************************************************
+bool ObjectReader::isChildInstance( size_t i )
+{
+    const ObjectHeader &header = getChildHeader( i );
+    return isChildInstance( header.getName() );
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
@@ -150,6 +150,31 @@ public:
     //! the various named "get" functions here.
     ObjectReaderPtr getChild( size_t i );
 
+    //-*************************************************************************
+    // INSTANCES
+    //-*************************************************************************
+
+    //! Whether this object was added with ObjectWriter::addChildInstance.
+    //! If so, its properties and children are those of the object it is
+    //! an instance of, and reading them reads that object's samples.
+    virtual bool isInstanceRoot() = 0;
+
+    //! Whether this object, or one of its ancestors, is an instance root.
+    //! This walks up the parents.
+    bool isInstanceDescendant();
+
+    //! The full name of the object this is an instance of, or an empty
+    //! string if it isn't an instance root.
+    virtual std::string getInstanceSourcePath() = 0;
+
+    //! Whether the child named iName is an instance root, without having
+    //! to get the child.
+    virtual bool isChildInstance( const std::string &iName ) = 0;
+
+    //! Whether the child at index i is an instance root.
+    //! It is an error to call with out-of-range indices.
+    bool isChildInstance( size_t i );
+
     //-*************************************************************************
     // YUP
     //-*************************************************************************
@@ -174,6 +174,16 @@ public:
     //! be thrown, as this is a programming error.
     virtual ObjectWriterPtr createChild( const ObjectHeader &iHeader ) = 0;
 
+    //! Adds iTarget, an object that was already created in this archive,
+    //! as a child named iName. The child is iTarget itself, properties,
+    //! children and all, so nothing is written for it but the reference.
+    //! Readers can tell it apart with ObjectReader::isInstanceRoot.
+    //! iTarget can't be this object or one of its ancestors, and the
+    //! child can't be written to; getChild( iName ) returns an empty
+    //! pointer for it.
+    virtual void addChildInstance( ObjectWriterPtr iTarget,
+                                   const std::string &iName ) = 0;
+
     //! Returns shared pointer to myself.
     //! Sometimes this may be a spoofed ptr.
     virtual ObjectWriterPtr asObjectPtr() = 0;
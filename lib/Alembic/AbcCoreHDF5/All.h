@@ -38,6 +38,11 @@
 #define _Alembic_AbcCoreHDF5_All_h_
 
 #include <Alembic/AbcCoreHDF5/ReadWrite.h>
+#include <Alembic/AbcCoreHDF5/DeltaEncoding.h>
+#include <Alembic/AbcCoreHDF5/HalfStorage.h>
+#include <Alembic/AbcCoreHDF5/Quantization.h>
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
+#include <Alembic/AbcCoreHDF5/Repack.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
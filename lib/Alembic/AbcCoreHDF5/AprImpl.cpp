@@ -35,6 +35,12 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreHDF5/AprImpl.h>
+#include <Alembic/AbcCoreHDF5/DeltaCodec.h>
+#include <Alembic/AbcCoreHDF5/DeltaEncoding.h>
+#include <Alembic/AbcCoreHDF5/HalfCodec.h>
+#include <Alembic/AbcCoreHDF5/HalfStorage.h>
+#include <Alembic/AbcCoreHDF5/Quantization.h>
+#include <Alembic/AbcCoreHDF5/QuantizeCodec.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -51,6 +57,10 @@ AprImpl::AprImpl( AbcA::CompoundPropertyReaderPtr iParent,
   : SimplePrImpl<AbcA::ArrayPropertyReader, AprImpl, AbcA::ArraySamplePtr&>
     ( iParent, iParentGroup, iHeader, iNumSamples, iFirstChangedIndex,
       iLastChangedIndex )
+  , m_isDeltaEncoded( false )
+  , m_deltaIndex( -1 )
+  , m_isQuantized( false )
+  , m_isHalfStored( false )
 {
     if ( m_header->getPropertyType() != AbcA::kArrayProperty )
     {
@@ -59,6 +69,17 @@ AprImpl::AprImpl( AbcA::CompoundPropertyReaderPtr iParent,
     }
 
     m_isScalarLike = iIsScalarLike;
+
+    uint32_t keyInterval = 0;
+    float64_t tolerance = 0.0;
+    m_isDeltaEncoded = IsDeltaEncodable( m_header->getDataType() ) &&
+        GetDeltaEncoding( m_header->getMetaData(), keyInterval, tolerance );
+
+    m_isQuantized = IsDeltaEncodable( m_header->getDataType() ) &&
+        GetQuantization( m_header->getMetaData(), tolerance );
+
+    m_isHalfStored = m_header->getDataType().getPod() == kFloat32POD &&
+        GetHalfStorage( m_header->getMetaData() );
 }
 
 //-*****************************************************************************
@@ -117,6 +138,91 @@ void AprImpl::getDimensions( index_t iSampleIndex, Dimensions & oDim )
     }
 }
 
+//-*****************************************************************************
+void AprImpl::getSamples( index_t iFirstIndex,
+                          index_t iLastIndex,
+                          std::vector<AbcA::ArraySamplePtr> &oSamples )
+{
+    oSamples.clear();
+
+    if ( iLastIndex < iFirstIndex )
+    {
+        return;
+    }
+
+    ABCA_ASSERT( iFirstIndex >= 0 && iLastIndex < m_numSamples,
+                 "Invalid sample range: " << iFirstIndex << " to "
+                 << iLastIndex << ", should be between 0 and "
+                 << m_numSamples-1 );
+
+    oSamples.reserve( iLastIndex - iFirstIndex + 1 );
+
+    // Repeated head and tail samples are only stored once, so every
+    // index that maps onto the same stored sample shares one read.
+    index_t lastStored = -1;
+    AbcA::ArraySamplePtr sample;
+    for ( index_t i = iFirstIndex; i <= iLastIndex; ++i )
+    {
+        index_t stored = verifySampleIndex( i );
+        if ( stored != lastStored )
+        {
+            getSample( stored, sample );
+            lastStored = stored;
+        }
+        oSamples.push_back( sample );
+    }
+}
+
+//-*****************************************************************************
+void AprImpl::getSampleAs( index_t iSampleIndex,
+                           PlainOldDataType iPod,
+                           AbcA::ArraySamplePtr &oSample )
+{
+    PlainOldDataType pod = m_header->getDataType().getPod();
+    if ( iPod == pod )
+    {
+        getSample( iSampleIndex, oSample );
+        return;
+    }
+
+    ABCA_ASSERT( AbcA::CanConvertPOD( pod, iPod ),
+                 "Can't read " << m_header->getName() << " of type "
+                 << m_header->getDataType() << " as " << PODName( iPod ) );
+
+    StatsScope scope( m_stats.get(), m_objectStats.get() );
+
+    AbcA::ReadArraySampleCachePtr cachePtr =
+        this->getObject()->getArchive()->getReadArraySampleCachePtr();
+
+    // The converted sample is cached next to the stored one, under the
+    // same digest but its own readPOD.
+    AbcA::ArraySampleKey key;
+    bool keyed = cachePtr && getKey( iSampleIndex, key );
+    if ( keyed )
+    {
+        key.readPOD = iPod;
+        AbcA::ReadArraySampleID found = cachePtr->find( key );
+        CountCacheLookup( found );
+        if ( found )
+        {
+            oSample = found.getSample();
+            return;
+        }
+    }
+
+    AbcA::ArraySamplePtr stored;
+    getSample( iSampleIndex, stored );
+    {
+        StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+        oSample = AbcA::ConvertArraySample( *stored, iPod );
+    }
+
+    if ( keyed )
+    {
+        oSample = cachePtr->store( key, oSample ).getSample();
+    }
+}
+
 //-*****************************************************************************
 void AprImpl::readSample( hid_t iGroup,
                           const std::string &iSampleName,
@@ -128,13 +234,121 @@ void AprImpl::readSample( hid_t iGroup,
     // Check index integrity.
     assert( iSampleIndex >= 0 && iSampleIndex <= m_lastChangedIndex );
 
+    if ( m_isDeltaEncoded && iSampleIndex > 0 &&
+         IsDeltaSample( iGroup, iSampleName ) )
+    {
+        oSamplePtr = readDeltaSample( iSampleIndex );
+        return;
+    }
+
     // Read the array sample, possibly from the cache.
+    oSamplePtr = readArray( iGroup, iSampleName );
+
+    if ( m_isDeltaEncoded )
+    {
+        setDeltaSample( iSampleIndex, oSamplePtr );
+    }
+}
+
+//-*****************************************************************************
+void AprImpl::setDeltaSample( index_t iSampleIndex,
+                              AbcA::ArraySamplePtr iSample )
+{
+    boost::mutex::scoped_lock lock( m_deltaMutex );
+    m_deltaIndex = iSampleIndex;
+    m_deltaSample = iSample;
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr AprImpl::readDeltaSample( index_t iSampleIndex )
+{
+    // Delta samples are never sample 0, so the smpi group is open.
+    assert( m_samplesIGroup >= 0 );
+
+    const std::string &myName = m_header->getName();
+    const AbcA::DataType &dataType = m_header->getDataType();
+
+    // Walk back until we reach a sample we already have or a keyframe,
+    // remembering the deltas we pass.
+    index_t lastIndex;
+    AbcA::ArraySamplePtr lastSample;
+    {
+        boost::mutex::scoped_lock lock( m_deltaMutex );
+        lastIndex = m_deltaIndex;
+        lastSample = m_deltaSample;
+    }
+
+    std::vector<index_t> deltas;
+    AbcA::ArraySamplePtr sample;
+    index_t index = iSampleIndex;
+    while ( !sample )
+    {
+        if ( index == lastIndex && lastSample )
+        {
+            sample = lastSample;
+            break;
+        }
+
+        std::string sampleName = getSampleName( myName, index );
+        hid_t group = index == 0 ? m_parentGroup : m_samplesIGroup;
+
+        if ( index == 0 || !IsDeltaSample( group, sampleName ) )
+        {
+            sample = readArray( group, sampleName );
+            break;
+        }
+
+        deltas.push_back( index );
+
+        // samples before the first change are stored as sample 0
+        index = verifySampleIndex( index - 1 );
+    }
+
+    for ( std::vector<index_t>::reverse_iterator it = deltas.rbegin();
+          it != deltas.rend(); ++it )
+    {
+        sample = ReadDeltaSample( m_samplesIGroup,
+                                  getSampleName( myName, *it ),
+                                  dataType, sample );
+    }
+
+    setDeltaSample( iSampleIndex, sample );
+
+    return sample;
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr AprImpl::readArray( hid_t iGroup,
+                                         const std::string &iSampleName )
+{
     const AbcA::DataType &dataType = m_header->getDataType();
     AbcA::ReadArraySampleCachePtr cachePtr =
         this->getObject()->getArchive()->getReadArraySampleCachePtr();
-    oSamplePtr = ReadArray( cachePtr, iGroup, iSampleName, dataType,
-                            m_fileDataType,
-                            m_nativeDataType );
+
+    // Samples that couldn't be quantized were written as they were.
+    if ( m_isQuantized )
+    {
+        AbcA::ArraySamplePtr sample =
+            ReadQuantizedArray( cachePtr, iGroup, iSampleName, dataType );
+        if ( sample )
+        {
+            return sample;
+        }
+    }
+
+    // Samples too large for halfs were written as float32.
+    if ( m_isHalfStored )
+    {
+        AbcA::ArraySamplePtr sample =
+            ReadHalfArray( cachePtr, iGroup, iSampleName, dataType );
+        if ( sample )
+        {
+            return sample;
+        }
+    }
+
+    return ReadArray( cachePtr, iGroup, iSampleName, dataType,
+                      m_fileDataType, m_nativeDataType );
 }
 
 //-*****************************************************************************
@@ -40,6 +40,8 @@
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/SimplePrImpl.h>
 
+#include <boost/thread/mutex.hpp>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
@@ -60,6 +62,14 @@ public:
     virtual AbcA::ArrayPropertyReaderPtr asArrayPtr();
     virtual bool isScalarLike();
     virtual void getDimensions( index_t iSampleIndex, Dimensions & oDim );
+
+    virtual void getSamples( index_t iFirstIndex,
+                             index_t iLastIndex,
+                             std::vector<AbcA::ArraySamplePtr> &oSamples );
+
+    virtual void getSampleAs( index_t iSampleIndex,
+                              PlainOldDataType iPod,
+                              AbcA::ArraySamplePtr &oSample );
 protected:
     friend class SimplePrImpl<AbcA::ArrayPropertyReader, AprImpl,
                               AbcA::ArraySamplePtr&>;
@@ -79,7 +89,33 @@ protected:
                   AbcA::ArraySampleKey & oSamplePtr );
 
 private:
+    // Rebuilds a delta encoded sample from the last sample rebuilt or the
+    // nearest keyframe before it, whichever is closer.
+    AbcA::ArraySamplePtr readDeltaSample( index_t iSampleIndex );
+
+    // Reads a whole stored sample, quantized, half stored or not, possibly
+    // from the cache.
+    AbcA::ArraySamplePtr readArray( hid_t iGroup,
+                                    const std::string &iSampleName );
+
     bool m_isScalarLike;
+
+    // Remembers the last sample rebuilt.
+    void setDeltaSample( index_t iSampleIndex,
+                         AbcA::ArraySamplePtr iSample );
+
+    // Delta encoded properties remember the last sample they rebuilt, so
+    // that reading forward only applies one delta per sample. Readers may
+    // be shared between threads, so the pair is only touched under
+    // m_deltaMutex.
+    bool m_isDeltaEncoded;
+    boost::mutex m_deltaMutex;
+    index_t m_deltaIndex;
+    AbcA::ArraySamplePtr m_deltaSample;
+
+    bool m_isQuantized;
+
+    bool m_isHalfStored;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
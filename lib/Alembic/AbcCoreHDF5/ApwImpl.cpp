@@ -37,11 +37,69 @@
 #include <Alembic/AbcCoreHDF5/ApwImpl.h>
 #include <Alembic/AbcCoreHDF5/WriteUtil.h>
 #include <Alembic/AbcCoreHDF5/StringWriteUtil.h>
+#include <Alembic/AbcCoreHDF5/DeltaEncoding.h>
+#include <Alembic/AbcCoreHDF5/HalfStorage.h>
+#include <Alembic/AbcCoreHDF5/HalfCodec.h>
+#include <Alembic/AbcCoreHDF5/Quantization.h>
+#include <Alembic/AbcCoreHDF5/QuantizeCodec.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// Float array properties pick up delta encoding from the archive's MetaData
+// unless they set their own. It is recorded on the property either way,
+// which is what tells readers to look for deltas.
+static AbcA::MetaData
+DeltaMetaData( AbcA::CompoundPropertyWriterPtr iParent,
+               const AbcA::MetaData & iMetaData,
+               const AbcA::DataType & iDataType )
+{
+    uint32_t keyInterval = 0;
+    float64_t tolerance = 0.0;
+    if ( !iParent || !IsDeltaEncodable( iDataType ) ||
+         GetDeltaEncoding( iMetaData, keyInterval, tolerance ) ||
+         !GetDeltaEncoding( iParent->getObject()->getArchive()->getMetaData(),
+                            keyInterval, tolerance ) )
+    {
+        return iMetaData;
+    }
+
+    AbcA::MetaData md( iMetaData );
+    SetDeltaEncoding( md, keyInterval, tolerance );
+    return md;
+}
+
+//-*****************************************************************************
+// Half storage set on the archive's MetaData only reaches the geom params
+// that are normals, colors or uvs, which is recorded on the property the
+// same way as delta encoding.
+static AbcA::MetaData
+HalfMetaData( AbcA::CompoundPropertyWriterPtr iParent,
+              const AbcA::MetaData & iMetaData,
+              const AbcA::DataType & iDataType )
+{
+    if ( !iParent || iDataType.getPod() != kFloat32POD ||
+         GetHalfStorage( iMetaData ) ||
+         iMetaData.get( "isGeomParam" ) != "true" ||
+         !GetHalfStorage( iParent->getObject()->getArchive()->getMetaData() ) )
+    {
+        return iMetaData;
+    }
+
+    std::string interp = iMetaData.get( "interpretation" );
+    if ( interp == "normal" || interp == "rgb" || interp == "rgba" ||
+         ( interp == "vector" && iDataType.getExtent() == 2 ) )
+    {
+        AbcA::MetaData md( iMetaData );
+        SetHalfStorage( md );
+        return md;
+    }
+
+    return iMetaData;
+}
+
 //-*****************************************************************************
 ApwImpl::ApwImpl( AbcA::CompoundPropertyWriterPtr iParent,
                   hid_t iParentGroup,
@@ -55,7 +113,11 @@ ApwImpl::ApwImpl( AbcA::CompoundPropertyWriterPtr iParent,
                  AbcA::ArraySample::Key>( iParent,
                                           iParentGroup,
                                           iName,
-                                          iMetaData,
+                                          HalfMetaData( iParent,
+                                              DeltaMetaData( iParent,
+                                                             iMetaData,
+                                                             iDataType ),
+                                              iDataType ),
                                           iDataType,
                                           iTimeSamplingIndex,
                                           AbcA::kArrayProperty )
@@ -68,14 +130,43 @@ ApwImpl::ApwImpl( AbcA::CompoundPropertyWriterPtr iParent,
 
     m_isScalarLike = true;
 
+    uint32_t keyInterval = 0;
+    float64_t tolerance = 0.0;
+    if ( IsDeltaEncodable( m_header->getDataType() ) &&
+         GetDeltaEncoding( m_header->getMetaData(), keyInterval, tolerance ) )
+    {
+        m_deltaWriter.reset( new DeltaWriter( keyInterval, tolerance ) );
+    }
+
+    m_quantizeTolerance = 0.0;
+    if ( IsDeltaEncodable( m_header->getDataType() ) )
+    {
+        GetQuantization( m_header->getMetaData(), m_quantizeTolerance );
+    }
+
+    m_isHalfStored = m_header->getDataType().getPod() == kFloat32POD &&
+        GetHalfStorage( m_header->getMetaData() );
+
     // The WrittenArraySampleID is invalid by default.
     assert( !m_previousWrittenArraySampleID );
+
+    if ( m_isReopened )
+    {
+        m_isScalarLike = m_wasScalarLike;
+
+        if ( m_nextSampleIndex > 0 )
+        {
+            restoreSamples();
+        }
+    }
 }
 
 
 //-*****************************************************************************
 ApwImpl::~ApwImpl()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     WritePropertyInfo( m_parentGroup, m_header->getName(),
         m_header->getPropertyType(), m_header->getDataType(), m_isScalarLike,
         m_timeSamplingIndex, m_nextSampleIndex, m_firstChangedIndex,
@@ -89,6 +180,103 @@ AbcA::ArrayPropertyWriterPtr ApwImpl::asArrayPtr()
     return shared_from_this();
 }
 
+//-*****************************************************************************
+// The last sample a reopened property wrote is what the next one is
+// compared against and repeats. Its plainly stored samples also go back
+// into the archive's map, so that later samples can link to them rather
+// than being written again. The codecs key their datasets by what a
+// reader rebuilds, and string datasets don't record how many bytes their
+// keys were made from, so those only restore the last sample.
+void ApwImpl::restoreSamples()
+{
+    const std::string &myName = m_header->getName();
+    PlainOldDataType pod = m_header->getDataType().getPod();
+
+    bool isPlain = !m_deltaWriter && m_quantizeTolerance == 0.0 &&
+        !m_isHalfStored && pod != kStringPOD && pod != kWstringPOD;
+
+    WrittenArraySampleMap &sampleMap =
+        GetWrittenArraySampleMap( this->getObject()->getArchive() );
+
+    for ( index_t smpI = isPlain ? 0 : m_lastChangedIndex;
+          smpI <= m_lastChangedIndex; ++smpI )
+    {
+        // Samples before the first change repeat sample 0, and have no
+        // datasets of their own.
+        if ( smpI > 0 && smpI < m_firstChangedIndex )
+        {
+            continue;
+        }
+
+        hid_t group = smpI == 0 ? m_parentGroup : getSampleIGroup();
+        const std::string sampleName = getSampleName( myName, smpI );
+
+        hid_t dsetId = H5Dopen( group, sampleName.c_str(), H5P_DEFAULT );
+        ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << sampleName );
+        DsetCloser dsetCloser( dsetId );
+
+        hid_t dspaceId = H5Dget_space( dsetId );
+        ABCA_ASSERT( dspaceId >= 0, "Could not get dataspace for dataSet: "
+                     << sampleName );
+        DspaceCloser dspaceCloser( dspaceId );
+
+        AbcA::ArraySample::Key key;
+        key.origPOD = pod;
+        key.readPOD = pod;
+        key.numBytes = H5Sget_simple_extent_npoints( dspaceId ) *
+            PODNumBytes( pod );
+
+        bool foundKey = ReadKey( dsetId, "key", key );
+        ABCA_ASSERT( foundKey, "Missing key on dataset: " << sampleName );
+
+        m_previousWrittenArraySampleID.reset(
+            new WrittenArraySampleID( key, dsetId ) );
+
+        if ( isPlain )
+        {
+            sampleMap.store( m_previousWrittenArraySampleID );
+        }
+
+        if ( m_deltaWriter && smpI == m_lastChangedIndex )
+        {
+            m_deltaWriter->reopened( IsDeltaSample( group, sampleName ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+// Compressing is most of the cost of writing a big sample, so it's done
+// here, where other objects of the archive can be doing the same. Only
+// plainly stored samples are, since the codecs write something else.
+void ApwImpl::prepareSample( const AbcA::ArraySample &iSamp,
+                             const AbcA::ArraySample::Key &iKey )
+{
+    m_compressed.reset();
+
+    if ( m_deltaWriter || m_quantizeTolerance > 0.0 || m_isHalfStored )
+    {
+        return;
+    }
+
+    AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+    int level = awp->getCompressionHint();
+    if ( level < 0 )
+    {
+        return;
+    }
+
+    // Samples that were written before are linked to instead.
+    {
+        boost::recursive_mutex::scoped_lock l( m_writeMutex );
+        if ( GetWrittenArraySampleMap( awp ).find( iKey ) )
+        {
+            return;
+        }
+    }
+
+    m_compressed = CompressArray( iSamp, iKey, level );
+}
+
 //-*****************************************************************************
 void ApwImpl::writeSample( hid_t iGroup,
                            const std::string &iSampleName,
@@ -110,15 +298,70 @@ void ApwImpl::writeSample( hid_t iGroup,
         m_isScalarLike = false;
     }
 
+    // Sample 0 is always a keyframe.
+    if ( m_deltaWriter && iSampleIndex > 0 )
+    {
+        WrittenArraySampleIDPtr deltaID =
+            m_deltaWriter->writeDelta( iGroup, iSampleName, iSampleIndex,
+                                       iSamp, iKey,
+                                       awp->getCompressionHint() );
+        if ( deltaID )
+        {
+            m_previousWrittenArraySampleID = deltaID;
+            RecordFrameExtent( awp, iGroup, iSampleName,
+                               m_timeSamplingIndex, iSampleIndex );
+            return;
+        }
+    }
+
+    // Quantized samples come back as rebuilt, which is what any deltas
+    // after them need to be taken against.
+    AbcA::ArraySamplePtr rebuilt;
+    if ( m_quantizeTolerance > 0.0 )
+    {
+        m_previousWrittenArraySampleID =
+            WriteQuantizedArray( GetWrittenArraySampleMap( awp ),
+                                 iGroup, iSampleName, iSamp, iKey,
+                                 m_quantizeTolerance,
+                                 awp->getCompressionHint(), rebuilt );
+    }
+
+    // Half stored samples come back as rebuilt too.
+    if ( !rebuilt && m_isHalfStored )
+    {
+        WrittenArraySampleIDPtr halfID =
+            WriteHalfArray( GetWrittenArraySampleMap( awp ),
+                            iGroup, iSampleName, iSamp, iKey,
+                            awp->getCompressionHint(), rebuilt );
+        if ( halfID )
+        {
+            m_previousWrittenArraySampleID = halfID;
+        }
+    }
+
     // Write the sample.
     // This distinguishes between string, wstring, and regular arrays.
-    m_previousWrittenArraySampleID =
-        WriteArray( GetWrittenArraySampleMap( awp ),
-                    iGroup, iSampleName,
-                    iSamp, iKey,
-                    m_fileDataType,
-                    m_nativeDataType,
-                    awp->getCompressionHint() );
+    if ( !rebuilt )
+    {
+        m_previousWrittenArraySampleID =
+            WriteArray( GetWrittenArraySampleMap( awp ),
+                        iGroup, iSampleName,
+                        iSamp, iKey,
+                        m_fileDataType,
+                        m_nativeDataType,
+                        awp->getCompressionHint(),
+                        m_compressed );
+    }
+
+    m_compressed.reset();
+
+    if ( m_deltaWriter )
+    {
+        m_deltaWriter->keyWritten( iSampleIndex, rebuilt ? *rebuilt : iSamp );
+    }
+
+    RecordFrameExtent( awp, iGroup, iSampleName,
+                       m_timeSamplingIndex, iSampleIndex );
 }
 
 } // End namespace ALEMBIC_VERSION_NS
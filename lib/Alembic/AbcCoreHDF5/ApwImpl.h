@@ -40,6 +40,7 @@
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/SimplePwImpl.h>
 #include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
+#include <Alembic/AbcCoreHDF5/DeltaCodec.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -65,7 +66,10 @@ protected:
              uint32_t iTimeSamplingIndex );
 
     virtual AbcA::ArrayPropertyWriterPtr asArrayPtr();
-    
+
+    // Picks up the samples a reopened property already wrote.
+    void restoreSamples();
+
 public:
     virtual ~ApwImpl();
 
@@ -73,6 +77,7 @@ public:
     static AbcA::ArraySample::Key
     computeSampleKey( const AbcA::ArraySample &iSamp )
     {
+        StatsTimer timer( &AbcA::ArchiveStats::hashSeconds );
         return iSamp.getKey();
     }
 
@@ -84,6 +89,10 @@ public:
                  iKey == m_previousWrittenArraySampleID->getKey() );
     }
 
+    //-*************************************************************************
+    void prepareSample( const AbcA::ArraySample &iSamp,
+                        const AbcA::ArraySample::Key &iKey );
+
     //-*************************************************************************
     void copyPreviousSample( hid_t iGroup,
                              const std::string &iSampleName,
@@ -92,6 +101,11 @@ public:
         // Copy the sample.
         CopyWrittenArray( iGroup, iSampleName,
                           m_previousWrittenArraySampleID );
+
+        if ( m_deltaWriter )
+        {
+            m_deltaWriter->writeHeld( iGroup, iSampleName );
+        }
     }
 
     //-*************************************************************************
@@ -108,6 +122,18 @@ protected:
 private:
     bool m_isScalarLike;
 
+    // Only set when the property is delta encoded.
+    DeltaWriterPtr m_deltaWriter;
+
+    // Greater than 0 when float samples are quantized.
+    float64_t m_quantizeTolerance;
+
+    // Whether float32 samples are written as halfs.
+    bool m_isHalfStored;
+
+    // The sample being written, deflated by prepareSample when it could be.
+    CompressedArrayPtr m_compressed;
+
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -45,19 +45,56 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 ArImpl::ArImpl( const std::string &iFileName,
-                AbcA::ReadArraySampleCachePtr iCache )
+                AbcA::ReadArraySampleCachePtr iCache,
+                const FileAccessProfile &iProfile )
   : m_fileName( iFileName )
   , m_file( -1 )
   , m_readArraySampleCache( iCache )
+  , m_stats( new StatsCollector() )
 {
     // OPEN THE FILE!
     htri_t exi = H5Fis_hdf5( m_fileName.c_str() );
     ABCA_ASSERT( exi == 1, "Nonexistent File: " << m_fileName );
 
-    m_file = H5Fopen( m_fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+    hid_t faid = FileAccessPlist( iProfile, false );
+    PlistCloser faidCloser( faid );
+
+    m_file = H5Fopen( m_fileName.c_str(), H5F_ACC_RDONLY, faid );
     ABCA_ASSERT( m_file >= 0,
                  "Could not open file: " << m_fileName );
 
+    init();
+}
+
+//-*****************************************************************************
+ArImpl::ArImpl( const std::string &iName,
+                const void *iData,
+                size_t iSize,
+                ArchiveImagePtr iImage,
+                AbcA::ReadArraySampleCachePtr iCache )
+  : m_fileName( iName )
+  , m_file( -1 )
+  , m_image( iImage )
+  , m_readArraySampleCache( iCache )
+  , m_stats( new StatsCollector() )
+{
+    ABCA_ASSERT( iData != NULL && iSize > 0,
+                 "Empty archive image: " << m_fileName );
+
+    // The image is opened read only, so HDF5 never writes into it, and
+    // it's owned by the caller (or m_image) so HDF5 mustn't free it.
+    m_file = H5LTopen_file_image( const_cast<void *>( iData ), iSize,
+                                  H5LT_FILE_IMAGE_DONT_COPY |
+                                  H5LT_FILE_IMAGE_DONT_RELEASE );
+    ABCA_ASSERT( m_file >= 0,
+                 "Could not open archive image: " << m_fileName );
+
+    init();
+}
+
+//-*****************************************************************************
+void ArImpl::init()
+{
     // get the version using HDF5 native calls
     int version = -INT_MAX;
     if (H5Aexists(m_file, "abc_version"))
@@ -119,6 +156,24 @@ AbcA::ArchiveReaderPtr ArImpl::asArchivePtr()
     return shared_from_this();
 }
 
+//-*****************************************************************************
+AbcA::ArchiveStats ArImpl::getStats()
+{
+    return m_stats->getStats();
+}
+
+//-*****************************************************************************
+void ArImpl::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    m_stats->getObjectStats( oStats );
+}
+
+//-*****************************************************************************
+void ArImpl::resetStats()
+{
+    m_stats->reset();
+}
+
 //-*****************************************************************************
 ArImpl::~ArImpl()
 {
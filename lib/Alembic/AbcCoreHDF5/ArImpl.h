@@ -38,6 +38,9 @@
 #define _Alembic_AbcCoreHDF5_ArImpl_h_
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+#include <Alembic/AbcCoreHDF5/ArchiveImage.h>
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -53,10 +56,24 @@ class ArImpl
 {
 private:
     friend struct ReadArchive;
+    friend struct ReadMemoryArchive;
 
     ArImpl( const std::string &iFileName,
+            AbcA::ReadArraySampleCachePtr iCache,
+            const FileAccessProfile &iProfile );
+
+    //! Reads the archive from the iSize bytes at iData, which are not
+    //! copied. iImage, if given, is held on to so that the bytes stay
+    //! valid for as long as this reader does.
+    ArImpl( const std::string &iName,
+            const void *iData,
+            size_t iSize,
+            ArchiveImagePtr iImage,
             AbcA::ReadArraySampleCachePtr iCache );
 
+    //! Everything that happens after m_file has been opened.
+    void init();
+
 public:
     virtual ~ArImpl();
 
@@ -95,10 +112,29 @@ public:
         return m_archiveVersion;
     }
 
+    virtual AbcA::ArchiveStats getStats();
+
+    virtual void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    virtual void resetStats();
+
+    //-*************************************************************************
+    // STATS
+    //-*************************************************************************
+
+    // What the property readers count to.
+    StatsCollectorPtr getStatsCollector() { return m_stats; }
+
+    // Counts to iStats instead, which a sharded archive's shards share.
+    // Only before anything has been read.
+    void setStatsCollector( StatsCollectorPtr iStats ) { m_stats = iStats; }
+
 private:
     std::string m_fileName;
     hid_t m_file;
 
+    ArchiveImagePtr m_image;
+
     TopOrImpl *m_top;
 
     int32_t m_archiveVersion;
@@ -106,6 +142,8 @@ private:
     std::vector <  AbcA::TimeSamplingPtr > m_timeSamples;
 
     AbcA::ReadArraySampleCachePtr m_readArraySampleCache;
+
+    StatsCollectorPtr m_stats;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
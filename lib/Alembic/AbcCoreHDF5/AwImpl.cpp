@@ -37,31 +37,163 @@
 #include <Alembic/AbcCoreHDF5/AwImpl.h>
 #include <Alembic/AbcCoreHDF5/TopOwImpl.h>
 #include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
 #include <Alembic/AbcCoreHDF5/HDF5Util.h>
 
+#include <set>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// File image callbacks for in memory archives.
+// These are plain malloc/realloc/free, except that once the file is closed
+// the buffer is copied into the ArchiveImage before being freed.
+// H5Fget_file_image() can't be used for this since, with the newer
+// superblock versions, images taken while the file is open fail their
+// checksum when read back.
+//-*****************************************************************************
+static void *ImageMalloc( size_t iSize, H5FD_file_image_op_t iOp,
+                          void *iUdata )
+{
+    static_cast<AwImpl::ImageCapture *>( iUdata )->bufferSize = iSize;
+    return malloc( iSize );
+}
+
+//-*****************************************************************************
+static void *ImageMemcpy( void *oDest, const void *iSrc, size_t iSize,
+                          H5FD_file_image_op_t iOp, void *iUdata )
+{
+    return memcpy( oDest, iSrc, iSize );
+}
+
+//-*****************************************************************************
+static void *ImageRealloc( void *iPtr, size_t iSize,
+                           H5FD_file_image_op_t iOp, void *iUdata )
+{
+    static_cast<AwImpl::ImageCapture *>( iUdata )->bufferSize = iSize;
+    return realloc( iPtr, iSize );
+}
+
+//-*****************************************************************************
+static herr_t ImageFree( void *iPtr, H5FD_file_image_op_t iOp,
+                         void *iUdata )
+{
+    AwImpl::ImageCapture *capture =
+        static_cast<AwImpl::ImageCapture *>( iUdata );
+
+    if ( iPtr && iOp == H5FD_FILE_IMAGE_OP_FILE_CLOSE )
+    {
+        size_t size = std::min( capture->imageSize, capture->bufferSize );
+        const Alembic::Util::uint8_t *data =
+            static_cast<const Alembic::Util::uint8_t *>( iPtr );
+        capture->image->assign( data, data + size );
+    }
+
+    free( iPtr );
+    return 0;
+}
+
+//-*****************************************************************************
+// The capture is owned by the AwImpl, which outlives the file, so every
+// property list copy can share it.
+static void *ImageUdataCopy( void *iUdata )
+{
+    return iUdata;
+}
+
+//-*****************************************************************************
+static herr_t ImageUdataFree( void *iUdata )
+{
+    return 0;
+}
+
+//-*****************************************************************************
+// Extents of the same time less than this far apart are merged, reading the
+// bytes between them is cheaper than another seek.
+static const uint64_t kFrameExtentGapBytes = 64 * 1024;
+
+//-*****************************************************************************
+static bool FrameExtentLess( const FrameExtent &iA, const FrameExtent &iB )
+{
+    if ( iA.time != iB.time )
+    {
+        return iA.time < iB.time;
+    }
+
+    return iA.offset < iB.offset;
+}
+
+//-*****************************************************************************
+static void MergeFrameExtents( FrameIndex &ioExtents )
+{
+    std::sort( ioExtents.begin(), ioExtents.end(), FrameExtentLess );
+
+    FrameIndex merged;
+    merged.reserve( ioExtents.size() );
+
+    for ( FrameIndex::const_iterator it = ioExtents.begin();
+          it != ioExtents.end(); ++it )
+    {
+        if ( !merged.empty() && merged.back().time == it->time &&
+             it->offset <= merged.back().offset + merged.back().size +
+             kFrameExtentGapBytes )
+        {
+            FrameExtent &last = merged.back();
+            last.size = std::max( last.offset + last.size,
+                                  it->offset + it->size ) - last.offset;
+        }
+        else
+        {
+            merged.push_back( *it );
+        }
+    }
+
+    ioExtents.swap( merged );
+}
+
 //-*****************************************************************************
 AwImpl::AwImpl( const std::string &iFileName,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                const FileAccessProfile &iProfile,
+                ArchiveImagePtr oImage )
   : m_fileName( iFileName )
   , m_metaData( iMetaData )
   , m_file( -1 )
+  , m_recordFrameIndex( iProfile.recordFrameIndex )
 {
+    m_imageCapture.image = oImage;
 
     // add default time sampling
     AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling() );
     m_timeSamples.push_back(ts);
 
     // OPEN THE FILE!
-    hid_t faid = H5Pcreate( H5P_FILE_ACCESS );
-    if ( faid < 0 )
+    // An in memory archive is a core driver file that never touches
+    // the disk, the name is only used by HDF5 to tell open files apart.
+    FileAccessProfile profile = iProfile;
+    if ( oImage )
     {
-        ABCA_THROW( "Could not create property access for fopen" );
+        profile.useCoreDriver = true;
+        profile.coreDriverBackingStore = false;
+    }
+
+    hid_t faid = FileAccessPlist( profile, true );
+
+    if ( oImage )
+    {
+        H5FD_file_image_callbacks_t callbacks = {
+            ImageMalloc, ImageMemcpy, ImageRealloc, ImageFree,
+            ImageUdataCopy, ImageUdataFree, &m_imageCapture };
+
+        if ( H5Pset_file_image_callbacks( faid, &callbacks ) < 0 )
+        {
+            H5Pclose( faid );
+            ABCA_THROW( "Could not set up in memory archive: "
+                        << m_fileName );
+        }
     }
-    H5Pset_libver_bounds( faid, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST );
 
     m_file = H5Fcreate( m_fileName.c_str(),
                         H5F_ACC_TRUNC, H5P_DEFAULT,
@@ -93,6 +225,63 @@ AwImpl::AwImpl( const std::string &iFileName,
     m_top = new TopOwImpl( *this, m_file, m_metaData );
 }
 
+//-*****************************************************************************
+AwImpl::AwImpl( const std::string &iFileName,
+                const FileAccessProfile &iProfile )
+  : m_fileName( iFileName )
+  , m_file( -1 )
+  , m_recordFrameIndex( iProfile.recordFrameIndex )
+{
+    // OPEN THE FILE!
+    htri_t exi = H5Fis_hdf5( m_fileName.c_str() );
+    ABCA_ASSERT( exi == 1, "Nonexistent File: " << m_fileName );
+
+    hid_t faid = FileAccessPlist( iProfile, true );
+
+    m_file = H5Fopen( m_fileName.c_str(), H5F_ACC_RDWR, faid );
+
+    H5Pclose( faid );
+
+    if ( m_file < 0 )
+    {
+        ABCA_THROW( "Could not open file: " << m_fileName );
+    }
+
+    int version = -INT_MAX;
+    if ( H5Aexists( m_file, "abc_version" ) > 0 )
+    {
+        H5LTget_attribute_int( m_file, ".", "abc_version", &version );
+    }
+
+    if ( version != ALEMBIC_HDF5_FILE_VERSION || !GroupExists( m_file, "ABC" ) )
+    {
+        H5Fclose( m_file );
+        m_file = -1;
+        ABCA_THROW( "Can't append to unsupported file: " << m_fileName );
+    }
+
+    // The TimeSamplings already written keep their indices, and new ones
+    // are numbered after them.
+    ReadTimeSamples( m_file, m_timeSamples );
+
+    // An archive with a frame index keeps one, and new samples are added
+    // to it.
+    if ( ReadFrameIndex( m_file, m_frameExtents ) )
+    {
+        m_recordFrameIndex = true;
+    }
+
+    // The archive's MetaData is the top object's.
+    {
+        hid_t topGroup = H5Gopen2( m_file, "ABC", H5P_DEFAULT );
+        GroupCloser topCloser( topGroup );
+        ReadMetaData( topGroup, ".prop.meta", m_metaData );
+    }
+
+    // The top object reopens the existing group.
+    m_top = new TopOwImpl( *this, m_file, m_metaData );
+}
+
 //-*****************************************************************************
 const std::string &AwImpl::getName() const
 {
@@ -124,6 +313,8 @@ AbcA::ObjectWriterPtr AwImpl::getTop()
 //-*****************************************************************************
 uint32_t AwImpl::addTimeSampling( const AbcA::TimeSampling & iTs )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     index_t numTS = m_timeSamples.size();
     for (index_t i = 0; i < numTS; ++i)
     {
@@ -148,12 +339,83 @@ uint32_t AwImpl::addTimeSampling( const AbcA::TimeSampling & iTs )
 //-*****************************************************************************
 AbcA::TimeSamplingPtr AwImpl::getTimeSampling( uint32_t iIndex )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     ABCA_ASSERT( iIndex < m_timeSamples.size(),
         "Invalid index provided to getTimeSampling." );
 
     return m_timeSamples[iIndex];
 }
 
+//-*****************************************************************************
+uint32_t AwImpl::getNumTimeSamplings()
+{
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
+    return m_timeSamples.size();
+}
+
+//-*****************************************************************************
+static bool IsUnder( const std::string &iName, const std::string &iAncestor )
+{
+    return iName == iAncestor ||
+        boost::starts_with( iName, iAncestor + "/" );
+}
+
+//-*****************************************************************************
+bool AwImpl::instanceReaches( const std::string &iFrom,
+                              const std::string &iName ) const
+{
+    std::vector<std::string> toVisit( 1, iFrom );
+    std::set<std::string> visited;
+    while ( !toVisit.empty() )
+    {
+        std::string from = toVisit.back();
+        toVisit.pop_back();
+        if ( !visited.insert( from ).second )
+        {
+            continue;
+        }
+
+        if ( IsUnder( iName, from ) )
+        {
+            return true;
+        }
+
+        // The hierarchy under from also holds what the instances under
+        // it hold.
+        for ( std::multimap<std::string, std::string>::const_iterator
+                  iter = m_instances.begin(); iter != m_instances.end();
+              ++iter )
+        {
+            if ( IsUnder( iter->first, from ) )
+            {
+                toVisit.push_back( iter->second );
+            }
+        }
+    }
+
+    return false;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveStats AwImpl::getStats()
+{
+    return m_stats.getStats();
+}
+
+//-*****************************************************************************
+void AwImpl::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    m_stats.getObjectStats( oStats );
+}
+
+//-*****************************************************************************
+void AwImpl::resetStats()
+{
+    m_stats.reset();
+}
+
 //-*****************************************************************************
 AwImpl::~AwImpl()
 {
@@ -163,6 +425,12 @@ AwImpl::~AwImpl()
     // empty out the map so any dataset IDs will be freed up
     m_writtenArraySampleMap.m_map.clear();
 
+    if ( m_file >= 0 && m_recordFrameIndex )
+    {
+        MergeFrameExtents( m_frameExtents );
+        WriteFrameIndex( m_file, m_frameExtents );
+    }
+
     if ( m_file >= 0 )
     {
         int dsetCount = H5Fget_obj_count( m_file,
@@ -192,6 +460,16 @@ AwImpl::~AwImpl()
             ABCA_THROW( excStr );
         }
 
+        if ( m_imageCapture.image )
+        {
+            // The core driver buffer grows in increments, this is how
+            // much of it is actually the file.
+            H5Fflush( m_file, H5F_SCOPE_LOCAL );
+            ssize_t imageSize = H5Fget_file_image( m_file, NULL, 0 );
+            m_imageCapture.imageSize = imageSize > 0 ? imageSize : 0;
+        }
+
+        // For in memory archives, this is what fills in the image.
         H5Fclose( m_file );
         m_file = -1;
     }
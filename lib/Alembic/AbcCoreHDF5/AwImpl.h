@@ -38,8 +38,14 @@
 #define _Alembic_AbcCoreHDF5_AwImpl_h_
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+#include <Alembic/AbcCoreHDF5/ArchiveImage.h>
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
 #include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
 #include <Alembic/AbcCoreHDF5/DataTypeRegistry.h>
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
+
+#include <boost/thread/recursive_mutex.hpp>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -54,9 +60,19 @@ class AwImpl : public AbcA::ArchiveWriter
 {
 private:
     friend struct WriteArchive;
+    friend struct WriteMemoryArchive;
+    friend struct AppendArchive;
+
+    //! If oImage is given, the archive is built in memory only and its
+    //! bytes are copied into oImage when the archive is closed.
+    AwImpl( const std::string &iFileName,
+            const AbcA::MetaData &iMetaData,
+            const FileAccessProfile &iProfile,
+            ArchiveImagePtr oImage = ArchiveImagePtr() );
 
+    //! Reopens the archive iFileName to add to it, see AppendArchive.
     AwImpl( const std::string &iFileName,
-            const AbcA::MetaData &iMetaData );
+            const FileAccessProfile &iProfile );
 
 public:
     virtual ~AwImpl();
@@ -75,22 +91,87 @@ public:
     //-*************************************************************************
     // GLOBAL FILE CONTEXT STUFF.
     //-*************************************************************************
+    //! Only to be used with the write mutex locked.
     WrittenArraySampleMap &getWrittenArraySampleMap()
     {
         return m_writtenArraySampleMap;
     }
 
+    //! Different objects of the archive may be written from different
+    //! threads. Everything that touches the file, or state that is shared
+    //! by the whole archive, locks this first. It is recursive because
+    //! writers are created and destroyed from inside one another.
+    boost::recursive_mutex &getWriteMutex() { return m_writeMutex; }
+
     virtual uint32_t addTimeSampling( const AbcA::TimeSampling & iTs );
 
     virtual AbcA::TimeSamplingPtr getTimeSampling( uint32_t iIndex );
 
-    virtual uint32_t getNumTimeSamplings() { return m_timeSamples.size(); }
+    virtual uint32_t getNumTimeSamplings();
+
+    virtual AbcA::ArchiveStats getStats();
+
+    virtual void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    virtual void resetStats();
+
+    //! What the property writers count to.
+    StatsCollector &getStatsCollector() { return m_stats; }
+
+    //-*************************************************************************
+    // INSTANCES
+    //-*************************************************************************
+    //! Records that iParent has a child that is an instance of iTarget,
+    //! both named the way readers name them. Only to be used with the
+    //! write mutex locked.
+    void addInstance( const std::string &iParent,
+                      const std::string &iTarget )
+    {
+        m_instances.insert( std::make_pair( iParent, iTarget ) );
+    }
+
+    //! Whether iName is iFrom, is under it, or is under an instance that
+    //! is somewhere under it, following instances of instances too. Only
+    //! to be used with the write mutex locked.
+    bool instanceReaches( const std::string &iFrom,
+                          const std::string &iName ) const;
+
+    //-*************************************************************************
+    // FRAME INDEX
+    //-*************************************************************************
+    bool isRecordingFrameIndex() const { return m_recordFrameIndex; }
+
+    //! Adds the iSize bytes at iOffset to the samples written for iTime.
+    //! The extents are sorted and merged into the frame index when the
+    //! archive is closed. See RecordFrameExtent in WriteUtil.h. Only to
+    //! be used with the write mutex locked.
+    void addFrameExtent( chrono_t iTime, uint64_t iOffset, uint64_t iSize )
+    {
+        m_frameExtents.push_back( FrameExtent( iTime, iOffset, iSize ) );
+    }
+
+    //-*************************************************************************
+    // IN MEMORY ARCHIVES
+    //-*************************************************************************
+    //! For in memory archives, the core driver's buffer is handed to us
+    //! through HDF5's file image callbacks when the file is closed, and
+    //! copied into image. See AwImpl.cpp.
+    struct ImageCapture
+    {
+        ImageCapture() : bufferSize( 0 ), imageSize( 0 ) {}
+
+        ArchiveImagePtr image;
+        size_t bufferSize;
+        size_t imageSize;
+    };
 
 private:
     std::string m_fileName;
     AbcA::MetaData m_metaData;
     hid_t m_file;
 
+    ImageCapture m_imageCapture;
+
     // This won't create a circular reference because the
     // TopObjectWriter we create is special and doesn't like back up
     // like a normal object writer would.
@@ -99,6 +180,16 @@ private:
     std::vector < AbcA::TimeSamplingPtr > m_timeSamples;
 
     WrittenArraySampleMap m_writtenArraySampleMap;
+
+    bool m_recordFrameIndex;
+    FrameIndex m_frameExtents;
+
+    // Parent to target, for every instance added, see addInstance.
+    std::multimap<std::string, std::string> m_instances;
+
+    boost::recursive_mutex m_writeMutex;
+
+    StatsCollector m_stats;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -46,8 +46,10 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 // With the object as an input.
-BaseCpwImpl::BaseCpwImpl( hid_t iParentGroup )
-  : m_parentGroup( iParentGroup )
+BaseCpwImpl::BaseCpwImpl( boost::recursive_mutex &iWriteMutex,
+                          hid_t iParentGroup )
+  : m_writeMutex( iWriteMutex )
+  , m_parentGroup( iParentGroup )
   , m_group( -1 )
 {
     // Check the validity of all inputs.
@@ -72,6 +74,8 @@ AbcA::ObjectWriterPtr BaseCpwImpl::getObject()
 //-*****************************************************************************
 size_t BaseCpwImpl::getNumProperties()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     return m_propertyHeaders.size();
 }
 
@@ -79,6 +83,8 @@ size_t BaseCpwImpl::getNumProperties()
 const AbcA::PropertyHeader &
 BaseCpwImpl::getPropertyHeader( size_t i )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     if ( i > m_propertyHeaders.size() )
     {
         ABCA_THROW( "Out of range index in " <<
@@ -95,6 +101,8 @@ BaseCpwImpl::getPropertyHeader( size_t i )
 const AbcA::PropertyHeader *
 BaseCpwImpl::getPropertyHeader( const std::string &iName )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     for ( PropertyHeaderPtrs::iterator piter = m_propertyHeaders.begin();
           piter != m_propertyHeaders.end(); ++piter )
     {
@@ -110,6 +118,8 @@ BaseCpwImpl::getPropertyHeader( const std::string &iName )
 AbcA::BasePropertyWriterPtr
 BaseCpwImpl::getProperty( const std::string &iName )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     MadeProperties::iterator fiter = m_madeProperties.find( iName );
     if ( fiter == m_madeProperties.end() )
     {
@@ -132,13 +142,21 @@ hid_t BaseCpwImpl::getGroup()
 
     ABCA_ASSERT( m_parentGroup >= 0, "invalid parent group" );
 
-    // Create the HDF5 group corresponding to this property.
+    // Create the HDF5 group corresponding to this property, or open it
+    // if the archive was reopened to append to it.
     const std::string groupName = getName();
 
-    hid_t copl = CreationOrderPlist();
-    m_group = H5Gcreate2( m_parentGroup, groupName.c_str(),
-                          H5P_DEFAULT, copl, H5P_DEFAULT );
-    H5Pclose( copl );
+    if ( GroupExists( m_parentGroup, groupName ) )
+    {
+        m_group = H5Gopen2( m_parentGroup, groupName.c_str(), H5P_DEFAULT );
+    }
+    else
+    {
+        hid_t copl = CreationOrderPlist();
+        m_group = H5Gcreate2( m_parentGroup, groupName.c_str(),
+                              H5P_DEFAULT, copl, H5P_DEFAULT );
+        H5Pclose( copl );
+    }
 
     ABCA_ASSERT( m_group >= 0,
                  "Could not create compound property group named: "
@@ -154,6 +172,8 @@ BaseCpwImpl::createScalarProperty( const std::string & iName,
         const AbcA::DataType & iDataType,
         uint32_t iTimeSamplingIndex )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     if ( m_madeProperties.count( iName ) )
     {
         ABCA_THROW( "Already have a property named: " << iName );
@@ -179,6 +199,7 @@ BaseCpwImpl::createArrayProperty( const std::string & iName,
         const AbcA::DataType & iDataType,
         uint32_t iTimeSamplingIndex )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
 
     if ( m_madeProperties.count( iName ) )
     {
@@ -203,6 +224,7 @@ AbcA::CompoundPropertyWriterPtr
 BaseCpwImpl::createCompoundProperty( const std::string & iName,
         const AbcA::MetaData & iMetaData )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
 
     if ( m_madeProperties.count( iName ) )
     {
@@ -224,6 +246,8 @@ BaseCpwImpl::createCompoundProperty( const std::string & iName,
 //-*****************************************************************************
 BaseCpwImpl::~BaseCpwImpl()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     if ( m_group >= 0 )
     {
         H5Gclose( m_group );
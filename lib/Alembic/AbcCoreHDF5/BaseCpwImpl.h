@@ -39,6 +39,8 @@
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 
+#include <boost/thread/recursive_mutex.hpp>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
@@ -50,7 +52,7 @@ protected:
     // First constructor is for building the top-level compound property
     // of an ObjectWriter. This one has meta data already written, so we
     // don't have to write it here.
-    BaseCpwImpl( hid_t iParentGroup );
+    BaseCpwImpl( boost::recursive_mutex &iWriteMutex, hid_t iParentGroup );
 
 public:
     virtual ~BaseCpwImpl();
@@ -93,6 +95,9 @@ protected:
     // The object we belong to. For TopCpwImpls, this will be NULL
     // to avoid circular references.
     AbcA::ObjectWriterPtr m_object;
+
+    // The archive's write mutex, see AwImpl::getWriteMutex.
+    boost::recursive_mutex &m_writeMutex;
     
     // The parent group. We need to keep this around because we
     // don't create our group until we need to. This is guaranteed to
@@ -56,17 +56,23 @@ class ObjectGroupVisitor
 {
 private:
     friend class BaseOrImpl;
-    ObjectGroupVisitor( BaseOrImpl &iParent )
-      : m_parent( iParent ) {}
+    ObjectGroupVisitor( BaseOrImpl &iParent,
+                        const AbcA::MetaData &iInstances )
+      : m_parent( iParent )
+      , m_instances( iInstances ) {}
 
 public:
     void createProtoObject( hid_t iGroup, const char *iName )
     {
-        m_parent.createProtoObject( iGroup, iName );
+        m_parent.createProtoObject( iGroup, iName,
+                                    m_instances.get( iName ) );
     }
 
 private:
     BaseOrImpl &m_parent;
+
+    // Which children are instances, see BaseOwImpl::addChildInstance.
+    const AbcA::MetaData &m_instances;
 };
 
 //-*****************************************************************************
@@ -107,10 +113,13 @@ BaseOrImpl::BaseOrImpl( ProtoObjectReaderPtr iProto )
     // Archive left NULL, will be set by OrImpl,
     // TopOrImpl handles archive differently.
 
-    ObjectGroupVisitor visitor( *this );
-
     hid_t id = m_proto->getGroup();
 
+    AbcA::MetaData instances;
+    ReadMetaData( id, ".instances", instances );
+
+    ObjectGroupVisitor visitor( *this, instances );
+
     herr_t status = H5Literate( id,
                                 H5_INDEX_CRT_ORDER,
                                 H5_ITER_INC,
@@ -123,7 +132,8 @@ BaseOrImpl::BaseOrImpl( ProtoObjectReaderPtr iProto )
 }
 
 //-*****************************************************************************
-void BaseOrImpl::createProtoObject( hid_t iGroup, const std::string &iName )
+void BaseOrImpl::createProtoObject( hid_t iGroup, const std::string &iName,
+                                    const std::string &iInstanceSource )
 {
     // We are called from ctor via VisitAllLinksCB(), so
     // we are multithread safe from changes to m_children,
@@ -135,7 +145,7 @@ void BaseOrImpl::createProtoObject( hid_t iGroup, const std::string &iName )
     child.proto = MakeProtoObjectReaderPtr(
         m_proto->getGroup(),
         m_proto->getHeader().getFullName(),
-        iName );
+        iName, iInstanceSource );
 
     m_protoObjects.push_back( child.proto );
     m_children[iName] = child;
@@ -240,6 +250,30 @@ BaseOrImpl::getChild( const std::string &iName )
     return optr;
 }
 
+//-*****************************************************************************
+bool BaseOrImpl::isInstanceRoot()
+{
+    // ProtoObjectReader created by ctor and then doesn't change,
+    // so multithread safe.
+    return !m_proto->getInstanceSource().empty();
+}
+
+//-*****************************************************************************
+std::string BaseOrImpl::getInstanceSourcePath()
+{
+    return m_proto->getInstanceSource();
+}
+
+//-*****************************************************************************
+bool BaseOrImpl::isChildInstance( const std::string &iName )
+{
+    // m_children filled by ctor via VisitAllLinksCB via createProtoObject ,
+    // so multithread safe.
+    ChildrenMap::iterator fiter = m_children.find( iName );
+    return fiter != m_children.end() &&
+        !(*fiter).second.proto->getInstanceSource().empty();
+}
+
 //-*****************************************************************************
 BaseOrImpl::~BaseOrImpl()
 {
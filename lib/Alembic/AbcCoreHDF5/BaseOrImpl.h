@@ -58,7 +58,8 @@ protected:
 
 public:
     // Not really public
-    void createProtoObject( hid_t iGroup, const std::string &iName );
+    void createProtoObject( hid_t iGroup, const std::string &iName,
+                            const std::string &iInstanceSource );
 
     virtual ~BaseOrImpl();
 
@@ -84,6 +85,16 @@ public:
 
     virtual AbcA::ObjectReaderPtr getChild( const std::string &iName );
 
+    //-*************************************************************************
+    // INSTANCES
+    //-*************************************************************************
+
+    virtual bool isInstanceRoot();
+
+    virtual std::string getInstanceSourcePath();
+
+    virtual bool isChildInstance( const std::string &iName );
+
 protected:
     typedef std::vector<ProtoObjectReaderPtr> ProtoObjects;
 
@@ -35,9 +35,11 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreHDF5/BaseOwImpl.h>
+#include <Alembic/AbcCoreHDF5/AwImpl.h>
 #include <Alembic/AbcCoreHDF5/OwImpl.h>
 #include <Alembic/AbcCoreHDF5/TopCpwImpl.h>
 #include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
 #include <Alembic/AbcCoreHDF5/HDF5Util.h>
 
 namespace Alembic {
@@ -45,20 +47,46 @@ namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
-BaseOwImpl::BaseOwImpl( hid_t iParentGroup,
+// Writers name the children of the top object "//child", readers "/child".
+static std::string ReaderName( const std::string &iFullName )
+{
+    if ( boost::starts_with( iFullName, "//" ) )
+    {
+        return iFullName.substr( 1 );
+    }
+    return iFullName;
+}
+
+//-*****************************************************************************
+BaseOwImpl::BaseOwImpl( boost::recursive_mutex &iWriteMutex,
+                        hid_t iParentGroup,
                         const std::string &iName,
                         const AbcA::MetaData &iMetaData )
-  : m_group( -1 )
+  : m_writeMutex( iWriteMutex )
+  , m_group( -1 )
   , m_properties( NULL )
 {
     // Check validity of all inputs.
     ABCA_ASSERT( iParentGroup >= 0, "Invalid parent group" );
 
-    // Create the HDF5 group corresponding to this object.
-    hid_t copl = CreationOrderPlist();
-    m_group = H5Gcreate2( iParentGroup, iName.c_str(),
-                          H5P_DEFAULT, copl, H5P_DEFAULT );
-    H5Pclose( copl );
+    // Create the HDF5 group corresponding to this object, unless it's
+    // already there because the archive was reopened to append to it.
+    if ( GroupExists( iParentGroup, iName ) )
+    {
+        m_group = H5Gopen2( iParentGroup, iName.c_str(), H5P_DEFAULT );
+
+        if ( m_group >= 0 )
+        {
+            ReadMetaData( m_group, ".instances", m_instances );
+        }
+    }
+    else
+    {
+        hid_t copl = CreationOrderPlist();
+        m_group = H5Gcreate2( iParentGroup, iName.c_str(),
+                              H5P_DEFAULT, copl, H5P_DEFAULT );
+        H5Pclose( copl );
+    }
     ABCA_ASSERT( m_group >= 0,
                  "Could not create group for object: " << iName );
 
@@ -73,6 +101,27 @@ AbcA::ArchiveWriterPtr BaseOwImpl::getArchive()
     return m_archive;
 }
 
+//-*****************************************************************************
+void BaseOwImpl::setArchive( AbcA::ArchiveWriterPtr iArchive )
+{
+    m_archive = iArchive;
+
+    if ( m_instances.size() > 0 )
+    {
+        boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
+        AwImpl *archive = dynamic_cast<AwImpl *>( m_archive.get() );
+        ABCA_ASSERT( archive, "Invalid archive in BaseOwImpl::setArchive()" );
+
+        const std::string myName = ReaderName( this->getFullName() );
+        for ( AbcA::MetaData::const_iterator iter = m_instances.begin();
+              iter != m_instances.end(); ++iter )
+        {
+            archive->addInstance( myName, iter->second );
+        }
+    }
+}
+
 //-*****************************************************************************
 AbcA::CompoundPropertyWriterPtr BaseOwImpl::getProperties()
 {
@@ -85,12 +134,16 @@ AbcA::CompoundPropertyWriterPtr BaseOwImpl::getProperties()
 //-*****************************************************************************
 size_t BaseOwImpl::getNumChildren()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     return m_childHeaders.size();
 }
 
 //-*****************************************************************************
 const AbcA::ObjectHeader & BaseOwImpl::getChildHeader( size_t i )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     if ( i >= m_childHeaders.size() )
     {
         ABCA_THROW( "Out of range index in OwImpl::getChildHeader: "
@@ -106,6 +159,8 @@ const AbcA::ObjectHeader & BaseOwImpl::getChildHeader( size_t i )
 const AbcA::ObjectHeader *
 BaseOwImpl::getChildHeader( const std::string &iName )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     size_t numChildren = m_childHeaders.size();
     for ( size_t i = 0; i < numChildren; ++i )
     {
@@ -122,6 +177,8 @@ BaseOwImpl::getChildHeader( const std::string &iName )
 AbcA::ObjectWriterPtr
 BaseOwImpl::getChild( const std::string &iName )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     MadeChildren::iterator fiter = m_madeChildren.find( iName );
     if ( fiter == m_madeChildren.end() )
     {
@@ -136,12 +193,22 @@ BaseOwImpl::getChild( const std::string &iName )
 AbcA::ObjectWriterPtr
 BaseOwImpl::createChild( const AbcA::ObjectHeader &iHeader )
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     if ( m_madeChildren.count( iHeader.getName() ) )
     {
         ABCA_THROW( "Already have an Object named: "
                      << iHeader.getName() );
     }
 
+    // Only possible when the archive was reopened, and it would write
+    // into the object that was instanced.
+    if ( !m_instances.get( iHeader.getName() ).empty() )
+    {
+        ABCA_THROW( "Can't create an Object named: " << iHeader.getName()
+                    << ", it is an instance" );
+    }
+
     ObjectHeaderPtr header(
         new AbcA::ObjectHeader( iHeader.getName(),
                                 this->getFullName() + "/" +
@@ -158,9 +225,90 @@ BaseOwImpl::createChild( const AbcA::ObjectHeader &iHeader )
     return ret;
 }
 
+//-*****************************************************************************
+void BaseOwImpl::addChildInstance( AbcA::ObjectWriterPtr iTarget,
+                                   const std::string &iName )
+{
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
+    if ( m_madeChildren.count( iName ) ||
+         !m_instances.get( iName ).empty() )
+    {
+        ABCA_THROW( "Already have an Object named: " << iName );
+    }
+
+    BaseOwImpl *target = dynamic_cast<BaseOwImpl *>( iTarget.get() );
+    ABCA_ASSERT( target && iTarget->getArchive() == getArchive(),
+                 "Can only add an instance of an object in the same archive "
+                 "as: " << iName );
+
+    AwImpl *archive = dynamic_cast<AwImpl *>( getArchive().get() );
+    ABCA_ASSERT( archive, "Invalid archive in BaseOwImpl::addChildInstance()" );
+
+    // An instance of ourselves, of one of our ancestors, or of anything
+    // that already holds us through instances of its own, would make
+    // the hierarchy a cycle.
+    const std::string &targetName = iTarget->getFullName();
+    const std::string &myName = this->getFullName();
+
+    // Stored the way readers name objects, children of the top object
+    // are named "/child" and not "//child" as they are here.
+    const std::string sourceName = ReaderName( targetName );
+    const std::string parentName = ReaderName( myName );
+    ABCA_ASSERT( targetName != "/" &&
+                 !archive->instanceReaches( sourceName, parentName ),
+                 "Can't add an instance of: " << targetName
+                 << " under itself as: " << iName );
+
+    // They are kept in MetaData, which doesn't escape these.
+    ABCA_ASSERT( iName.find_first_of( ";=" ) == std::string::npos &&
+                 targetName.find_first_of( ";=" ) == std::string::npos,
+                 "Can't add an instance of: " << targetName << " as: "
+                 << iName << ", names of instances can't contain ; or =" );
+
+    // The child is the target's group, linked to under another name.
+    herr_t status = H5Lcreate_hard( target->m_group, ".", m_group,
+                                    iName.c_str(), H5P_DEFAULT,
+                                    H5P_DEFAULT );
+    ABCA_ASSERT( status >= 0,
+                 "Could not add instance of: " << targetName
+                 << " named: " << iName );
+
+    ObjectHeaderPtr header(
+        new AbcA::ObjectHeader( iName, myName + "/" + iName,
+                                iTarget->getMetaData() ) );
+
+    m_childHeaders.push_back( header );
+    m_madeChildren[iName] = WeakOwPtr();
+
+    m_instances.set( iName, sourceName );
+    archive->addInstance( parentName, sourceName );
+}
+
 //-*****************************************************************************
 BaseOwImpl::~BaseOwImpl()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
+    if ( m_group >= 0 && m_instances.size() > 0 )
+    {
+        try
+        {
+            // A reopened object rewrites the ones it already had.
+            if ( H5Aexists( m_group, ".instances" ) > 0 )
+            {
+                H5Adelete( m_group, ".instances" );
+            }
+
+            WriteMetaData( m_group, ".instances", m_instances );
+        }
+        catch ( std::exception &exc )
+        {
+            std::cerr << "AbcCoreHDF5::BaseOwImpl::~BaseOwImpl(): "
+                      << "EXCEPTION: " << exc.what() << std::endl;
+        }
+    }
+
     delete m_properties;
 
     if ( m_group >= 0 )
@@ -39,6 +39,8 @@
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 
+#include <boost/thread/recursive_mutex.hpp>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
@@ -51,7 +53,8 @@ class TopCpwImpl;
 class BaseOwImpl : public AbcA::ObjectWriter
 {
 protected:
-    BaseOwImpl( hid_t iParentGroup,
+    BaseOwImpl( boost::recursive_mutex &iWriteMutex,
+                hid_t iParentGroup,
                 const std::string &iName,
                 const AbcA::MetaData &iMetaData );
     
@@ -82,8 +85,16 @@ public:
     virtual AbcA::ObjectWriterPtr createChild(
         const AbcA::ObjectHeader &iHeader );
 
+    virtual void addChildInstance( AbcA::ObjectWriterPtr iTarget,
+                                   const std::string &iName );
+
+    // The archive's write mutex, see AwImpl::getWriteMutex.
+    boost::recursive_mutex &getWriteMutex() { return m_writeMutex; }
+
 protected:
-    void setArchive( AbcA::ArchiveWriterPtr iArchive ) { m_archive = iArchive; }
+    // Also tells the archive about the instances a reopened object
+    // already had, so that new ones can't make a cycle with them.
+    void setArchive( AbcA::ArchiveWriterPtr iArchive );
 
 private:
     typedef std::vector<ObjectHeaderPtr> ChildHeaders;
@@ -93,6 +104,10 @@ private:
     // This will be NULL with TopOwImpl, to avoid a circular reference.
     AbcA::ArchiveWriterPtr m_archive;
 
+    // Held by reference, so that it can be locked by the destructor
+    // of the TopOwImpl, which has no archive ptr.
+    boost::recursive_mutex &m_writeMutex;
+
     // The group corresponding to this property.
     hid_t m_group;
 
@@ -103,6 +118,11 @@ private:
     // The children
     ChildHeaders m_childHeaders;
     MadeChildren m_madeChildren;
+
+    // The children that are instances, by name, with the full names of
+    // the objects they are instances of. Written as ".instances" when we
+    // are closed.
+    AbcA::MetaData m_instances;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
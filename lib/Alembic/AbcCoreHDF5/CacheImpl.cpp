@@ -55,6 +55,14 @@ CacheImpl::~CacheImpl()
 //-*****************************************************************************
 AbcA::ReadArraySampleID
 CacheImpl::find( const AbcA::ArraySample::Key &iKey )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return findRecord( iKey );
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+CacheImpl::findRecord( const AbcA::ArraySample::Key &iKey )
 {
     // Check the locked map! If we have already locked it, just return
     // it locked!
@@ -63,8 +71,17 @@ CacheImpl::find( const AbcA::ArraySample::Key &iKey )
     {
         AbcA::ArraySamplePtr deleterPtr =
             (*foundIter).second.weakDeleter.lock();
-        assert( deleterPtr );
-
+        if ( deleterPtr )
+        {
+            return AbcA::ReadArraySampleID( iKey, deleterPtr );
+        }
+
+        // The last reference was just released on another thread, whose
+        // deleter is waiting on the mutex. Lock the sample again; that
+        // deleter's unlock then only costs the new record its place in
+        // the locked map.
+        AbcA::ArraySamplePtr givenSampPtr = (*foundIter).second.given;
+        deleterPtr = lock( iKey, givenSampPtr );
         return AbcA::ReadArraySampleID( iKey, deleterPtr );
     }
 
@@ -97,8 +114,10 @@ CacheImpl::store( const AbcA::ArraySample::Key &iKey,
 {
     ABCA_ASSERT( iSamp, "Cannot store a null sample" );
 
+    boost::mutex::scoped_lock l( m_mutex );
+
     // Check to see if we already have it.
-    AbcA::ReadArraySampleID foundID = find( iKey );
+    AbcA::ReadArraySampleID foundID = findRecord( iKey );
     if ( foundID )
     {
         return foundID;
@@ -136,6 +155,8 @@ CacheImpl::lock( const AbcA::ArraySample::Key &iKey,
 //-*****************************************************************************
 void CacheImpl::unlock( const AbcA::ArraySample::Key &iKey )
 {
+    boost::mutex::scoped_lock l( m_mutex );
+
     Map::iterator foundIter = m_lockedMap.find( iKey );
     if ( foundIter != m_lockedMap.end() )
     {
@@ -39,6 +39,8 @@
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 
+#include <boost/thread/mutex.hpp>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
@@ -54,7 +56,8 @@ typedef boost::weak_ptr<CacheImpl> CacheImplWeakPtr;
 //-*****************************************************************************
 //! This class is underimplemented. It ought to allow limits on storage.
 //! Todo!
-//! THIS CLASS IS NOT MULTITHREAD SAFE
+//! The maps are locked, because the record deleters run on whichever
+//! thread releases the last reference to a sample.
 class CacheImpl : public AbcA::ReadArraySampleCache
 {
 public:
@@ -110,6 +113,7 @@ public:
 
 private:
     friend class RecordDeleter;
+    AbcA::ReadArraySampleID findRecord( const AbcA::ArraySample::Key &iKey );
     AbcA::ArraySamplePtr lock( const AbcA::ArraySample::Key &iKey,
                                AbcA::ArraySamplePtr iSamp );
     void unlock( const AbcA::ArraySample::Key &iKey );
@@ -146,6 +150,9 @@ private:
 
     Map m_lockedMap;
     UnlockedMap m_unlockedMap;
+
+    // Guards both maps.
+    boost::mutex m_mutex;
 };
 
 //-*****************************************************************************
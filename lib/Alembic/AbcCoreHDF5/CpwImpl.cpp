@@ -47,7 +47,8 @@ CpwImpl::CpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
                   hid_t iParentGroup,
                   const std::string & iName,
                   const AbcA::MetaData & iMeta )
-  : BaseCpwImpl( iParentGroup )
+  : BaseCpwImpl( GetWriteMutex( iParent->getObject()->getArchive() ),
+                 iParentGroup )
   , m_parent( iParent )
   , m_header( new AbcA::PropertyHeader(iName, iMeta) )
 {
@@ -71,8 +72,12 @@ CpwImpl::CpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
         m_header->getPropertyType(), m_header->getDataType(),
         false, 0, 0, 0, 0 );
 
-    WriteMetaData( iParentGroup, m_header->getName() + ".meta",
-        m_header->getMetaData() );
+    // A reopened compound keeps its MetaData.
+    const std::string metaName = m_header->getName() + ".meta";
+    if ( H5Aexists( iParentGroup, metaName.c_str() ) <= 0 )
+    {
+        WriteMetaData( iParentGroup, metaName, m_header->getMetaData() );
+    }
 }
 
 //-*****************************************************************************
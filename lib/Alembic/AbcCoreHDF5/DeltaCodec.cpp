@@ -0,0 +1,413 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/DeltaCodec.h>
+#include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
+#include <Alembic/AbcCoreHDF5/HDF5Util.h>
+
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The values are copied through memcpy instead of being read through a
+// pointer cast, since the floats and their bits are different types.
+template <class BITS>
+static void XorBits( const void *iPrevious, const void *iCurrent,
+                     size_t iNumVals, std::vector<BITS> &oBits )
+{
+    std::vector<BITS> prev( iNumVals );
+    oBits.resize( iNumVals );
+    memcpy( &prev.front(), iPrevious, iNumVals * sizeof( BITS ) );
+    memcpy( &oBits.front(), iCurrent, iNumVals * sizeof( BITS ) );
+
+    for ( size_t i = 0; i < iNumVals; ++i )
+    {
+        oBits[i] ^= prev[i];
+    }
+}
+
+//-*****************************************************************************
+// Readers and writers must rebuild quantized values the same way, bit for
+// bit, or lossy samples will drift.
+template <class T>
+inline T Dequantize( T iPrevious, int32_t iQuantized, float64_t iStep )
+{
+    return static_cast<T>( static_cast<float64_t>( iPrevious ) +
+                           iQuantized * iStep );
+}
+
+//-*****************************************************************************
+// Returns false if any value can't be rebuilt within half a step of the
+// original, because it isn't finite or because it moved too far.
+template <class T>
+static bool Quantize( const T *iPrevious, const T *iCurrent, size_t iNumVals,
+                      float64_t iStep, std::vector<int32_t> &oQuantized,
+                      T *oRebuilt )
+{
+    static const float64_t minQ = std::numeric_limits<int32_t>::min();
+    static const float64_t maxQ = std::numeric_limits<int32_t>::max();
+
+    float64_t tolerance = iStep * 0.5;
+    oQuantized.resize( iNumVals );
+    for ( size_t i = 0; i < iNumVals; ++i )
+    {
+        float64_t q = floor( ( static_cast<float64_t>( iCurrent[i] ) -
+                               static_cast<float64_t>( iPrevious[i] ) ) /
+                             iStep + 0.5 );
+
+        // written so that NaNs fail
+        if ( !( q >= minQ && q <= maxQ ) )
+        {
+            return false;
+        }
+
+        oQuantized[i] = static_cast<int32_t>( q );
+        oRebuilt[i] = Dequantize( iPrevious[i], oQuantized[i], iStep );
+
+        if ( !( fabs( static_cast<float64_t>( oRebuilt[i] ) -
+                      static_cast<float64_t>( iCurrent[i] ) ) <= tolerance ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-*****************************************************************************
+// The deltas are mostly runs of zero bytes once they are shuffled, which
+// deflate does very well on, so they are always compressed.
+static hid_t WriteDeltaDataset( hid_t iGroup,
+                                const std::string &iName,
+                                size_t iNumVals,
+                                hid_t iFileType,
+                                hid_t iNativeType,
+                                const void *iData,
+                                int iCompressionLevel )
+{
+    hsize_t hdim = iNumVals;
+    hid_t dspaceId = H5Screate_simple( 1, &hdim, NULL );
+    ABCA_ASSERT( dspaceId >= 0,
+                 "WriteDeltaDataset() Failed in dataspace construction" );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    hid_t plist = H5Pcreate( H5P_DATASET_CREATE );
+    ABCA_ASSERT( plist >= 0, "WriteDeltaDataset() H5Pcreate failed" );
+    PlistCloser plistCloser( plist );
+
+    int level = iCompressionLevel < 1 ? 1 :
+        ( iCompressionLevel > 9 ? 9 : iCompressionLevel );
+
+    herr_t status = H5Pset_chunk( plist, 1, &hdim );
+    ABCA_ASSERT( status >= 0, "WriteDeltaDataset() H5Pset_chunk failed" );
+    status = H5Pset_shuffle( plist );
+    ABCA_ASSERT( status >= 0, "WriteDeltaDataset() H5Pset_shuffle failed" );
+    status = H5Pset_deflate( plist, ( unsigned int )level );
+    ABCA_ASSERT( status >= 0, "WriteDeltaDataset() H5Pset_deflate failed" );
+
+    hid_t dsetId = H5Dcreate2( iGroup, iName.c_str(), iFileType, dspaceId,
+                               H5P_DEFAULT, plist, H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0,
+                 "WriteDeltaDataset() Failed in dataset constructor" );
+
+    status = StatsH5Dwrite( dsetId, iNativeType, iData );
+    if ( status < 0 )
+    {
+        H5Dclose( dsetId );
+        ABCA_THROW( "WriteDeltaDataset() H5Dwrite failed: " << iName );
+    }
+
+    return dsetId;
+}
+
+//-*****************************************************************************
+bool IsDeltaEncodable( const AbcA::DataType &iDataType )
+{
+    return iDataType.getPod() == kFloat32POD ||
+        iDataType.getPod() == kFloat64POD;
+}
+
+//-*****************************************************************************
+bool IsDeltaSample( hid_t iGroup, const std::string &iName )
+{
+    std::string markerName = iName + ".delta";
+    return H5Aexists( iGroup, markerName.c_str() ) > 0;
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+ReadDeltaSample( hid_t iGroup,
+                 const std::string &iName,
+                 const AbcA::DataType &iDataType,
+                 AbcA::ArraySamplePtr iPrevious )
+{
+    ABCA_ASSERT( iPrevious, "No previous sample to apply delta: " << iName );
+
+    float64_t marker = 0.0;
+    ReadScalar( iGroup, iName + ".delta", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                ( void * )&marker );
+
+    if ( marker < 0.0 )
+    {
+        return iPrevious;
+    }
+
+    hid_t dsetId = H5Dopen( iGroup, iName.c_str(), H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iName );
+    DsetCloser dsetCloser( dsetId );
+
+    hid_t dspaceId = H5Dget_space( dsetId );
+    ABCA_ASSERT( dspaceId >= 0, "Could not get dataspace for dataSet: "
+                 << iName );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    size_t numVals = iPrevious->getDimensions().numPoints() *
+        iDataType.getExtent();
+    ABCA_ASSERT( ( size_t )H5Sget_simple_extent_npoints( dspaceId ) ==
+                 numVals, "Delta size doesn't match previous sample: "
+                 << iName );
+
+    AbcA::ArraySamplePtr ret =
+        AbcA::AllocateArraySample( iDataType, iPrevious->getDimensions() );
+    void *data = const_cast<void *>( ret->getData() );
+
+    herr_t status = -1;
+    if ( marker == 0.0 && iDataType.getPod() == kFloat32POD )
+    {
+        std::vector<uint32_t> bits( numVals );
+        status = StatsH5Dread( dsetId, H5T_NATIVE_UINT32, &bits.front() );
+        StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+        std::vector<uint32_t> rebuilt;
+        XorBits( iPrevious->getData(), &bits.front(), numVals, rebuilt );
+        memcpy( data, &rebuilt.front(), numVals * sizeof( uint32_t ) );
+    }
+    else if ( marker == 0.0 )
+    {
+        std::vector<uint64_t> bits( numVals );
+        status = StatsH5Dread( dsetId, H5T_NATIVE_UINT64, &bits.front() );
+        StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+        std::vector<uint64_t> rebuilt;
+        XorBits( iPrevious->getData(), &bits.front(), numVals, rebuilt );
+        memcpy( data, &rebuilt.front(), numVals * sizeof( uint64_t ) );
+    }
+    else
+    {
+        std::vector<int32_t> quantized( numVals );
+        status = StatsH5Dread( dsetId, H5T_NATIVE_INT32, &quantized.front() );
+
+        StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+
+        if ( iDataType.getPod() == kFloat32POD )
+        {
+            const float32_t *prev =
+                static_cast<const float32_t *>( iPrevious->getData() );
+            float32_t *out = static_cast<float32_t *>( data );
+            for ( size_t i = 0; i < numVals; ++i )
+            {
+                out[i] = Dequantize( prev[i], quantized[i], marker );
+            }
+        }
+        else
+        {
+            const float64_t *prev =
+                static_cast<const float64_t *>( iPrevious->getData() );
+            float64_t *out = static_cast<float64_t *>( data );
+            for ( size_t i = 0; i < numVals; ++i )
+            {
+                out[i] = Dequantize( prev[i], quantized[i], marker );
+            }
+        }
+    }
+
+    ABCA_ASSERT( status >= 0, "H5Dread() failed: " << iName );
+
+    return ret;
+}
+
+//-*****************************************************************************
+DeltaWriter::DeltaWriter( uint32_t iKeyInterval, float64_t iTolerance )
+  : m_keyInterval( iKeyInterval )
+  , m_step( iTolerance * 2.0 )
+  , m_keyIndex( 0 )
+  , m_previousIsDelta( false )
+{
+    ABCA_ASSERT( m_keyInterval > 0, "Delta key interval must be at least 1" );
+    ABCA_ASSERT( m_step >= 0.0, "Delta tolerance can't be negative" );
+}
+
+//-*****************************************************************************
+WrittenArraySampleIDPtr
+DeltaWriter::writeDelta( hid_t iGroup,
+                         const std::string &iName,
+                         index_t iSampleIndex,
+                         const AbcA::ArraySample &iSamp,
+                         const AbcA::ArraySample::Key &iKey,
+                         int iCompressionLevel )
+{
+    const AbcA::DataType &dataType = iSamp.getDataType();
+    const Dimensions &dims = iSamp.getDimensions();
+    size_t numVals = dims.numPoints() * dataType.getExtent();
+
+    if ( !m_previous || numVals == 0 ||
+         dims != m_previous->getDimensions() ||
+         iSampleIndex - m_keyIndex >= ( index_t )m_keyInterval )
+    {
+        return WrittenArraySampleIDPtr();
+    }
+
+    bool isFloat32 = dataType.getPod() == kFloat32POD;
+
+    std::vector<uint32_t> bits32;
+    std::vector<uint64_t> bits64;
+    std::vector<int32_t> quantized;
+    AbcA::ArraySamplePtr rebuilt =
+        AbcA::AllocateArraySample( dataType, dims );
+    void *rebuiltData = const_cast<void *>( rebuilt->getData() );
+
+    hid_t fileType = -1;
+    hid_t nativeType = -1;
+    const void *deltaData = NULL;
+
+    if ( m_step == 0.0 )
+    {
+        memcpy( rebuiltData, iSamp.getData(),
+                dims.numPoints() * dataType.getNumBytes() );
+        if ( isFloat32 )
+        {
+            XorBits( m_previous->getData(), iSamp.getData(), numVals, bits32 );
+            fileType = H5T_STD_U32LE;
+            nativeType = H5T_NATIVE_UINT32;
+            deltaData = &bits32.front();
+        }
+        else
+        {
+            XorBits( m_previous->getData(), iSamp.getData(), numVals, bits64 );
+            fileType = H5T_STD_U64LE;
+            nativeType = H5T_NATIVE_UINT64;
+            deltaData = &bits64.front();
+        }
+    }
+    else
+    {
+        bool ok = isFloat32 ?
+            Quantize( static_cast<const float32_t *>( m_previous->getData() ),
+                      static_cast<const float32_t *>( iSamp.getData() ),
+                      numVals, m_step, quantized,
+                      static_cast<float32_t *>( rebuiltData ) ) :
+            Quantize( static_cast<const float64_t *>( m_previous->getData() ),
+                      static_cast<const float64_t *>( iSamp.getData() ),
+                      numVals, m_step, quantized,
+                      static_cast<float64_t *>( rebuiltData ) );
+
+        if ( !ok )
+        {
+            return WrittenArraySampleIDPtr();
+        }
+
+        fileType = H5T_STD_I32LE;
+        nativeType = H5T_NATIVE_INT32;
+        deltaData = &quantized.front();
+    }
+
+    if ( dims.rank() > 1 )
+    {
+        WriteDimensions( iGroup, iName + ".dims", dims );
+    }
+
+    hid_t dsetId = WriteDeltaDataset( iGroup, iName, numVals, fileType,
+                                      nativeType, deltaData,
+                                      iCompressionLevel );
+    DsetCloser dsetCloser( dsetId );
+
+    // The key on the dataset is for what readers get back, while the
+    // returned ID keeps the key of what was given, so that repeats of it
+    // are still caught.
+    WriteKey( dsetId, "key", m_step == 0.0 ? iKey : rebuilt->getKey() );
+
+    WriteScalar( iGroup, iName + ".delta", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                 ( const void * )&m_step );
+
+    m_previous = rebuilt;
+    m_previousIsDelta = true;
+
+    return WrittenArraySampleIDPtr( new WrittenArraySampleID( iKey, dsetId ) );
+}
+
+//-*****************************************************************************
+void DeltaWriter::keyWritten( index_t iSampleIndex,
+                              const AbcA::ArraySample &iSamp )
+{
+    m_keyIndex = iSampleIndex;
+    m_previousIsDelta = false;
+
+    m_previous = AbcA::AllocateArraySample( iSamp.getDataType(),
+                                            iSamp.getDimensions() );
+    size_t numBytes = iSamp.getDimensions().numPoints() *
+        iSamp.getDataType().getNumBytes();
+    if ( numBytes > 0 )
+    {
+        memcpy( const_cast<void *>( m_previous->getData() ), iSamp.getData(),
+                numBytes );
+    }
+}
+
+//-*****************************************************************************
+void DeltaWriter::writeHeld( hid_t iGroup, const std::string &iName )
+{
+    if ( m_previousIsDelta )
+    {
+        float64_t held = -1.0;
+        WriteScalar( iGroup, iName + ".delta", H5T_IEEE_F64LE,
+                     H5T_NATIVE_DOUBLE, ( const void * )&held );
+    }
+}
+
+//-*****************************************************************************
+void DeltaWriter::reopened( bool iPreviousIsDelta )
+{
+    m_previousIsDelta = iPreviousIsDelta;
+    m_previous.reset();
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,127 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_DeltaCodec_h_
+#define _Alembic_AbcCoreHDF5_DeltaCodec_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Delta encoded array properties (see DeltaEncoding.h) store keyframes as
+// ordinary array samples. Every other sample has a float64 marker
+// attribute named <sampleName>.delta next to its dataset:
+//
+//   == 0  the dataset holds the XOR of each value's bits with the bits of
+//         the previous sample (uint32 for float32, uint64 for float64)
+//   >  0  the dataset holds int32 multiples of the marker to add to the
+//         previous sample
+//   <  0  the sample is held from the previous one, and its dataset is
+//         a link to the previous sample's dataset
+//
+// The previous sample is always sample index - 1, so a reader rebuilds a
+// sample by walking back to a keyframe and applying deltas forward.
+//-*****************************************************************************
+
+//-*****************************************************************************
+bool IsDeltaEncodable( const AbcA::DataType &iDataType );
+
+//-*****************************************************************************
+bool IsDeltaSample( hid_t iGroup, const std::string &iName );
+
+//-*****************************************************************************
+// Rebuilds the delta sample iName from iPrevious, the sample before it.
+AbcA::ArraySamplePtr
+ReadDeltaSample( hid_t iGroup,
+                 const std::string &iName,
+                 const AbcA::DataType &iDataType,
+                 AbcA::ArraySamplePtr iPrevious );
+
+//-*****************************************************************************
+// The encoding state of one array property writer. It holds on to the
+// previous sample as a reader would rebuild it, so that lossy deltas
+// don't drift.
+class DeltaWriter
+{
+public:
+    DeltaWriter( uint32_t iKeyInterval, float64_t iTolerance );
+
+    // Writes iSamp as a delta against the previous sample, if it can.
+    // Returns an invalid pointer when iSamp has to be a keyframe instead,
+    // in which case nothing was written and keyWritten must be called
+    // once the keyframe is.
+    WrittenArraySampleIDPtr writeDelta( hid_t iGroup,
+                                        const std::string &iName,
+                                        index_t iSampleIndex,
+                                        const AbcA::ArraySample &iSamp,
+                                        const AbcA::ArraySample::Key &iKey,
+                                        int iCompressionLevel );
+
+    void keyWritten( index_t iSampleIndex, const AbcA::ArraySample &iSamp );
+
+    // Marks the copy of the previous sample at iName as held, if the
+    // previous sample was a delta.
+    void writeHeld( hid_t iGroup, const std::string &iName );
+
+    // For a property reopened by AppendArchive, whose previous sample
+    // isn't in memory. The next sample written will be a keyframe.
+    void reopened( bool iPreviousIsDelta );
+
+private:
+    uint32_t m_keyInterval;
+
+    // The quantization step, twice the tolerance, or 0 for lossless.
+    float64_t m_step;
+
+    index_t m_keyIndex;
+    bool m_previousIsDelta;
+    AbcA::ArraySamplePtr m_previous;
+};
+
+typedef boost::shared_ptr<DeltaWriter> DeltaWriterPtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,99 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/DeltaEncoding.h>
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+static const char * g_keyIntervalKey = "deltaKeyInterval";
+static const char * g_toleranceKey = "deltaTolerance";
+
+//-*****************************************************************************
+void SetDeltaEncoding( AbcA::MetaData &ioMetaData,
+                       uint32_t iKeyInterval,
+                       float64_t iTolerance )
+{
+    ABCA_ASSERT( iKeyInterval > 0, "Delta key interval must be at least 1" );
+    ABCA_ASSERT( iTolerance >= 0.0,
+                 "Delta tolerance can't be negative: " << iTolerance );
+
+    ioMetaData.set( g_keyIntervalKey,
+                    boost::lexical_cast<std::string>( iKeyInterval ) );
+
+    std::ostringstream strm;
+    strm << std::setprecision( 17 ) << iTolerance;
+    ioMetaData.set( g_toleranceKey, strm.str() );
+}
+
+//-*****************************************************************************
+bool GetDeltaEncoding( const AbcA::MetaData &iMetaData,
+                       uint32_t &oKeyInterval,
+                       float64_t &oTolerance )
+{
+    std::string interval = iMetaData.get( g_keyIntervalKey );
+    if ( interval.empty() )
+    {
+        return false;
+    }
+
+    try
+    {
+        oKeyInterval = boost::lexical_cast<uint32_t>( interval );
+
+        std::string tolerance = iMetaData.get( g_toleranceKey );
+        oTolerance = tolerance.empty() ? 0.0 :
+            boost::lexical_cast<float64_t>( tolerance );
+    }
+    catch ( boost::bad_lexical_cast & )
+    {
+        return false;
+    }
+
+    return oKeyInterval > 0 && oTolerance >= 0.0;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
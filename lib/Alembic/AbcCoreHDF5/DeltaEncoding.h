@@ -0,0 +1,87 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_DeltaEncoding_h_
+#define _Alembic_AbcCoreHDF5_DeltaEncoding_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Delta encoding stores float32 and float64 array samples, such as the
+//! positions of a deforming mesh, as periodic full keyframes with every
+//! sample in between stored as its difference from the sample before it.
+//! Those differences are mostly zero bits and compress far better than
+//! the full arrays. Readers rebuild each sample transparently.
+//!
+//! It is turned on through MetaData. Set on a property's MetaData, it
+//! applies to that property:
+//!
+//!     AbcA::MetaData md;
+//!     SetDeltaEncoding( md, 24 );
+//!     OP3fArrayProperty P( props, "P", md, tsidx );
+//!
+//! Set on the MetaData an OArchive is created with, it applies to every
+//! float array property in the archive which doesn't set its own, which
+//! is how it reaches the positions made by the AbcGeom schemas.
+//!
+//! iKeyInterval is the most samples apart two keyframes can be. A sample
+//! whose dimensions differ from the previous one is always a keyframe.
+//!
+//! With iTolerance at 0 the encoding is lossless. With a positive
+//! iTolerance each delta is quantized, and every value read back is
+//! within iTolerance of the value that was written.
+void SetDeltaEncoding( AbcCoreAbstract::MetaData &ioMetaData,
+                       uint32_t iKeyInterval,
+                       Util::float64_t iTolerance = 0.0 );
+
+//! Returns whether iMetaData turns on delta encoding, and if so fills
+//! in its key interval and tolerance.
+bool GetDeltaEncoding( const AbcCoreAbstract::MetaData &iMetaData,
+                       uint32_t &oKeyInterval,
+                       Util::float64_t &oTolerance );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,504 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/DiskCacheImpl.h>
+
+#ifndef PLATFORM_WINDOWS
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+static const char kEntryMagic[8] = { 'A', 'b', 'c', 'D', 'i', 's', 'k', '1' };
+static const char *kEntrySuffix = ".abcsample";
+static const char *kTempPrefix = ".tmp.";
+
+// Samples smaller than this are cheap to read again, and not worth a file.
+static const uint64_t kMinEntryBytes = 1024;
+
+// Sample data starts on a multiple of this within the entry.
+static const size_t kEntryAlignment = 16;
+
+// Temporary files this old were left behind by a process that died
+// while writing them.
+static const time_t kStaleTempSeconds = 60 * 60;
+
+//-*****************************************************************************
+// An entry is this header, the sample's dimensions as rank uint64s, and
+// then the sample's data, aligned.
+struct EntryHeader
+{
+    char magic[8];
+    uint64_t numBytes;
+    Util::Digest digest;
+    uint32_t origPOD;
+    uint32_t readPOD;
+    uint32_t pod;
+    uint32_t extent;
+    uint32_t rank;
+    uint32_t unused;
+};
+
+//-*****************************************************************************
+static size_t EntryDataOffset( size_t iRank )
+{
+    size_t offset = sizeof( EntryHeader ) + iRank * sizeof( uint64_t );
+    return ( offset + kEntryAlignment - 1 ) / kEntryAlignment *
+        kEntryAlignment;
+}
+
+//-*****************************************************************************
+static bool IsDiskCacheable( const AbcA::ArraySample::Key &iKey,
+                             const AbcA::ArraySample &iSamp )
+{
+    PlainOldDataType pod = iSamp.getDataType().getPod();
+    return pod != kStringPOD && pod != kWstringPOD &&
+        pod != kUnknownPOD && iKey.numBytes >= kMinEntryBytes &&
+        iSamp.getDimensions().numPoints() > 0;
+}
+
+//-*****************************************************************************
+// Unmaps the entry along with the sample that points into it.
+struct MappedSampleDeleter
+{
+    MappedSampleDeleter( void *iAddress, size_t iSize )
+      : address( iAddress ), size( iSize ) {}
+
+    void operator()( AbcA::ArraySample *iSamp )
+    {
+        delete iSamp;
+        munmap( address, size );
+    }
+
+    void *address;
+    size_t size;
+};
+
+//-*****************************************************************************
+// Entries written or used within the same second still need telling apart.
+static double ModifiedTime( const struct stat &iStat )
+{
+#if defined( PLATFORM_DARWIN )
+    return iStat.st_mtimespec.tv_sec + iStat.st_mtimespec.tv_nsec * 1e-9;
+#else
+    return iStat.st_mtim.tv_sec + iStat.st_mtim.tv_nsec * 1e-9;
+#endif
+}
+
+//-*****************************************************************************
+struct DirectoryEntry
+{
+    std::string path;
+    double modified;
+    uint64_t size;
+};
+
+//-*****************************************************************************
+static bool OlderEntry( const DirectoryEntry &iA, const DirectoryEntry &iB )
+{
+    return iA.modified < iB.modified;
+}
+
+//-*****************************************************************************
+static bool EndsWith( const std::string &iStr, const std::string &iSuffix )
+{
+    return iStr.size() >= iSuffix.size() &&
+        iStr.compare( iStr.size() - iSuffix.size(), iSuffix.size(),
+                      iSuffix ) == 0;
+}
+
+//-*****************************************************************************
+// Lists the entries in iDirectory, and removes stale temporary files.
+static void ListEntries( const std::string &iDirectory,
+                         std::vector<DirectoryEntry> &oEntries )
+{
+    oEntries.clear();
+
+    DIR *dir = opendir( iDirectory.c_str() );
+    if ( !dir )
+    {
+        return;
+    }
+
+    time_t now = time( NULL );
+
+    while ( struct dirent *ent = readdir( dir ) )
+    {
+        std::string name = ent->d_name;
+        bool isTemp = name.compare( 0, strlen( kTempPrefix ),
+                                    kTempPrefix ) == 0;
+        if ( !isTemp && !EndsWith( name, kEntrySuffix ) )
+        {
+            continue;
+        }
+
+        DirectoryEntry entry;
+        entry.path = iDirectory + "/" + name;
+
+        struct stat st;
+        if ( stat( entry.path.c_str(), &st ) != 0 )
+        {
+            continue;
+        }
+
+        if ( isTemp )
+        {
+            if ( now - st.st_mtime > kStaleTempSeconds )
+            {
+                unlink( entry.path.c_str() );
+            }
+            continue;
+        }
+
+        entry.modified = ModifiedTime( st );
+        entry.size = st.st_size;
+        oEntries.push_back( entry );
+    }
+
+    closedir( dir );
+}
+
+//-*****************************************************************************
+DiskCacheImpl::DiskCacheImpl( const std::string &iDirectory,
+                              uint64_t iMaxBytes,
+                              AbcA::ReadArraySampleCachePtr iMemoryCache )
+  : m_directory( iDirectory )
+  , m_maxBytes( iMaxBytes )
+  , m_memoryCache( iMemoryCache )
+  , m_numBytes( 0 )
+  , m_numWritten( 0 )
+{
+    ABCA_ASSERT( m_memoryCache, "A disk cache needs a memory cache" );
+
+    if ( mkdir( m_directory.c_str(), 0777 ) != 0 && errno != EEXIST )
+    {
+        ABCA_THROW( "Could not create cache directory: " << m_directory );
+    }
+
+    struct stat st;
+    ABCA_ASSERT( stat( m_directory.c_str(), &st ) == 0 &&
+                 S_ISDIR( st.st_mode ),
+                 "Not a directory: " << m_directory );
+
+    // What's already there counts, whoever put it there.
+    trim( m_maxBytes );
+}
+
+//-*****************************************************************************
+DiskCacheImpl::~DiskCacheImpl()
+{
+    // Nothing!
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+DiskCacheImpl::find( const AbcA::ArraySample::Key &iKey )
+{
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+
+        AbcA::ReadArraySampleID found = m_memoryCache->find( iKey );
+        if ( found )
+        {
+            return found;
+        }
+    }
+
+    // Without the lock, so that other threads aren't kept waiting on the
+    // disk. If two threads load the same entry, the memory cache keeps
+    // whichever is stored first.
+    AbcA::ArraySamplePtr samp = load( iKey );
+    if ( !samp )
+    {
+        return AbcA::ReadArraySampleID();
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_memoryCache->store( iKey, samp );
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+DiskCacheImpl::store( const AbcA::ArraySample::Key &iKey,
+                      AbcA::ArraySamplePtr iSamp )
+{
+    ABCA_ASSERT( iSamp, "Cannot store a null sample" );
+
+    AbcA::ReadArraySampleID stored;
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        stored = m_memoryCache->store( iKey, iSamp );
+    }
+
+    if ( IsDiskCacheable( iKey, *iSamp ) )
+    {
+        // Without the lock too, see write.
+        write( iKey, *iSamp );
+
+        // Trim down below the limit, so that it isn't done on every store.
+        if ( getNumBytes() > m_maxBytes )
+        {
+            trim( m_maxBytes - m_maxBytes / 4 );
+        }
+    }
+
+    return stored;
+}
+
+//-*****************************************************************************
+uint64_t DiskCacheImpl::getNumBytes()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_numBytes;
+}
+
+//-*****************************************************************************
+void DiskCacheImpl::trim( uint64_t iMaxBytes )
+{
+    // Other processes write to the directory too, so go by what's there.
+    std::vector<DirectoryEntry> entries;
+    ListEntries( m_directory, entries );
+
+    uint64_t numBytes = 0;
+    for ( size_t i = 0; i < entries.size(); ++i )
+    {
+        numBytes += entries[i].size;
+    }
+
+    std::sort( entries.begin(), entries.end(), OlderEntry );
+
+    for ( size_t i = 0; i < entries.size() && numBytes > iMaxBytes; ++i )
+    {
+        // Anyone who has it mapped keeps it until they're done with it.
+        if ( unlink( entries[i].path.c_str() ) == 0 )
+        {
+            numBytes -= entries[i].size;
+        }
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_numBytes = numBytes;
+}
+
+//-*****************************************************************************
+std::string
+DiskCacheImpl::entryPath( const AbcA::ArraySample::Key &iKey ) const
+{
+    std::ostringstream strm;
+    strm << m_directory << "/" << iKey.digest.str() << "."
+         << iKey.numBytes << "." << ( int ) iKey.origPOD << "."
+         << ( int ) iKey.readPOD << kEntrySuffix;
+    return strm.str();
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+DiskCacheImpl::load( const AbcA::ArraySample::Key &iKey )
+{
+    std::string path = entryPath( iKey );
+
+    int fd = open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        return AbcA::ArraySamplePtr();
+    }
+
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 ||
+         ( size_t ) st.st_size < sizeof( EntryHeader ) )
+    {
+        close( fd );
+        return AbcA::ArraySamplePtr();
+    }
+
+    size_t size = st.st_size;
+    void *address = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+
+    if ( address == MAP_FAILED )
+    {
+        return AbcA::ArraySamplePtr();
+    }
+
+    const EntryHeader *header = static_cast<const EntryHeader *>( address );
+
+    // Entries are never changed once they are renamed into place, so
+    // anything that doesn't add up wasn't written by this version.
+    bool valid = memcmp( header->magic, kEntryMagic, 8 ) == 0 &&
+        header->numBytes == iKey.numBytes &&
+        header->digest == iKey.digest &&
+        header->origPOD == ( uint32_t ) iKey.origPOD &&
+        header->readPOD == ( uint32_t ) iKey.readPOD &&
+        header->pod < ( uint32_t ) kNumPlainOldDataTypes &&
+        header->pod != ( uint32_t ) kStringPOD &&
+        header->pod != ( uint32_t ) kWstringPOD &&
+        header->extent > 0 && header->extent < 256 &&
+        header->rank > 0 && EntryDataOffset( header->rank ) <= size;
+
+    AbcA::DataType dataType;
+    Dimensions dims;
+    size_t dataOffset = 0;
+
+    if ( valid )
+    {
+        dataType = AbcA::DataType( ( PlainOldDataType ) header->pod,
+                                   ( uint8_t ) header->extent );
+
+        const uint64_t *dimsData =
+            reinterpret_cast<const uint64_t *>( header + 1 );
+        dims.setRank( header->rank );
+        for ( uint32_t i = 0; i < header->rank; ++i )
+        {
+            dims[i] = dimsData[i];
+        }
+
+        dataOffset = EntryDataOffset( header->rank );
+        valid = dataOffset + dataType.getNumBytes() * dims.numPoints() ==
+            size;
+    }
+
+    if ( !valid )
+    {
+        munmap( address, size );
+        unlink( path.c_str() );
+        return AbcA::ArraySamplePtr();
+    }
+
+    // Bring it up to date, so it's the last to be evicted.
+    utime( path.c_str(), NULL );
+
+    const char *data = static_cast<const char *>( address ) + dataOffset;
+    return AbcA::ArraySamplePtr(
+        new AbcA::ArraySample( data, dataType, dims ),
+        MappedSampleDeleter( address, size ) );
+}
+
+//-*****************************************************************************
+void DiskCacheImpl::write( const AbcA::ArraySample::Key &iKey,
+                           const AbcA::ArraySample &iSamp )
+{
+    std::string path = entryPath( iKey );
+
+    // Another process might already have written it.
+    struct stat st;
+    if ( stat( path.c_str(), &st ) == 0 )
+    {
+        return;
+    }
+
+    uint64_t tempIndex = 0;
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        tempIndex = m_numWritten++;
+    }
+
+    std::ostringstream strm;
+    strm << m_directory << "/" << kTempPrefix << getpid() << "."
+         << ( size_t ) this << "." << tempIndex;
+    std::string tempPath = strm.str();
+
+    FILE *file = fopen( tempPath.c_str(), "wb" );
+    if ( !file )
+    {
+        return;
+    }
+
+    const Dimensions &dims = iSamp.getDimensions();
+    const AbcA::DataType &dataType = iSamp.getDataType();
+
+    EntryHeader header;
+    memcpy( header.magic, kEntryMagic, 8 );
+    header.numBytes = iKey.numBytes;
+    header.digest = iKey.digest;
+    header.origPOD = iKey.origPOD;
+    header.readPOD = iKey.readPOD;
+    header.pod = dataType.getPod();
+    header.extent = dataType.getExtent();
+    header.rank = dims.rank();
+    header.unused = 0;
+
+    std::vector<uint64_t> dimsData( dims.rank() );
+    for ( size_t i = 0; i < dims.rank(); ++i )
+    {
+        dimsData[i] = dims[i];
+    }
+
+    size_t dataOffset = EntryDataOffset( dims.rank() );
+    size_t numPadding = dataOffset - sizeof( EntryHeader ) -
+        dimsData.size() * sizeof( uint64_t );
+    char padding[kEntryAlignment] = { 0 };
+
+    size_t dataBytes = dataType.getNumBytes() * dims.numPoints();
+
+    bool ok =
+        fwrite( &header, sizeof( EntryHeader ), 1, file ) == 1 &&
+        fwrite( &dimsData.front(), sizeof( uint64_t ), dimsData.size(),
+                file ) == dimsData.size() &&
+        fwrite( padding, 1, numPadding, file ) == numPadding &&
+        fwrite( iSamp.getData(), 1, dataBytes, file ) == dataBytes;
+
+    // A cache that can't be written to, because the disk is full for
+    // instance, only means reading from the archive again.
+    ok = ( fclose( file ) == 0 ) && ok;
+    if ( !ok || rename( tempPath.c_str(), path.c_str() ) != 0 )
+    {
+        unlink( tempPath.c_str() );
+        return;
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_numBytes += dataOffset + dataBytes;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
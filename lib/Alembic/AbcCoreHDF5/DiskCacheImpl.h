@@ -0,0 +1,115 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_DiskCacheImpl_h_
+#define _Alembic_AbcCoreHDF5_DiskCacheImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+
+#include <boost/thread/mutex.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A second level array sample cache, kept as one file per sample in a
+//! directory on a local disk, in front of which sits an ordinary memory
+//! cache. See CreateDiskCache in ReadWrite.h.
+//!
+//! Entries are written to a temporary file and renamed into place, so any
+//! number of processes can share the directory: a reader either finds a
+//! complete entry or none at all. Found entries are memory mapped rather
+//! than read, and evicting one that is mapped elsewhere only unlinks it.
+//! The directory is kept under its size limit least recently used first,
+//! by file modification time, which a hit brings up to date.
+//!
+//! Only the memory cache and the byte counts are locked. Entries are
+//! loaded, written and trimmed without the lock, which the temporary file
+//! and rename make as safe between threads as between processes, so that
+//! a thread writing a large sample doesn't hold up every other reader.
+class DiskCacheImpl : public AbcA::ReadArraySampleCache
+{
+public:
+    DiskCacheImpl( const std::string &iDirectory,
+                   uint64_t iMaxBytes,
+                   AbcA::ReadArraySampleCachePtr iMemoryCache );
+
+    virtual ~DiskCacheImpl();
+
+    virtual AbcA::ReadArraySampleID
+    find( const AbcA::ArraySample::Key &iKey );
+
+    virtual AbcA::ReadArraySampleID
+    store( const AbcA::ArraySample::Key &iKey,
+           AbcA::ArraySamplePtr iSamp );
+
+    const std::string &getDirectory() const { return m_directory; }
+
+    //! Bytes of entries in the directory, as of the last time it was
+    //! scanned plus what this cache has written since.
+    uint64_t getNumBytes();
+
+    //! Removes the least recently used entries until the directory is
+    //! under iMaxBytes.
+    void trim( uint64_t iMaxBytes );
+
+private:
+    std::string entryPath( const AbcA::ArraySample::Key &iKey ) const;
+
+    AbcA::ArraySamplePtr load( const AbcA::ArraySample::Key &iKey );
+
+    void write( const AbcA::ArraySample::Key &iKey,
+                const AbcA::ArraySample &iSamp );
+
+    std::string m_directory;
+    uint64_t m_maxBytes;
+    AbcA::ReadArraySampleCachePtr m_memoryCache;
+
+    // Guards m_memoryCache and the counts below.
+    boost::mutex m_mutex;
+    uint64_t m_numBytes;
+    uint64_t m_numWritten;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,123 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+FileAccessProfile FileAccessProfile::Playback()
+{
+    FileAccessProfile ret;
+
+    // Playback reads the same chunks over and over while scrubbing, so
+    // keep plenty of them around, and evict the oldest ones first.
+    ret.rawChunkCacheSlots = 12421;
+    ret.rawChunkCacheBytes = 64 * 1024 * 1024;
+    ret.rawChunkCachePreemption = 0.25;
+
+    // Big hierarchies mean lots of object headers.
+    ret.metaDataCacheInitialBytes = 16 * 1024 * 1024;
+    ret.metaDataCacheMinBytes = 4 * 1024 * 1024;
+    ret.metaDataCacheMaxBytes = 128 * 1024 * 1024;
+
+    ret.sieveBufferBytes = 4 * 1024 * 1024;
+
+    return ret;
+}
+
+//-*****************************************************************************
+FileAccessProfile FileAccessProfile::Export()
+{
+    FileAccessProfile ret;
+
+    // Samples are written exactly once, so chunks that have been fully
+    // written can go first.
+    ret.rawChunkCacheSlots = 4099;
+    ret.rawChunkCacheBytes = 16 * 1024 * 1024;
+    ret.rawChunkCachePreemption = 1.0;
+
+    ret.metaDataCacheInitialBytes = 8 * 1024 * 1024;
+    ret.metaDataCacheMinBytes = 2 * 1024 * 1024;
+    ret.metaDataCacheMaxBytes = 64 * 1024 * 1024;
+
+    // Keep the metadata together in big blocks, and put large
+    // datasets on filesystem block boundaries.
+    ret.metaDataBlockBytes = 1024 * 1024;
+    ret.alignmentThreshold = 1024 * 1024;
+    ret.alignment = 4096;
+
+    ret.sieveBufferBytes = 1024 * 1024;
+
+    return ret;
+}
+
+//-*****************************************************************************
+FileAccessProfile FileAccessProfile::InMemory()
+{
+    FileAccessProfile ret;
+
+    ret.useCoreDriver = true;
+    ret.coreDriverIncrementBytes = 4 * 1024 * 1024;
+    ret.coreDriverBackingStore = true;
+
+    return ret;
+}
+
+//-*****************************************************************************
+FileAccessProfile FileAccessProfile::TimeMajor()
+{
+    FileAccessProfile ret = FileAccessProfile::Export();
+
+    // Samples go into the file in the order they were written, so when
+    // that's time order, padding between them only breaks up the frames.
+    ret.alignmentThreshold = 0;
+    ret.alignment = 0;
+
+    // Export already aggregates the metadata, this does the same for the
+    // samples small enough to be written between object headers.
+    ret.smallDataBlockBytes = 1024 * 1024;
+
+    ret.recordFrameIndex = true;
+
+    return ret;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,157 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_FileAccessProfile_h_
+#define _Alembic_AbcCoreHDF5_FileAccessProfile_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A FileAccessProfile bundles the tuning knobs of the HDF5 file access
+//! property list that an archive is opened or created with.
+//! Any value left at 0 means "use the libhdf5 default", so a default
+//! constructed profile behaves exactly like the plain H5P_DEFAULT open.
+//!
+//! The profile is handed to the ReadArchive or WriteArchive functor, which
+//! is in turn handed to IArchive or OArchive:
+//!
+//!     IArchive archive( ReadArchive( FileAccessProfile::Playback() ),
+//!                       "shot.abc" );
+struct FileAccessProfile
+{
+    FileAccessProfile()
+      : rawChunkCacheSlots( 0 )
+      , rawChunkCacheBytes( 0 )
+      , rawChunkCachePreemption( -1.0 )
+      , metaDataCacheInitialBytes( 0 )
+      , metaDataCacheMinBytes( 0 )
+      , metaDataCacheMaxBytes( 0 )
+      , metaDataBlockBytes( 0 )
+      , smallDataBlockBytes( 0 )
+      , sieveBufferBytes( 0 )
+      , alignmentThreshold( 0 )
+      , alignment( 0 )
+      , useCoreDriver( false )
+      , coreDriverIncrementBytes( 0 )
+      , coreDriverBackingStore( true )
+      , recordFrameIndex( false ) {}
+
+    //! Number of hash slots in the raw data chunk cache. HDF5 recommends
+    //! a prime number roughly 100 times the number of chunks that fit
+    //! in rawChunkCacheBytes.
+    size_t rawChunkCacheSlots;
+
+    //! Total size of the raw data chunk cache for each open dataset.
+    size_t rawChunkCacheBytes;
+
+    //! Chunk preemption policy, 0.0 through 1.0. Negative keeps the
+    //! default. Values near 1.0 favor evicting chunks that have been
+    //! fully read or written, which suits Alembic's write-once samples.
+    double rawChunkCachePreemption;
+
+    //! Metadata cache configuration. The metadata cache holds object
+    //! headers and B-tree nodes, which dominate when walking large
+    //! hierarchies.
+    size_t metaDataCacheInitialBytes;
+    size_t metaDataCacheMinBytes;
+    size_t metaDataCacheMaxBytes;
+
+    //! Size of the blocks metadata is aggregated into on disk. Larger
+    //! blocks keep object headers close together, which cuts seeks.
+    size_t metaDataBlockBytes;
+
+    //! Size of the blocks small raw data is aggregated into on disk.
+    //! Samples written one after another land next to each other in the
+    //! same block instead of between object headers.
+    size_t smallDataBlockBytes;
+
+    //! Size of the data sieve buffer used for partial I/O of contiguous
+    //! datasets.
+    size_t sieveBufferBytes;
+
+    //! Any file object at least alignmentThreshold bytes large will be
+    //! aligned on an address which is a multiple of alignment.
+    //! Both must be non-zero for alignment to be applied.
+    uint64_t alignmentThreshold;
+    uint64_t alignment;
+
+    //! Use the HDF5 core (in-memory) driver. The whole file is held in
+    //! memory, which is ideal for small archives that are read in full.
+    bool useCoreDriver;
+
+    //! Growth increment of the in-memory image for the core driver.
+    //! 0 selects 1MB.
+    size_t coreDriverIncrementBytes;
+
+    //! When writing with the core driver, whether the in-memory image
+    //! is flushed to the named file when the archive is closed.
+    bool coreDriverBackingStore;
+
+    //! When writing, record where in the file the samples for each time
+    //! were written, see FrameIndex.h.
+    bool recordFrameIndex;
+
+    //! A profile suited to read-heavy playback: a large chunk cache and
+    //! metadata cache so repeated frame reads stay in memory.
+    static FileAccessProfile Playback();
+
+    //! A profile suited to write-heavy export: large aggregated metadata
+    //! blocks, aligned large datasets and a chunk cache that evicts
+    //! fully written chunks first.
+    static FileAccessProfile Export();
+
+    //! A profile which keeps the whole archive in memory with the core
+    //! driver. Intended for small archives.
+    static FileAccessProfile InMemory();
+
+    //! A profile suited to writing archives that will be streamed a frame
+    //! at a time: aggregated metadata and small data blocks, no alignment
+    //! padding, and a frame index. Used by RepackArchive.
+    static FileAccessProfile TimeMajor();
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
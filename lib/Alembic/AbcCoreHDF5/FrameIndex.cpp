@@ -0,0 +1,147 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
+#include <Alembic/AbcCoreHDF5/HDF5Util.h>
+
+#include <fstream>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+static const size_t kPrefetchBlockBytes = 4 * 1024 * 1024;
+
+//-*****************************************************************************
+static bool FrameExtentTimeLess( const FrameExtent &iA,
+                                 const FrameExtent &iB )
+{
+    return iA.time < iB.time;
+}
+
+//-*****************************************************************************
+bool ReadFrameIndex( const std::string &iFileName, FrameIndex &oIndex )
+{
+    oIndex.clear();
+
+    htri_t exi = H5Fis_hdf5( iFileName.c_str() );
+    ABCA_ASSERT( exi == 1, "Nonexistent File: " << iFileName );
+
+    hid_t file = H5Fopen( iFileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+    ABCA_ASSERT( file >= 0, "Could not open file: " << iFileName );
+
+    bool found = ReadFrameIndex( file, oIndex );
+
+    H5Fclose( file );
+
+    return found;
+}
+
+//-*****************************************************************************
+FramePrefetcher::FramePrefetcher( const std::string &iFileName )
+  : m_fileName( iFileName )
+{
+    ReadFrameIndex( m_fileName, m_index );
+}
+
+//-*****************************************************************************
+size_t FramePrefetcher::prefetch( AbcCoreAbstract::chrono_t iTime )
+{
+    if ( m_index.empty() )
+    {
+        return 0;
+    }
+
+    // Find the nearest indexed time.
+    FrameIndex::const_iterator it =
+        std::lower_bound( m_index.begin(), m_index.end(),
+                          FrameExtent( iTime, 0, 0 ), FrameExtentTimeLess );
+
+    if ( it == m_index.end() )
+    {
+        --it;
+    }
+
+    if ( it != m_index.begin() )
+    {
+        FrameIndex::const_iterator prev = it - 1;
+        if ( iTime - prev->time <= it->time - iTime )
+        {
+            it = prev;
+        }
+    }
+
+    AbcCoreAbstract::chrono_t frameTime = it->time;
+
+    // The nearest time may be any of its extents, go back to the first.
+    while ( it != m_index.begin() && ( it - 1 )->time == frameTime )
+    {
+        --it;
+    }
+
+    std::ifstream file( m_fileName.c_str(), std::ios::in | std::ios::binary );
+    if ( !file )
+    {
+        return 0;
+    }
+
+    m_buffer.resize( kPrefetchBlockBytes );
+
+    size_t numRead = 0;
+    for ( ; it != m_index.end() && it->time == frameTime; ++it )
+    {
+        file.clear();
+        file.seekg( it->offset );
+
+        Util::uint64_t left = it->size;
+        while ( left > 0 && file )
+        {
+            size_t toRead = std::min<Util::uint64_t>( left, m_buffer.size() );
+            file.read( &m_buffer.front(), toRead );
+
+            numRead += file.gcount();
+            left -= toRead;
+        }
+    }
+
+    return numRead;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,125 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_FrameIndex_h_
+#define _Alembic_AbcCoreHDF5_FrameIndex_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A frame index records where in the file the samples written for each
+//! time are, so that a player can pull a whole frame of a scene into
+//! memory with a few large sequential reads before walking the hierarchy,
+//! rather than with one small read per property.
+//!
+//! It is written by archives created with a FileAccessProfile that has
+//! recordFrameIndex set, such as FileAccessProfile::TimeMajor(). Written
+//! in the usual object by object order, a frame is scattered all over
+//! the file and its index has many extents. Rewritten in time order with
+//! RepackArchive, each frame is only one or a few.
+//!
+//! Only the uncompressed array samples which are stored in a dataset of
+//! their own are indexed. Scalar samples live in the object headers, and
+//! compressed, delta encoded and quantized samples are chunked, which
+//! HDF5 doesn't give a single address for.
+struct FrameExtent
+{
+    FrameExtent() : time( 0.0 ), offset( 0 ), size( 0 ) {}
+
+    FrameExtent( AbcCoreAbstract::chrono_t iTime,
+                 Util::uint64_t iOffset,
+                 Util::uint64_t iSize )
+      : time( iTime ), offset( iOffset ), size( iSize ) {}
+
+    AbcCoreAbstract::chrono_t time;
+
+    //! Byte offset into the file, and how many bytes from there.
+    Util::uint64_t offset;
+    Util::uint64_t size;
+};
+
+//! Sorted by time, and then by offset.
+typedef std::vector<FrameExtent> FrameIndex;
+
+//-*****************************************************************************
+//! Reads the frame index of the archive iFileName into oIndex.
+//! Returns false if the archive doesn't have one.
+bool ReadFrameIndex( const std::string &iFileName, FrameIndex &oIndex );
+
+//-*****************************************************************************
+//! Reads the frames of an archive with a frame index straight from the
+//! file, so that the operating system has them cached by the time the
+//! archive asks for them. Use it alongside the IArchive, from the thread
+//! that's about to read the frame or from one running ahead of it:
+//!
+//!     FramePrefetcher prefetcher( "shot.abc" );
+//!     IArchive archive( ReadArchive(), "shot.abc" );
+//!     ...
+//!     prefetcher.prefetch( time );
+//!     drawScene( archive, time );
+class FramePrefetcher
+{
+public:
+    explicit FramePrefetcher( const std::string &iFileName );
+
+    //! Whether the archive has a frame index. If it doesn't, prefetch
+    //! does nothing.
+    bool hasIndex() const { return !m_index.empty(); }
+
+    const FrameIndex &getIndex() const { return m_index; }
+
+    //! Reads the extents of the indexed time nearest to iTime, and
+    //! returns how many bytes were read.
+    size_t prefetch( AbcCoreAbstract::chrono_t iTime );
+
+private:
+    std::string m_fileName;
+    FrameIndex m_index;
+    std::vector<char> m_buffer;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
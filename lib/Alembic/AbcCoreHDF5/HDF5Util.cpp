@@ -90,6 +90,176 @@ hid_t DsetGzipCreatePlist( const Dimensions &dims, int level )
     return ID;
 }
 
+//-*****************************************************************************
+//-*****************************************************************************
+// FILE ACCESS TUNING
+//-*****************************************************************************
+//-*****************************************************************************
+// The limits libhdf5 enforces on the metadata cache size. These aren't
+// exported in the public headers.
+static const size_t kMaxMetaDataCacheBytes = 128 * 1024 * 1024;
+static const size_t kMinMetaDataCacheBytes = 1024;
+
+//-*****************************************************************************
+static void SetMetaDataCache( hid_t iPlist, const FileAccessProfile &iProfile )
+{
+    if ( iProfile.metaDataCacheInitialBytes == 0 &&
+         iProfile.metaDataCacheMinBytes == 0 &&
+         iProfile.metaDataCacheMaxBytes == 0 )
+    {
+        return;
+    }
+
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    herr_t status = H5Pget_mdc_config( iPlist, &config );
+    ABCA_ASSERT( status >= 0,
+                 "FileAccessPlist: H5Pget_mdc_config() failed" );
+
+    // Anything that wasn't given comes from the current configuration.
+    size_t minSize = iProfile.metaDataCacheMinBytes > 0 ?
+        iProfile.metaDataCacheMinBytes : config.min_size;
+    size_t maxSize = iProfile.metaDataCacheMaxBytes > 0 ?
+        iProfile.metaDataCacheMaxBytes : config.max_size;
+    size_t initSize = iProfile.metaDataCacheInitialBytes > 0 ?
+        iProfile.metaDataCacheInitialBytes : config.initial_size;
+
+    // HDF5 rejects configurations outside of its hard limits, or where
+    // min <= initial <= max doesn't hold.
+    maxSize = std::min( maxSize, kMaxMetaDataCacheBytes );
+    minSize = std::max( minSize, kMinMetaDataCacheBytes );
+    minSize = std::min( minSize, maxSize );
+    initSize = std::max( minSize, std::min( initSize, maxSize ) );
+
+    config.set_initial_size = true;
+    config.initial_size = initSize;
+    config.min_size = minSize;
+    config.max_size = maxSize;
+
+    status = H5Pset_mdc_config( iPlist, &config );
+    ABCA_ASSERT( status >= 0,
+                 "FileAccessPlist: H5Pset_mdc_config() failed" );
+}
+
+//-*****************************************************************************
+hid_t FileAccessPlist( const FileAccessProfile &iProfile, bool iForWriting )
+{
+    herr_t status;
+    hid_t ID = H5Pcreate( H5P_FILE_ACCESS );
+    ABCA_ASSERT( ID >= 0,
+                 "FileAccessPlist: H5Pcreate() failed" );
+
+    if ( iForWriting )
+    {
+        status = H5Pset_libver_bounds( ID, H5F_LIBVER_LATEST,
+                                       H5F_LIBVER_LATEST );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_libver_bounds() failed" );
+    }
+
+    if ( iProfile.rawChunkCacheSlots > 0 ||
+         iProfile.rawChunkCacheBytes > 0 ||
+         iProfile.rawChunkCachePreemption >= 0.0 )
+    {
+        int mdcElems = 0;
+        size_t slots = 0;
+        size_t bytes = 0;
+        double w0 = 0.0;
+        status = H5Pget_cache( ID, &mdcElems, &slots, &bytes, &w0 );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pget_cache() failed" );
+
+        if ( iProfile.rawChunkCacheSlots > 0 )
+        { slots = iProfile.rawChunkCacheSlots; }
+
+        if ( iProfile.rawChunkCacheBytes > 0 )
+        { bytes = iProfile.rawChunkCacheBytes; }
+
+        if ( iProfile.rawChunkCachePreemption >= 0.0 )
+        { w0 = std::min( iProfile.rawChunkCachePreemption, 1.0 ); }
+
+        status = H5Pset_cache( ID, mdcElems, slots, bytes, w0 );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_cache() failed" );
+    }
+
+    SetMetaDataCache( ID, iProfile );
+
+    if ( iProfile.sieveBufferBytes > 0 )
+    {
+        status = H5Pset_sieve_buf_size( ID, iProfile.sieveBufferBytes );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_sieve_buf_size() failed" );
+    }
+
+    // These only affect where things get allocated, so they only mean
+    // something when writing.
+    if ( iForWriting && iProfile.metaDataBlockBytes > 0 )
+    {
+        status = H5Pset_meta_block_size( ID, iProfile.metaDataBlockBytes );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_meta_block_size() failed" );
+    }
+
+    if ( iForWriting && iProfile.smallDataBlockBytes > 0 )
+    {
+        status = H5Pset_small_data_block_size( ID,
+                                               iProfile.smallDataBlockBytes );
+        ABCA_ASSERT( status >= 0,
+            "FileAccessPlist: H5Pset_small_data_block_size() failed" );
+    }
+
+    if ( iForWriting && iProfile.alignmentThreshold > 0 &&
+         iProfile.alignment > 0 )
+    {
+        status = H5Pset_alignment( ID, iProfile.alignmentThreshold,
+                                   iProfile.alignment );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_alignment() failed" );
+    }
+
+    if ( iProfile.useCoreDriver )
+    {
+        size_t increment = iProfile.coreDriverIncrementBytes > 0 ?
+            iProfile.coreDriverIncrementBytes : 1024 * 1024;
+
+        // a reader never writes back
+        status = H5Pset_fapl_core( ID, increment,
+            iForWriting && iProfile.coreDriverBackingStore );
+        ABCA_ASSERT( status >= 0,
+                     "FileAccessPlist: H5Pset_fapl_core() failed" );
+    }
+
+    return ID;
+}
+
+//-*****************************************************************************
+const char *kFrameIndexName = "abc_frame_index";
+
+//-*****************************************************************************
+hid_t FrameExtentType()
+{
+    hid_t ID = H5Tcreate( H5T_COMPOUND, sizeof( FrameExtent ) );
+    ABCA_ASSERT( ID >= 0, "FrameExtentType: H5Tcreate() failed" );
+
+    herr_t status = H5Tinsert( ID, "time", HOFFSET( FrameExtent, time ),
+                               H5T_NATIVE_DOUBLE );
+    status = std::min( status,
+        H5Tinsert( ID, "offset", HOFFSET( FrameExtent, offset ),
+                   H5T_NATIVE_UINT64 ) );
+    status = std::min( status,
+        H5Tinsert( ID, "size", HOFFSET( FrameExtent, size ),
+                   H5T_NATIVE_UINT64 ) );
+
+    if ( status < 0 )
+    {
+        H5Tclose( ID );
+        ABCA_THROW( "FrameExtentType: H5Tinsert() failed" );
+    }
+
+    return ID;
+}
+
 //-*****************************************************************************
 bool EquivalentDatatypes( hid_t iA, hid_t iB )
 {
@@ -38,6 +38,8 @@
 #define _Alembic_AbcCoreHDF5_HDF5Util_h_
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -99,6 +101,18 @@ struct PlistCloser
 hid_t CreationOrderPlist();
 hid_t DsetGzipCreatePlist( const Dimensions &dims, int level );
 
+//! Creates a file access property list configured from iProfile.
+//! iForWriting adds the settings only meaningful at file creation.
+//! The caller is responsible for closing it.
+hid_t FileAccessPlist( const FileAccessProfile &iProfile, bool iForWriting );
+
+//-*****************************************************************************
+//! The name of the dataset at the root of the file that holds the frame
+//! index, and the compound type a FrameExtent is stored as.
+//! The caller is responsible for closing the type.
+extern const char *kFrameIndexName;
+hid_t FrameExtentType();
+
 //-*****************************************************************************
 bool EquivalentDatatypes( hid_t idA, hid_t idB );
 
@@ -0,0 +1,263 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/HalfCodec.h>
+#include <Alembic/AbcCoreHDF5/DataTypeRegistry.h>
+#include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
+#include <Alembic/AbcCoreHDF5/HDF5Util.h>
+
+#include <half.h>
+
+#include <float.h>
+#include <math.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Whether every finite value fits in a half. Infinities and NaNs carry
+// over as they are.
+static bool FitsHalf( const float32_t *iVals, size_t iNumVals )
+{
+    bool fits = true;
+    for ( size_t i = 0; i < iNumVals; ++i )
+    {
+        float32_t v = fabsf( iVals[i] );
+        fits &= !( v > HALF_MAX && v <= FLT_MAX );
+    }
+    return fits;
+}
+
+//-*****************************************************************************
+WrittenArraySampleIDPtr
+WriteHalfArray( WrittenArraySampleMap &iMap,
+                hid_t iGroup,
+                const std::string &iName,
+                const AbcA::ArraySample &iSamp,
+                const AbcA::ArraySample::Key &iKey,
+                int iCompressionLevel,
+                AbcA::ArraySamplePtr &oRebuilt )
+{
+    const AbcA::DataType &dataType = iSamp.getDataType();
+    const Dimensions &dims = iSamp.getDimensions();
+    size_t numVals = dims.numPoints() * dataType.getExtent();
+
+    if ( numVals == 0 || dims.rank() == 0 ||
+         dataType.getPod() != kFloat32POD ||
+         !FitsHalf( static_cast<const float32_t *>( iSamp.getData() ),
+                    numVals ) )
+    {
+        return WrittenArraySampleIDPtr();
+    }
+
+    AbcA::ArraySamplePtr halfs =
+        AbcA::ConvertArraySample( iSamp, kFloat16POD );
+    AbcA::ArraySamplePtr rebuilt =
+        AbcA::ConvertArraySample( *halfs, kFloat32POD );
+
+    if ( dims.rank() > 1 )
+    {
+        WriteDimensions( iGroup, iName + ".dims", dims );
+    }
+
+    AbcA::ArraySample::Key mapKey = iKey;
+    mapKey.origPOD = kFloat16POD;
+    mapKey.readPOD = kFloat16POD;
+
+    WrittenArraySampleIDPtr mapID = iMap.find( mapKey );
+    if ( mapID )
+    {
+        CopyWrittenArray( iGroup, iName, mapID );
+
+        hid_t dsetId = H5Dopen( iGroup, iName.c_str(), H5P_DEFAULT );
+        ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iName );
+        DsetCloser dsetCloser( dsetId );
+
+        oRebuilt = rebuilt;
+        return WrittenArraySampleIDPtr(
+            new WrittenArraySampleID( iKey, dsetId ) );
+    }
+
+    AbcA::DataType halfType( kFloat16POD, 1 );
+    bool cleanFile = false;
+    hid_t fileType = GetFileH5T( halfType, cleanFile );
+    bool cleanNative = false;
+    hid_t nativeType = GetNativeH5T( halfType, cleanNative );
+
+    hsize_t hdim = numVals;
+    hid_t dspaceId = H5Screate_simple( 1, &hdim, NULL );
+    ABCA_ASSERT( dspaceId >= 0,
+                 "WriteHalfArray() Failed in dataspace construction" );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    hid_t dsetId = -1;
+    if ( iCompressionLevel >= 0 )
+    {
+        hid_t zipPlist = DsetGzipCreatePlist( dims,
+            iCompressionLevel > 9 ? 9 : iCompressionLevel );
+        PlistCloser plistCloser( zipPlist );
+
+        dsetId = H5Dcreate2( iGroup, iName.c_str(), fileType, dspaceId,
+                             H5P_DEFAULT, zipPlist, H5P_DEFAULT );
+    }
+    else
+    {
+        dsetId = H5Dcreate2( iGroup, iName.c_str(), fileType, dspaceId,
+                             H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+    }
+
+    herr_t status = -1;
+    if ( dsetId >= 0 )
+    {
+        status = StatsH5Dwrite( dsetId, nativeType, halfs->getData() );
+    }
+
+    if ( cleanFile ) { H5Tclose( fileType ); }
+    if ( cleanNative ) { H5Tclose( nativeType ); }
+
+    ABCA_ASSERT( dsetId >= 0,
+                 "WriteHalfArray() Failed in dataset constructor" );
+    DsetCloser dsetCloser( dsetId );
+    ABCA_ASSERT( status >= 0, "WriteHalfArray() H5Dwrite failed: " << iName );
+
+    WriteKey( dsetId, "key", rebuilt->getKey() );
+
+    iMap.store( WrittenArraySampleIDPtr(
+        new WrittenArraySampleID( mapKey, dsetId ) ) );
+
+    oRebuilt = rebuilt;
+    return WrittenArraySampleIDPtr( new WrittenArraySampleID( iKey, dsetId ) );
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+ReadHalfArray( AbcA::ReadArraySampleCachePtr iCache,
+               hid_t iGroup,
+               const std::string &iName,
+               const AbcA::DataType &iDataType )
+{
+    hid_t dsetId = H5Dopen( iGroup, iName.c_str(), H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iName );
+    DsetCloser dsetCloser( dsetId );
+
+    {
+        hid_t dtypeId = H5Dget_type( dsetId );
+        ABCA_ASSERT( dtypeId >= 0, "Could not get datatype for dataSet: "
+                     << iName );
+        DtypeCloser dtypeCloser( dtypeId );
+
+        if ( H5Tget_class( dtypeId ) != H5T_FLOAT ||
+             H5Tget_size( dtypeId ) != 2 )
+        {
+            return AbcA::ArraySamplePtr();
+        }
+    }
+
+    hid_t dspaceId = H5Dget_space( dsetId );
+    ABCA_ASSERT( dspaceId >= 0, "Could not get dataspace for dataSet: "
+                 << iName );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    size_t numVals = H5Sget_simple_extent_npoints( dspaceId );
+    size_t extent = iDataType.getExtent();
+
+    // the same key lookup as ReadArray
+    AbcA::ArraySample::Key key;
+    bool foundDigest = false;
+    if ( iCache )
+    {
+        key.origPOD = iDataType.getPod();
+        key.readPOD = key.origPOD;
+        key.numBytes = iDataType.getNumBytes() * numVals;
+
+        foundDigest = ReadKey( dsetId, "key", key );
+
+        AbcA::ReadArraySampleID found = iCache->find( key );
+        CountCacheLookup( found );
+        if ( found )
+        {
+            return found.getSample();
+        }
+    }
+
+    Dimensions dims;
+    std::string dimName = iName + ".dims";
+    if ( H5Aexists( iGroup, dimName.c_str() ) )
+    {
+        ReadDimensions( iGroup, dimName, dims );
+    }
+    else
+    {
+        dims.setRank( 1 );
+        dims[0] = numVals / extent;
+    }
+    ABCA_ASSERT( dims.numPoints() * extent == numVals,
+                 "Half dataset doesn't match its dimensions: " << iName );
+
+    AbcA::ArraySamplePtr halfs = AbcA::AllocateArraySample(
+        AbcA::DataType( kFloat16POD, extent ), dims );
+
+    bool cleanNative = false;
+    hid_t nativeType = GetNativeH5T( AbcA::DataType( kFloat16POD, 1 ),
+                                     cleanNative );
+    herr_t status = StatsH5Dread( dsetId, nativeType,
+                                  const_cast<void *>( halfs->getData() ) );
+    if ( cleanNative ) { H5Tclose( nativeType ); }
+    ABCA_ASSERT( status >= 0, "H5Dread() failed: " << iName );
+
+    AbcA::ArraySamplePtr ret;
+    {
+        StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+        ret = AbcA::ConvertArraySample( *halfs, iDataType.getPod() );
+    }
+
+    if ( foundDigest && iCache )
+    {
+        AbcA::ReadArraySampleID stored = iCache->store( key, ret );
+        if ( stored )
+        {
+            return stored.getSample();
+        }
+    }
+
+    return ret;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,87 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_HalfCodec_h_
+#define _Alembic_AbcCoreHDF5_HalfCodec_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Half stored array samples (see HalfStorage.h) are datasets of the same
+// float16 file type as kFloat16POD properties, under float32 properties.
+// Readers tell them apart from float32 datasets by their 2 byte type.
+//
+// The key on the dataset is that of the float32 sample readers get back.
+// Half stored datasets are shared through the WrittenArraySampleMap under
+// the key of the sample written with its PODs set to kFloat16POD, so that
+// they are only ever linked to from other half stored properties.
+//-*****************************************************************************
+
+//-*****************************************************************************
+// Writes the float32 sample iSamp as halfs. Returns an invalid pointer if
+// it can't be, in which case nothing was written. Otherwise oRebuilt is
+// set to the sample that readers will get back.
+WrittenArraySampleIDPtr
+WriteHalfArray( WrittenArraySampleMap &iMap,
+                hid_t iGroup,
+                const std::string &iName,
+                const AbcA::ArraySample &iSamp,
+                const AbcA::ArraySample::Key &iKey,
+                int iCompressionLevel,
+                AbcA::ArraySamplePtr &oRebuilt );
+
+//-*****************************************************************************
+// Reads the half stored dataset iName as float32, returning an invalid
+// pointer if iName isn't stored as halfs.
+AbcA::ArraySamplePtr
+ReadHalfArray( AbcA::ReadArraySampleCachePtr iCache,
+               hid_t iGroup,
+               const std::string &iName,
+               const AbcA::DataType &iDataType );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,79 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_HalfStorage_h_
+#define _Alembic_AbcCoreHDF5_HalfStorage_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Half storage writes float32 array properties, such as normals, uvs and
+//! colors, to the file as float16, halving their size. The property's
+//! DataType stays float32, so readers get float32 samples back through the
+//! same typed properties as before, converted from the stored halfs.
+//!
+//! It is turned on through MetaData. Set on a property's MetaData, it
+//! applies to that property:
+//!
+//!     AbcA::MetaData md;
+//!     SetHalfStorage( md );
+//!     ON3fGeomParam N( params, "N", false, kFacevaryingScope, 1, md );
+//!
+//! Set on the MetaData an OArchive is created with, it applies to every
+//! float32 geom param in the archive that is a normal, a color, or a two
+//! component vector such as a uv. Positions and other arrays are left as
+//! they are.
+//!
+//! Samples with finite values too large for a half are stored as float32.
+//! Combined with delta encoding, it applies to the keyframes. Quantization
+//! takes precedence over it where both are set.
+void SetHalfStorage( AbcCoreAbstract::MetaData &ioMetaData );
+
+//! Returns whether iMetaData turns on half storage.
+bool GetHalfStorage( const AbcCoreAbstract::MetaData &iMetaData );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
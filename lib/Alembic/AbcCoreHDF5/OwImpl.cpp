@@ -48,7 +48,8 @@ namespace ALEMBIC_VERSION_NS {
 OwImpl::OwImpl( AbcA::ObjectWriterPtr iParent,
                 hid_t iParentGroup,
                 ObjectHeaderPtr iHeader )
-  : BaseOwImpl( iParentGroup, iHeader->getName(), iHeader->getMetaData() )
+  : BaseOwImpl( GetWriteMutex( iParent->getArchive() ), iParentGroup,
+                iHeader->getName(), iHeader->getMetaData() )
   , m_parent( iParent )
   , m_header( iHeader )
 {
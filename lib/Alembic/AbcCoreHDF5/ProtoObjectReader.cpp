@@ -44,7 +44,9 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 ProtoObjectReader::ProtoObjectReader( hid_t iParent,
                                       const std::string &iParentFullPathName,
-                                      const std::string &iName )
+                                      const std::string &iName,
+                                      const std::string &iInstanceSource )
+  : m_instanceSource( iInstanceSource )
 {
     // Validate.
     ABCA_ASSERT( iParent >= 0,
@@ -49,17 +49,24 @@ class ProtoObjectReader : private boost::noncopyable
 public:
     ProtoObjectReader( hid_t iParentProperty,
                        const std::string &iParentFullPathName,
-                       const std::string &iName );
+                       const std::string &iName,
+                       const std::string &iInstanceSource = "" );
     ~ProtoObjectReader();
 
     hid_t getGroup() const { return m_group; }
 
     const AbcA::ObjectHeader &getHeader() const { return m_header; }
 
+    // The full name of the object this one is an instance of, or empty.
+    const std::string &getInstanceSource() const
+    { return m_instanceSource; }
+
 protected:
     hid_t m_group;
 
     AbcA::ObjectHeader m_header;
+
+    std::string m_instanceSource;
 };
 
 //-*****************************************************************************
@@ -68,11 +75,13 @@ typedef boost::shared_ptr<ProtoObjectReader> ProtoObjectReaderPtr;
 inline ProtoObjectReaderPtr
 MakeProtoObjectReaderPtr( hid_t iParentProperty,
                           const std::string &iParentFullPathName,
-                          const std::string &iName )
+                          const std::string &iName,
+                          const std::string &iInstanceSource = "" )
 {
     return boost::make_shared<ProtoObjectReader>( iParentProperty,
                                                   iParentFullPathName,
-                                                  iName );
+                                                  iName,
+                                                  iInstanceSource );
 }
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -0,0 +1,80 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_Quantization_h_
+#define _Alembic_AbcCoreHDF5_Quantization_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Quantization is a lossy codec for float32 and float64 array properties,
+//! such as particle positions, velocities and widths. Each sample's values
+//! are stored as integers counting steps of just under twice the tolerance
+//! up from the sample's minimum, per component, and packed into just as
+//! many bits as the sample's range needs. Readers rebuild the floats
+//! transparently, and every value read back is within iTolerance of the
+//! value written.
+//!
+//! It is turned on through the MetaData the property is created with:
+//!
+//!     AbcA::MetaData md;
+//!     SetQuantization( md, 0.001 );
+//!     OV3fArrayProperty v( props, "v", md, tsidx );
+//!
+//! Samples with values that aren't finite, or whose range can't be
+//! covered in 32 bits at this tolerance, are stored losslessly.
+//! Quantization can be combined with delta encoding (see DeltaEncoding.h),
+//! in which case it applies to the keyframes.
+void SetQuantization( AbcCoreAbstract::MetaData &ioMetaData,
+                      Util::float64_t iTolerance );
+
+//! Returns whether iMetaData turns on quantization, and if so fills in
+//! its tolerance.
+bool GetQuantization( const AbcCoreAbstract::MetaData &iMetaData,
+                      Util::float64_t &oTolerance );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,431 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/QuantizeCodec.h>
+#include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
+#include <Alembic/AbcCoreHDF5/HDF5Util.h>
+
+#include <limits>
+
+#include <float.h>
+#include <math.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The largest integer we quantize to, so it always fits the uint32 we
+// store it in.
+static const float64_t g_maxQuantized = 4294967295.0;
+
+//-*****************************************************************************
+// With the extent known at compile time the inner loop unrolls, leaving
+// one multiply-add per value that the compiler vectorizes.
+template <class T, size_t EXTENT>
+static void DequantizeFixed( const uint32_t *iQuantized, size_t iNumPoints,
+                             const float64_t *iMin, float64_t iStep,
+                             T *oVals )
+{
+    for ( size_t p = 0; p < iNumPoints; ++p )
+    {
+        for ( size_t c = 0; c < EXTENT; ++c )
+        {
+            oVals[c] = static_cast<T>( iMin[c] + iQuantized[c] * iStep );
+        }
+        iQuantized += EXTENT;
+        oVals += EXTENT;
+    }
+}
+
+//-*****************************************************************************
+// Writers rebuild their samples through this too, so that what they check
+// against the tolerance is exactly what readers get.
+template <class T>
+static void Dequantize( const uint32_t *iQuantized, size_t iNumPoints,
+                        size_t iExtent, const float64_t *iMin,
+                        float64_t iStep, T *oVals )
+{
+    switch ( iExtent )
+    {
+    case 1:
+        DequantizeFixed<T, 1>( iQuantized, iNumPoints, iMin, iStep, oVals );
+        return;
+    case 2:
+        DequantizeFixed<T, 2>( iQuantized, iNumPoints, iMin, iStep, oVals );
+        return;
+    case 3:
+        DequantizeFixed<T, 3>( iQuantized, iNumPoints, iMin, iStep, oVals );
+        return;
+    case 4:
+        DequantizeFixed<T, 4>( iQuantized, iNumPoints, iMin, iStep, oVals );
+        return;
+    default:
+        break;
+    }
+
+    size_t numVals = iNumPoints * iExtent;
+    for ( size_t i = 0; i < numVals; ++i )
+    {
+        oVals[i] = static_cast<T>( iMin[i % iExtent] + iQuantized[i] * iStep );
+    }
+}
+
+//-*****************************************************************************
+// Fills in oMin, oStep, oQuantized and oRebuilt, and returns the largest
+// integer used. Returns a negative number if the sample can't be quantized.
+template <class T>
+static float64_t Quantize( const T *iVals, size_t iNumPoints, size_t iExtent,
+                           float64_t iTolerance,
+                           std::vector<float64_t> &oMin,
+                           float64_t &oStep,
+                           std::vector<uint32_t> &oQuantized,
+                           T *oRebuilt )
+{
+    size_t numVals = iNumPoints * iExtent;
+    float64_t maxAbs = 0.0;
+
+    oMin.assign( iExtent, DBL_MAX );
+    std::vector<float64_t> maxs( iExtent, -DBL_MAX );
+    for ( size_t i = 0; i < numVals; ++i )
+    {
+        float64_t v = static_cast<float64_t>( iVals[i] );
+
+        // written so that NaNs fail
+        if ( !( fabs( v ) <= DBL_MAX ) )
+        {
+            return -1.0;
+        }
+
+        size_t c = i % iExtent;
+        oMin[c] = v < oMin[c] ? v : oMin[c];
+        maxs[c] = v > maxs[c] ? v : maxs[c];
+        maxAbs = fabs( v ) > maxAbs ? fabs( v ) : maxAbs;
+    }
+
+    // Rounding to the nearest step is off by up to half a step, and
+    // rounding that back to T can add up to an epsilon more, so the step
+    // leaves room for it.
+    float64_t step = ( iTolerance -
+        maxAbs * std::numeric_limits<T>::epsilon() ) * 2.0;
+    if ( !( step > 0.0 ) )
+    {
+        return -1.0;
+    }
+
+    float64_t maxQuantized = 0.0;
+    for ( size_t c = 0; c < iExtent; ++c )
+    {
+        float64_t q = floor( ( maxs[c] - oMin[c] ) / step + 0.5 );
+        if ( !( q <= g_maxQuantized ) )
+        {
+            return -1.0;
+        }
+        maxQuantized = q > maxQuantized ? q : maxQuantized;
+    }
+
+    oQuantized.resize( numVals );
+    for ( size_t i = 0; i < numVals; ++i )
+    {
+        float64_t q = floor( ( static_cast<float64_t>( iVals[i] ) -
+                               oMin[i % iExtent] ) / step + 0.5 );
+        oQuantized[i] = static_cast<uint32_t>( q );
+    }
+
+    Dequantize( &oQuantized.front(), iNumPoints, iExtent, &oMin.front(),
+                step, oRebuilt );
+
+    for ( size_t i = 0; i < numVals; ++i )
+    {
+        if ( !( fabs( static_cast<float64_t>( oRebuilt[i] ) -
+                      static_cast<float64_t>( iVals[i] ) ) <= iTolerance ) )
+        {
+            return -1.0;
+        }
+    }
+
+    oStep = step;
+    return maxQuantized;
+}
+
+//-*****************************************************************************
+// The key quantized samples go in the WrittenArraySampleMap under, see
+// QuantizeCodec.h.
+static AbcA::ArraySample::Key QuantizedKey( const AbcA::ArraySample::Key &iKey,
+                                            float64_t iTolerance )
+{
+    uint64_t bits = 0;
+    memcpy( &bits, &iTolerance, sizeof( bits ) );
+
+    AbcA::ArraySample::Key ret = iKey;
+    ret.readPOD = kUint32POD;
+    ret.digest.words[0] ^= bits;
+    ret.digest.words[1] ^= bits * 0x9E3779B97F4A7C15ULL;
+    return ret;
+}
+
+//-*****************************************************************************
+WrittenArraySampleIDPtr
+WriteQuantizedArray( WrittenArraySampleMap &iMap,
+                     hid_t iGroup,
+                     const std::string &iName,
+                     const AbcA::ArraySample &iSamp,
+                     const AbcA::ArraySample::Key &iKey,
+                     float64_t iTolerance,
+                     int iCompressionLevel,
+                     AbcA::ArraySamplePtr &oRebuilt )
+{
+    const AbcA::DataType &dataType = iSamp.getDataType();
+    const Dimensions &dims = iSamp.getDimensions();
+    size_t extent = dataType.getExtent();
+    size_t numPoints = dims.numPoints();
+
+    if ( numPoints == 0 || dims.rank() == 0 ||
+         ( dataType.getPod() != kFloat32POD &&
+           dataType.getPod() != kFloat64POD ) )
+    {
+        return WrittenArraySampleIDPtr();
+    }
+
+    AbcA::ArraySamplePtr rebuilt = AbcA::AllocateArraySample( dataType, dims );
+    void *rebuiltData = const_cast<void *>( rebuilt->getData() );
+
+    std::vector<float64_t> mins;
+    float64_t step = 0.0;
+    std::vector<uint32_t> quantized;
+    float64_t maxQuantized = dataType.getPod() == kFloat32POD ?
+        Quantize( static_cast<const float32_t *>( iSamp.getData() ),
+                  numPoints, extent, iTolerance, mins, step, quantized,
+                  static_cast<float32_t *>( rebuiltData ) ) :
+        Quantize( static_cast<const float64_t *>( iSamp.getData() ),
+                  numPoints, extent, iTolerance, mins, step, quantized,
+                  static_cast<float64_t *>( rebuiltData ) );
+
+    if ( maxQuantized < 0.0 )
+    {
+        return WrittenArraySampleIDPtr();
+    }
+
+    size_t precision = 1;
+    while ( precision < 32 &&
+            ( ( ( uint64_t )maxQuantized ) >> precision ) != 0 )
+    {
+        ++precision;
+    }
+
+    if ( dims.rank() > 1 )
+    {
+        WriteDimensions( iGroup, iName + ".dims", dims );
+    }
+
+    AbcA::ArraySample::Key mapKey = QuantizedKey( iKey, iTolerance );
+
+    WrittenArraySampleIDPtr mapID = iMap.find( mapKey );
+    if ( mapID )
+    {
+        CopyWrittenArray( iGroup, iName, mapID );
+
+        hid_t dsetId = H5Dopen( iGroup, iName.c_str(), H5P_DEFAULT );
+        ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iName );
+        DsetCloser dsetCloser( dsetId );
+
+        oRebuilt = rebuilt;
+        return WrittenArraySampleIDPtr(
+            new WrittenArraySampleID( iKey, dsetId ) );
+    }
+
+    hsize_t hdim = quantized.size();
+    hid_t dspaceId = H5Screate_simple( 1, &hdim, NULL );
+    ABCA_ASSERT( dspaceId >= 0,
+                 "WriteQuantizedArray() Failed in dataspace construction" );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    // The N-bit filter packs each value down to the datatype's precision.
+    hid_t fileType = H5Tcopy( H5T_STD_U32LE );
+    ABCA_ASSERT( fileType >= 0, "WriteQuantizedArray() H5Tcopy failed" );
+    DtypeCloser dtypeCloser( fileType );
+    herr_t status = H5Tset_precision( fileType, precision );
+    ABCA_ASSERT( status >= 0, "WriteQuantizedArray() H5Tset_precision failed" );
+
+    hid_t plist = H5Pcreate( H5P_DATASET_CREATE );
+    ABCA_ASSERT( plist >= 0, "WriteQuantizedArray() H5Pcreate failed" );
+    PlistCloser plistCloser( plist );
+
+    status = H5Pset_chunk( plist, 1, &hdim );
+    ABCA_ASSERT( status >= 0, "WriteQuantizedArray() H5Pset_chunk failed" );
+    status = H5Pset_nbit( plist );
+    ABCA_ASSERT( status >= 0, "WriteQuantizedArray() H5Pset_nbit failed" );
+    if ( iCompressionLevel >= 0 )
+    {
+        status = H5Pset_deflate( plist, ( unsigned int )
+                                 ( iCompressionLevel > 9 ? 9 :
+                                   iCompressionLevel ) );
+        ABCA_ASSERT( status >= 0,
+                     "WriteQuantizedArray() H5Pset_deflate failed" );
+    }
+
+    hid_t dsetId = H5Dcreate2( iGroup, iName.c_str(), fileType, dspaceId,
+                               H5P_DEFAULT, plist, H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0,
+                 "WriteQuantizedArray() Failed in dataset constructor" );
+    DsetCloser dsetCloser( dsetId );
+
+    status = StatsH5Dwrite( dsetId, H5T_NATIVE_UINT32, &quantized.front() );
+    ABCA_ASSERT( status >= 0, "WriteQuantizedArray() H5Dwrite failed: "
+                 << iName );
+
+    WriteSmallArray( dsetId, "qmin", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                     extent, ( const void * )&mins.front() );
+    WriteScalar( dsetId, "qstep", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                 ( const void * )&step );
+
+    // The key on the dataset is for what readers get back, while the
+    // returned ID keeps the key of what was given, so that repeats of it
+    // are still caught.
+    WriteKey( dsetId, "key", rebuilt->getKey() );
+
+    iMap.store( WrittenArraySampleIDPtr(
+        new WrittenArraySampleID( mapKey, dsetId ) ) );
+
+    oRebuilt = rebuilt;
+    return WrittenArraySampleIDPtr( new WrittenArraySampleID( iKey, dsetId ) );
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+ReadQuantizedArray( AbcA::ReadArraySampleCachePtr iCache,
+                    hid_t iGroup,
+                    const std::string &iName,
+                    const AbcA::DataType &iDataType )
+{
+    hid_t dsetId = H5Dopen( iGroup, iName.c_str(), H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iName );
+    DsetCloser dsetCloser( dsetId );
+
+    if ( H5Aexists( dsetId, "qstep" ) <= 0 )
+    {
+        return AbcA::ArraySamplePtr();
+    }
+
+    hid_t dspaceId = H5Dget_space( dsetId );
+    ABCA_ASSERT( dspaceId >= 0, "Could not get dataspace for dataSet: "
+                 << iName );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    size_t numVals = H5Sget_simple_extent_npoints( dspaceId );
+    size_t extent = iDataType.getExtent();
+
+    // the same key lookup as ReadArray
+    AbcA::ArraySample::Key key;
+    bool foundDigest = false;
+    if ( iCache )
+    {
+        key.origPOD = iDataType.getPod();
+        key.readPOD = key.origPOD;
+        key.numBytes = iDataType.getNumBytes() * numVals;
+
+        foundDigest = ReadKey( dsetId, "key", key );
+
+        AbcA::ReadArraySampleID found = iCache->find( key );
+        CountCacheLookup( found );
+        if ( found )
+        {
+            return found.getSample();
+        }
+    }
+
+    std::vector<float64_t> mins( extent );
+    size_t numMins = 0;
+    ReadSmallArray( dsetId, "qmin", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                    extent, numMins, ( void * )&mins.front() );
+    ABCA_ASSERT( numMins == extent, "Bad quantization minimums: " << iName );
+
+    float64_t step = 0.0;
+    ReadScalar( dsetId, "qstep", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE,
+                ( void * )&step );
+
+    Dimensions dims;
+    std::string dimName = iName + ".dims";
+    if ( H5Aexists( iGroup, dimName.c_str() ) )
+    {
+        ReadDimensions( iGroup, dimName, dims );
+    }
+    else
+    {
+        dims.setRank( 1 );
+        dims[0] = numVals / extent;
+    }
+    ABCA_ASSERT( dims.numPoints() * extent == numVals,
+                 "Quantized dataset doesn't match its dimensions: " << iName );
+
+    std::vector<uint32_t> quantized( numVals );
+    herr_t status = StatsH5Dread( dsetId, H5T_NATIVE_UINT32,
+                                  &quantized.front() );
+    ABCA_ASSERT( status >= 0, "H5Dread() failed: " << iName );
+
+    StatsTimer timer( &AbcA::ArchiveStats::decompressSeconds );
+
+    AbcA::ArraySamplePtr ret = AbcA::AllocateArraySample( iDataType, dims );
+    void *data = const_cast<void *>( ret->getData() );
+    if ( iDataType.getPod() == kFloat32POD )
+    {
+        Dequantize( &quantized.front(), dims.numPoints(), extent,
+                    &mins.front(), step, static_cast<float32_t *>( data ) );
+    }
+    else
+    {
+        ABCA_ASSERT( iDataType.getPod() == kFloat64POD,
+                     "Quantized dataset isn't a float type: " << iName );
+        Dequantize( &quantized.front(), dims.numPoints(), extent,
+                    &mins.front(), step, static_cast<float64_t *>( data ) );
+    }
+
+    if ( foundDigest && iCache )
+    {
+        AbcA::ReadArraySampleID stored = iCache->store( key, ret );
+        if ( stored )
+        {
+            return stored.getSample();
+        }
+    }
+
+    return ret;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
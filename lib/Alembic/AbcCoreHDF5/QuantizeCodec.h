@@ -0,0 +1,95 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_QuantizeCodec_h_
+#define _Alembic_AbcCoreHDF5_QuantizeCodec_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Quantized array samples (see Quantization.h) are datasets of unsigned
+// integers, bit-packed by the HDF5 N-bit filter to the precision of their
+// datatype. Two attributes on the dataset record how to rebuild them:
+//
+//   qmin   float64[extent], the minimum of each component
+//   qstep  float64, the size of one integer step
+//
+// value = qmin[component] + stored * qstep
+//
+// Because the attributes are on the dataset, links to it carry them along,
+// so quantized datasets are shared through the WrittenArraySampleMap like
+// any other. They go in it under the key of the original sample with the
+// tolerance folded into its digest and a readPOD of uint32, so that they
+// only match the same sample quantized to the same tolerance.
+//-*****************************************************************************
+
+//-*****************************************************************************
+// Writes iSamp quantized to within iTolerance, or links to the dataset of
+// the same sample already written that way. Returns an invalid pointer
+// if it can't be, in which case nothing was written. Otherwise oRebuilt
+// is set to the sample that readers will get back.
+WrittenArraySampleIDPtr
+WriteQuantizedArray( WrittenArraySampleMap &iMap,
+                     hid_t iGroup,
+                     const std::string &iName,
+                     const AbcA::ArraySample &iSamp,
+                     const AbcA::ArraySample::Key &iKey,
+                     float64_t iTolerance,
+                     int iCompressionLevel,
+                     AbcA::ArraySamplePtr &oRebuilt );
+
+//-*****************************************************************************
+// Reads and rebuilds the quantized dataset iName, returning an invalid
+// pointer if iName isn't quantized.
+AbcA::ArraySamplePtr
+ReadQuantizedArray( AbcA::ReadArraySampleCachePtr iCache,
+                    hid_t iGroup,
+                    const std::string &iName,
+                    const AbcA::DataType &iDataType );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -51,6 +51,14 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 //-*****************************************************************************
 
+//-*****************************************************************************
+StatsCollectorPtr GetStatsCollector( AbcA::ArchiveReaderPtr iVal )
+{
+    ArImpl *ptr = dynamic_cast<ArImpl*>( iVal.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+    return ptr->getStatsCollector();
+}
+
 //-*****************************************************************************
 void
 ReadScalar( hid_t iParent,
@@ -89,7 +97,7 @@ ReadScalar( hid_t iParent,
                      << " as scalar" );
     }
 
-    herr_t status = H5Aread( attrId, iNativeType, oData );
+    herr_t status = StatsH5Aread( attrId, iNativeType, oData );
     ABCA_ASSERT( status >= 0, "Couldn't read from attribute: " << iAttrName );
 }
 
@@ -139,7 +147,7 @@ ReadSmallArray( hid_t iParent,
         oNumElems = ( size_t )numPoints;
     }
 
-    herr_t status = H5Aread( attrId, iNativeType, oData );
+    herr_t status = StatsH5Aread( attrId, iNativeType, oData );
     ABCA_ASSERT( status >= 0, "Couldn't read from attribute: " << iAttrName );
 }
 
@@ -538,6 +546,7 @@ ReadArray( AbcA::ReadArraySampleCachePtr iCache,
         foundDigest = ReadKey( dsetId, "key", key );
 
         AbcA::ReadArraySampleID found = iCache->find( key );
+        CountCacheLookup( found );
 
         if ( found )
         {
@@ -602,9 +611,8 @@ ReadArray( AbcA::ReadArraySampleCachePtr iCache,
         assert( ret->getData() );
 
         // And... read into it.
-        herr_t status = H5Dread( dsetId, iNativeType,
-                                 H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                                 const_cast<void*>( ret->getData() ) );
+        herr_t status = StatsH5Dread( dsetId, iNativeType,
+                                      const_cast<void*>( ret->getData() ) );
 
         ABCA_ASSERT( status >= 0, "H5Dread() failed." );
     }
@@ -700,6 +708,43 @@ ReadTimeSamples( hid_t iParent,
     }
 }
 
+//-*****************************************************************************
+bool
+ReadFrameIndex( hid_t iFile, FrameIndex &oIndex )
+{
+    oIndex.clear();
+
+    if ( !DatasetExists( iFile, kFrameIndexName ) )
+    {
+        return false;
+    }
+
+    hid_t dsetId = H5Dopen( iFile, kFrameIndexName, H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Cannot open frame index" );
+    DsetCloser dsetCloser( dsetId );
+
+    hid_t dspaceId = H5Dget_space( dsetId );
+    ABCA_ASSERT( dspaceId >= 0, "Could not get dataspace for frame index" );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    hssize_t numPoints = H5Sget_simple_extent_npoints( dspaceId );
+    if ( numPoints <= 0 )
+    {
+        return true;
+    }
+
+    oIndex.resize( numPoints );
+
+    hid_t typeId = FrameExtentType();
+    DtypeCloser dtypeCloser( typeId );
+
+    herr_t status = H5Dread( dsetId, typeId, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                             &oIndex.front() );
+    ABCA_ASSERT( status >= 0, "Can't read frame index" );
+
+    return true;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreHDF5
 } // End namespace Alembic
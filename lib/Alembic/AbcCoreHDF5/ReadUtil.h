@@ -39,6 +39,8 @@
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/StringReadUtil.h>
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -49,6 +51,10 @@ namespace ALEMBIC_VERSION_NS {
 // UTILITY THING
 //-*****************************************************************************
 
+//-*****************************************************************************
+// What iArchive's property readers count to, see ArImpl::getStatsCollector.
+StatsCollectorPtr GetStatsCollector( AbcA::ArchiveReaderPtr iArchive );
+
 //-*****************************************************************************
 bool
 ReadKey( hid_t iHashDset,
@@ -121,6 +127,12 @@ void
 ReadTimeSamples( hid_t iParent,
                  std::vector <  AbcA::TimeSamplingPtr > & oTimeSamples );
 
+//-*****************************************************************************
+// Fills in oIndex with the frame index at the root of iFile, returns false
+// if there isn't one.
+bool
+ReadFrameIndex( hid_t iFile, FrameIndex &oIndex );
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
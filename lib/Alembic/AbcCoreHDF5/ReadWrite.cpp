@@ -39,6 +39,8 @@
 #include <Alembic/AbcCoreHDF5/AwImpl.h>
 #include <Alembic/AbcCoreHDF5/ArImpl.h>
 #include <Alembic/AbcCoreHDF5/CacheImpl.h>
+#include <Alembic/AbcCoreHDF5/DiskCacheImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedArImpl.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -50,7 +52,17 @@ WriteArchive::operator()( const std::string &iFileName,
                           const AbcA::MetaData &iMetaData ) const
 {
     AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iFileName,
-                                                   iMetaData ) );
+                                                   iMetaData,
+                                                   m_profile ) );
+    return archivePtr;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveWriterPtr
+AppendArchive::operator()( const std::string &iFileName,
+                           const AbcA::MetaData &iMetaData ) const
+{
+    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iFileName, m_profile ) );
     return archivePtr;
 }
 
@@ -62,6 +74,21 @@ CreateCache()
     return cachePtr;
 }
 
+//-*****************************************************************************
+AbcA::ReadArraySampleCachePtr
+CreateDiskCache( const std::string &iDirectory,
+                 uint64_t iMaxBytes,
+                 AbcA::ReadArraySampleCachePtr iMemoryCache )
+{
+#ifdef PLATFORM_WINDOWS
+    return iMemoryCache;
+#else
+    AbcA::ReadArraySampleCachePtr cachePtr(
+        new DiskCacheImpl( iDirectory, iMaxBytes, iMemoryCache ) );
+    return cachePtr;
+#endif
+}
+
 
 //-*****************************************************************************
 // This version creates a cache.
@@ -69,7 +96,8 @@ AbcA::ArchiveReaderPtr
 ReadArchive::operator()( const std::string &iFileName ) const
 {
     AbcA::ReadArraySampleCachePtr cachePtr = CreateCache();
-    AbcA::ArchiveReaderPtr archivePtr( new ArImpl( iFileName, cachePtr ) );
+    AbcA::ArchiveReaderPtr archivePtr( new ArImpl( iFileName, cachePtr,
+                                                   m_profile ) );
     return archivePtr;
 }
 
@@ -80,7 +108,84 @@ ReadArchive::operator()( const std::string &iFileName,
                          AbcA::ReadArraySampleCachePtr iCachePtr ) const
 {
     AbcA::ArchiveReaderPtr archivePtr( new ArImpl( iFileName,
-                                                   iCachePtr ) );
+                                                   iCachePtr,
+                                                   m_profile ) );
+    return archivePtr;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveWriterPtr
+WriteMemoryArchive::operator()( const std::string &iFileName,
+                                const AbcA::MetaData &iMetaData ) const
+{
+    ABCA_ASSERT( m_image, "WriteMemoryArchive needs an ArchiveImage" );
+
+    AbcA::ArchiveWriterPtr archivePtr( new AwImpl( iFileName,
+                                                   iMetaData,
+                                                   FileAccessProfile(),
+                                                   m_image ) );
+    return archivePtr;
+}
+
+//-*****************************************************************************
+ReadMemoryArchive::ReadMemoryArchive( ArchiveImagePtr iImage )
+  : m_image( iImage )
+  , m_data( NULL )
+  , m_size( 0 )
+{
+    ABCA_ASSERT( m_image, "ReadMemoryArchive needs an ArchiveImage" );
+
+    if ( !m_image->empty() )
+    {
+        m_data = &( m_image->front() );
+        m_size = m_image->size();
+    }
+}
+
+//-*****************************************************************************
+ReadMemoryArchive::ReadMemoryArchive( const void *iData, size_t iSize )
+  : m_data( iData )
+  , m_size( iSize )
+{
+}
+
+//-*****************************************************************************
+// This version creates a cache.
+AbcA::ArchiveReaderPtr
+ReadMemoryArchive::operator()( const std::string &iName ) const
+{
+    return ( *this )( iName, CreateCache() );
+}
+
+//-*****************************************************************************
+// This version takes a cache from outside.
+AbcA::ArchiveReaderPtr
+ReadMemoryArchive::operator()( const std::string &iName,
+                               AbcA::ReadArraySampleCachePtr iCachePtr ) const
+{
+    AbcA::ArchiveReaderPtr archivePtr( new ArImpl( iName, m_data, m_size,
+                                                   m_image, iCachePtr ) );
+    return archivePtr;
+}
+
+//-*****************************************************************************
+// This version creates a cache.
+AbcA::ArchiveReaderPtr
+ReadShardedArchive::operator()( const std::string &iName ) const
+{
+    return ( *this )( iName, CreateCache() );
+}
+
+//-*****************************************************************************
+// This version takes a cache from outside.
+AbcA::ArchiveReaderPtr
+ReadShardedArchive::operator()( const std::string &iName,
+                                AbcA::ReadArraySampleCachePtr iCachePtr ) const
+{
+    ShardSetPtr shards( new ShardSet( m_shardNames, m_maxOpenShards,
+                                      m_profile, iCachePtr ) );
+
+    AbcA::ArchiveReaderPtr archivePtr( new ShardedArImpl( iName, shards ) );
     return archivePtr;
 }
 
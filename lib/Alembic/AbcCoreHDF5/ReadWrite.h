@@ -38,6 +38,8 @@
 #define _Alembic_AbcCoreHDF5_ReadWrite_h_
 
 #include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+#include <Alembic/AbcCoreHDF5/ArchiveImage.h>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -46,12 +48,62 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 //! Will return a shared pointer to the archive writer
 //! There is only one way to create an archive writer in AbcCoreHDF5.
+//! An optional FileAccessProfile tunes the HDF5 file access for the
+//! archive being written.
+//!
+//! Different objects of the archive may be created and written from
+//! different threads. Their samples are hashed and compressed at the same
+//! time, and written to the file one at a time. A single object, and the
+//! properties under it, should still only be written from one thread.
 struct WriteArchive
 {
+    WriteArchive() {}
+
+    explicit WriteArchive( const FileAccessProfile &iProfile )
+      : m_profile( iProfile ) {}
+
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( const std::string &iFileName,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData )
         const;
+
+    const FileAccessProfile &getProfile() const { return m_profile; }
+
+private:
+    FileAccessProfile m_profile;
+};
+
+//-*****************************************************************************
+//! Will return a shared pointer to an archive writer over an archive that
+//! was already written, so more samples can be added to it without
+//! rewriting it.
+//! Objects and properties created with the names of ones already in the
+//! archive reopen them, and carry on from their last sample. They keep
+//! the MetaData, DataType and TimeSampling they were written with, as does
+//! the archive, so iMetaData is only here so that AppendArchive can be
+//! used wherever WriteArchive is:
+//!
+//!     {
+//!         OArchive archive( AppendArchive(), "shot.abc" );
+//!         OXform xform( archive.getTop(), "xform" );
+//!         xform.getSchema().set( nextSample );
+//!     }
+struct AppendArchive
+{
+    AppendArchive() {}
+
+    explicit AppendArchive( const FileAccessProfile &iProfile )
+      : m_profile( iProfile ) {}
+
+    ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
+    operator()( const std::string &iFileName,
+                const ::Alembic::AbcCoreAbstract::MetaData &iMetaData =
+                ::Alembic::AbcCoreAbstract::MetaData() ) const;
+
+    const FileAccessProfile &getProfile() const { return m_profile; }
+
+private:
+    FileAccessProfile m_profile;
 };
 
 //-*****************************************************************************
@@ -63,11 +115,43 @@ struct WriteArchive
 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr
 CreateCache( void );
 
+//-*****************************************************************************
+//! Creates a cache which keeps the array samples it's given in iDirectory
+//! as well as in iMemoryCache, so that later processes on the same host
+//! find them there instead of reading and decompressing them again. Meant
+//! for archives on network filesystems, with iDirectory on a local disk.
+//! Samples are keyed by a hash of their contents, so archives which share
+//! data share entries too, and any number of processes can use the same
+//! directory at once.
+//! The directory is kept to roughly iMaxBytes, evicting the least recently
+//! used entries first. String samples, and samples small enough to be
+//! cheap to read again, only go into iMemoryCache.
+//! It's passed to ReadArchive like any other cache:
+//!
+//!     ReadArraySampleCachePtr cache =
+//!         CreateDiskCache( "/local/abcCache", 20ULL << 30 );
+//!     IArchive archive( ReadArchive(), "/net/show/asset.abc",
+//!                       ErrorHandler::kThrowPolicy, cache );
+//!
+//! On Windows there is no disk level, and iMemoryCache is returned.
+::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr
+CreateDiskCache( const std::string &iDirectory,
+                 ::Alembic::Util::uint64_t iMaxBytes,
+                 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr
+                 iMemoryCache = CreateCache() );
+
 //-*****************************************************************************
 //! Will return a shared pointer to the archive reader
 //! This version creates a cache associated with the archive.
+//! An optional FileAccessProfile tunes the HDF5 file access for the
+//! archive being read.
 struct ReadArchive
 {
+    ReadArchive() {}
+
+    explicit ReadArchive( const FileAccessProfile &iProfile )
+      : m_profile( iProfile ) {}
+
     // Make our own cache.
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName ) const;
@@ -77,6 +161,120 @@ struct ReadArchive
     operator()( const std::string &iFileName,
                 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache )
         const;
+
+    const FileAccessProfile &getProfile() const { return m_profile; }
+
+private:
+    FileAccessProfile m_profile;
+};
+
+//-*****************************************************************************
+//! Will return a shared pointer to an archive reader that presents several
+//! archives as one. Each holds the same hierarchy over its own stretch of
+//! frames, as farm jobs that write a shot in chunks leave them, so they
+//! can be read without stitching them together first.
+//! The shards are put in frame order by when their first TimeSampling
+//! (after the default one) starts, and must all have the same
+//! TimeSamplingTypes, none of them acyclic. The archive's TimeSamplings
+//! are the first shard's, and each property's samples are those of each
+//! shard in turn. A property with only one sample in a shard holds it
+//! until the next shard starts.
+//! Each shard is only opened when it's needed, and the ones used least
+//! recently are closed to keep no more than iMaxOpenShards open. All of
+//! them share the one cache.
+//!
+//!     std::vector<std::string> shards;
+//!     shards.push_back( "shot.0101-0200.abc" );
+//!     shards.push_back( "shot.0001-0100.abc" );
+//!     IArchive archive( ReadShardedArchive( shards ), "shot" );
+struct ReadShardedArchive
+{
+    explicit ReadShardedArchive( const std::vector<std::string> &iShardNames,
+                                 size_t iMaxOpenShards = 4 )
+      : m_shardNames( iShardNames )
+      , m_maxOpenShards( iMaxOpenShards ) {}
+
+    ReadShardedArchive( const std::vector<std::string> &iShardNames,
+                        size_t iMaxOpenShards,
+                        const FileAccessProfile &iProfile )
+      : m_shardNames( iShardNames )
+      , m_maxOpenShards( iMaxOpenShards )
+      , m_profile( iProfile ) {}
+
+    //! iName only names the archive, it isn't opened.
+    ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    operator()( const std::string &iName ) const;
+
+    ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    operator()( const std::string &iName,
+                ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache )
+        const;
+
+    const FileAccessProfile &getProfile() const { return m_profile; }
+
+private:
+    std::vector<std::string> m_shardNames;
+    size_t m_maxOpenShards;
+    FileAccessProfile m_profile;
+};
+
+//-*****************************************************************************
+//! Will return a shared pointer to an archive writer that builds the
+//! archive in memory. Nothing is written to disk; when the archive writer
+//! is destroyed, the serialized archive is copied into the ArchiveImage
+//! this was constructed with.
+//! iFileName only names the archive, but no two in memory archives that
+//! are open at the same time may share a name.
+//!
+//!     ArchiveImagePtr image( new ArchiveImage );
+//!     {
+//!         OArchive archive( WriteMemoryArchive( image ), "handoff" );
+//!         ...
+//!     }
+//!     // image now holds the archive bytes.
+struct WriteMemoryArchive
+{
+    explicit WriteMemoryArchive( ArchiveImagePtr oImage )
+      : m_image( oImage ) {}
+
+    ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
+    operator()( const std::string &iFileName,
+                const ::Alembic::AbcCoreAbstract::MetaData &iMetaData )
+        const;
+
+private:
+    ArchiveImagePtr m_image;
+};
+
+//-*****************************************************************************
+//! Will return a shared pointer to an archive reader over an archive
+//! image rather than a file. The bytes are read in place, without being
+//! copied.
+//! As with ReadArchive, there's a version that creates a cache and one
+//! that takes the given cache.
+struct ReadMemoryArchive
+{
+    //! Reads an image made by WriteMemoryArchive (or loaded from a file).
+    //! The archive readers keep the image alive.
+    explicit ReadMemoryArchive( ArchiveImagePtr iImage );
+
+    //! Reads iSize bytes at iData, such as a shared memory segment.
+    //! The caller must keep them valid and unchanged for as long as any
+    //! archive reader made from them exists.
+    ReadMemoryArchive( const void *iData, size_t iSize );
+
+    ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    operator()( const std::string &iName ) const;
+
+    ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    operator()( const std::string &iName,
+                ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache )
+        const;
+
+private:
+    ArchiveImagePtr m_image;
+    const void *m_data;
+    size_t m_size;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -0,0 +1,326 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/Repack.h>
+#include <Alembic/AbcCoreHDF5/ReadWrite.h>
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// A property being repacked, holding both ends. Only one of the pairs is
+// set.
+struct RepackProperty
+{
+    AbcA::ScalarPropertyReaderPtr scalarReader;
+    AbcA::ScalarPropertyWriterPtr scalarWriter;
+
+    AbcA::ArrayPropertyReaderPtr arrayReader;
+    AbcA::ArrayPropertyWriterPtr arrayWriter;
+};
+
+//-*****************************************************************************
+struct RepackSample
+{
+    RepackSample( chrono_t iTime, size_t iProperty, index_t iIndex )
+      : time( iTime ), property( iProperty ), index( iIndex ) {}
+
+    chrono_t time;
+    size_t property;
+    index_t index;
+};
+
+//-*****************************************************************************
+bool RepackSampleLess( const RepackSample &iA, const RepackSample &iB )
+{
+    return iA.time < iB.time;
+}
+
+//-*****************************************************************************
+// An instance whose source hadn't been copied yet when it was found.
+struct RepackInstance
+{
+    RepackInstance( AbcA::ObjectWriterPtr iParent, const std::string &iName,
+                    const std::string &iSource )
+      : parent( iParent ), name( iName ), source( iSource ) {}
+
+    AbcA::ObjectWriterPtr parent;
+    std::string name;
+    std::string source;
+};
+
+//-*****************************************************************************
+class Repacker
+{
+public:
+    Repacker( AbcA::ArchiveReaderPtr iReader, AbcA::ArchiveWriterPtr iWriter )
+      : m_reader( iReader ), m_writer( iWriter ) {}
+
+    void copyObject( AbcA::ObjectReaderPtr iReader,
+                     AbcA::ObjectWriterPtr iWriter );
+
+    void addInstances();
+
+    void writeSamples();
+
+private:
+    void copyProperties( AbcA::CompoundPropertyReaderPtr iReader,
+                         AbcA::CompoundPropertyWriterPtr iWriter );
+
+    void addSamples( AbcA::TimeSamplingPtr iTs, size_t iNumSamples );
+
+    void writeSample( const RepackSample &iSample );
+
+    AbcA::ArchiveReaderPtr m_reader;
+    AbcA::ArchiveWriterPtr m_writer;
+
+    // The objects are held on to until all of the samples are written,
+    // they are what keep their properties alive.
+    std::vector<AbcA::ObjectReaderPtr> m_objectReaders;
+    std::vector<AbcA::ObjectWriterPtr> m_objectWriters;
+
+    // The copied objects by their full names as read.
+    std::map<std::string, AbcA::ObjectWriterPtr> m_copiedObjects;
+    std::vector<RepackInstance> m_instances;
+
+    std::vector<RepackProperty> m_properties;
+    std::vector<RepackSample> m_samples;
+};
+
+//-*****************************************************************************
+void Repacker::copyObject( AbcA::ObjectReaderPtr iReader,
+                           AbcA::ObjectWriterPtr iWriter )
+{
+    m_objectReaders.push_back( iReader );
+    m_objectWriters.push_back( iWriter );
+    m_copiedObjects[iReader->getFullName()] = iWriter;
+
+    copyProperties( iReader->getProperties(), iWriter->getProperties() );
+
+    size_t numChildren = iReader->getNumChildren();
+    for ( size_t i = 0; i < numChildren; ++i )
+    {
+        const AbcA::ObjectHeader &header = iReader->getChildHeader( i );
+
+        // Instances stay instances, copying them would copy their source
+        // all over again.
+        if ( iReader->isChildInstance( i ) )
+        {
+            std::string source =
+                iReader->getChild( i )->getInstanceSourcePath();
+
+            std::map<std::string, AbcA::ObjectWriterPtr>::iterator fiter =
+                m_copiedObjects.find( source );
+            if ( fiter != m_copiedObjects.end() )
+            {
+                iWriter->addChildInstance( (*fiter).second,
+                                           header.getName() );
+            }
+            else
+            {
+                m_instances.push_back(
+                    RepackInstance( iWriter, header.getName(), source ) );
+            }
+            continue;
+        }
+
+        copyObject( iReader->getChild( i ), iWriter->createChild( header ) );
+    }
+}
+
+//-*****************************************************************************
+void Repacker::addInstances()
+{
+    // The ones whose source comes later in the hierarchy, these are
+    // added after the parent's other children.
+    for ( std::vector<RepackInstance>::iterator it = m_instances.begin();
+          it != m_instances.end(); ++it )
+    {
+        std::map<std::string, AbcA::ObjectWriterPtr>::iterator fiter =
+            m_copiedObjects.find( (*it).source );
+        ABCA_ASSERT( fiter != m_copiedObjects.end(),
+                     "Could not find instance source: " << (*it).source );
+
+        (*it).parent->addChildInstance( (*fiter).second, (*it).name );
+    }
+    m_instances.clear();
+}
+
+//-*****************************************************************************
+void Repacker::copyProperties( AbcA::CompoundPropertyReaderPtr iReader,
+                               AbcA::CompoundPropertyWriterPtr iWriter )
+{
+    size_t numProps = iReader->getNumProperties();
+    for ( size_t i = 0; i < numProps; ++i )
+    {
+        const AbcA::PropertyHeader &header = iReader->getPropertyHeader( i );
+        const std::string &name = header.getName();
+
+        if ( header.isCompound() )
+        {
+            copyProperties( iReader->getCompoundProperty( name ),
+                            iWriter->createCompoundProperty(
+                                name, header.getMetaData() ) );
+            continue;
+        }
+
+        // The archive's TimeSamplings were all added up front, so this
+        // finds the one the property already uses.
+        AbcA::TimeSamplingPtr ts = header.getTimeSampling();
+        uint32_t tsIndex = m_writer->addTimeSampling( *ts );
+
+        RepackProperty prop;
+        size_t numSamples = 0;
+
+        if ( header.isScalar() )
+        {
+            prop.scalarReader = iReader->getScalarProperty( name );
+            prop.scalarWriter = iWriter->createScalarProperty( name,
+                header.getMetaData(), header.getDataType(), tsIndex );
+            numSamples = prop.scalarReader->getNumSamples();
+        }
+        else
+        {
+            prop.arrayReader = iReader->getArrayProperty( name );
+            prop.arrayWriter = iWriter->createArrayProperty( name,
+                header.getMetaData(), header.getDataType(), tsIndex );
+            numSamples = prop.arrayReader->getNumSamples();
+        }
+
+        m_properties.push_back( prop );
+        addSamples( ts, numSamples );
+    }
+}
+
+//-*****************************************************************************
+void Repacker::addSamples( AbcA::TimeSamplingPtr iTs, size_t iNumSamples )
+{
+    size_t propIndex = m_properties.size() - 1;
+    for ( size_t i = 0; i < iNumSamples; ++i )
+    {
+        m_samples.push_back(
+            RepackSample( iTs->getSampleTime( i ), propIndex, i ) );
+    }
+}
+
+//-*****************************************************************************
+void Repacker::writeSamples()
+{
+    // A property's samples are already in time order, and the sort
+    // being stable keeps them in index order, which is the order they
+    // have to be set in.
+    std::stable_sort( m_samples.begin(), m_samples.end(), RepackSampleLess );
+
+    for ( std::vector<RepackSample>::const_iterator it = m_samples.begin();
+          it != m_samples.end(); ++it )
+    {
+        writeSample( *it );
+    }
+}
+
+//-*****************************************************************************
+void Repacker::writeSample( const RepackSample &iSample )
+{
+    RepackProperty &prop = m_properties[iSample.property];
+
+    if ( prop.arrayReader )
+    {
+        AbcA::ArraySamplePtr samp;
+        prop.arrayReader->getSample( iSample.index, samp );
+        prop.arrayWriter->setSample( *samp );
+        return;
+    }
+
+    const AbcA::DataType &dt = prop.scalarReader->getDataType();
+    size_t extent = dt.getExtent();
+
+    if ( dt.getPod() == kStringPOD )
+    {
+        std::vector<std::string> strs( extent );
+        prop.scalarReader->getSample( iSample.index, &strs.front() );
+        prop.scalarWriter->setSample( &strs.front() );
+    }
+    else if ( dt.getPod() == kWstringPOD )
+    {
+        std::vector<std::wstring> wstrs( extent );
+        prop.scalarReader->getSample( iSample.index, &wstrs.front() );
+        prop.scalarWriter->setSample( &wstrs.front() );
+    }
+    else
+    {
+        std::vector<uint8_t> bytes( dt.getNumBytes() );
+        prop.scalarReader->getSample( iSample.index, &bytes.front() );
+        prop.scalarWriter->setSample( &bytes.front() );
+    }
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+void RepackArchive( const std::string &iInFileName,
+                    const std::string &iOutFileName,
+                    const FileAccessProfile &iProfile )
+{
+    ABCA_ASSERT( iInFileName != iOutFileName,
+                 "Can't repack an archive onto itself: " << iInFileName );
+
+    // Every sample is read exactly once, a cache would only fill up.
+    AbcA::ArchiveReaderPtr reader =
+        ReadArchive()( iInFileName, AbcA::ReadArraySampleCachePtr() );
+
+    AbcA::ArchiveWriterPtr writer =
+        WriteArchive( iProfile )( iOutFileName, reader->getMetaData() );
+
+    // Add the TimeSamplings in order so they keep their indices.
+    uint32_t numTimeSamplings = reader->getNumTimeSamplings();
+    for ( uint32_t i = 1; i < numTimeSamplings; ++i )
+    {
+        writer->addTimeSampling( *reader->getTimeSampling( i ) );
+    }
+
+    Repacker repacker( reader, writer );
+    repacker.copyObject( reader->getTop(), writer->getTop() );
+    repacker.addInstances();
+    repacker.writeSamples();
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
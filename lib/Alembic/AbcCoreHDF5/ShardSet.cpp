@@ -0,0 +1,458 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardSet.h>
+#include <Alembic/AbcCoreHDF5/ReadWrite.h>
+#include <Alembic/AbcCoreHDF5/ArImpl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+namespace {
+
+//-*****************************************************************************
+// What's read from a shard while putting the shards in order.
+struct ShardInfo
+{
+    std::string fileName;
+    chrono_t start;
+    AbcA::MetaData metaData;
+    int32_t archiveVersion;
+    std::vector<AbcA::TimeSamplingPtr> timeSamples;
+};
+
+//-*****************************************************************************
+bool StartsBefore( const ShardInfo &iA, const ShardInfo &iB )
+{
+    return iA.start < iB.start;
+}
+
+//-*****************************************************************************
+// Sample counts are stored as 32 bit values, so no shard can start after
+// this many samples.
+const index_t kMaxSamples = std::numeric_limits<uint32_t>::max();
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+ShardSet::ShardSet( const std::vector<std::string> &iFileNames,
+                    size_t iMaxOpenShards,
+                    const FileAccessProfile &iProfile,
+                    AbcA::ReadArraySampleCachePtr iCache )
+  : m_maxOpenShards( std::max( iMaxOpenShards, ( size_t )1 ) )
+  , m_profile( iProfile )
+  , m_cache( iCache )
+  , m_stats( new StatsCollector() )
+  , m_archiveVersion( 0 )
+{
+    ABCA_ASSERT( !iFileNames.empty(), "No shards to read" );
+
+    // Each shard is opened just long enough to see where it starts, so
+    // that this stays within the budget no matter the order they're in.
+    std::vector<ShardInfo> shards( iFileNames.size() );
+    for ( size_t k = 0; k < iFileNames.size(); ++k )
+    {
+        ShardInfo &info = shards[k];
+        AbcA::ArchiveReaderPtr archive =
+            ReadArchive( m_profile )( iFileNames[k], m_cache );
+
+        info.fileName = iFileNames[k];
+        info.metaData = archive->getMetaData();
+        info.archiveVersion = archive->getArchiveVersion();
+
+        uint32_t numTs = archive->getNumTimeSamplings();
+        for ( uint32_t i = 0; i < numTs; ++i )
+        {
+            info.timeSamples.push_back( archive->getTimeSampling( i ) );
+        }
+
+        // TimeSampling 0 is the default one, every archive has it and it
+        // always starts at 0.
+        ABCA_ASSERT( numTs > 1, "Shard " << info.fileName
+                     << " has no TimeSampling of its own to order it by" );
+
+        info.start = info.timeSamples[1]->getSampleTime( 0 );
+    }
+
+    std::stable_sort( shards.begin(), shards.end(), StartsBefore );
+
+    // The first shard's TimeSamplings carry on through the rest.
+    m_metaData = shards[0].metaData;
+    m_archiveVersion = shards[0].archiveVersion;
+    m_timeSamples = shards[0].timeSamples;
+
+    uint32_t numTs = m_timeSamples.size();
+    m_startIndices.resize( numTs,
+                           std::vector<index_t>( shards.size(), 0 ) );
+
+    for ( size_t k = 0; k < shards.size(); ++k )
+    {
+        const ShardInfo &info = shards[k];
+        m_fileNames.push_back( info.fileName );
+
+        ABCA_ASSERT( info.timeSamples.size() == numTs,
+                     "Shard " << info.fileName << " has "
+                     << info.timeSamples.size() << " TimeSamplings, but "
+                     << m_fileNames[0] << " has " << numTs );
+
+        for ( uint32_t i = 1; i < numTs; ++i )
+        {
+            const AbcA::TimeSampling &ts = *info.timeSamples[i];
+            const AbcA::TimeSamplingType &tst = ts.getTimeSamplingType();
+
+            ABCA_ASSERT( !tst.isAcyclic(), "Shard " << info.fileName
+                         << " has acyclic TimeSampling " << i
+                         << ", which can't be carried across shards" );
+
+            ABCA_ASSERT( tst == m_timeSamples[i]->getTimeSamplingType(),
+                         "Shard " << info.fileName
+                         << " doesn't sample TimeSampling " << i
+                         << " the way " << m_fileNames[0] << " does" );
+
+            chrono_t start = ts.getSampleTime( 0 );
+            std::pair<index_t, chrono_t> nearest =
+                m_timeSamples[i]->getNearIndex( start, kMaxSamples );
+
+            ABCA_ASSERT( fabs( nearest.second - start ) <=
+                         tst.getTimePerCycle() * 1.0e-4,
+                         "Shard " << info.fileName << " starts at "
+                         << start << ", between the samples of "
+                         << "TimeSampling " << i << " in "
+                         << m_fileNames[0] );
+
+            // Two shards can't start on the same frame, though other
+            // TimeSamplings may well not move on from one shard to the
+            // next.
+            if ( k > 0 )
+            {
+                index_t previous = m_startIndices[i][k-1];
+                ABCA_ASSERT( nearest.first > previous ||
+                             ( i > 1 && nearest.first == previous ),
+                             "Shard " << info.fileName << " overlaps "
+                             << m_fileNames[k-1] );
+            }
+
+            m_startIndices[i][k] = nearest.first;
+        }
+    }
+
+    m_open.resize( m_fileNames.size() );
+}
+
+//-*****************************************************************************
+AbcA::TimeSamplingPtr ShardSet::getTimeSampling( uint32_t iIndex ) const
+{
+    ABCA_ASSERT( iIndex < m_timeSamples.size(),
+        "Invalid index provided to getTimeSampling." );
+
+    return m_timeSamples[iIndex];
+}
+
+//-*****************************************************************************
+uint32_t
+ShardSet::getTimeSamplingIndex( const AbcA::TimeSampling &iTs ) const
+{
+    for ( uint32_t i = 0; i < m_timeSamples.size(); ++i )
+    {
+        if ( *m_timeSamples[i] == iTs )
+        {
+            return i;
+        }
+    }
+
+    ABCA_THROW( "TimeSampling isn't one of the first shard's: "
+                << m_fileNames[0] );
+    return 0;
+}
+
+//-*****************************************************************************
+index_t ShardSet::getStartIndex( uint32_t iTsIndex, size_t iShard ) const
+{
+    assert( iTsIndex < m_startIndices.size() );
+    assert( iShard < m_fileNames.size() );
+
+    return m_startIndices[iTsIndex][iShard];
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleCachePtr ShardSet::getCache()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_cache;
+}
+
+//-*****************************************************************************
+void ShardSet::setCache( AbcA::ReadArraySampleCachePtr iCache )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    m_cache = iCache;
+
+    for ( std::list<size_t>::iterator iter = m_recent.begin();
+          iter != m_recent.end(); ++iter )
+    {
+        m_open[*iter]->archive->setReadArraySampleCachePtr( iCache );
+    }
+}
+
+//-*****************************************************************************
+size_t ShardSet::getNumOpenShards()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_recent.size();
+}
+
+//-*****************************************************************************
+ShardSet::OpenShardPtr ShardSet::open( size_t iShard )
+{
+    ABCA_ASSERT( iShard < m_fileNames.size(),
+                 "Invalid shard index: " << iShard );
+
+    if ( m_open[iShard] )
+    {
+        if ( m_recent.front() != iShard )
+        {
+            m_recent.remove( iShard );
+            m_recent.push_front( iShard );
+        }
+        return m_open[iShard];
+    }
+
+    OpenShardPtr shard( new OpenShard );
+    shard->archive = ReadArchive( m_profile )( m_fileNames[iShard], m_cache );
+
+    ArImpl *ar = dynamic_cast<ArImpl *>( shard->archive.get() );
+    ABCA_ASSERT( ar, "Invalid shard: " << m_fileNames[iShard] );
+    ar->setStatsCollector( m_stats );
+
+    m_open[iShard] = shard;
+    m_recent.push_front( iShard );
+
+    // A shard a reader is still using stays open until it's done.
+    while ( m_recent.size() > m_maxOpenShards )
+    {
+        m_open[m_recent.back()].reset();
+        m_recent.pop_back();
+    }
+
+    return shard;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr
+ShardSet::findObject( size_t iShard, const std::string &iFullName )
+{
+    OpenShard &shard = *m_open[iShard];
+
+    std::map<std::string, AbcA::ObjectReaderPtr>::iterator fiter =
+        shard.objects.find( iFullName );
+    if ( fiter != shard.objects.end() )
+    {
+        return (*fiter).second;
+    }
+
+    AbcA::ObjectReaderPtr obj;
+    if ( iFullName == "/" )
+    {
+        obj = shard.archive->getTop();
+    }
+    else
+    {
+        size_t slash = iFullName.rfind( '/' );
+        ABCA_ASSERT( slash != std::string::npos,
+                     "Invalid object name: " << iFullName );
+
+        std::string parentName = slash == 0 ? std::string( "/" ) :
+            iFullName.substr( 0, slash );
+
+        obj = findObject( iShard, parentName )->getChild(
+            iFullName.substr( slash + 1 ) );
+    }
+
+    ABCA_ASSERT( obj, "Shard " << m_fileNames[iShard]
+                 << " has no object " << iFullName );
+
+    shard.objects[iFullName] = obj;
+    return obj;
+}
+
+//-*****************************************************************************
+AbcA::BasePropertyReaderPtr
+ShardSet::findProperty( size_t iShard, const std::string &iFullName,
+                        const PropertyPath &iPath )
+{
+    assert( !iPath.empty() );
+
+    OpenShard &shard = *m_open[iShard];
+
+    std::string key = iFullName + "|";
+    for ( size_t i = 0; i < iPath.size(); ++i )
+    {
+        key += "/" + iPath[i];
+    }
+
+    std::map<std::string, AbcA::BasePropertyReaderPtr>::iterator fiter =
+        shard.properties.find( key );
+    if ( fiter != shard.properties.end() )
+    {
+        return (*fiter).second;
+    }
+
+    // The compounds along the way are kept as well, so that the next
+    // property looked up in them doesn't read them again.
+    AbcA::CompoundPropertyReaderPtr parent;
+    if ( iPath.size() == 1 )
+    {
+        parent = findObject( iShard, iFullName )->getProperties();
+    }
+    else
+    {
+        PropertyPath parentPath( iPath.begin(), iPath.end() - 1 );
+        parent = findProperty( iShard, iFullName, parentPath )->
+            asCompoundPtr();
+    }
+
+    const std::string &name = iPath.back();
+    const AbcA::PropertyHeader *header =
+        parent ? parent->getPropertyHeader( name ) : NULL;
+
+    ABCA_ASSERT( header, "Shard " << m_fileNames[iShard]
+                 << " has no property " << key );
+
+    AbcA::BasePropertyReaderPtr prop;
+    switch ( header->getPropertyType() )
+    {
+    case AbcA::kScalarProperty:
+        prop = parent->getScalarProperty( name );
+        break;
+    case AbcA::kArrayProperty:
+        prop = parent->getArrayProperty( name );
+        break;
+    default:
+        prop = parent->getCompoundProperty( name );
+        break;
+    }
+
+    ABCA_ASSERT( prop, "Shard " << m_fileNames[iShard]
+                 << " could not read property " << key );
+
+    shard.properties[key] = prop;
+    return prop;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr
+ShardSet::getObject( size_t iShard, const std::string &iFullName )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    OpenShardPtr shard = open( iShard );
+
+    // Shares the shard's ownership, so it stays open while this is held.
+    return AbcA::ObjectReaderPtr( shard,
+                                  findObject( iShard, iFullName ).get() );
+}
+
+//-*****************************************************************************
+AbcA::CompoundPropertyReaderPtr
+ShardSet::getCompound( size_t iShard, const std::string &iFullName,
+                       const PropertyPath &iPath )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    OpenShardPtr shard = open( iShard );
+
+    AbcA::CompoundPropertyReaderPtr cpr;
+    if ( iPath.empty() )
+    {
+        cpr = findObject( iShard, iFullName )->getProperties();
+    }
+    else
+    {
+        cpr = findProperty( iShard, iFullName, iPath )->asCompoundPtr();
+    }
+
+    ABCA_ASSERT( cpr, "Property in shard " << m_fileNames[iShard]
+                 << " isn't a compound property: " << iPath.back() );
+
+    return AbcA::CompoundPropertyReaderPtr( shard, cpr.get() );
+}
+
+//-*****************************************************************************
+AbcA::ScalarPropertyReaderPtr
+ShardSet::getScalar( size_t iShard, const std::string &iFullName,
+                     const PropertyPath &iPath )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    OpenShardPtr shard = open( iShard );
+
+    AbcA::ScalarPropertyReaderPtr spr =
+        findProperty( iShard, iFullName, iPath )->asScalarPtr();
+
+    ABCA_ASSERT( spr, "Property in shard " << m_fileNames[iShard]
+                 << " isn't a scalar property: " << iPath.back() );
+
+    return AbcA::ScalarPropertyReaderPtr( shard, spr.get() );
+}
+
+//-*****************************************************************************
+AbcA::ArrayPropertyReaderPtr
+ShardSet::getArray( size_t iShard, const std::string &iFullName,
+                    const PropertyPath &iPath )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    OpenShardPtr shard = open( iShard );
+
+    AbcA::ArrayPropertyReaderPtr apr =
+        findProperty( iShard, iFullName, iPath )->asArrayPtr();
+
+    ABCA_ASSERT( apr, "Property in shard " << m_fileNames[iShard]
+                 << " isn't an array property: " << iPath.back() );
+
+    return AbcA::ArrayPropertyReaderPtr( shard, apr.get() );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
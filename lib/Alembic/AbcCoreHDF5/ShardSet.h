@@ -0,0 +1,179 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardSet_h_
+#define _Alembic_AbcCoreHDF5_ShardSet_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/FileAccessProfile.h>
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The names of the compound properties leading to a property, from the
+// object's top compound down, followed by the property's own name.
+typedef std::vector<std::string> PropertyPath;
+
+//-*****************************************************************************
+// The archives behind a sharded archive (see ReadShardedArchive), in frame
+// order, along with how their samples line up.
+//
+// A shard is opened the first time a reader needs it, and the least
+// recently used ones are closed again whenever more than the budget are
+// open. The object and property readers made from an open shard are held
+// here, rather than by the sharded readers that use them, so that
+// dropping a shard is all it takes to close its file.
+class ShardSet : boost::noncopyable
+{
+public:
+    ShardSet( const std::vector<std::string> &iFileNames,
+              size_t iMaxOpenShards,
+              const FileAccessProfile &iProfile,
+              AbcA::ReadArraySampleCachePtr iCache );
+
+    size_t getNumShards() const { return m_fileNames.size(); }
+
+    const std::string &getFileName( size_t iShard ) const
+    { return m_fileNames[iShard]; }
+
+    // The merged TimeSamplings are the first shard's.
+    uint32_t getNumTimeSamplings() const { return m_timeSamples.size(); }
+
+    AbcA::TimeSamplingPtr getTimeSampling( uint32_t iIndex ) const;
+
+    // Finds the index of the merged TimeSampling equal to iTs.
+    uint32_t getTimeSamplingIndex( const AbcA::TimeSampling &iTs ) const;
+
+    // The index, on the merged TimeSampling iTsIndex, of a shard's first
+    // sample.
+    index_t getStartIndex( uint32_t iTsIndex, size_t iShard ) const;
+
+    const AbcA::MetaData &getMetaData() const { return m_metaData; }
+
+    int32_t getArchiveVersion() const { return m_archiveVersion; }
+
+    AbcA::ReadArraySampleCachePtr getCache();
+
+    // Also hands the cache to the shards that are open.
+    void setCache( AbcA::ReadArraySampleCachePtr iCache );
+
+    // How many shards have their files open right now.
+    size_t getNumOpenShards();
+
+    // What all of the shards count to, whether they're open now or not.
+    StatsCollectorPtr getStatsCollector() { return m_stats; }
+
+    //-*************************************************************************
+    // Each of these opens the shard if it has to, and throws if the shard
+    // doesn't hold what's asked for. The readers returned keep their shard
+    // open for as long as they're held, even past its eviction, so they
+    // should only be held for the length of a call.
+    //-*************************************************************************
+    AbcA::ObjectReaderPtr getObject( size_t iShard,
+                                     const std::string &iFullName );
+
+    // An empty path is the object's top compound.
+    AbcA::CompoundPropertyReaderPtr
+    getCompound( size_t iShard, const std::string &iFullName,
+                 const PropertyPath &iPath );
+
+    AbcA::ScalarPropertyReaderPtr
+    getScalar( size_t iShard, const std::string &iFullName,
+               const PropertyPath &iPath );
+
+    AbcA::ArrayPropertyReaderPtr
+    getArray( size_t iShard, const std::string &iFullName,
+              const PropertyPath &iPath );
+
+private:
+    struct OpenShard
+    {
+        AbcA::ArchiveReaderPtr archive;
+        std::map<std::string, AbcA::ObjectReaderPtr> objects;
+        std::map<std::string, AbcA::BasePropertyReaderPtr> properties;
+    };
+
+    typedef boost::shared_ptr<OpenShard> OpenShardPtr;
+
+    // These expect m_mutex to be locked.
+    OpenShardPtr open( size_t iShard );
+    AbcA::ObjectReaderPtr findObject( size_t iShard,
+                                      const std::string &iFullName );
+    AbcA::CompoundPropertyReaderPtr
+    findCompound( size_t iShard, const std::string &iFullName,
+                  const PropertyPath &iPath, size_t iDepth );
+    AbcA::BasePropertyReaderPtr
+    findProperty( size_t iShard, const std::string &iFullName,
+                  const PropertyPath &iPath );
+
+    std::vector<std::string> m_fileNames;
+    size_t m_maxOpenShards;
+    FileAccessProfile m_profile;
+    AbcA::ReadArraySampleCachePtr m_cache;
+    StatsCollectorPtr m_stats;
+
+    AbcA::MetaData m_metaData;
+    int32_t m_archiveVersion;
+    std::vector<AbcA::TimeSamplingPtr> m_timeSamples;
+
+    // Indexed by TimeSampling, then by shard.
+    std::vector< std::vector<index_t> > m_startIndices;
+
+    // Indexed by shard, empty for the ones that are closed.
+    std::vector<OpenShardPtr> m_open;
+
+    // The open shards, most recently used first.
+    std::list<size_t> m_recent;
+
+    boost::mutex m_mutex;
+};
+
+typedef boost::shared_ptr<ShardSet> ShardSetPtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
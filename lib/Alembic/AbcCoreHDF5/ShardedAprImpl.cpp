@@ -0,0 +1,179 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardedAprImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+ShardedAprImpl::ShardedAprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                                ShardSetPtr iShards,
+                                const std::string &iObjectName,
+                                const PropertyPath &iPath,
+                                PropertyHeaderPtr iHeader )
+  : ShardedPrImpl<AbcA::ArrayPropertyReader, ShardedAprImpl,
+                  AbcA::ArrayPropertyReaderPtr>
+    ( iParent, iShards, iObjectName, iPath, iHeader )
+  , m_isScalarLike( -1 )
+{
+    if ( m_header->getPropertyType() != AbcA::kArrayProperty )
+    {
+        ABCA_THROW( "Attempted to create a ArrayPropertyReader from a "
+                    "non-array property type" );
+    }
+}
+
+//-*****************************************************************************
+void ShardedAprImpl::getSample( index_t iSampleIndex,
+                                AbcA::ArraySamplePtr &oSample )
+{
+    size_t shard = 0;
+    index_t shardIndex = 0;
+    findSample( iSampleIndex, shard, shardIndex );
+
+    getShardProperty( shard )->getSample( shardIndex, oSample );
+}
+
+//-*****************************************************************************
+void ShardedAprImpl::getSampleAs( index_t iSampleIndex,
+                                  PlainOldDataType iPod,
+                                  AbcA::ArraySamplePtr &oSample )
+{
+    size_t shard = 0;
+    index_t shardIndex = 0;
+    findSample( iSampleIndex, shard, shardIndex );
+
+    getShardProperty( shard )->getSampleAs( shardIndex, iPod, oSample );
+}
+
+//-*****************************************************************************
+void ShardedAprImpl::getSamples( index_t iFirstIndex,
+                                 index_t iLastIndex,
+                                 std::vector<AbcA::ArraySamplePtr> &oSamples )
+{
+    oSamples.clear();
+    if ( iLastIndex < iFirstIndex )
+    {
+        return;
+    }
+
+    // Repeats within a shard come out of the cache, so there's little
+    // to share by asking each shard for its part of the range at once.
+    oSamples.resize( iLastIndex - iFirstIndex + 1 );
+    for ( index_t i = iFirstIndex; i <= iLastIndex; ++i )
+    {
+        getSample( i, oSamples[i - iFirstIndex] );
+    }
+}
+
+//-*****************************************************************************
+bool ShardedAprImpl::getKey( index_t iSampleIndex,
+                             AbcA::ArraySampleKey &oKey )
+{
+    size_t shard = 0;
+    index_t shardIndex = 0;
+    findSample( iSampleIndex, shard, shardIndex );
+
+    return getShardProperty( shard )->getKey( shardIndex, oKey );
+}
+
+//-*****************************************************************************
+void ShardedAprImpl::getDimensions( index_t iSampleIndex, Dimensions &oDim )
+{
+    size_t shard = 0;
+    index_t shardIndex = 0;
+    findSample( iSampleIndex, shard, shardIndex );
+
+    getShardProperty( shard )->getDimensions( shardIndex, oDim );
+}
+
+//-*****************************************************************************
+bool ShardedAprImpl::isScalarLike()
+{
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        if ( m_isScalarLike >= 0 )
+        {
+            return m_isScalarLike == 1;
+        }
+    }
+
+    // Only if it is in every shard.
+    bool scalarLike = true;
+    for ( size_t k = 0; k < m_shards->getNumShards() && scalarLike; ++k )
+    {
+        scalarLike = getShardProperty( k )->isScalarLike();
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_isScalarLike = scalarLike ? 1 : 0;
+    return scalarLike;
+}
+
+//-*****************************************************************************
+AbcA::ArrayPropertyReaderPtr ShardedAprImpl::asArrayPtr()
+{
+    return shared_from_this();
+}
+
+//-*****************************************************************************
+AbcA::ArrayPropertyReaderPtr
+ShardedAprImpl::fetchShardProperty( size_t iShard )
+{
+    return m_shards->getArray( iShard, m_objectName, m_path );
+}
+
+//-*****************************************************************************
+bool ShardedAprImpl::sameFirstSample( size_t iShardA, size_t iShardB )
+{
+    // The keys are digests of the sample contents, so this doesn't have
+    // to read the samples themselves.
+    AbcA::ArraySampleKey a;
+    AbcA::ArraySampleKey b;
+    if ( !getShardProperty( iShardA )->getKey( 0, a ) ||
+         !getShardProperty( iShardB )->getKey( 0, b ) )
+    {
+        return false;
+    }
+
+    return a == b;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
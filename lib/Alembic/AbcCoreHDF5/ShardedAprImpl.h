@@ -0,0 +1,104 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedAprImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedAprImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardedPrImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The array property reader of a sharded archive, which reads each sample
+// from the shard that holds it. The samples go through the shards' own
+// caches, which are all the sharded archive's cache.
+class ShardedAprImpl
+    : public ShardedPrImpl<AbcA::ArrayPropertyReader,
+                           ShardedAprImpl,
+                           AbcA::ArrayPropertyReaderPtr>
+    , public boost::enable_shared_from_this<ShardedAprImpl>
+{
+public:
+    ShardedAprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                    ShardSetPtr iShards,
+                    const std::string &iObjectName,
+                    const PropertyPath &iPath,
+                    PropertyHeaderPtr iHeader );
+
+    virtual void getSample( index_t iSampleIndex,
+                            AbcA::ArraySamplePtr &oSample );
+
+    virtual void getSampleAs( index_t iSampleIndex,
+                              PlainOldDataType iPod,
+                              AbcA::ArraySamplePtr &oSample );
+
+    virtual void getSamples( index_t iFirstIndex,
+                             index_t iLastIndex,
+                             std::vector<AbcA::ArraySamplePtr> &oSamples );
+
+    virtual bool getKey( index_t iSampleIndex, AbcA::ArraySampleKey &oKey );
+
+    virtual void getDimensions( index_t iSampleIndex, Dimensions &oDim );
+
+    virtual bool isScalarLike();
+
+    virtual AbcA::ArrayPropertyReaderPtr asArrayPtr();
+
+protected:
+    friend class ShardedPrImpl<AbcA::ArrayPropertyReader,
+                               ShardedAprImpl,
+                               AbcA::ArrayPropertyReaderPtr>;
+
+    // These functions are called by ShardedPrImpl.
+    AbcA::ArrayPropertyReaderPtr fetchShardProperty( size_t iShard );
+
+    bool sameFirstSample( size_t iShardA, size_t iShardB );
+
+    // -1 until it's asked for, guarded by m_mutex.
+    int m_isScalarLike;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
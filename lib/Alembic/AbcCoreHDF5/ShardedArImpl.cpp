@@ -0,0 +1,140 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardedArImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedOrImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+ShardedArImpl::ShardedArImpl( const std::string &iName, ShardSetPtr iShards )
+  : m_name( iName )
+  , m_shards( iShards )
+  , m_top( NULL )
+{
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+
+    m_top = new ShardedOrImpl( *this, m_shards );
+}
+
+//-*****************************************************************************
+const std::string &ShardedArImpl::getName() const
+{
+    return m_name;
+}
+
+//-*****************************************************************************
+const AbcA::MetaData &ShardedArImpl::getMetaData() const
+{
+    return m_shards->getMetaData();
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ShardedArImpl::getTop()
+{
+    assert( m_top );
+
+    AbcA::ObjectReaderPtr ret( m_top, Alembic::Util::NullDeleter() );
+    return ret;
+}
+
+//-*****************************************************************************
+AbcA::TimeSamplingPtr ShardedArImpl::getTimeSampling( uint32_t iIndex )
+{
+    return m_shards->getTimeSampling( iIndex );
+}
+
+//-*****************************************************************************
+AbcA::ArchiveReaderPtr ShardedArImpl::asArchivePtr()
+{
+    return shared_from_this();
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleCachePtr ShardedArImpl::getReadArraySampleCachePtr()
+{
+    return m_shards->getCache();
+}
+
+//-*****************************************************************************
+void
+ShardedArImpl::setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
+{
+    m_shards->setCache( iPtr );
+}
+
+//-*****************************************************************************
+uint32_t ShardedArImpl::getNumTimeSamplings()
+{
+    return m_shards->getNumTimeSamplings();
+}
+
+//-*****************************************************************************
+int32_t ShardedArImpl::getArchiveVersion()
+{
+    return m_shards->getArchiveVersion();
+}
+
+//-*****************************************************************************
+AbcA::ArchiveStats ShardedArImpl::getStats()
+{
+    return m_shards->getStatsCollector()->getStats();
+}
+
+//-*****************************************************************************
+void ShardedArImpl::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    m_shards->getStatsCollector()->getObjectStats( oStats );
+}
+
+//-*****************************************************************************
+void ShardedArImpl::resetStats()
+{
+    m_shards->getStatsCollector()->reset();
+}
+
+//-*****************************************************************************
+ShardedArImpl::~ShardedArImpl()
+{
+    delete m_top;
+    m_top = NULL;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,114 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedArImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedArImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardSet.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+class ShardedOrImpl;
+
+//-*****************************************************************************
+// The archive reader of a sharded archive, see ReadShardedArchive.
+class ShardedArImpl
+    : public AbcA::ArchiveReader
+    , public boost::enable_shared_from_this<ShardedArImpl>
+{
+private:
+    friend struct ReadShardedArchive;
+
+    ShardedArImpl( const std::string &iName, ShardSetPtr iShards );
+
+public:
+    virtual ~ShardedArImpl();
+
+    //-*************************************************************************
+    // ABSTRACT FUNCTIONS
+    //-*************************************************************************
+    virtual const std::string &getName() const;
+
+    virtual const AbcA::MetaData &getMetaData() const;
+
+    virtual AbcA::ObjectReaderPtr getTop();
+
+    virtual AbcA::TimeSamplingPtr getTimeSampling( uint32_t iIndex );
+
+    virtual AbcA::ArchiveReaderPtr asArchivePtr();
+
+    virtual AbcA::ReadArraySampleCachePtr getReadArraySampleCachePtr();
+
+    virtual void
+    setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr );
+
+    virtual uint32_t getNumTimeSamplings();
+
+    virtual int32_t getArchiveVersion();
+
+    virtual AbcA::ArchiveStats getStats();
+
+    virtual void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    virtual void resetStats();
+
+    //-*************************************************************************
+    // SHARDS
+    //-*************************************************************************
+    size_t getNumShards() const { return m_shards->getNumShards(); }
+
+    size_t getNumOpenShards() { return m_shards->getNumOpenShards(); }
+
+private:
+    std::string m_name;
+
+    ShardSetPtr m_shards;
+
+    ShardedOrImpl *m_top;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
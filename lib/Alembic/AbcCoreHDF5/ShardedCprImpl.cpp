@@ -0,0 +1,284 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardedCprImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedOrImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedSprImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedAprImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+ShardedCprImpl::ShardedCprImpl( ShardedOrImpl &iObject, ShardSetPtr iShards )
+  : m_topObject( &iObject )
+  , m_shards( iShards )
+  , m_objectName( iObject.getHeader().getFullName() )
+{
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+
+    readHeaders();
+}
+
+//-*****************************************************************************
+ShardedCprImpl::ShardedCprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                                ShardSetPtr iShards,
+                                const std::string &iObjectName,
+                                const PropertyPath &iPath,
+                                PropertyHeaderPtr iHeader )
+  : m_topObject( NULL )
+  , m_parent( iParent )
+  , m_shards( iShards )
+  , m_objectName( iObjectName )
+  , m_path( iPath )
+  , m_header( iHeader )
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+    ABCA_ASSERT( m_header, "Invalid header" );
+
+    readHeaders();
+}
+
+//-*****************************************************************************
+void ShardedCprImpl::readHeaders()
+{
+    AbcA::CompoundPropertyReaderPtr first =
+        m_shards->getCompound( 0, m_objectName, m_path );
+
+    if ( !m_header )
+    {
+        m_header.reset( new AbcA::PropertyHeader( first->getHeader() ) );
+    }
+
+    size_t numProperties = first->getNumProperties();
+    for ( size_t i = 0; i < numProperties; ++i )
+    {
+        PropertyHeaderPtr header(
+            new AbcA::PropertyHeader( first->getPropertyHeader( i ) ) );
+
+        // The first shard's TimeSamplings are the ones that carry on
+        // through the rest, but they are a separate copy.
+        if ( !header->isCompound() )
+        {
+            header->setTimeSampling( m_shards->getTimeSampling(
+                m_shards->getTimeSamplingIndex(
+                    *header->getTimeSampling() ) ) );
+        }
+
+        m_propertyHeaders.push_back( header );
+    }
+}
+
+//-*****************************************************************************
+const AbcA::PropertyHeader &ShardedCprImpl::getHeader() const
+{
+    ABCA_ASSERT( m_header, "Invalid header" );
+    return *m_header;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ShardedCprImpl::getObject()
+{
+    if ( m_topObject )
+    {
+        return m_topObject->asObjectPtr();
+    }
+
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    return m_parent->getObject();
+}
+
+//-*****************************************************************************
+AbcA::CompoundPropertyReaderPtr ShardedCprImpl::getParent()
+{
+    // The top compound has no parent.
+    return m_parent;
+}
+
+//-*****************************************************************************
+AbcA::CompoundPropertyReaderPtr ShardedCprImpl::asCompoundPtr()
+{
+    if ( m_topObject )
+    {
+        return m_topObject->getProperties();
+    }
+
+    return shared_from_this();
+}
+
+//-*****************************************************************************
+size_t ShardedCprImpl::getNumProperties()
+{
+    return m_propertyHeaders.size();
+}
+
+//-*****************************************************************************
+const AbcA::PropertyHeader &ShardedCprImpl::getPropertyHeader( size_t i )
+{
+    if ( i >= m_propertyHeaders.size() )
+    {
+        ABCA_THROW( "Out of range index in "
+                    << "ShardedCprImpl::getPropertyHeader: " << i );
+    }
+
+    return *m_propertyHeaders[i];
+}
+
+//-*****************************************************************************
+const AbcA::PropertyHeader *
+ShardedCprImpl::getPropertyHeader( const std::string &iName )
+{
+    for ( PropertyHeaderPtrs::iterator piter = m_propertyHeaders.begin();
+          piter != m_propertyHeaders.end(); ++piter )
+    {
+        if ( (*piter)->getName() == iName )
+        {
+            return (*piter).get();
+        }
+    }
+    return NULL;
+}
+
+//-*****************************************************************************
+PropertyHeaderPtr ShardedCprImpl::findHeader( const std::string &iName,
+                                              AbcA::PropertyType iType )
+{
+    for ( PropertyHeaderPtrs::iterator piter = m_propertyHeaders.begin();
+          piter != m_propertyHeaders.end(); ++piter )
+    {
+        if ( (*piter)->getName() == iName )
+        {
+            if ( (*piter)->getPropertyType() != iType )
+            {
+                ABCA_THROW( "Tried to read property " << iName
+                            << " as type " << iType << ", but it is type "
+                            << (*piter)->getPropertyType() );
+            }
+            return *piter;
+        }
+    }
+    return PropertyHeaderPtr();
+}
+
+//-*****************************************************************************
+AbcA::ScalarPropertyReaderPtr
+ShardedCprImpl::getScalarProperty( const std::string &iName )
+{
+    PropertyHeaderPtr header = findHeader( iName, AbcA::kScalarProperty );
+    if ( !header )
+    {
+        return AbcA::ScalarPropertyReaderPtr();
+    }
+
+    boost::mutex::scoped_lock l( m_madePropertiesMutex );
+
+    AbcA::BasePropertyReaderPtr bptr = m_madeProperties[iName].lock();
+    if ( !bptr )
+    {
+        PropertyPath path( m_path );
+        path.push_back( iName );
+
+        bptr.reset( new ShardedSprImpl( asCompoundPtr(), m_shards,
+                                        m_objectName, path, header ) );
+        m_madeProperties[iName] = bptr;
+    }
+
+    return bptr->asScalarPtr();
+}
+
+//-*****************************************************************************
+AbcA::ArrayPropertyReaderPtr
+ShardedCprImpl::getArrayProperty( const std::string &iName )
+{
+    PropertyHeaderPtr header = findHeader( iName, AbcA::kArrayProperty );
+    if ( !header )
+    {
+        return AbcA::ArrayPropertyReaderPtr();
+    }
+
+    boost::mutex::scoped_lock l( m_madePropertiesMutex );
+
+    AbcA::BasePropertyReaderPtr bptr = m_madeProperties[iName].lock();
+    if ( !bptr )
+    {
+        PropertyPath path( m_path );
+        path.push_back( iName );
+
+        bptr.reset( new ShardedAprImpl( asCompoundPtr(), m_shards,
+                                        m_objectName, path, header ) );
+        m_madeProperties[iName] = bptr;
+    }
+
+    return bptr->asArrayPtr();
+}
+
+//-*****************************************************************************
+AbcA::CompoundPropertyReaderPtr
+ShardedCprImpl::getCompoundProperty( const std::string &iName )
+{
+    PropertyHeaderPtr header = findHeader( iName, AbcA::kCompoundProperty );
+    if ( !header )
+    {
+        return AbcA::CompoundPropertyReaderPtr();
+    }
+
+    boost::mutex::scoped_lock l( m_madePropertiesMutex );
+
+    AbcA::BasePropertyReaderPtr bptr = m_madeProperties[iName].lock();
+    if ( !bptr )
+    {
+        PropertyPath path( m_path );
+        path.push_back( iName );
+
+        bptr.reset( new ShardedCprImpl( asCompoundPtr(), m_shards,
+                                        m_objectName, path, header ) );
+        m_madeProperties[iName] = bptr;
+    }
+
+    return bptr->asCompoundPtr();
+}
+
+//-*****************************************************************************
+ShardedCprImpl::~ShardedCprImpl()
+{
+    // Nothing!
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
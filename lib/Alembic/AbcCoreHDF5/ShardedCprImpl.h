@@ -0,0 +1,135 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedCprImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedCprImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardSet.h>
+#include <boost/thread/mutex.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+class ShardedOrImpl;
+
+//-*****************************************************************************
+// The compound property reader of a sharded archive. Its properties are
+// the first shard's, with the TimeSamplings of the sharded archive.
+class ShardedCprImpl
+    : public AbcA::CompoundPropertyReader
+    , public boost::enable_shared_from_this<ShardedCprImpl>
+{
+public:
+    // The top compound of iObject, which owns it. Like TopCprImpl, it
+    // doesn't hold on to its object, to avoid a circular reference.
+    ShardedCprImpl( ShardedOrImpl &iObject, ShardSetPtr iShards );
+
+    // A compound property inside iParent.
+    ShardedCprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                    ShardSetPtr iShards,
+                    const std::string &iObjectName,
+                    const PropertyPath &iPath,
+                    PropertyHeaderPtr iHeader );
+
+    virtual ~ShardedCprImpl();
+
+    //-*************************************************************************
+    // FROM ABSTRACT
+    //-*************************************************************************
+    virtual const AbcA::PropertyHeader &getHeader() const;
+
+    virtual AbcA::ObjectReaderPtr getObject();
+
+    virtual AbcA::CompoundPropertyReaderPtr getParent();
+
+    virtual AbcA::CompoundPropertyReaderPtr asCompoundPtr();
+
+    virtual size_t getNumProperties();
+
+    virtual const AbcA::PropertyHeader & getPropertyHeader( size_t i );
+
+    virtual const AbcA::PropertyHeader *
+    getPropertyHeader( const std::string &iName );
+
+    virtual AbcA::ScalarPropertyReaderPtr
+    getScalarProperty( const std::string &iName );
+
+    virtual AbcA::ArrayPropertyReaderPtr
+    getArrayProperty( const std::string &iName );
+
+    virtual AbcA::CompoundPropertyReaderPtr
+    getCompoundProperty( const std::string &iName );
+
+protected:
+    // Copies the headers from the first shard.
+    void readHeaders();
+
+    // The header of property iName, or NULL if there isn't one. Throws if
+    // the property isn't of type iType.
+    PropertyHeaderPtr findHeader( const std::string &iName,
+                                  AbcA::PropertyType iType );
+
+    // Set for the top compound only.
+    ShardedOrImpl *m_topObject;
+
+    // Set for all but the top compound.
+    AbcA::CompoundPropertyReaderPtr m_parent;
+
+    ShardSetPtr m_shards;
+
+    // Where to find this compound in each shard.
+    std::string m_objectName;
+    PropertyPath m_path;
+
+    PropertyHeaderPtr m_header;
+    PropertyHeaderPtrs m_propertyHeaders;
+
+    typedef std::map<std::string, WeakBprPtr> MadeProperties;
+    MadeProperties m_madeProperties;
+    boost::mutex m_madePropertiesMutex;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,238 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardedOrImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedArImpl.h>
+#include <Alembic/AbcCoreHDF5/ShardedCprImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+ShardedOrImpl::ShardedOrImpl( ShardedArImpl &iArchive, ShardSetPtr iShards )
+  : m_topArchive( &iArchive )
+  , m_shards( iShards )
+  , m_properties( NULL )
+{
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+
+    m_header.reset( new AbcA::ObjectHeader(
+        m_shards->getObject( 0, "/" )->getHeader() ) );
+
+    readChildHeaders();
+}
+
+//-*****************************************************************************
+ShardedOrImpl::ShardedOrImpl( AbcA::ObjectReaderPtr iParent,
+                              ShardSetPtr iShards,
+                              ObjectHeaderPtr iHeader )
+  : m_topArchive( NULL )
+  , m_parent( iParent )
+  , m_shards( iShards )
+  , m_header( iHeader )
+  , m_properties( NULL )
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+    ABCA_ASSERT( m_header, "Invalid header" );
+
+    m_archive = m_parent->getArchive();
+    ABCA_ASSERT( m_archive, "Invalid archive" );
+
+    readChildHeaders();
+}
+
+//-*****************************************************************************
+void ShardedOrImpl::readChildHeaders()
+{
+    AbcA::ObjectReaderPtr first =
+        m_shards->getObject( 0, m_header->getFullName() );
+
+    size_t numChildren = first->getNumChildren();
+    for ( size_t i = 0; i < numChildren; ++i )
+    {
+        m_childHeaders.push_back( ObjectHeaderPtr(
+            new AbcA::ObjectHeader( first->getChildHeader( i ) ) ) );
+    }
+}
+
+//-*****************************************************************************
+const AbcA::ObjectHeader &ShardedOrImpl::getHeader() const
+{
+    ABCA_ASSERT( m_header, "Invalid header" );
+    return *m_header;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveReaderPtr ShardedOrImpl::getArchive()
+{
+    if ( m_topArchive )
+    {
+        return m_topArchive->asArchivePtr();
+    }
+
+    return m_archive;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ShardedOrImpl::getParent()
+{
+    // The top object has no parent.
+    return m_parent;
+}
+
+//-*****************************************************************************
+AbcA::CompoundPropertyReaderPtr ShardedOrImpl::getProperties()
+{
+    boost::mutex::scoped_lock l( m_propertiesMutex );
+
+    if ( !m_properties )
+    {
+        m_properties = new ShardedCprImpl( *this, m_shards );
+    }
+
+    AbcA::CompoundPropertyReaderPtr ret( m_properties,
+                                         Alembic::Util::NullDeleter() );
+    return ret;
+}
+
+//-*****************************************************************************
+size_t ShardedOrImpl::getNumChildren()
+{
+    return m_childHeaders.size();
+}
+
+//-*****************************************************************************
+const AbcA::ObjectHeader & ShardedOrImpl::getChildHeader( size_t i )
+{
+    if ( i >= m_childHeaders.size() )
+    {
+        ABCA_THROW( "Out of range index in ShardedOrImpl::getChildHeader: "
+                     << i );
+    }
+
+    return *m_childHeaders[i];
+}
+
+//-*****************************************************************************
+const AbcA::ObjectHeader *
+ShardedOrImpl::getChildHeader( const std::string &iName )
+{
+    for ( size_t i = 0; i < m_childHeaders.size(); ++i )
+    {
+        if ( m_childHeaders[i]->getName() == iName )
+        {
+            return m_childHeaders[i].get();
+        }
+    }
+
+    return NULL;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ShardedOrImpl::getChild( const std::string &iName )
+{
+    ObjectHeaderPtr header;
+    for ( size_t i = 0; i < m_childHeaders.size(); ++i )
+    {
+        if ( m_childHeaders[i]->getName() == iName )
+        {
+            header = m_childHeaders[i];
+            break;
+        }
+    }
+
+    if ( !header )
+    {
+        return AbcA::ObjectReaderPtr();
+    }
+
+    boost::mutex::scoped_lock l( m_madeChildrenMutex );
+
+    AbcA::ObjectReaderPtr optr = m_madeChildren[iName].lock();
+    if ( !optr )
+    {
+        optr.reset( new ShardedOrImpl( asObjectPtr(), m_shards, header ) );
+        m_madeChildren[iName] = optr;
+    }
+
+    return optr;
+}
+
+//-*****************************************************************************
+// Instances are the first shard's too.
+bool ShardedOrImpl::isInstanceRoot()
+{
+    return m_shards->getObject( 0, m_header->getFullName() )->
+        isInstanceRoot();
+}
+
+//-*****************************************************************************
+std::string ShardedOrImpl::getInstanceSourcePath()
+{
+    return m_shards->getObject( 0, m_header->getFullName() )->
+        getInstanceSourcePath();
+}
+
+//-*****************************************************************************
+bool ShardedOrImpl::isChildInstance( const std::string &iName )
+{
+    return m_shards->getObject( 0, m_header->getFullName() )->
+        isChildInstance( iName );
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ShardedOrImpl::asObjectPtr()
+{
+    if ( m_topArchive )
+    {
+        return m_topArchive->getTop();
+    }
+
+    return shared_from_this();
+}
+
+//-*****************************************************************************
+ShardedOrImpl::~ShardedOrImpl()
+{
+    // delete NULL okay
+    delete m_properties;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,132 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedOrImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedOrImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardSet.h>
+#include <boost/thread/mutex.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+class ShardedArImpl;
+class ShardedCprImpl;
+
+//-*****************************************************************************
+// The object reader of a sharded archive. Its children are the first
+// shard's.
+class ShardedOrImpl
+    : public AbcA::ObjectReader
+    , public boost::enable_shared_from_this<ShardedOrImpl>
+{
+public:
+    // The top object of iArchive, which owns it. Like TopOrImpl, it
+    // doesn't hold on to its archive, to avoid a circular reference.
+    ShardedOrImpl( ShardedArImpl &iArchive, ShardSetPtr iShards );
+
+    // A child of iParent.
+    ShardedOrImpl( AbcA::ObjectReaderPtr iParent,
+                   ShardSetPtr iShards,
+                   ObjectHeaderPtr iHeader );
+
+    virtual ~ShardedOrImpl();
+
+    //-*************************************************************************
+    // ABSTRACT
+    //-*************************************************************************
+    virtual const AbcA::ObjectHeader &getHeader() const;
+
+    virtual AbcA::ArchiveReaderPtr getArchive();
+
+    virtual AbcA::ObjectReaderPtr getParent();
+
+    virtual AbcA::CompoundPropertyReaderPtr getProperties();
+
+    virtual size_t getNumChildren();
+
+    virtual const AbcA::ObjectHeader & getChildHeader( size_t i );
+
+    virtual const AbcA::ObjectHeader *
+    getChildHeader( const std::string &iName );
+
+    virtual AbcA::ObjectReaderPtr getChild( const std::string &iName );
+
+    virtual bool isInstanceRoot();
+
+    virtual std::string getInstanceSourcePath();
+
+    virtual bool isChildInstance( const std::string &iName );
+
+    virtual AbcA::ObjectReaderPtr asObjectPtr();
+
+protected:
+    // Copies the child headers from the first shard.
+    void readChildHeaders();
+
+    // Set for the top object only.
+    ShardedArImpl *m_topArchive;
+
+    // Set for all but the top object.
+    AbcA::ArchiveReaderPtr m_archive;
+    AbcA::ObjectReaderPtr m_parent;
+
+    ShardSetPtr m_shards;
+
+    ObjectHeaderPtr m_header;
+
+    // The properties
+    // We own these, and they only refer back to us by reference.
+    ShardedCprImpl *m_properties;
+    boost::mutex m_propertiesMutex;
+
+    // The children
+    std::vector<ObjectHeaderPtr> m_childHeaders;
+    std::map<std::string, WeakOrPtr> m_madeChildren;
+    boost::mutex m_madeChildrenMutex;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
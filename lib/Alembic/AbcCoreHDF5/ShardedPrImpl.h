@@ -0,0 +1,384 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedPrImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedPrImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardSet.h>
+#include <boost/thread/mutex.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// This templated base class implements what the scalar and array property
+// readers of a sharded archive have in common, which is working out which
+// shard holds a sample, the same way SimplePrImpl does for the properties
+// of a single archive.
+//
+// Sample i of a property is sample i - s of the last shard that starts at
+// or before i, s being the index on the merged TimeSampling that the
+// shard starts at. Past the end of that shard's samples, a shard with only
+// one sample holds it, as properties that don't change are only written
+// once per shard, and any other shard leaves a gap, which throws.
+//
+// The IMPL class is assumed to have the following functions:
+// READER_PTR fetchShardProperty( size_t iShard );
+// bool sameFirstSample( size_t iShardA, size_t iShardB );
+//
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+class ShardedPrImpl : public ABSTRACT
+{
+protected:
+    ShardedPrImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                   ShardSetPtr iShards,
+                   const std::string &iObjectName,
+                   const PropertyPath &iPath,
+                   PropertyHeaderPtr iHeader );
+
+public:
+    //-*************************************************************************
+    // ABSTRACT API
+    //-*************************************************************************
+    virtual const AbcA::PropertyHeader &getHeader() const;
+
+    virtual AbcA::ObjectReaderPtr getObject();
+
+    virtual AbcA::CompoundPropertyReaderPtr getParent();
+
+    virtual size_t getNumSamples();
+
+    virtual bool isConstant();
+
+    virtual std::pair<index_t, chrono_t> getFloorIndex( chrono_t iTime );
+
+    virtual std::pair<index_t, chrono_t> getCeilIndex( chrono_t iTime );
+
+    virtual std::pair<index_t, chrono_t> getNearIndex( chrono_t iTime );
+
+protected:
+    // This property's reader in a shard, checked against the header.
+    READER_PTR getShardProperty( size_t iShard );
+
+    size_t getShardNumSamples( size_t iShard );
+
+    // Finds the shard holding sample iIndex, and the sample's index there.
+    void findSample( index_t iIndex, size_t &oShard, index_t &oShardIndex );
+
+    // Parent compound property reader. It must exist.
+    AbcA::CompoundPropertyReaderPtr m_parent;
+
+    ShardSetPtr m_shards;
+
+    // Where to find this property in each shard.
+    std::string m_objectName;
+    PropertyPath m_path;
+
+    // The header, with the merged TimeSampling.
+    PropertyHeaderPtr m_header;
+    uint32_t m_timeSamplingIndex;
+
+    // Everything below is worked out as it's needed, -1 until then.
+    boost::mutex m_mutex;
+    std::vector<index_t> m_shardNumSamples;
+    index_t m_numSamples;
+    int m_isConstant;
+};
+
+//-*****************************************************************************
+//-*****************************************************************************
+//-*****************************************************************************
+// IMPLEMENTATION
+//-*****************************************************************************
+//-*****************************************************************************
+//-*****************************************************************************
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::ShardedPrImpl
+(
+    AbcA::CompoundPropertyReaderPtr iParent,
+    ShardSetPtr iShards,
+    const std::string &iObjectName,
+    const PropertyPath &iPath,
+    PropertyHeaderPtr iHeader
+)
+  : m_parent( iParent )
+  , m_shards( iShards )
+  , m_objectName( iObjectName )
+  , m_path( iPath )
+  , m_header( iHeader )
+  , m_timeSamplingIndex( 0 )
+  , m_numSamples( -1 )
+  , m_isConstant( -1 )
+{
+    // Validate all inputs.
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_shards, "Invalid shards" );
+    ABCA_ASSERT( m_header, "Invalid header" );
+    ABCA_ASSERT( m_header->getPropertyType() != AbcA::kCompoundProperty,
+                 "Tried to create a simple property with a compound header" );
+
+    m_timeSamplingIndex =
+        m_shards->getTimeSamplingIndex( *m_header->getTimeSampling() );
+
+    m_shardNumSamples.resize( m_shards->getNumShards(), -1 );
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+const AbcA::PropertyHeader &
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getHeader() const
+{
+    ABCA_ASSERT( m_header, "Invalid header" );
+    return *m_header;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+AbcA::ObjectReaderPtr
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getObject()
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    return m_parent->getObject();
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+AbcA::CompoundPropertyReaderPtr
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getParent()
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    return m_parent;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+READER_PTR
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getShardProperty( size_t iShard )
+{
+    READER_PTR ptr =
+        static_cast<IMPL *>( this )->fetchShardProperty( iShard );
+
+    ABCA_ASSERT( ptr->getHeader().getDataType() == m_header->getDataType(),
+                 "Property " << m_header->getName() << " of "
+                 << m_objectName << " doesn't have the same DataType in "
+                 << m_shards->getFileName( iShard ) << " as in "
+                 << m_shards->getFileName( 0 ) );
+
+    return ptr;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+size_t
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getShardNumSamples( size_t iShard )
+{
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        if ( m_shardNumSamples[iShard] >= 0 )
+        {
+            return m_shardNumSamples[iShard];
+        }
+    }
+
+    // Not holding the lock, since this may have to open the shard.
+    index_t numSamples = getShardProperty( iShard )->getNumSamples();
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_shardNumSamples[iShard] = numSamples;
+    return numSamples;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+size_t ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getNumSamples()
+{
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        if ( m_numSamples >= 0 )
+        {
+            return m_numSamples;
+        }
+    }
+
+    // Up to the end of the last shard with any samples, which is usually
+    // the last shard.
+    index_t numSamples = 0;
+    for ( size_t k = m_shards->getNumShards(); k-- > 0; )
+    {
+        index_t shardSamples = getShardNumSamples( k );
+        if ( shardSamples > 0 )
+        {
+            numSamples = shardSamples +
+                m_shards->getStartIndex( m_timeSamplingIndex, k );
+            break;
+        }
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_numSamples = numSamples;
+    return numSamples;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+bool ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::isConstant()
+{
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        if ( m_isConstant >= 0 )
+        {
+            return m_isConstant == 1;
+        }
+    }
+
+    // Constant in every shard, with the same value in each. This has to
+    // look at every shard, so it isn't worked out until it's asked for.
+    size_t numShards = m_shards->getNumShards();
+    size_t firstShard = numShards;
+    bool constant = true;
+    for ( size_t k = 0; k < numShards && constant; ++k )
+    {
+        if ( getShardNumSamples( k ) == 0 )
+        {
+            continue;
+        }
+
+        if ( !getShardProperty( k )->isConstant() )
+        {
+            constant = false;
+        }
+        else if ( firstShard == numShards )
+        {
+            firstShard = k;
+        }
+        else
+        {
+            constant = static_cast<IMPL *>( this )->sameFirstSample(
+                firstShard, k );
+        }
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    m_isConstant = constant ? 1 : 0;
+    return constant;
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+void ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::findSample(
+    index_t iIndex, size_t &oShard, index_t &oShardIndex )
+{
+    index_t numSamples = getNumSamples();
+
+    ABCA_ASSERT( iIndex >= 0 && iIndex < numSamples,
+                 "Invalid sample index: " << iIndex
+                 << ", should be between 0 and " << numSamples - 1 );
+
+    for ( size_t k = m_shards->getNumShards(); k-- > 0; )
+    {
+        index_t start = m_shards->getStartIndex( m_timeSamplingIndex, k );
+        if ( start > iIndex )
+        {
+            continue;
+        }
+
+        index_t shardSamples = getShardNumSamples( k );
+        if ( shardSamples == 0 )
+        {
+            continue;
+        }
+
+        index_t shardIndex = iIndex - start;
+        if ( shardIndex >= shardSamples )
+        {
+            ABCA_ASSERT( shardSamples == 1,
+                         "Sample " << iIndex << " of property "
+                         << m_header->getName() << " of " << m_objectName
+                         << " is in a gap after the end of "
+                         << m_shards->getFileName( k ) );
+
+            shardIndex = 0;
+        }
+
+        oShard = k;
+        oShardIndex = shardIndex;
+        return;
+    }
+
+    ABCA_THROW( "No shard holds sample " << iIndex << " of property "
+                << m_header->getName() << " of " << m_objectName );
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+std::pair<index_t, chrono_t>
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getFloorIndex( chrono_t iTime )
+{
+    return m_header->getTimeSampling()->getFloorIndex( iTime,
+                                                       getNumSamples() );
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+std::pair<index_t, chrono_t>
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getCeilIndex( chrono_t iTime )
+{
+    return m_header->getTimeSampling()->getCeilIndex( iTime,
+                                                      getNumSamples() );
+}
+
+//-*****************************************************************************
+template <class ABSTRACT, class IMPL, class READER_PTR>
+std::pair<index_t, chrono_t>
+ShardedPrImpl<ABSTRACT,IMPL,READER_PTR>::getNearIndex( chrono_t iTime )
+{
+    return m_header->getTimeSampling()->getNearIndex( iTime,
+                                                      getNumSamples() );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
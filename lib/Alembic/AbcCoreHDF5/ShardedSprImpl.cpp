@@ -0,0 +1,98 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/ShardedSprImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+void ShardedSprImpl::getSample( index_t iSampleIndex, void *oSample )
+{
+    size_t shard = 0;
+    index_t shardIndex = 0;
+    findSample( iSampleIndex, shard, shardIndex );
+
+    getShardProperty( shard )->getSample( shardIndex, oSample );
+}
+
+//-*****************************************************************************
+AbcA::ScalarPropertyReaderPtr ShardedSprImpl::asScalarPtr()
+{
+    return shared_from_this();
+}
+
+//-*****************************************************************************
+AbcA::ScalarPropertyReaderPtr
+ShardedSprImpl::fetchShardProperty( size_t iShard )
+{
+    return m_shards->getScalar( iShard, m_objectName, m_path );
+}
+
+//-*****************************************************************************
+bool ShardedSprImpl::sameFirstSample( size_t iShardA, size_t iShardB )
+{
+    const AbcA::DataType &dataType = m_header->getDataType();
+    size_t extent = dataType.getExtent();
+
+    if ( dataType.getPod() == kStringPOD )
+    {
+        std::vector<std::string> a( extent );
+        std::vector<std::string> b( extent );
+        getShardProperty( iShardA )->getSample( 0, &a.front() );
+        getShardProperty( iShardB )->getSample( 0, &b.front() );
+        return a == b;
+    }
+    else if ( dataType.getPod() == kWstringPOD )
+    {
+        std::vector<std::wstring> a( extent );
+        std::vector<std::wstring> b( extent );
+        getShardProperty( iShardA )->getSample( 0, &a.front() );
+        getShardProperty( iShardB )->getSample( 0, &b.front() );
+        return a == b;
+    }
+
+    std::vector<Alembic::Util::uint8_t> a( dataType.getNumBytes() );
+    std::vector<Alembic::Util::uint8_t> b( dataType.getNumBytes() );
+    getShardProperty( iShardA )->getSample( 0, &a.front() );
+    getShardProperty( iShardB )->getSample( 0, &b.front() );
+    return a == b;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,95 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_ShardedSprImpl_h_
+#define _Alembic_AbcCoreHDF5_ShardedSprImpl_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+#include <Alembic/AbcCoreHDF5/ShardedPrImpl.h>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The scalar property reader of a sharded archive, which reads each
+// sample from the shard that holds it.
+class ShardedSprImpl
+    : public ShardedPrImpl<AbcA::ScalarPropertyReader,
+                           ShardedSprImpl,
+                           AbcA::ScalarPropertyReaderPtr>
+    , public boost::enable_shared_from_this<ShardedSprImpl>
+{
+public:
+    ShardedSprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                    ShardSetPtr iShards,
+                    const std::string &iObjectName,
+                    const PropertyPath &iPath,
+                    PropertyHeaderPtr iHeader )
+      : ShardedPrImpl<AbcA::ScalarPropertyReader, ShardedSprImpl,
+                      AbcA::ScalarPropertyReaderPtr>
+        ( iParent, iShards, iObjectName, iPath, iHeader )
+    {
+        if ( m_header->getPropertyType() != AbcA::kScalarProperty )
+        {
+            ABCA_THROW( "Attempted to create a ScalarPropertyReader from a "
+                        "non-scalar property type" );
+        }
+    }
+
+    virtual void getSample( index_t iSampleIndex, void *oSample );
+
+    virtual AbcA::ScalarPropertyReaderPtr asScalarPtr();
+
+protected:
+    friend class ShardedPrImpl<AbcA::ScalarPropertyReader,
+                               ShardedSprImpl,
+                               AbcA::ScalarPropertyReaderPtr>;
+
+    // These functions are called by ShardedPrImpl.
+    AbcA::ScalarPropertyReaderPtr fetchShardProperty( size_t iShard );
+
+    bool sameFirstSample( size_t iShardA, size_t iShardB );
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
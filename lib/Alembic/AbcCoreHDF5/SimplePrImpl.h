@@ -146,6 +146,11 @@ protected:
     // sample in a sub group. Therefore, there may not actually be
     // a group associated with this property.
     hid_t m_samplesIGroup;
+
+    // Where the samples read through this property are counted, for
+    // the archive and for the object it belongs to.
+    StatsCollectorPtr m_stats;
+    StatsBlockPtr m_objectStats;
 };
 
 //-*****************************************************************************
@@ -207,6 +212,10 @@ SimplePrImpl<ABSTRACT,IMPL,SAMPLE>::SimplePrImpl
                  << " first change index: " << m_firstChangedIndex
                  << " last change index: " << m_lastChangedIndex
                  << " total number of samples: " << m_numSamples );
+
+    AbcA::ObjectReaderPtr object = m_parent->getObject();
+    m_stats = GetStatsCollector( object->getArchive() );
+    m_objectStats = m_stats->getObjectBlock( object->getFullName() );
 }
 
 //-*****************************************************************************
@@ -310,9 +319,19 @@ void
 SimplePrImpl<ABSTRACT,IMPL,SAMPLE>::getSample( index_t iSampleIndex,
                                                SAMPLE oSample )
 {
+    StatsScope scope( m_stats.get(), m_objectStats.get() );
 
     iSampleIndex = verifySampleIndex( iSampleIndex );
 
+    if ( m_header->getPropertyType() == AbcA::kScalarProperty )
+    {
+        ++scope.stats().scalarSamplesRead;
+    }
+    else
+    {
+        ++scope.stats().arraySamplesRead;
+    }
+
     // Get our name.
     const std::string &myName = m_header->getName();
 
@@ -39,6 +39,7 @@
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/WriteUtil.h>
+#include <Alembic/AbcCoreHDF5/ReadUtil.h>
 #include <Alembic/AbcCoreHDF5/DataTypeRegistry.h>
 #include <Alembic/AbcCoreHDF5/HDF5Util.h>
 
@@ -64,9 +65,16 @@ namespace ALEMBIC_VERSION_NS {
 // The IMPL class is assumed to have the following functions:
 // KEY  computeSampleKey( SAMPLE iSamp ) const;
 // bool sameAsPreviousSample( SAMPLE iSamp, const KEY &iKey ) const;
+// void prepareSample( SAMPLE iSamp, const KEY &iKey );
 // void copyPreviousSample( index_t iSampleIndex );
 // void writeSample( index_t iSampleIndex, SAMPLE iSamp, const KEY &iKey );
 //
+// Different objects of an archive may be written from different threads.
+// The first three are called without the archive's write mutex, so they
+// must not touch the file or anything shared by the whole archive; this
+// is where the expensive work that can be done at the same time goes.
+// Everything else is called with it locked.
+//
 //-*****************************************************************************
 template <class ABSTRACT, class IMPL, class SAMPLE, class KEY>
 class SimplePwImpl : public ABSTRACT
@@ -93,7 +101,7 @@ public:
 
     virtual AbcA::CompoundPropertyWriterPtr getParent();
 
-private:
+protected:
     hid_t getSampleIGroup();
 
 public:
@@ -141,6 +149,20 @@ protected:
 
     // Index representing which TimeSampling from the ArchiveWriter to use.
     uint32_t m_timeSamplingIndex;
+
+    // The archive's write mutex, see AwImpl::getWriteMutex.
+    boost::recursive_mutex &m_writeMutex;
+
+    // Where the samples written through this property are counted, for
+    // the archive and for the object it belongs to.
+    StatsCollector &m_stats;
+    StatsBlockPtr m_objectStats;
+
+    // Set when the property was already in the file, because the archive
+    // was reopened by AppendArchive. The indices above are then the ones
+    // it was written with, and m_wasScalarLike is its scalar like hint.
+    bool m_isReopened;
+    bool m_wasScalarLike;
 };
 
 //-*****************************************************************************
@@ -174,9 +196,36 @@ SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::SimplePwImpl
   , m_firstChangedIndex( 0 )
   , m_lastChangedIndex( 0 )
   , m_timeSamplingIndex(iTimeSamplingIndex)
+  , m_writeMutex( GetWriteMutex( iParent->getObject()->getArchive() ) )
+  , m_stats( GetStatsCollector( iParent->getObject()->getArchive() ) )
+  , m_objectStats( m_stats.getObjectBlock(
+                       iParent->getObject()->getFullName() ) )
+  , m_isReopened( false )
+  , m_wasScalarLike( false )
 {
     // Check the validity of all inputs.
     ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_parentGroup >= 0, "Invalid parent group" );
+
+    // A property that's already in the file carries on from its last
+    // sample, with the MetaData and TimeSampling it was written with.
+    AbcA::MetaData metaData = iMetaData;
+    const std::string infoName = iName + ".info";
+    if ( H5Aexists( m_parentGroup, infoName.c_str() ) > 0 )
+    {
+        AbcA::PropertyHeader header;
+        ReadPropertyHeader( m_parentGroup, iName, header, m_wasScalarLike,
+                            m_nextSampleIndex, m_firstChangedIndex,
+                            m_lastChangedIndex, m_timeSamplingIndex );
+
+        ABCA_ASSERT( header.getPropertyType() == iPropType &&
+                     header.getDataType() == iDataType,
+                     "Can't reopen property: " << iName
+                     << " with a different type" );
+
+        metaData = header.getMetaData();
+        m_isReopened = true;
+    }
 
     // will assert if TimeSamplingPtr not found
     AbcA::TimeSamplingPtr ts =
@@ -184,10 +233,9 @@ SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::SimplePwImpl
             m_timeSamplingIndex );
 
     m_header = PropertyHeaderPtr( new AbcA::PropertyHeader( iName, iPropType,
-        iMetaData, iDataType, ts ) );
+        metaData, iDataType, ts ) );
 
     ABCA_ASSERT( m_header, "Invalid property header" );
-    ABCA_ASSERT( m_parentGroup >= 0, "Invalid parent group" );
     ABCA_ASSERT( m_header->getDataType().getExtent() > 0,
         "Invalid DatatType extent");
  
@@ -204,8 +252,11 @@ SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::SimplePwImpl
         ABCA_ASSERT( m_nativeDataType >= 0, "Couldn't get native datatype" );
     }
 
-    WriteMetaData( m_parentGroup, m_header->getName() + ".meta",
-        m_header->getMetaData() );
+    if ( !m_isReopened )
+    {
+        WriteMetaData( m_parentGroup, m_header->getName() + ".meta",
+            m_header->getMetaData() );
+    }
 }
 
 //-*****************************************************************************
@@ -254,7 +305,19 @@ hid_t SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::getSampleIGroup()
                  "can't create sampleI group before numSamples > 1" );
 
     const std::string groupName = m_header->getName() + ".smpi";
-    
+
+    // A reopened property may have written it already.
+    if ( GroupExists( m_parentGroup, groupName ) )
+    {
+        m_sampleIGroup = H5Gopen2( m_parentGroup, groupName.c_str(),
+                                   H5P_DEFAULT );
+        ABCA_ASSERT( m_sampleIGroup >= 0,
+                     "Could not open simple samples group named: "
+                     << groupName );
+
+        return m_sampleIGroup;
+    }
+
     hid_t copl = CreationOrderPlist();
     PlistCloser plistCloser( copl );
     
@@ -284,12 +347,31 @@ void SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::setSample
         "Can not write more samples than we have times for when using "
         "Acyclic sampling." );
 
+    StatsScope scope( &m_stats, m_objectStats.get() );
+    if ( m_header->getPropertyType() == AbcA::kScalarProperty )
+    {
+        ++scope.stats().scalarSamplesWritten;
+    }
+    else
+    {
+        ++scope.stats().arraySamplesWritten;
+    }
+
     // The Key helps us analyze the sample.
     KEY key = static_cast<IMPL*>(this)->computeSampleKey( iSamp );
 
+    bool isChanged = m_nextSampleIndex == 0  ||
+        !(static_cast<IMPL*>(this)->sameAsPreviousSample( iSamp, key ));
+
+    if ( isChanged )
+    {
+        static_cast<IMPL*>(this)->prepareSample( iSamp, key );
+    }
+
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     // We need to write the sample
-    if ( m_nextSampleIndex == 0  ||
-        !(static_cast<IMPL*>(this)->sameAsPreviousSample( iSamp, key )) )
+    if ( isChanged )
     {
         const std::string &myName = m_header->getName();
 
@@ -377,6 +459,8 @@ void SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::setTimeSamplingIndex
 template <class ABSTRACT, class IMPL, class SAMPLE, class KEY>
 SimplePwImpl<ABSTRACT,IMPL,SAMPLE,KEY>::~SimplePwImpl()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     // Wrap the whole thing in a try block, so as to prevent
     // exceptions from being thrown out of a destructor.
     try
@@ -37,6 +37,7 @@
 #include <Alembic/AbcCoreHDF5/SpwImpl.h>
 #include <Alembic/AbcCoreHDF5/WriteUtil.h>
 #include <Alembic/AbcCoreHDF5/StringWriteUtil.h>
+#include <Alembic/AbcCoreHDF5/StringReadUtil.h>
 #include <Alembic/AbcCoreHDF5/DataTypeRegistry.h>
 #include <Alembic/AbcCoreHDF5/HDF5Util.h>
 
@@ -68,11 +69,20 @@ SpwImpl::SpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
         ABCA_THROW( "Attempted to create a ScalarPropertyWriter from a "
                     "non-scalar property type" );
     }
+
+    // The next sample is compared against, and repeats, the last one
+    // that was written before the archive was reopened.
+    if ( m_isReopened && m_nextSampleIndex > 0 )
+    {
+        restorePreviousSample();
+    }
 }
 
 //-*****************************************************************************
 SpwImpl::~SpwImpl()
 {
+    boost::recursive_mutex::scoped_lock l( m_writeMutex );
+
     WritePropertyInfo( m_parentGroup, m_header->getName(),
         m_header->getPropertyType(), m_header->getDataType(), true,
         m_timeSamplingIndex, m_nextSampleIndex, m_firstChangedIndex,
@@ -85,6 +95,61 @@ AbcA::ScalarPropertyWriterPtr SpwImpl::asScalarPtr()
     return shared_from_this();
 }
 
+//-*****************************************************************************
+void SpwImpl::restorePreviousSample()
+{
+    const AbcA::DataType &dtype = m_header->getDataType();
+    uint8_t extent = dtype.getExtent();
+
+    const std::string sampleName =
+        getSampleName( m_header->getName(), m_lastChangedIndex );
+    hid_t group = m_lastChangedIndex == 0 ? m_parentGroup : getSampleIGroup();
+
+    if ( dtype.getPod() == kStringPOD )
+    {
+        std::vector<std::string> strings( extent );
+        if ( extent == 1 )
+        {
+            ReadString( group, sampleName, strings.front() );
+        }
+        else
+        {
+            ReadStrings( group, sampleName, extent, &strings.front() );
+        }
+        m_previousSample.copyFrom( &strings.front() );
+    }
+    else if ( dtype.getPod() == kWstringPOD )
+    {
+        std::vector<std::wstring> wstrings( extent );
+        if ( extent == 1 )
+        {
+            ReadWstring( group, sampleName, wstrings.front() );
+        }
+        else
+        {
+            ReadWstrings( group, sampleName, extent, &wstrings.front() );
+        }
+        m_previousSample.copyFrom( &wstrings.front() );
+    }
+    else
+    {
+        std::vector<uint8_t> bytes( dtype.getNumBytes() );
+        if ( extent == 1 )
+        {
+            ReadScalar( group, sampleName, m_fileDataType, m_nativeDataType,
+                        &bytes.front() );
+        }
+        else
+        {
+            size_t readElements = 0;
+            ReadSmallArray( group, sampleName, m_fileDataType,
+                            m_nativeDataType, extent, readElements,
+                            &bytes.front() );
+        }
+        m_previousSample.copyFrom( &bytes.front() );
+    }
+}
+
 //-*****************************************************************************
 void SpwImpl::copyPreviousSample( hid_t iGroup,
                                   const std::string &iSampleName,
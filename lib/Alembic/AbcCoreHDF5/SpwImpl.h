@@ -76,6 +76,10 @@ protected:
 
     AbcA::ScalarPropertyWriterPtr asScalarPtr();
 
+    // Reads the last sample a reopened property wrote back into
+    // m_previousSample.
+    void restorePreviousSample();
+
 public:
     virtual ~SpwImpl();
 
@@ -95,6 +99,10 @@ public:
                                                       1.0e-9 );
     }
 
+    //-*************************************************************************
+    // Scalar samples are too small to be worth preparing.
+    void prepareSample( const void *iSamp, const ScalarSampleKey &iKey ) {}
+
     //-*************************************************************************
     void copyPreviousSample( hid_t iGroup,
                              const std::string &iSampleName,
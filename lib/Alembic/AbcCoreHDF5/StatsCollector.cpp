@@ -0,0 +1,375 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
+#include <Alembic/AbcCoreHDF5/HDF5Util.h>
+
+#include <boost/thread/tss.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// What a thread is counting to, and its block of each collector it has
+// counted to, by the collectors' ids.
+struct ThreadStats
+{
+    ThreadStats() : current( NULL ) {}
+
+    AbcA::ArchiveStats *current;
+
+    typedef std::map<uint64_t, boost::weak_ptr<StatsBlock> > BlockMap;
+    BlockMap blocks;
+};
+
+boost::thread_specific_ptr<ThreadStats> g_threadStats;
+
+boost::mutex g_nextIdMutex;
+uint64_t g_nextId = 0;
+
+//-*****************************************************************************
+ThreadStats &GetThreadStats()
+{
+    ThreadStats *ret = g_threadStats.get();
+    if ( !ret )
+    {
+        ret = new ThreadStats();
+        g_threadStats.reset( ret );
+    }
+    return *ret;
+}
+
+//-*****************************************************************************
+float64_t Seconds()
+{
+    static const boost::posix_time::ptime epoch(
+        boost::gregorian::date( 2000, 1, 1 ) );
+
+    return ( boost::posix_time::microsec_clock::universal_time() - epoch ).
+        total_microseconds() * 1.0e-6;
+}
+
+//-*****************************************************************************
+void AddBlock( StatsBlock &iBlock, const AbcA::ArchiveStats &iStats )
+{
+    boost::mutex::scoped_lock l( iBlock.mutex );
+    iBlock.stats += iStats;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveStats GetBlock( StatsBlock &iBlock )
+{
+    boost::mutex::scoped_lock l( iBlock.mutex );
+    return iBlock.stats;
+}
+
+//-*****************************************************************************
+void ResetBlock( StatsBlock &iBlock )
+{
+    boost::mutex::scoped_lock l( iBlock.mutex );
+    iBlock.stats = AbcA::ArchiveStats();
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+StatsCollector::StatsCollector()
+{
+    boost::mutex::scoped_lock l( g_nextIdMutex );
+    m_id = g_nextId++;
+}
+
+//-*****************************************************************************
+StatsBlockPtr StatsCollector::getObjectBlock( const std::string &iFullName )
+{
+    // Writers name the children of the top object "//child", readers
+    // "/child", they go in the same list.
+    std::string name = iFullName;
+    if ( boost::starts_with( name, "//" ) )
+    {
+        name.erase( 0, 1 );
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+
+    StatsBlockPtr &ret = m_objectBlocks[name];
+    if ( !ret )
+    {
+        ret.reset( new StatsBlock() );
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+void StatsCollector::add( const AbcA::ArchiveStats &iStats,
+                          StatsBlock *iObject )
+{
+    ThreadStats &threadStats = GetThreadStats();
+
+    StatsBlockPtr block;
+    ThreadStats::BlockMap::iterator fiter = threadStats.blocks.find( m_id );
+    if ( fiter != threadStats.blocks.end() )
+    {
+        block = (*fiter).second.lock();
+    }
+
+    if ( !block )
+    {
+        block.reset( new StatsBlock() );
+        {
+            boost::mutex::scoped_lock l( m_mutex );
+            m_threadBlocks.push_back( block );
+        }
+
+        // Forget the blocks of collectors that are gone while we're here.
+        for ( ThreadStats::BlockMap::iterator it = threadStats.blocks.begin();
+              it != threadStats.blocks.end(); )
+        {
+            if ( (*it).second.expired() )
+            {
+                threadStats.blocks.erase( it++ );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        threadStats.blocks[m_id] = block;
+    }
+
+    AddBlock( *block, iStats );
+
+    if ( iObject )
+    {
+        AddBlock( *iObject, iStats );
+    }
+}
+
+//-*****************************************************************************
+AbcA::ArchiveStats StatsCollector::getStats()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    AbcA::ArchiveStats ret;
+    for ( std::vector<StatsBlockPtr>::iterator it = m_threadBlocks.begin();
+          it != m_threadBlocks.end(); ++it )
+    {
+        ret += GetBlock( **it );
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+void StatsCollector::getObjectStats( AbcA::ObjectStatsVec &oStats )
+{
+    oStats.clear();
+
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+
+        for ( std::map<std::string, StatsBlockPtr>::iterator it =
+                  m_objectBlocks.begin(); it != m_objectBlocks.end(); ++it )
+        {
+            AbcA::ArchiveStats stats = GetBlock( *(*it).second );
+
+            // Objects whose properties were only opened.
+            if ( stats.totalBytes() > 0 || stats.scalarSamplesRead > 0 ||
+                 stats.arraySamplesRead > 0 ||
+                 stats.scalarSamplesWritten > 0 ||
+                 stats.arraySamplesWritten > 0 )
+            {
+                oStats.push_back( AbcA::ObjectStats( (*it).first, stats ) );
+            }
+        }
+    }
+
+    AbcA::SortHotObjects( oStats );
+}
+
+//-*****************************************************************************
+void StatsCollector::reset()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    for ( std::vector<StatsBlockPtr>::iterator it = m_threadBlocks.begin();
+          it != m_threadBlocks.end(); ++it )
+    {
+        ResetBlock( **it );
+    }
+
+    for ( std::map<std::string, StatsBlockPtr>::iterator it =
+              m_objectBlocks.begin(); it != m_objectBlocks.end(); ++it )
+    {
+        ResetBlock( *(*it).second );
+    }
+}
+
+//-*****************************************************************************
+StatsScope::StatsScope( StatsCollector *iCollector, StatsBlock *iObject )
+  : m_collector( iCollector )
+  , m_object( iObject )
+{
+    ThreadStats &threadStats = GetThreadStats();
+    m_previous = threadStats.current;
+    threadStats.current = &m_stats;
+}
+
+//-*****************************************************************************
+StatsScope::~StatsScope()
+{
+    g_threadStats->current = m_previous;
+
+    if ( m_collector )
+    {
+        m_collector->add( m_stats, m_object );
+    }
+}
+
+//-*****************************************************************************
+AbcA::ArchiveStats *CurrentStats()
+{
+    ThreadStats *threadStats = g_threadStats.get();
+    return threadStats ? threadStats->current : NULL;
+}
+
+//-*****************************************************************************
+StatsTimer::StatsTimer( float64_t AbcA::ArchiveStats::*iSeconds,
+                        uint64_t AbcA::ArchiveStats::*iCalls )
+  : m_stats( CurrentStats() )
+  , m_seconds( iSeconds )
+  , m_start( 0.0 )
+{
+    // Outside of a scope, not even the clock is read.
+    if ( m_stats )
+    {
+        if ( iCalls )
+        {
+            ++( m_stats->*iCalls );
+        }
+        m_start = Seconds();
+    }
+}
+
+//-*****************************************************************************
+StatsTimer::~StatsTimer()
+{
+    if ( m_stats )
+    {
+        m_stats->*m_seconds += Seconds() - m_start;
+    }
+}
+
+//-*****************************************************************************
+herr_t StatsH5Aread( hid_t iAttr, hid_t iMemType, void *oBuf )
+{
+    StatsTimer timer( &AbcA::ArchiveStats::storageSeconds,
+                      &AbcA::ArchiveStats::storageCalls );
+
+    herr_t status = H5Aread( iAttr, iMemType, oBuf );
+
+    if ( status >= 0 && CurrentStats() )
+    {
+        CountStats( &AbcA::ArchiveStats::bytesRead,
+                    H5Aget_storage_size( iAttr ) );
+    }
+    return status;
+}
+
+//-*****************************************************************************
+herr_t StatsH5Awrite( hid_t iAttr, hid_t iMemType, const void *iBuf )
+{
+    StatsTimer timer( &AbcA::ArchiveStats::storageSeconds,
+                      &AbcA::ArchiveStats::storageCalls );
+
+    herr_t status = H5Awrite( iAttr, iMemType, iBuf );
+
+    if ( status >= 0 && CurrentStats() )
+    {
+        CountStats( &AbcA::ArchiveStats::bytesWritten,
+                    H5Aget_storage_size( iAttr ) );
+    }
+    return status;
+}
+
+//-*****************************************************************************
+herr_t StatsH5Dread( hid_t iDset, hid_t iMemType, void *oBuf )
+{
+    StatsTimer timer( &AbcA::ArchiveStats::storageSeconds,
+                      &AbcA::ArchiveStats::storageCalls );
+
+    herr_t status = H5Dread( iDset, iMemType, H5S_ALL, H5S_ALL,
+                             H5P_DEFAULT, oBuf );
+
+    if ( status >= 0 && CurrentStats() )
+    {
+        CountStats( &AbcA::ArchiveStats::bytesRead,
+                    H5Dget_storage_size( iDset ) );
+    }
+    return status;
+}
+
+//-*****************************************************************************
+herr_t StatsH5Dwrite( hid_t iDset, hid_t iMemType, const void *iBuf )
+{
+    StatsTimer timer( &AbcA::ArchiveStats::storageSeconds,
+                      &AbcA::ArchiveStats::storageCalls );
+
+    herr_t status = H5Dwrite( iDset, iMemType, H5S_ALL, H5S_ALL,
+                              H5P_DEFAULT, iBuf );
+
+    // The bytes handed over, a chunked dataset may not have been stored
+    // yet to know its size.
+    if ( status >= 0 && CurrentStats() )
+    {
+        hid_t dspaceId = H5Dget_space( iDset );
+        if ( dspaceId >= 0 )
+        {
+            DspaceCloser dspaceCloser( dspaceId );
+            CountStats( &AbcA::ArchiveStats::bytesWritten,
+                        H5Sget_select_npoints( dspaceId ) *
+                        H5Tget_size( iMemType ) );
+        }
+    }
+    return status;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
@@ -0,0 +1,174 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreHDF5_StatsCollector_h_
+#define _Alembic_AbcCoreHDF5_StatsCollector_h_
+
+#include <Alembic/AbcCoreHDF5/Foundation.h>
+
+#include <boost/thread/mutex.hpp>
+
+namespace Alembic {
+namespace AbcCoreHDF5 {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// What one thread, or one object, has counted, and the lock that lets it
+// be added up while it's still being counted to.
+struct StatsBlock
+{
+    boost::mutex mutex;
+    AbcA::ArchiveStats stats;
+};
+
+typedef boost::shared_ptr<StatsBlock> StatsBlockPtr;
+
+//-*****************************************************************************
+// The counts an archive keeps, see AbcA::ArchiveStats. Each thread adds
+// to a block of its own, so threads reading or writing at the same time
+// don't wait on each other, and to the block of the object it read or
+// wrote for, which they only share when they share the object.
+// The storage calls counted are HDF5's reads and writes of sample data,
+// its own decompression is part of the time spent in them.
+class StatsCollector : private boost::noncopyable
+{
+public:
+    StatsCollector();
+
+    // The block of the object with the full name, made the first time
+    // it's asked for.
+    StatsBlockPtr getObjectBlock( const std::string &iFullName );
+
+    // Adds iStats to this thread's block, and to iObject's if there is one.
+    void add( const AbcA::ArchiveStats &iStats, StatsBlock *iObject );
+
+    AbcA::ArchiveStats getStats();
+
+    void getObjectStats( AbcA::ObjectStatsVec &oStats );
+
+    void reset();
+
+private:
+    // Never reused, so a thread can't mistake this for a collector that
+    // used to be at the same address.
+    uint64_t m_id;
+
+    boost::mutex m_mutex;
+    std::vector<StatsBlockPtr> m_threadBlocks;
+    std::map<std::string, StatsBlockPtr> m_objectBlocks;
+};
+
+typedef boost::shared_ptr<StatsCollector> StatsCollectorPtr;
+
+//-*****************************************************************************
+// Counts what this thread does until it goes out of scope, and then adds
+// it to the collector. The innermost scope is the one counted to.
+class StatsScope : private boost::noncopyable
+{
+public:
+    StatsScope( StatsCollector *iCollector, StatsBlock *iObject );
+
+    ~StatsScope();
+
+    AbcA::ArchiveStats &stats() { return m_stats; }
+
+private:
+    StatsCollector *m_collector;
+    StatsBlock *m_object;
+    AbcA::ArchiveStats m_stats;
+    AbcA::ArchiveStats *m_previous;
+};
+
+//-*****************************************************************************
+// The stats of the innermost StatsScope of this thread, or NULL when
+// nothing is being counted.
+AbcA::ArchiveStats *CurrentStats();
+
+//-*****************************************************************************
+inline void CountStats( uint64_t AbcA::ArchiveStats::*iCount,
+                        uint64_t iAmount = 1 )
+{
+    AbcA::ArchiveStats *stats = CurrentStats();
+    if ( stats )
+    {
+        stats->*iCount += iAmount;
+    }
+}
+
+//-*****************************************************************************
+// Counts a lookup in the read cache.
+inline void CountCacheLookup( bool iFound )
+{
+    CountStats( iFound ? &AbcA::ArchiveStats::cacheHits :
+                &AbcA::ArchiveStats::cacheMisses );
+}
+
+//-*****************************************************************************
+// Adds the seconds until it goes out of scope to the current stats, and
+// counts a call, if iCalls is given.
+class StatsTimer : private boost::noncopyable
+{
+public:
+    explicit StatsTimer( float64_t AbcA::ArchiveStats::*iSeconds,
+                         uint64_t AbcA::ArchiveStats::*iCalls = NULL );
+
+    ~StatsTimer();
+
+private:
+    AbcA::ArchiveStats *m_stats;
+    float64_t AbcA::ArchiveStats::*m_seconds;
+    float64_t m_start;
+};
+
+//-*****************************************************************************
+// HDF5's reads and writes of whole attributes and datasets, timed and
+// counted to the current stats.
+herr_t StatsH5Aread( hid_t iAttr, hid_t iMemType, void *oBuf );
+
+herr_t StatsH5Awrite( hid_t iAttr, hid_t iMemType, const void *iBuf );
+
+herr_t StatsH5Dread( hid_t iDset, hid_t iMemType, void *oBuf );
+
+herr_t StatsH5Dwrite( hid_t iDset, hid_t iMemType, const void *iBuf );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreHDF5
+} // End namespace Alembic
+
+#endif
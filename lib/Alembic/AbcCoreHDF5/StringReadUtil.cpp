@@ -125,8 +125,8 @@ ReadStringT( hid_t iParent,
                                     ( CharT )0 );
 
     // Read into it.
-    herr_t status = H5Aread( attrId, GetNativeDtype<CharT>(),
-                             ( void * )&charStorage.front() );
+    herr_t status = StatsH5Aread( attrId, GetNativeDtype<CharT>(),
+                                  ( void * )&charStorage.front() );
     ABCA_ASSERT( status >= 0, "Couldn't read from attribute: " << iAttrName );
 
     // Return it.
@@ -172,8 +172,8 @@ ReadStringT<std::string,char>( hid_t iParent,
                                    ( char )0 );
 
     // Read into it.
-    herr_t status = H5Aread( attrId, attrFtype,
-                             ( void * )&charStorage.front() );
+    herr_t status = StatsH5Aread( attrId, attrFtype,
+                                  ( void * )&charStorage.front() );
     ABCA_ASSERT( status >= 0, "Couldn't read from attribute: " << iAttrName );
 
     // Return it.
@@ -207,6 +207,8 @@ static void ExtractStrings( StringT *oStrings,
                             size_t iNumChars,
                             size_t iNumStringsExpected )
 {
+    StatsTimer timer( &AbcA::ArchiveStats::stringDecodeSeconds );
+
     // To read any string,
     // just imagine how we'd do it?
     // Start with two pointers, one for beginning and one for end.
@@ -317,8 +319,8 @@ ReadStringsT( hid_t iParent,
                                     ( CharT )0 );
 
     // Read into it.
-    herr_t status = H5Aread( attrId, GetNativeDtype<CharT>(),
-                             ( void * )&charStorage.front() );
+    herr_t status = StatsH5Aread( attrId, GetNativeDtype<CharT>(),
+                                  ( void * )&charStorage.front() );
     ABCA_ASSERT( status >= 0, "Couldn't read from attribute: " << iAttrName );
 
     // Extract 'em.
@@ -389,6 +391,7 @@ ReadStringArrayT( AbcA::ReadArraySampleCachePtr iCache,
 
         foundDigest = ReadKey( dsetId, "key", key );
         AbcA::ReadArraySampleID found = iCache->find( key );
+        CountCacheLookup( found );
         if ( found )
         {
             AbcA::ArraySamplePtr ret = found.getSample();
@@ -475,9 +478,8 @@ ReadStringArrayT( AbcA::ReadArraySampleCachePtr iCache,
         std::vector<CharT> charStorage( totalNumChars, ( CharT )0 );
         
         // Read into it.
-        herr_t status = H5Dread( dsetId, GetNativeDtype<CharT>(),
-                                 H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                                 ( void * )&charStorage.front() );
+        herr_t status = StatsH5Dread( dsetId, GetNativeDtype<CharT>(),
+                                      ( void * )&charStorage.front() );
         ABCA_ASSERT( status >= 0,
                      "Could not read string array from data set. Weird." );
 
@@ -393,8 +393,8 @@ WriteStringArrayT( WrittenArraySampleMap &iMap,
     // Write the data.
     if ( hasData )
     {
-        H5Dwrite( dsetId, GetNativeDtype<CharT>(), H5S_ALL,
-                  H5S_ALL, H5P_DEFAULT, &charBuffer.front() );
+        StatsH5Dwrite( dsetId, GetNativeDtype<CharT>(),
+                       &charBuffer.front() );
     }
 
     // Write the key
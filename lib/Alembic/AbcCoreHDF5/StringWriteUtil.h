@@ -34,8 +34,8 @@
 //
 //-*****************************************************************************
 
-#ifndef _Alembic_AbcCoreHDF5_StringReadUtil_h_
-#define _Alembic_AbcCoreHDF5_StringReadUtil_h_
+#ifndef _Alembic_AbcCoreHDF5_StringWriteUtil_h_
+#define _Alembic_AbcCoreHDF5_StringWriteUtil_h_
 
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
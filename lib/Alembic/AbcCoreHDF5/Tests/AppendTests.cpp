@@ -0,0 +1,264 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <vector>
+
+#include <hdf5.h>
+#include <math.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numPoints = 1000;
+
+//-*****************************************************************************
+// The value written for each sample. The first session writes samples
+// 0, 1 and 1 again, the appending one carries on with 1 again, 2 and then
+// 0, which it should link to rather than write again.
+static const size_t g_values[] = { 0, 1, 1, 1, 2, 0 };
+static const size_t g_firstSession = 3;
+static const size_t g_numSamples = 6;
+
+//-*****************************************************************************
+std::vector<float32_t> sampleValues( size_t iValue )
+{
+    std::vector<float32_t> vals( g_numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t ) sin( i * 0.37 + iValue * 0.1 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+void writeSamples( ABC::ArrayPropertyWriterPtr iArray,
+                   ABC::ScalarPropertyWriterPtr iScalar,
+                   size_t iBegin, size_t iEnd )
+{
+    TESTING_ASSERT( iArray->getNumSamples() == iBegin );
+    TESTING_ASSERT( iScalar->getNumSamples() == iBegin );
+
+    for ( size_t s = iBegin; s < iEnd; ++s )
+    {
+        std::vector<float32_t> vals = sampleValues( g_values[s] );
+        iArray->setSample( ABC::ArraySample( &vals.front(),
+                                             iArray->getDataType(),
+                                             Dimensions( g_numPoints ) ) );
+
+        int32_t frame = ( int32_t ) g_values[s];
+        iScalar->setSample( &frame );
+    }
+}
+
+//-*****************************************************************************
+void checkSamples( ABC::ArrayPropertyReaderPtr iArray,
+                   ABC::ScalarPropertyReaderPtr iScalar )
+{
+    TESTING_ASSERT( iArray->getNumSamples() == g_numSamples );
+    TESTING_ASSERT( iScalar->getNumSamples() == g_numSamples );
+    TESTING_ASSERT( iArray->getTimeSampling()->getTimeSamplingType() ==
+                    ABC::TimeSamplingType( 1.0 / 24.0 ) );
+
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        iArray->getSample( s, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+        std::vector<float32_t> expected = sampleValues( g_values[s] );
+        const float32_t *data =
+            static_cast<const float32_t *>( samp->getData() );
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            TESTING_ASSERT( data[i] == expected[i] );
+        }
+
+        int32_t frame = -1;
+        iScalar->getSample( s, &frame );
+        TESTING_ASSERT( frame == ( int32_t ) g_values[s] );
+    }
+}
+
+//-*****************************************************************************
+haddr_t objectAddress( hid_t iFile, const std::string &iPath )
+{
+    H5O_info_t oinfo;
+    TESTING_ASSERT( H5Oget_info_by_name( iFile, iPath.c_str(), &oinfo,
+                                         H5P_DEFAULT ) >= 0 );
+    return oinfo.addr;
+}
+
+//-*****************************************************************************
+void testAppend()
+{
+    std::string name = "append.abc";
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+
+    ABC::MetaData deltaMd;
+    A5::SetDeltaEncoding( deltaMd, 4 );
+
+    {
+        ABC::MetaData archiveMd;
+        archiveMd.set( "shot", "sq10_sh20" );
+
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, archiveMd );
+        uint32_t tsIndex = a->addTimeSampling(
+            ABC::TimeSampling( 1.0 / 24.0, 0.0 ) );
+        TESTING_ASSERT( tsIndex == 1 );
+
+        ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+            ABC::ObjectHeader( "geo", ABC::MetaData() ) );
+        ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+
+        writeSamples( props->createArrayProperty( "P", ABC::MetaData(),
+                                                  f3, tsIndex ),
+                      props->createScalarProperty( "frame", ABC::MetaData(),
+                                                   i1, tsIndex ),
+                      0, g_firstSession );
+
+        ABC::CompoundPropertyWriterPtr arb =
+            props->createCompoundProperty( "arb", ABC::MetaData() );
+        writeSamples( arb->createArrayProperty( "delta", deltaMd,
+                                                f3, tsIndex ),
+                      arb->createScalarProperty( "frame", ABC::MetaData(),
+                                                 i1, tsIndex ),
+                      0, g_firstSession );
+    }
+
+    {
+        A5::AppendArchive w;
+        ABC::ArchiveWriterPtr a = w( name );
+
+        // the archive keeps what it was written with
+        TESTING_ASSERT( a->getMetaData().get( "shot" ) == "sq10_sh20" );
+        TESTING_ASSERT( a->getNumTimeSamplings() == 2 );
+        uint32_t tsIndex = a->addTimeSampling(
+            ABC::TimeSampling( 1.0 / 24.0, 0.0 ) );
+        TESTING_ASSERT( tsIndex == 1 );
+
+        ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+            ABC::ObjectHeader( "geo", ABC::MetaData() ) );
+        ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+
+        writeSamples( props->createArrayProperty( "P", ABC::MetaData(),
+                                                  f3, tsIndex ),
+                      props->createScalarProperty( "frame", ABC::MetaData(),
+                                                   i1, tsIndex ),
+                      g_firstSession, g_numSamples );
+
+        // still delta encoded, even without saying so again
+        ABC::CompoundPropertyWriterPtr arb =
+            props->createCompoundProperty( "arb", ABC::MetaData() );
+
+        // reopening with a different type is an error
+        TESTING_ASSERT_THROW( arb->createArrayProperty( "frame",
+            ABC::MetaData(), f3, tsIndex ), Alembic::Util::Exception );
+
+        ABC::ArrayPropertyWriterPtr delta = arb->createArrayProperty(
+            "delta", ABC::MetaData(), f3, tsIndex );
+        uint32_t keyInterval = 0;
+        Alembic::Util::float64_t tolerance = 0.0;
+        TESTING_ASSERT( A5::GetDeltaEncoding( delta->getMetaData(),
+                                              keyInterval, tolerance ) );
+        TESTING_ASSERT( keyInterval == 4 );
+        writeSamples( delta,
+                      arb->createScalarProperty( "frame", ABC::MetaData(),
+                                                 i1, tsIndex ),
+                      g_firstSession, g_numSamples );
+
+        // new objects and properties are added alongside
+        ABC::ObjectWriterPtr geo2 = a->getTop()->createChild(
+            ABC::ObjectHeader( "geo2", ABC::MetaData() ) );
+        writeSamples( geo2->getProperties()->createArrayProperty( "P",
+                          ABC::MetaData(), f3, tsIndex ),
+                      props->createScalarProperty( "newFrame",
+                          ABC::MetaData(), i1, tsIndex ),
+                      0, g_numSamples );
+    }
+
+    // the last sample of P is a link to the first, which was written
+    // before the archive was reopened
+    {
+        hid_t file = H5Fopen( name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+        TESTING_ASSERT( file >= 0 );
+        TESTING_ASSERT( objectAddress( file, "/ABC/geo/.prop/P.smp0" ) ==
+                        objectAddress( file, "/ABC/geo/.prop/P.smpi/0005" ) );
+        H5Fclose( file );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    TESTING_ASSERT( a->getMetaData().get( "shot" ) == "sq10_sh20" );
+    TESTING_ASSERT( a->getTop()->getNumChildren() == 2 );
+
+    // The object owns its properties, so it has to be held on to.
+    ABC::ObjectReaderPtr geo = a->getTop()->getChild( "geo" );
+    ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+    checkSamples( props->getArrayProperty( "P" ),
+                  props->getScalarProperty( "frame" ) );
+    checkSamples( props->getArrayProperty( "P" ),
+                  props->getScalarProperty( "newFrame" ) );
+
+    ABC::CompoundPropertyReaderPtr arb = props->getCompoundProperty( "arb" );
+    checkSamples( arb->getArrayProperty( "delta" ),
+                  arb->getScalarProperty( "frame" ) );
+
+    checkSamples( a->getTop()->getChild( "geo2" )->getProperties()->
+                  getArrayProperty( "P" ),
+                  props->getScalarProperty( "frame" ) );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testAppend();
+    return 0;
+}
@@ -0,0 +1,202 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+//-*****************************************************************************
+// Times writing the same scene into one archive from 1, 2, 4 and 8
+// threads, each thread writing its share of the objects. Hashing and
+// compressing the samples is done by the threads at the same time, and
+// only the writes to the file are taken in turn, so this is how much of
+// that is gained. Not run as part of the test suite.
+//
+//     AbcCoreHDF5_ConcurrentWriteBenchmark [numObjects] [numFrames]
+//                                          [numVals] [compressionHint]
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include <math.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+struct BenchSettings
+{
+    size_t numObjects;
+    size_t numFrames;
+    size_t numVals;
+    int compressionHint;
+};
+
+//-*****************************************************************************
+static double secondsSince( const boost::posix_time::ptime &iStart )
+{
+    boost::posix_time::time_duration d =
+        boost::posix_time::microsec_clock::local_time() - iStart;
+    return d.total_microseconds() / 1.0e6;
+}
+
+//-*****************************************************************************
+// Writes every iNumThreads'th object, starting with iThread, a frame at a
+// time the way an exporter would.
+class ObjectWriterThread
+{
+public:
+    ObjectWriterThread( ABC::ArchiveWriterPtr iArchive,
+                        const BenchSettings &iSettings,
+                        size_t iThread, size_t iNumThreads )
+      : m_archive( iArchive )
+      , m_settings( iSettings )
+      , m_thread( iThread )
+      , m_numThreads( iNumThreads )
+    {}
+
+    void operator()()
+    {
+        ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+        uint32_t tsIndex = m_archive->addTimeSampling(
+            ABC::TimeSampling( 1.0 / 24.0, 0.0 ) );
+
+        std::vector<ABC::ObjectWriterPtr> geos;
+        std::vector<ABC::ArrayPropertyWriterPtr> P;
+        for ( size_t o = m_thread; o < m_settings.numObjects;
+              o += m_numThreads )
+        {
+            std::string name = "geo" + boost::lexical_cast<std::string>( o );
+            geos.push_back( m_archive->getTop()->createChild(
+                ABC::ObjectHeader( name, ABC::MetaData() ) ) );
+            P.push_back( geos.back()->getProperties()->createArrayProperty(
+                "P", ABC::MetaData(), f3, tsIndex ) );
+        }
+
+        // A wavy grid, which compresses about as well as real points do.
+        std::vector<float32_t> vals( m_settings.numVals * 3 );
+        for ( size_t f = 0; f < m_settings.numFrames; ++f )
+        {
+            for ( size_t i = 0; i < P.size(); ++i )
+            {
+                float32_t phase = ( float32_t ) ( f * 0.1 + i + m_thread );
+                for ( size_t v = 0; v < m_settings.numVals; ++v )
+                {
+                    vals[v * 3] = ( float32_t ) ( v % 1000 );
+                    vals[v * 3 + 1] = sinf( v * 0.01f + phase );
+                    vals[v * 3 + 2] = ( float32_t ) ( v / 1000 );
+                }
+
+                P[i]->setSample( ABC::ArraySample( &vals.front(), f3,
+                    Dimensions( m_settings.numVals ) ) );
+            }
+        }
+    }
+
+private:
+    ABC::ArchiveWriterPtr m_archive;
+    BenchSettings m_settings;
+    size_t m_thread;
+    size_t m_numThreads;
+};
+
+//-*****************************************************************************
+static double timeWrite( const BenchSettings &iSettings, size_t iNumThreads )
+{
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::local_time();
+
+    {
+        ABC::ArchiveWriterPtr a = A5::WriteArchive()(
+            "concurrentWriteBenchmark.abc", ABC::MetaData() );
+        a->setCompressionHint( iSettings.compressionHint );
+
+        boost::thread_group threads;
+        for ( size_t t = 0; t < iNumThreads; ++t )
+        {
+            threads.create_thread(
+                ObjectWriterThread( a, iSettings, t, iNumThreads ) );
+        }
+        threads.join_all();
+    }
+
+    return secondsSince( start );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    BenchSettings settings;
+    settings.numObjects = argc > 1 ?
+        boost::lexical_cast<size_t>( argv[1] ) : 64;
+    settings.numFrames = argc > 2 ?
+        boost::lexical_cast<size_t>( argv[2] ) : 24;
+    settings.numVals = argc > 3 ?
+        boost::lexical_cast<size_t>( argv[3] ) : 50000;
+    settings.compressionHint = argc > 4 ?
+        boost::lexical_cast<int>( argv[4] ) : 6;
+
+    std::cout << "objects: " << settings.numObjects
+              << " frames: " << settings.numFrames
+              << " points: " << settings.numVals
+              << " compression: " << settings.compressionHint
+              << " cores: " << boost::thread::hardware_concurrency()
+              << std::endl;
+
+    double oneThread = 0.0;
+    for ( size_t numThreads = 1; numThreads <= 8; numThreads *= 2 )
+    {
+        double secs = timeWrite( settings, numThreads );
+        if ( numThreads == 1 )
+        {
+            oneThread = secs;
+        }
+
+        std::cout << numThreads << " threads: " << secs << "s, "
+                  << oneThread / secs << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+#include <sstream>
+#include <iostream>
+
+#include <math.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numThreads = 8;
+static const size_t g_objectsPerThread = 4;
+static const size_t g_numFrames = 20;
+static const size_t g_numPoints = 2000;
+
+//-*****************************************************************************
+std::string objectName( size_t iObject )
+{
+    std::ostringstream strm;
+    strm << "geo" << iObject;
+    return strm.str();
+}
+
+//-*****************************************************************************
+std::vector<float32_t> frameValues( size_t iObject, size_t iFrame )
+{
+    std::vector<float32_t> vals( g_numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t ) sin( i * 0.37 + iFrame * 0.1 +
+                                     iObject * 10.0 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+// The same for every object, so that the threads share these samples
+// through the archive's map.
+std::vector<int32_t> sharedValues( size_t iFrame )
+{
+    std::vector<int32_t> vals( g_numPoints );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( int32_t ) ( i + iFrame / 4 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+// Every thread makes its own objects under the top one, and writes all
+// of their frames.
+class ObjectWriterThread
+{
+public:
+    ObjectWriterThread( ABC::ArchiveWriterPtr iArchive, size_t iThread,
+                        std::string &oError )
+      : m_archive( iArchive )
+      , m_thread( iThread )
+      , m_error( oError )
+    {}
+
+    void operator()()
+    {
+        try
+        {
+            write();
+        }
+        catch ( std::exception &exc )
+        {
+            m_error = exc.what();
+        }
+    }
+
+private:
+    void write()
+    {
+        ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+        ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+        ABC::DataType s1( Alembic::Util::kStringPOD, 1 );
+
+        // Half of the threads ask for the same TimeSampling.
+        uint32_t tsIndex = m_archive->addTimeSampling( ABC::TimeSampling(
+            1.0 / 24.0, m_thread % 2 ? 1.0 : 2.0 + m_thread ) );
+
+        // The objects have to outlive their properties.
+        std::vector<ABC::ObjectWriterPtr> geos;
+        std::vector<ABC::ArrayPropertyWriterPtr> P;
+        std::vector<ABC::ArrayPropertyWriterPtr> shared;
+        std::vector<ABC::ScalarPropertyWriterPtr> frame;
+
+        for ( size_t i = 0; i < g_objectsPerThread; ++i )
+        {
+            size_t o = m_thread * g_objectsPerThread + i;
+            ABC::ObjectWriterPtr geo = m_archive->getTop()->createChild(
+                ABC::ObjectHeader( objectName( o ), ABC::MetaData() ) );
+            geos.push_back( geo );
+
+            ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+            P.push_back( props->createArrayProperty( "P", ABC::MetaData(),
+                                                     f3, tsIndex ) );
+            shared.push_back( props->createArrayProperty( "shared",
+                ABC::MetaData(), i1, tsIndex ) );
+
+            ABC::CompoundPropertyWriterPtr arb =
+                props->createCompoundProperty( "arb", ABC::MetaData() );
+            frame.push_back( arb->createScalarProperty( "frame",
+                ABC::MetaData(), i1, tsIndex ) );
+
+            std::string nameValue = objectName( o );
+            props->createScalarProperty( "name", ABC::MetaData(), s1, 0 )->
+                setSample( &nameValue );
+
+            geo->createChild( ABC::ObjectHeader( "child", ABC::MetaData() ) );
+        }
+
+        // The frames of all of the objects are interleaved, the way an
+        // exporter would write them.
+        for ( size_t f = 0; f < g_numFrames; ++f )
+        {
+            std::vector<int32_t> sharedVals = sharedValues( f );
+            for ( size_t i = 0; i < g_objectsPerThread; ++i )
+            {
+                size_t o = m_thread * g_objectsPerThread + i;
+                std::vector<float32_t> vals = frameValues( o, f );
+                P[i]->setSample( ABC::ArraySample( &vals.front(), f3,
+                    Dimensions( g_numPoints ) ) );
+
+                shared[i]->setSample( ABC::ArraySample( &sharedVals.front(),
+                    i1, Dimensions( g_numPoints ) ) );
+
+                int32_t frameValue = ( int32_t ) f;
+                frame[i]->setSample( &frameValue );
+            }
+        }
+
+        // Let go of everything here, so that the writers are closed from
+        // different threads too.
+    }
+
+    ABC::ArchiveWriterPtr m_archive;
+    size_t m_thread;
+    std::string &m_error;
+};
+
+//-*****************************************************************************
+void writeConcurrently( const std::string &iName, int iCompressionHint )
+{
+    ABC::ArchiveWriterPtr a = A5::WriteArchive()( iName, ABC::MetaData() );
+    a->setCompressionHint( iCompressionHint );
+
+    std::vector<std::string> errors( g_numThreads );
+    boost::thread_group threads;
+    for ( size_t t = 0; t < g_numThreads; ++t )
+    {
+        threads.create_thread( ObjectWriterThread( a, t, errors[t] ) );
+    }
+    threads.join_all();
+
+    for ( size_t t = 0; t < g_numThreads; ++t )
+    {
+        if ( !errors[t].empty() )
+        {
+            std::cerr << "Thread " << t << ": " << errors[t] << std::endl;
+        }
+        TESTING_ASSERT( errors[t].empty() );
+    }
+}
+
+//-*****************************************************************************
+void checkArchive( const std::string &iName )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName );
+
+    // The default, one for the odd threads, and one for each even thread.
+    TESTING_ASSERT( a->getNumTimeSamplings() == 2 + g_numThreads / 2 );
+
+    ABC::ObjectReaderPtr top = a->getTop();
+    TESTING_ASSERT( top->getNumChildren() ==
+                    g_numThreads * g_objectsPerThread );
+
+    for ( size_t o = 0; o < g_numThreads * g_objectsPerThread; ++o )
+    {
+        size_t thread = o / g_objectsPerThread;
+
+        ABC::ObjectReaderPtr geo = top->getChild( objectName( o ) );
+        TESTING_ASSERT( geo );
+        TESTING_ASSERT( geo->getNumChildren() == 1 );
+
+        ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+        TESTING_ASSERT( props->getNumProperties() == 4 );
+
+        ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+        ABC::ArrayPropertyReaderPtr shared =
+            props->getArrayProperty( "shared" );
+        ABC::ScalarPropertyReaderPtr frame =
+            props->getCompoundProperty( "arb" )->getScalarProperty( "frame" );
+        TESTING_ASSERT( P->getNumSamples() == g_numFrames );
+        TESTING_ASSERT( shared->getNumSamples() == g_numFrames );
+        TESTING_ASSERT( frame->getNumSamples() == g_numFrames );
+
+        ABC::chrono_t start = thread % 2 ? 1.0 : 2.0 + thread;
+        TESTING_ASSERT( P->getTimeSampling()->getSampleTime( 0 ) == start );
+
+        for ( size_t f = 0; f < g_numFrames; ++f )
+        {
+            ABC::ArraySamplePtr samp;
+            P->getSample( f, samp );
+            TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+            std::vector<float32_t> expected = frameValues( o, f );
+            const float32_t *data =
+                static_cast<const float32_t *>( samp->getData() );
+            for ( size_t i = 0; i < expected.size(); ++i )
+            {
+                TESTING_ASSERT( data[i] == expected[i] );
+            }
+
+            shared->getSample( f, samp );
+            std::vector<int32_t> expectedShared = sharedValues( f );
+            const int32_t *sharedData =
+                static_cast<const int32_t *>( samp->getData() );
+            for ( size_t i = 0; i < expectedShared.size(); ++i )
+            {
+                TESTING_ASSERT( sharedData[i] == expectedShared[i] );
+            }
+
+            int32_t frameValue = -1;
+            frame->getSample( f, &frameValue );
+            TESTING_ASSERT( frameValue == ( int32_t ) f );
+        }
+
+        ABC::ScalarPropertyReaderPtr name = props->getScalarProperty( "name" );
+        std::string nameValue;
+        name->getSample( 0, &nameValue );
+        TESTING_ASSERT( nameValue == objectName( o ) );
+    }
+}
+
+//-*****************************************************************************
+void testConcurrentWrite()
+{
+    // Compressed, which is done before the samples are written.
+    writeConcurrently( "concurrentCompressed.abc", 3 );
+    checkArchive( "concurrentCompressed.abc" );
+
+    // And not.
+    writeConcurrently( "concurrentPlain.abc", -1 );
+    checkArchive( "concurrentPlain.abc" );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testConcurrentWrite();
+
+    return 0;
+}
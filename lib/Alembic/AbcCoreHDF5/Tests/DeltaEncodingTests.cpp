@@ -0,0 +1,419 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <math.h>
+#include <string.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::int32_t;
+using Alembic::Util::uint32_t;
+using Alembic::Util::float32_t;
+using Alembic::Util::float64_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numSamples = 40;
+static const uint32_t g_keyInterval = 8;
+
+//-*****************************************************************************
+// The points of sample iSample. The motion is small so the deltas are
+// mostly zero bits. Samples 10 through 13 are all the same, sample 20
+// has a different number of points, and samples past 35 are the same, so
+// that held samples, topology changes and repeated tails are all covered.
+template <class T>
+std::vector<T> samplePoints( size_t iSample )
+{
+    size_t t = iSample;
+    if ( t >= 10 && t <= 13 ) { t = 10; }
+    if ( t > 35 ) { t = 35; }
+
+    size_t numPoints = iSample == 20 ? 77 : 100;
+    std::vector<T> vals( numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( T )( i * 0.25 + sin( t * 0.1 + i ) * 0.01 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+template <class T>
+void writeSamples( ABC::ArrayPropertyWriterPtr iProp,
+                   const ABC::DataType &iType )
+{
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        // sample 12 goes through setFromPreviousSample instead
+        if ( s == 12 )
+        {
+            iProp->setFromPreviousSample();
+            continue;
+        }
+
+        std::vector<T> vals = samplePoints<T>( s );
+        iProp->setSample( ABC::ArraySample( &vals.front(), iType,
+                                            Dimensions( vals.size() / 3 ) ) );
+    }
+}
+
+//-*****************************************************************************
+// iTolerance of 0 means the values must match exactly.
+template <class T>
+void checkSample( ABC::ArrayPropertyReaderPtr iProp, size_t iSample,
+                  float64_t iTolerance )
+{
+    ABC::ArraySamplePtr samp;
+    iProp->getSample( iSample, samp );
+
+    std::vector<T> expected = samplePoints<T>( iSample );
+    TESTING_ASSERT( samp->getDimensions().numPoints() * 3 ==
+                    expected.size() );
+
+    Dimensions dims;
+    iProp->getDimensions( iSample, dims );
+    TESTING_ASSERT( dims.numPoints() * 3 == expected.size() );
+
+    const T *data = static_cast<const T *>( samp->getData() );
+    if ( iTolerance == 0.0 )
+    {
+        TESTING_ASSERT( memcmp( data, &expected.front(),
+                                expected.size() * sizeof( T ) ) == 0 );
+    }
+    else
+    {
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            TESTING_ASSERT( fabs( ( float64_t )data[i] - expected[i] ) <=
+                            iTolerance );
+        }
+    }
+}
+
+//-*****************************************************************************
+template <class T>
+void checkSamples( ABC::ArrayPropertyReaderPtr iProp, float64_t iTolerance )
+{
+    TESTING_ASSERT( iProp->getNumSamples() == g_numSamples );
+
+    // forwards, which only applies one delta at a time
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        checkSample<T>( iProp, s, iTolerance );
+    }
+
+    // backwards and jumping around, which walks back to keyframes
+    for ( size_t s = g_numSamples; s > 0; --s )
+    {
+        checkSample<T>( iProp, s - 1, iTolerance );
+    }
+    size_t order[] = { 17, 3, 39, 0, 21, 11, 30, 12, 29 };
+    for ( size_t i = 0; i < sizeof( order ) / sizeof( order[0] ); ++i )
+    {
+        checkSample<T>( iProp, order[i], iTolerance );
+    }
+}
+
+//-*****************************************************************************
+void testPropertyEncoding()
+{
+    std::string name = "deltaEncoding.abc";
+    ABC::DataType f3d( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType d3d( Alembic::Util::kFloat64POD, 3 );
+    float64_t tolerance = 1e-4;
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+
+        ABC::MetaData lossless;
+        A5::SetDeltaEncoding( lossless, g_keyInterval );
+        writeSamples<float32_t>(
+            props->createArrayProperty( "lossless", lossless, f3d, 0 ), f3d );
+
+        ABC::MetaData lossy;
+        A5::SetDeltaEncoding( lossy, g_keyInterval, tolerance );
+        writeSamples<float64_t>(
+            props->createArrayProperty( "lossy", lossy, d3d, 0 ), d3d );
+        writeSamples<float32_t>(
+            props->createArrayProperty( "lossyFloat", lossy, f3d, 0 ), f3d );
+
+        writeSamples<float32_t>(
+            props->createArrayProperty( "plain", ABC::MetaData(), f3d, 0 ),
+            f3d );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+
+    checkSamples<float32_t>( props->getArrayProperty( "lossless" ), 0.0 );
+    checkSamples<float64_t>( props->getArrayProperty( "lossy" ), tolerance );
+    checkSamples<float32_t>( props->getArrayProperty( "lossyFloat" ),
+                             tolerance );
+    checkSamples<float32_t>( props->getArrayProperty( "plain" ), 0.0 );
+
+    // lossless samples have the same keys as they would unencoded
+    ABC::ArrayPropertyReaderPtr lossless =
+        props->getArrayProperty( "lossless" );
+    ABC::ArrayPropertyReaderPtr plain = props->getArrayProperty( "plain" );
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySampleKey losslessKey;
+        ABC::ArraySampleKey plainKey;
+        TESTING_ASSERT( lossless->getKey( s, losslessKey ) );
+        TESTING_ASSERT( plain->getKey( s, plainKey ) );
+        TESTING_ASSERT( losslessKey == plainKey );
+    }
+}
+
+//-*****************************************************************************
+// Reads every sample of one property, starting at a different sample on
+// each thread so that the threads keep replacing each other's last
+// rebuilt sample.
+class DeltaReaderThread
+{
+public:
+    DeltaReaderThread( ABC::ArrayPropertyReaderPtr iProp, size_t iStart,
+                       bool &oOk )
+      : m_prop( iProp )
+      , m_start( iStart )
+      , m_ok( oOk )
+    {}
+
+    void operator()()
+    {
+        for ( size_t pass = 0; pass < 20; ++pass )
+        {
+            for ( size_t i = 0; i < g_numSamples; ++i )
+            {
+                size_t s = ( m_start + i ) % g_numSamples;
+                ABC::ArraySamplePtr samp;
+                m_prop->getSample( s, samp );
+
+                std::vector<float32_t> expected =
+                    samplePoints<float32_t>( s );
+                if ( samp->getDimensions().numPoints() * 3 !=
+                     expected.size() ||
+                     memcmp( samp->getData(), &expected.front(),
+                             expected.size() * sizeof( float32_t ) ) != 0 )
+                {
+                    m_ok = false;
+                }
+            }
+        }
+    }
+
+private:
+    ABC::ArrayPropertyReaderPtr m_prop;
+    size_t m_start;
+    bool &m_ok;
+};
+
+//-*****************************************************************************
+void testConcurrentRead()
+{
+    std::string name = "deltaEncodingConcurrent.abc";
+    ABC::DataType f3d( Alembic::Util::kFloat32POD, 3 );
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+
+        ABC::MetaData md;
+        A5::SetDeltaEncoding( md, g_keyInterval );
+        writeSamples<float32_t>( a->getTop()->getProperties()->
+            createArrayProperty( "P", md, f3d, 0 ), f3d );
+    }
+
+    // Without a cache, so every read rebuilds its sample.
+    ABC::ArchiveReaderPtr a =
+        A5::ReadArchive()( name, ABC::ReadArraySampleCachePtr() );
+    ABC::ArrayPropertyReaderPtr p =
+        a->getTop()->getProperties()->getArrayProperty( "P" );
+
+    const size_t numThreads = 4;
+    bool ok[numThreads];
+    boost::thread_group threads;
+    for ( size_t t = 0; t < numThreads; ++t )
+    {
+        ok[t] = true;
+        threads.create_thread( DeltaReaderThread( p, t * 11, ok[t] ) );
+    }
+    threads.join_all();
+
+    for ( size_t t = 0; t < numThreads; ++t )
+    {
+        TESTING_ASSERT( ok[t] );
+    }
+}
+
+//-*****************************************************************************
+void testLossyFallback()
+{
+    std::string name = "deltaEncodingFallback.abc";
+    ABC::DataType fd( Alembic::Util::kFloat32POD, 1 );
+    float64_t tolerance = 1e-3;
+
+    std::vector< std::vector<float32_t> > written;
+    std::vector<float32_t> vals( 10, 1.0f );
+    written.push_back( vals );
+
+    // too big a jump for the quantized delta
+    vals[3] = 1e30f;
+    written.push_back( vals );
+
+    // and another
+    vals[3] = 1e30f * 1.5f;
+    written.push_back( vals );
+
+    // not finite at all
+    vals[4] = std::numeric_limits<float32_t>::infinity();
+    written.push_back( vals );
+
+    vals[4] = 2.0f;
+    written.push_back( vals );
+
+    // and back to small moves, which are deltas again
+    vals[0] = 1.0004f;
+    written.push_back( vals );
+
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+
+        ABC::MetaData md;
+        A5::SetDeltaEncoding( md, 100, tolerance );
+        ABC::ArrayPropertyWriterPtr p =
+            a->getTop()->getProperties()->createArrayProperty( "vals", md,
+                                                               fd, 0 );
+        for ( size_t s = 0; s < written.size(); ++s )
+        {
+            p->setSample( ABC::ArraySample( &written[s].front(), fd,
+                                            Dimensions( 10 ) ) );
+        }
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::ArrayPropertyReaderPtr p =
+        a->getTop()->getProperties()->getArrayProperty( "vals" );
+
+    for ( size_t s = 0; s < written.size(); ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        p->getSample( s, samp );
+        const float32_t *data = ( const float32_t * ) samp->getData();
+        for ( size_t i = 0; i < 10; ++i )
+        {
+            if ( written[s][i] ==
+                 std::numeric_limits<float32_t>::infinity() )
+            {
+                TESTING_ASSERT( data[i] == written[s][i] );
+            }
+            else
+            {
+                TESTING_ASSERT( fabs( data[i] - written[s][i] ) <=
+                                tolerance );
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void testArchiveDefault()
+{
+    std::string name = "deltaEncodingArchive.abc";
+    ABC::DataType f3d( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType i32d( Alembic::Util::kInt32POD, 1 );
+    {
+        ABC::MetaData md;
+        A5::SetDeltaEncoding( md, g_keyInterval );
+
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, md );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+
+        writeSamples<float32_t>(
+            props->createArrayProperty( "P", ABC::MetaData(), f3d, 0 ), f3d );
+
+        std::vector<int32_t> ints( 5, 3 );
+        props->createArrayProperty( "ints", ABC::MetaData(), i32d,
+            0 )->setSample( ABC::ArraySample( &ints.front(), i32d,
+                                              Dimensions( 5 ) ) );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+
+    uint32_t interval = 0;
+    float64_t tolerance = -1.0;
+    ABC::ArrayPropertyReaderPtr p = props->getArrayProperty( "P" );
+    TESTING_ASSERT( A5::GetDeltaEncoding( p->getMetaData(), interval,
+                                          tolerance ) );
+    TESTING_ASSERT( interval == g_keyInterval && tolerance == 0.0 );
+    checkSamples<float32_t>( p, 0.0 );
+
+    // only float arrays are encoded
+    TESTING_ASSERT( !A5::GetDeltaEncoding(
+        props->getArrayProperty( "ints" )->getMetaData(), interval,
+        tolerance ) );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testPropertyEncoding();
+    testConcurrentRead();
+    testLossyFallback();
+    testArchiveDefault();
+    return 0;
+}
@@ -0,0 +1,336 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/AbcCoreHDF5/DiskCacheImpl.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+#include <string>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::uint64_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numPoints = 1000;
+static const size_t g_numSamples = 3;
+static const std::string g_cacheDir = "diskCache";
+
+//-*****************************************************************************
+std::vector<float32_t> sampleValues( size_t iSample )
+{
+    std::vector<float32_t> vals( g_numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t )( i * 0.5 + iSample * 1000.0 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+// Writes P, which is big enough to go to disk, and small and names, which
+// aren't.
+void writeArchive( const std::string &iName )
+{
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+    ABC::DataType s1( Alembic::Util::kStringPOD, 1 );
+
+    A5::WriteArchive w;
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+        ABC::ObjectHeader( "geo", ABC::MetaData() ) );
+    ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+
+    ABC::ArrayPropertyWriterPtr P =
+        props->createArrayProperty( "P", ABC::MetaData(), f3, 0 );
+    ABC::ArrayPropertyWriterPtr small =
+        props->createArrayProperty( "small", ABC::MetaData(), i1, 0 );
+    ABC::ArrayPropertyWriterPtr names =
+        props->createArrayProperty( "names", ABC::MetaData(), s1, 0 );
+
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        std::vector<float32_t> vals = sampleValues( s );
+        P->setSample( ABC::ArraySample( &vals.front(), f3,
+                                        Dimensions( g_numPoints ) ) );
+
+        int32_t smallVals[4] = { 1, 2, 3, ( int32_t ) s };
+        small->setSample( ABC::ArraySample( smallVals, i1,
+                                            Dimensions( 4 ) ) );
+
+        std::vector<std::string> strs( 2000, "name" );
+        strs[0] = s == 0 ? "zero" : "other";
+        names->setSample( ABC::ArraySample( &strs.front(), s1,
+                                            Dimensions( strs.size() ) ) );
+    }
+}
+
+//-*****************************************************************************
+void checkP( ABC::ArraySamplePtr iSamp, size_t iSample )
+{
+    TESTING_ASSERT( iSamp );
+    TESTING_ASSERT( iSamp->getDimensions().numPoints() == g_numPoints );
+    TESTING_ASSERT( iSamp->getDataType() ==
+                    ABC::DataType( Alembic::Util::kFloat32POD, 3 ) );
+
+    std::vector<float32_t> expected = sampleValues( iSample );
+    const float32_t *data =
+        static_cast<const float32_t *>( iSamp->getData() );
+    for ( size_t i = 0; i < expected.size(); ++i )
+    {
+        TESTING_ASSERT( data[i] == expected[i] );
+    }
+}
+
+//-*****************************************************************************
+// Reads every sample of the archive through iCache.
+void readArchive( const std::string &iName,
+                  ABC::ReadArraySampleCachePtr iCache )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName, iCache );
+    ABC::ObjectReaderPtr geo = a->getTop()->getChild( "geo" );
+    ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+
+    ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+    ABC::ArrayPropertyReaderPtr small = props->getArrayProperty( "small" );
+    ABC::ArrayPropertyReaderPtr names = props->getArrayProperty( "names" );
+
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        P->getSample( s, samp );
+        checkP( samp, s );
+
+        small->getSample( s, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 4 );
+        TESTING_ASSERT(
+            static_cast<const int32_t *>( samp->getData() )[3] == s );
+
+        names->getSample( s, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 2000 );
+        TESTING_ASSERT( static_cast<const std::string *>(
+            samp->getData() )[0] == ( s == 0 ? "zero" : "other" ) );
+    }
+}
+
+//-*****************************************************************************
+std::vector<ABC::ArraySample::Key> keysOfP( const std::string &iName )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName );
+    ABC::ObjectReaderPtr geo = a->getTop()->getChild( "geo" );
+    ABC::ArrayPropertyReaderPtr P =
+        geo->getProperties()->getArrayProperty( "P" );
+
+    std::vector<ABC::ArraySample::Key> keys( g_numSamples );
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        TESTING_ASSERT( P->getKey( s, keys[s] ) );
+    }
+    return keys;
+}
+
+//-*****************************************************************************
+void testDiskCache()
+{
+    std::string name = "diskCacheArchive.abc";
+    std::string copyName = "diskCacheArchiveCopy.abc";
+    writeArchive( name );
+    writeArchive( copyName );
+
+    uint64_t maxBytes = 10 * 1024 * 1024;
+
+    // Start empty.
+    {
+        ABC::ReadArraySampleCachePtr cache =
+            A5::CreateDiskCache( g_cacheDir, maxBytes );
+        dynamic_cast<A5::DiskCacheImpl *>( cache.get() )->trim( 0 );
+    }
+
+    ABC::ReadArraySampleCachePtr cache =
+        A5::CreateDiskCache( g_cacheDir, maxBytes );
+    A5::DiskCacheImpl *disk = dynamic_cast<A5::DiskCacheImpl *>( cache.get() );
+    TESTING_ASSERT( disk );
+    TESTING_ASSERT( disk->getNumBytes() == 0 );
+
+    // Only P goes to disk.
+    readArchive( name, cache );
+    uint64_t entryBytes = disk->getNumBytes();
+    TESTING_ASSERT( entryBytes >= g_numSamples * g_numPoints * 12 );
+    TESTING_ASSERT( entryBytes < g_numSamples * ( g_numPoints * 12 + 1024 ) );
+
+    // Reading it again comes from memory, and adds nothing.
+    readArchive( name, cache );
+    TESTING_ASSERT( disk->getNumBytes() == entryBytes );
+
+    // A new cache, as another process would have, finds P on disk, for
+    // another archive with the same data as well.
+    std::vector<ABC::ArraySample::Key> keys = keysOfP( copyName );
+    {
+        ABC::ReadArraySampleCachePtr other =
+            A5::CreateDiskCache( g_cacheDir, maxBytes );
+        TESTING_ASSERT( dynamic_cast<A5::DiskCacheImpl *>(
+            other.get() )->getNumBytes() == entryBytes );
+
+        for ( size_t s = 0; s < g_numSamples; ++s )
+        {
+            ABC::ReadArraySampleID found = other->find( keys[s] );
+            TESTING_ASSERT( found );
+            checkP( found.getSample(), s );
+        }
+
+        readArchive( copyName, other );
+        TESTING_ASSERT( dynamic_cast<A5::DiskCacheImpl *>(
+            other.get() )->getNumBytes() == entryBytes );
+    }
+
+    // Something that was never stored isn't found.
+    ABC::ArraySample::Key missing = keys[0];
+    missing.numBytes += 1;
+    TESTING_ASSERT( !cache->find( missing ) );
+
+    // Use sample 1 last. Modification times are only as fine grained as
+    // the kernel's clock tick.
+    boost::this_thread::sleep( boost::posix_time::milliseconds( 100 ) );
+
+    // Samples stay valid after their entries are evicted.
+    ABC::ReadArraySampleCachePtr fresh =
+        A5::CreateDiskCache( g_cacheDir, maxBytes );
+    ABC::ArraySamplePtr held = fresh->find( keys[1] ).getSample();
+    TESTING_ASSERT( held );
+
+    // Opening with a smaller limit evicts down to it, least recently
+    // used first.
+    uint64_t oneEntry = entryBytes / g_numSamples;
+    ABC::ReadArraySampleCachePtr smaller =
+        A5::CreateDiskCache( g_cacheDir, oneEntry + oneEntry / 2 );
+    TESTING_ASSERT( dynamic_cast<A5::DiskCacheImpl *>(
+        smaller.get() )->getNumBytes() == oneEntry );
+    TESTING_ASSERT( smaller->find( keys[1] ) );
+    TESTING_ASSERT( !smaller->find( keys[0] ) );
+
+    dynamic_cast<A5::DiskCacheImpl *>( smaller.get() )->trim( 0 );
+    TESTING_ASSERT( !A5::CreateDiskCache( g_cacheDir, maxBytes )->
+                    find( keys[1] ) );
+    checkP( held, 1 );
+}
+
+//-*****************************************************************************
+// Reads an archive of its own through a shared cache.
+class CacheReaderThread
+{
+public:
+    CacheReaderThread( const std::string &iName,
+                       ABC::ReadArraySampleCachePtr iCache,
+                       std::string &oError )
+      : m_name( iName )
+      , m_cache( iCache )
+      , m_error( oError )
+    {}
+
+    void operator()()
+    {
+        try
+        {
+            readArchive( m_name, m_cache );
+        }
+        catch ( std::exception &exc )
+        {
+            m_error = exc.what();
+        }
+    }
+
+private:
+    std::string m_name;
+    ABC::ReadArraySampleCachePtr m_cache;
+    std::string &m_error;
+};
+
+//-*****************************************************************************
+// Threads that find and store the same samples at once, loading and
+// writing entries without the cache's lock, all read them back intact
+// and leave one entry for each.
+void testConcurrentDiskCache()
+{
+    std::string name = "diskCacheArchive.abc";
+    uint64_t maxBytes = 10 * 1024 * 1024;
+
+    ABC::ReadArraySampleCachePtr cache =
+        A5::CreateDiskCache( g_cacheDir, maxBytes );
+    dynamic_cast<A5::DiskCacheImpl *>( cache.get() )->trim( 0 );
+
+    const size_t numThreads = 8;
+    std::vector<std::string> errors( numThreads );
+    boost::thread_group threads;
+    for ( size_t t = 0; t < numThreads; ++t )
+    {
+        threads.create_thread( CacheReaderThread( name, cache, errors[t] ) );
+    }
+    threads.join_all();
+
+    for ( size_t t = 0; t < numThreads; ++t )
+    {
+        TESTING_ASSERT( errors[t].empty() );
+    }
+
+    // What's on disk, as a new cache counts it.
+    uint64_t entryBytes = dynamic_cast<A5::DiskCacheImpl *>(
+        A5::CreateDiskCache( g_cacheDir, maxBytes ).get() )->getNumBytes();
+    TESTING_ASSERT( entryBytes >= g_numSamples * g_numPoints * 12 );
+    TESTING_ASSERT( entryBytes < g_numSamples * ( g_numPoints * 12 + 1024 ) );
+
+    readArchive( name, cache );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testDiskCache();
+    testConcurrentDiskCache();
+    return 0;
+}
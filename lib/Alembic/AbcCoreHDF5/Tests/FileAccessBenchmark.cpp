@@ -0,0 +1,210 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+//-*****************************************************************************
+// Times a write-heavy export and a read-heavy playback pass with the
+// default HDF5 file access and with the FileAccessProfile presets.
+// Not run as part of the test suite.
+//
+//     AbcCoreHDF5_FileAccessBenchmark [numObjects] [numSamples] [numVals]
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+#include <vector>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+struct BenchSettings
+{
+    size_t numObjects;
+    size_t numSamples;
+    size_t numVals;
+};
+
+//-*****************************************************************************
+static double secondsSince( const boost::posix_time::ptime &iStart )
+{
+    boost::posix_time::time_duration d =
+        boost::posix_time::microsec_clock::local_time() - iStart;
+    return d.total_microseconds() / 1.0e6;
+}
+
+//-*****************************************************************************
+double timeExport( const std::string &iName,
+                   const A5::FileAccessProfile &iProfile,
+                   const BenchSettings &iSettings )
+{
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::local_time();
+
+    A5::WriteArchive w( iProfile );
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    ABC::ObjectWriterPtr top = a->getTop();
+
+    ABC::DataType f32d( Alembic::Util::kFloat32POD, 3 );
+
+    // properties don't keep their object alive, so hold onto both
+    std::vector<ABC::ObjectWriterPtr> objects;
+    std::vector<ABC::ArrayPropertyWriterPtr> props;
+    for ( size_t o = 0; o < iSettings.numObjects; ++o )
+    {
+        std::string name = "obj" + boost::lexical_cast<std::string>( o );
+        ABC::ObjectWriterPtr child =
+            top->createChild( ABC::ObjectHeader( name, ABC::MetaData() ) );
+        objects.push_back( child );
+        props.push_back( child->getProperties()->createArrayProperty(
+            "P", ABC::MetaData(), f32d, 0 ) );
+    }
+
+    // every sample differs so nothing gets deduplicated
+    std::vector<float32_t> vals( iSettings.numVals * 3 );
+    for ( size_t s = 0; s < iSettings.numSamples; ++s )
+    {
+        for ( size_t o = 0; o < props.size(); ++o )
+        {
+            for ( size_t i = 0; i < vals.size(); ++i )
+            {
+                vals[i] = ( float32_t )( s + o + i * 0.001 );
+            }
+            props[o]->setSample( ABC::ArraySample( &vals.front(), f32d,
+                Dimensions( iSettings.numVals ) ) );
+        }
+    }
+
+    // closing flushes everything
+    props.clear();
+    objects.clear();
+    top.reset();
+    a.reset();
+
+    return secondsSince( start );
+}
+
+//-*****************************************************************************
+double timePlayback( const std::string &iName,
+                     const A5::FileAccessProfile &iProfile )
+{
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::local_time();
+
+    A5::ReadArchive r( iProfile );
+    ABC::ArchiveReaderPtr a = r( iName );
+    ABC::ObjectReaderPtr top = a->getTop();
+
+    std::vector<ABC::ObjectReaderPtr> objects;
+    std::vector<ABC::ArrayPropertyReaderPtr> props;
+    for ( size_t o = 0; o < top->getNumChildren(); ++o )
+    {
+        objects.push_back( top->getChild( o ) );
+        props.push_back(
+            objects.back()->getProperties()->getArrayProperty( "P" ) );
+    }
+
+    // scrub forward twice, the way an interactive session would, reading
+    // each object per frame
+    double sum = 0.0;
+    for ( size_t pass = 0; pass < 2; ++pass )
+    {
+        size_t numSamples = props.empty() ? 0 : props[0]->getNumSamples();
+        for ( size_t s = 0; s < numSamples; ++s )
+        {
+            for ( size_t o = 0; o < props.size(); ++o )
+            {
+                ABC::ArraySamplePtr samp;
+                props[o]->getSample( s, samp );
+                sum += ( ( const float32_t * ) samp->getData() )[0];
+            }
+        }
+    }
+
+    double secs = secondsSince( start );
+
+    // keep the reads from being optimized away
+    if ( sum < 0.0 ) { std::cout << sum << std::endl; }
+
+    return secs;
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    BenchSettings settings;
+    settings.numObjects = argc > 1 ?
+        boost::lexical_cast<size_t>( argv[1] ) : 500;
+    settings.numSamples = argc > 2 ?
+        boost::lexical_cast<size_t>( argv[2] ) : 48;
+    settings.numVals = argc > 3 ?
+        boost::lexical_cast<size_t>( argv[3] ) : 2000;
+
+    std::cout << "objects: " << settings.numObjects
+              << " samples: " << settings.numSamples
+              << " points: " << settings.numVals << std::endl;
+
+    std::string name = "fileAccessBenchmark.abc";
+
+    std::cout << "export   default:  "
+              << timeExport( name, A5::FileAccessProfile(), settings )
+              << "s" << std::endl;
+    std::cout << "export   Export:   "
+              << timeExport( name, A5::FileAccessProfile::Export(), settings )
+              << "s" << std::endl;
+
+    std::cout << "playback default:  "
+              << timePlayback( name, A5::FileAccessProfile() )
+              << "s" << std::endl;
+    std::cout << "playback Playback: "
+              << timePlayback( name, A5::FileAccessProfile::Playback() )
+              << "s" << std::endl;
+    std::cout << "playback InMemory: "
+              << timePlayback( name, A5::FileAccessProfile::InMemory() )
+              << "s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <iostream>
+#include <vector>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numVals = 4096;
+static const size_t g_numSamples = 8;
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName,
+                   const A5::FileAccessProfile &iProfile )
+{
+    A5::WriteArchive w( iProfile );
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    ABC::ObjectWriterPtr top = a->getTop();
+
+    ABC::ObjectWriterPtr child =
+        top->createChild( ABC::ObjectHeader( "child", ABC::MetaData() ) );
+
+    ABC::DataType f32d( Alembic::Util::kFloat32POD, 1 );
+    ABC::ArrayPropertyWriterPtr awp =
+        child->getProperties()->createArrayProperty( "floats",
+            ABC::MetaData(), f32d, 0 );
+
+    std::vector<float32_t> vals( g_numVals );
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        for ( size_t i = 0; i < g_numVals; ++i )
+        {
+            vals[i] = ( float32_t )( s * g_numVals + i );
+        }
+        awp->setSample( ABC::ArraySample( &vals.front(), f32d,
+                                          Dimensions( g_numVals ) ) );
+    }
+}
+
+//-*****************************************************************************
+void readArchive( const std::string &iName,
+                  const A5::FileAccessProfile &iProfile )
+{
+    A5::ReadArchive r( iProfile );
+    ABC::ArchiveReaderPtr a = r( iName );
+    ABC::ObjectReaderPtr top = a->getTop();
+    TESTING_ASSERT( top->getNumChildren() == 1 );
+
+    ABC::ObjectReaderPtr child = top->getChild( 0 );
+    TESTING_ASSERT( child->getName() == "child" );
+
+    ABC::ArrayPropertyReaderPtr ap =
+        child->getProperties()->getArrayProperty( "floats" );
+    TESTING_ASSERT( ap );
+    TESTING_ASSERT( ap->getNumSamples() == g_numSamples );
+
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        ap->getSample( s, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == g_numVals );
+
+        const float32_t *data = ( const float32_t * )( samp->getData() );
+        for ( size_t i = 0; i < g_numVals; ++i )
+        {
+            TESTING_ASSERT( data[i] == ( float32_t )( s * g_numVals + i ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+void testPresets()
+{
+    A5::FileAccessProfile def;
+    TESTING_ASSERT( def.rawChunkCacheBytes == 0 );
+    TESTING_ASSERT( !def.useCoreDriver );
+
+    A5::FileAccessProfile playback = A5::FileAccessProfile::Playback();
+    TESTING_ASSERT( playback.rawChunkCacheBytes > 0 );
+    TESTING_ASSERT( playback.metaDataCacheMinBytes <=
+                    playback.metaDataCacheInitialBytes );
+    TESTING_ASSERT( playback.metaDataCacheInitialBytes <=
+                    playback.metaDataCacheMaxBytes );
+
+    A5::FileAccessProfile exportProfile = A5::FileAccessProfile::Export();
+    TESTING_ASSERT( exportProfile.alignment > 0 );
+    TESTING_ASSERT( exportProfile.metaDataBlockBytes > 0 );
+
+    TESTING_ASSERT( A5::FileAccessProfile::InMemory().useCoreDriver );
+
+    // the functors hold on to what they were given
+    A5::ReadArchive r( playback );
+    TESTING_ASSERT( r.getProfile().rawChunkCacheBytes ==
+                    playback.rawChunkCacheBytes );
+}
+
+//-*****************************************************************************
+void testRoundTrips()
+{
+    // every profile must produce a file any other profile can read
+    std::vector<A5::FileAccessProfile> profiles;
+    profiles.push_back( A5::FileAccessProfile() );
+    profiles.push_back( A5::FileAccessProfile::Playback() );
+    profiles.push_back( A5::FileAccessProfile::Export() );
+    profiles.push_back( A5::FileAccessProfile::InMemory() );
+
+    // deliberately unbalanced metadata cache sizes get clamped
+    A5::FileAccessProfile odd;
+    odd.metaDataCacheInitialBytes = 512;
+    odd.metaDataCacheMaxBytes = size_t( 1 ) << 40;
+    odd.rawChunkCachePreemption = 2.0;
+    profiles.push_back( odd );
+
+    for ( size_t w = 0; w < profiles.size(); ++w )
+    {
+        std::string name = "fileAccessProfile.abc";
+        writeArchive( name, profiles[w] );
+
+        for ( size_t r = 0; r < profiles.size(); ++r )
+        {
+            readArchive( name, profiles[r] );
+        }
+    }
+}
+
+//-*****************************************************************************
+void testCoreDriverWithoutBackingStore()
+{
+    std::string name = "fileAccessNoBacking.abc";
+
+    // write a real file first so we can tell it gets left alone
+    writeArchive( name, A5::FileAccessProfile() );
+
+    A5::FileAccessProfile memOnly = A5::FileAccessProfile::InMemory();
+    memOnly.coreDriverBackingStore = false;
+
+    {
+        A5::WriteArchive w( memOnly );
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+    }
+
+    // the original contents are still what's on disk
+    readArchive( name, A5::FileAccessProfile() );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testPresets();
+    testRoundTrips();
+    testCoreDriverWithoutBackingStore();
+    return 0;
+}
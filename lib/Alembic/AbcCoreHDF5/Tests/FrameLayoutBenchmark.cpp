@@ -0,0 +1,252 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+//-*****************************************************************************
+// Times reading a frame of a whole scene from a cold cache, from an archive
+// written object by object and from the same archive after RepackArchive,
+// with and without a FramePrefetcher reading the frame ahead of the
+// archive. Not run as part of the test suite.
+//
+// The file is dropped from the OS page cache before every frame, which is
+// only done on Linux. Elsewhere the times are warm cache times.
+//
+//     AbcCoreHDF5_FrameLayoutBenchmark [numObjects] [numFrames] [numVals]
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+struct BenchSettings
+{
+    size_t numObjects;
+    size_t numFrames;
+    size_t numVals;
+};
+
+//-*****************************************************************************
+static double secondsSince( const boost::posix_time::ptime &iStart )
+{
+    boost::posix_time::time_duration d =
+        boost::posix_time::microsec_clock::local_time() - iStart;
+    return d.total_microseconds() / 1.0e6;
+}
+
+//-*****************************************************************************
+// Drops iName from the page cache, returns false if it couldn't.
+static bool evict( const std::string &iName )
+{
+#ifdef __linux__
+    int fd = open( iName.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        return false;
+    }
+
+    fdatasync( fd );
+    bool evicted = posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED ) == 0;
+    close( fd );
+    return evicted;
+#else
+    return false;
+#endif
+}
+
+//-*****************************************************************************
+// Every object gets all of its frames before the next object starts, which
+// is how most exporters write.
+void writeObjectMajor( const std::string &iName,
+                       const BenchSettings &iSettings )
+{
+    A5::WriteArchive w;
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    uint32_t tsIndex = a->addTimeSampling(
+        ABC::TimeSampling( 1.0 / 24.0, 0.0 ) );
+
+    ABC::DataType f32d( Alembic::Util::kFloat32POD, 3 );
+
+    std::vector<float32_t> vals( iSettings.numVals * 3 );
+    for ( size_t o = 0; o < iSettings.numObjects; ++o )
+    {
+        std::string name = "obj" + boost::lexical_cast<std::string>( o );
+        ABC::ObjectWriterPtr child = a->getTop()->createChild(
+            ABC::ObjectHeader( name, ABC::MetaData() ) );
+        ABC::ArrayPropertyWriterPtr P =
+            child->getProperties()->createArrayProperty(
+                "P", ABC::MetaData(), f32d, tsIndex );
+
+        // every sample differs so nothing gets deduplicated
+        for ( size_t f = 0; f < iSettings.numFrames; ++f )
+        {
+            for ( size_t i = 0; i < vals.size(); ++i )
+            {
+                vals[i] = ( float32_t )( f + o * 1000 + i * 0.001 );
+            }
+            P->setSample( ABC::ArraySample( &vals.front(), f32d,
+                Dimensions( iSettings.numVals ) ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+// Returns the average number of seconds it took to read a frame.
+double timeFrames( const std::string &iName, bool iPrefetch, bool &oCold )
+{
+    ABC::ArchiveReaderPtr a =
+        A5::ReadArchive()( iName, ABC::ReadArraySampleCachePtr() );
+    ABC::ObjectReaderPtr top = a->getTop();
+
+    std::vector<ABC::ObjectReaderPtr> objects;
+    std::vector<ABC::ArrayPropertyReaderPtr> props;
+    for ( size_t o = 0; o < top->getNumChildren(); ++o )
+    {
+        objects.push_back( top->getChild( o ) );
+        props.push_back(
+            objects.back()->getProperties()->getArrayProperty( "P" ) );
+    }
+
+    A5::FramePrefetcher prefetcher( iName );
+
+    size_t numFrames = props.empty() ? 0 : props[0]->getNumSamples();
+    ABC::TimeSamplingPtr ts = a->getTimeSampling( 1 );
+
+    double secs = 0.0;
+    double sum = 0.0;
+    oCold = true;
+    for ( size_t f = 0; f < numFrames; ++f )
+    {
+        oCold = evict( iName ) && oCold;
+
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::local_time();
+
+        if ( iPrefetch )
+        {
+            prefetcher.prefetch( ts->getSampleTime( f ) );
+        }
+
+        for ( size_t o = 0; o < props.size(); ++o )
+        {
+            ABC::ArraySamplePtr samp;
+            props[o]->getSample( f, samp );
+            sum += ( ( const float32_t * ) samp->getData() )[0];
+        }
+
+        secs += secondsSince( start );
+    }
+
+    // keep the reads from being optimized away
+    if ( sum < 0.0 ) { std::cout << sum << std::endl; }
+
+    return numFrames > 0 ? secs / numFrames : 0.0;
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    BenchSettings settings;
+    settings.numObjects = argc > 1 ?
+        boost::lexical_cast<size_t>( argv[1] ) : 1000;
+    settings.numFrames = argc > 2 ?
+        boost::lexical_cast<size_t>( argv[2] ) : 24;
+    settings.numVals = argc > 3 ?
+        boost::lexical_cast<size_t>( argv[3] ) : 500;
+
+    std::cout << "objects: " << settings.numObjects
+              << " frames: " << settings.numFrames
+              << " points: " << settings.numVals << std::endl;
+
+    std::string objectMajor = "frameLayoutObjectMajor.abc";
+    std::string timeMajor = "frameLayoutTimeMajor.abc";
+
+    writeObjectMajor( objectMajor, settings );
+
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::local_time();
+    A5::RepackArchive( objectMajor, timeMajor );
+    std::cout << "repack:                  " << secondsSince( start )
+              << "s" << std::endl;
+
+    A5::FrameIndex index;
+    A5::ReadFrameIndex( timeMajor, index );
+    std::cout << "frame index extents:     " << index.size() << std::endl;
+
+    bool cold = true;
+    bool allCold = true;
+
+    std::cout << "object major:            "
+              << timeFrames( objectMajor, false, cold ) * 1000.0
+              << "ms per frame" << std::endl;
+    allCold = allCold && cold;
+
+    std::cout << "time major:              "
+              << timeFrames( timeMajor, false, cold ) * 1000.0
+              << "ms per frame" << std::endl;
+    allCold = allCold && cold;
+
+    std::cout << "time major, prefetched:  "
+              << timeFrames( timeMajor, true, cold ) * 1000.0
+              << "ms per frame" << std::endl;
+    allCold = allCold && cold;
+
+    if ( !allCold )
+    {
+        std::cout << "could not drop the files from the page cache, "
+                  << "these are warm cache times" << std::endl;
+    }
+
+    return 0;
+}
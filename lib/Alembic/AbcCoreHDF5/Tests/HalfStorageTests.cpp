@@ -0,0 +1,326 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <limits>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float16_t;
+using Alembic::Util::float32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numSamples = 6;
+static const size_t g_numPoints = 5000;
+
+//-*****************************************************************************
+std::vector<float32_t> sampleValues( size_t iSample, size_t iExtent )
+{
+    std::vector<float32_t> vals( g_numPoints * iExtent );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t ) sin( i * 0.37 + iSample * 0.1 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+void writeSamples( ABC::ArrayPropertyWriterPtr iProp )
+{
+    const ABC::DataType &dataType = iProp->getDataType();
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        // sample 3 is a repeat of 2
+        std::vector<float32_t> vals =
+            sampleValues( s == 3 ? 2 : s, dataType.getExtent() );
+        iProp->setSample( ABC::ArraySample( &vals.front(), dataType,
+                                            Dimensions( g_numPoints ) ) );
+    }
+}
+
+//-*****************************************************************************
+// Half stored samples read back as the halfs of what was written, and
+// the rest read back exactly.
+void checkSamples( ABC::ArrayPropertyReaderPtr iProp, bool iHalfs )
+{
+    TESTING_ASSERT( iProp->getDataType().getPod() ==
+                    Alembic::Util::kFloat32POD );
+    TESTING_ASSERT( iProp->getNumSamples() == g_numSamples );
+
+    size_t extent = iProp->getDataType().getExtent();
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        iProp->getSample( s, samp );
+        TESTING_ASSERT( samp->getDataType() == iProp->getDataType() );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+        std::vector<float32_t> expected =
+            sampleValues( s == 3 ? 2 : s, extent );
+        const float32_t *data =
+            static_cast<const float32_t *>( samp->getData() );
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            float32_t e = iHalfs ?
+                ( float32_t ) float16_t( expected[i] ) : expected[i];
+            TESTING_ASSERT( data[i] == e );
+        }
+
+        // keys are those of what is read back
+        ABC::ArraySampleKey key;
+        TESTING_ASSERT( iProp->getKey( s, key ) );
+        TESTING_ASSERT( key.digest == samp->getKey().digest );
+    }
+}
+
+//-*****************************************************************************
+size_t fileSize( const std::string &iName )
+{
+    FILE *f = fopen( iName.c_str(), "rb" );
+    TESTING_ASSERT( f != NULL );
+    fseek( f, 0, SEEK_END );
+    long size = ftell( f );
+    fclose( f );
+    return ( size_t )size;
+}
+
+//-*****************************************************************************
+ABC::MetaData geomParamMetaData( const std::string &iInterpretation )
+{
+    ABC::MetaData md;
+    md.set( "isGeomParam", "true" );
+    md.set( "interpretation", iInterpretation );
+    return md;
+}
+
+//-*****************************************************************************
+void testHalfStorage()
+{
+    std::string name = "halfStorage.abc";
+    ABC::MetaData md;
+    A5::SetHalfStorage( md );
+    TESTING_ASSERT( A5::GetHalfStorage( md ) );
+    TESTING_ASSERT( !A5::GetHalfStorage( ABC::MetaData() ) );
+
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType f2( Alembic::Util::kFloat32POD, 2 );
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+
+        writeSamples( props->createArrayProperty( "N", md, f3, 0 ) );
+
+        // the same samples again, shared with N
+        writeSamples( props->createArrayProperty( "N2", md, f3, 0 ) );
+
+        // and not half stored, so not shared with either
+        writeSamples( props->createArrayProperty( "P", ABC::MetaData(),
+                                                  f3, 0 ) );
+
+        // half stored keyframes with deltas between them
+        ABC::MetaData deltaMd( md );
+        A5::SetDeltaEncoding( deltaMd, 2 );
+        writeSamples( props->createArrayProperty( "delta", deltaMd, f2, 0 ) );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+    checkSamples( props->getArrayProperty( "N" ), true );
+    checkSamples( props->getArrayProperty( "N2" ), true );
+    checkSamples( props->getArrayProperty( "P" ), false );
+
+    ABC::ArrayPropertyReaderPtr delta = props->getArrayProperty( "delta" );
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        delta->getSample( s, samp );
+        std::vector<float32_t> expected = sampleValues( s == 3 ? 2 : s, 2 );
+        const float32_t *data =
+            static_cast<const float32_t *>( samp->getData() );
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            TESTING_ASSERT( fabs( data[i] - expected[i] ) <= 1e-3 );
+        }
+    }
+}
+
+//-*****************************************************************************
+void testArchiveWide()
+{
+    std::string name = "halfStorageArchive.abc";
+    ABC::MetaData archiveMd;
+    A5::SetHalfStorage( archiveMd );
+
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType f2( Alembic::Util::kFloat32POD, 2 );
+    ABC::DataType f4( Alembic::Util::kFloat32POD, 4 );
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, archiveMd );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+
+        writeSamples( props->createArrayProperty( "N",
+            geomParamMetaData( "normal" ), f3, 0 ) );
+        writeSamples( props->createArrayProperty( "uv",
+            geomParamMetaData( "vector" ), f2, 0 ) );
+        writeSamples( props->createArrayProperty( "Cs",
+            geomParamMetaData( "rgba" ), f4, 0 ) );
+
+        // not normals, colors or uvs
+        writeSamples( props->createArrayProperty( "v",
+            geomParamMetaData( "vector" ), f3, 0 ) );
+        writeSamples( props->createArrayProperty( "P",
+            geomParamMetaData( "point" ), f3, 0 ) );
+        writeSamples( props->createArrayProperty( "notParam",
+            ABC::MetaData(), f3, 0 ) );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+    checkSamples( props->getArrayProperty( "N" ), true );
+    checkSamples( props->getArrayProperty( "uv" ), true );
+    checkSamples( props->getArrayProperty( "Cs" ), true );
+    checkSamples( props->getArrayProperty( "v" ), false );
+    checkSamples( props->getArrayProperty( "P" ), false );
+    checkSamples( props->getArrayProperty( "notParam" ), false );
+
+    // the properties say so themselves
+    TESTING_ASSERT( A5::GetHalfStorage(
+        props->getArrayProperty( "N" )->getMetaData() ) );
+    TESTING_ASSERT( !A5::GetHalfStorage(
+        props->getArrayProperty( "P" )->getMetaData() ) );
+}
+
+//-*****************************************************************************
+void testFallback()
+{
+    std::string name = "halfStorageFallback.abc";
+    ABC::DataType fd( Alembic::Util::kFloat32POD, 1 );
+
+    std::vector< std::vector<float32_t> > written;
+    std::vector<float32_t> vals( 10, 0.5f );
+    written.push_back( vals );
+
+    // not finite, which halfs hold
+    vals[2] = std::numeric_limits<float32_t>::infinity();
+    written.push_back( vals );
+
+    // too large for a half
+    vals[2] = 1e6f;
+    written.push_back( vals );
+
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+
+        ABC::MetaData md;
+        A5::SetHalfStorage( md );
+        ABC::ArrayPropertyWriterPtr p =
+            a->getTop()->getProperties()->createArrayProperty( "vals", md,
+                                                               fd, 0 );
+        for ( size_t s = 0; s < written.size(); ++s )
+        {
+            p->setSample( ABC::ArraySample( &written[s].front(), fd,
+                                            Dimensions( 10 ) ) );
+        }
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::ArrayPropertyReaderPtr p =
+        a->getTop()->getProperties()->getArrayProperty( "vals" );
+
+    for ( size_t s = 0; s < written.size(); ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        p->getSample( s, samp );
+        const float32_t *data = ( const float32_t * ) samp->getData();
+        for ( size_t i = 0; i < 10; ++i )
+        {
+            TESTING_ASSERT( data[i] == written[s][i] );
+        }
+    }
+}
+
+//-*****************************************************************************
+void testSize()
+{
+    ABC::MetaData md;
+    A5::SetHalfStorage( md );
+
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    std::string plainName = "halfStoragePlain.abc";
+    std::string halfName = "halfStorageHalfs.abc";
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr plain = w( plainName, ABC::MetaData() );
+        writeSamples( plain->getTop()->getProperties()->createArrayProperty(
+            "N", ABC::MetaData(), f3, 0 ) );
+
+        ABC::ArchiveWriterPtr halfs = w( halfName, ABC::MetaData() );
+        writeSamples( halfs->getTop()->getProperties()->createArrayProperty(
+            "N", md, f3, 0 ) );
+    }
+
+    // about half the bytes, less the archive's own overhead
+    TESTING_ASSERT( fileSize( halfName ) * 3 < fileSize( plainName ) * 2 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testHalfStorage();
+    testArchiveWide();
+    testFallback();
+    testSize();
+    return 0;
+}
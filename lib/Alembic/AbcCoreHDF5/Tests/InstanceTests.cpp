@@ -0,0 +1,300 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <vector>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numFrames = 5;
+
+//-*****************************************************************************
+// /proto, with an "id" array property, a child "leaf" and a leaf "val",
+// /set/inst0 and /set/inst1 instances of /proto, and /set/leafInst an
+// instance of /proto/leaf.
+void writeInstances( const std::string &iName )
+{
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+
+    A5::WriteArchive w;
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    uint32_t tsIndex = a->addTimeSampling(
+        ABC::TimeSampling( 1.0 / 24.0, 1.0 ) );
+
+    ABC::MetaData md;
+    md.set( "schema", "proto" );
+
+    ABC::ObjectWriterPtr proto = a->getTop()->createChild(
+        ABC::ObjectHeader( "proto", md ) );
+    ABC::ObjectWriterPtr leaf = proto->createChild(
+        ABC::ObjectHeader( "leaf", ABC::MetaData() ) );
+    ABC::ObjectWriterPtr set = a->getTop()->createChild(
+        ABC::ObjectHeader( "set", ABC::MetaData() ) );
+
+    ABC::ArrayPropertyWriterPtr id = proto->getProperties()->
+        createArrayProperty( "id", ABC::MetaData(), i1, tsIndex );
+    ABC::ScalarPropertyWriterPtr val = leaf->getProperties()->
+        createScalarProperty( "val", ABC::MetaData(), i1, 0 );
+
+    // Added before the samples are set, the instances still see them all.
+    set->addChildInstance( proto, "inst0" );
+    set->addChildInstance( proto, "inst1" );
+    set->addChildInstance( leaf, "leafInst" );
+
+    TESTING_ASSERT( set->getNumChildren() == 3 );
+    TESTING_ASSERT( set->getChildHeader( 0 ).getName() == "inst0" );
+    TESTING_ASSERT( set->getChildHeader( 0 ).getMetaData().get( "schema" )
+                    == "proto" );
+    TESTING_ASSERT( !set->getChild( "inst0" ) );
+
+    // Same name twice, as an instance or as an object.
+    TESTING_ASSERT_THROW( set->addChildInstance( proto, "inst0" ),
+                          Alembic::Util::Exception );
+    TESTING_ASSERT_THROW( set->createChild(
+                              ABC::ObjectHeader( "inst1", ABC::MetaData() ) ),
+                          Alembic::Util::Exception );
+
+    // Under itself, or under one of its own children.
+    TESTING_ASSERT_THROW( proto->addChildInstance( proto, "self" ),
+                          Alembic::Util::Exception );
+    TESTING_ASSERT_THROW( leaf->addChildInstance( proto, "loop" ),
+                          Alembic::Util::Exception );
+
+    // Under something that already holds it through an instance, here
+    // /set holding /proto, and /proto/leaf through /set/leafInst.
+    TESTING_ASSERT_THROW( proto->addChildInstance( set, "sibling" ),
+                          Alembic::Util::Exception );
+    TESTING_ASSERT_THROW( leaf->addChildInstance( set, "nephew" ),
+                          Alembic::Util::Exception );
+    TESTING_ASSERT_THROW( set->addChildInstance( a->getTop(), "top" ),
+                          Alembic::Util::Exception );
+    TESTING_ASSERT_THROW( set->addChildInstance( proto, "a=b" ),
+                          Alembic::Util::Exception );
+
+    std::vector<int32_t> ids( 10 );
+    for ( size_t f = 0; f < g_numFrames; ++f )
+    {
+        for ( size_t i = 0; i < ids.size(); ++i )
+        {
+            ids[i] = ( int32_t )( f * 100 + i );
+        }
+        id->setSample( ABC::ArraySample( &ids.front(), i1,
+                                         Dimensions( ids.size() ) ) );
+    }
+
+    int32_t valValue = 42;
+    val->setSample( &valValue );
+}
+
+//-*****************************************************************************
+void checkProto( ABC::ObjectReaderPtr iObj )
+{
+    ABC::CompoundPropertyReaderPtr props = iObj->getProperties();
+    TESTING_ASSERT( props->getNumProperties() == 1 );
+    TESTING_ASSERT( iObj->getMetaData().get( "schema" ) == "proto" );
+
+    ABC::ArrayPropertyReaderPtr id = props->getArrayProperty( "id" );
+    TESTING_ASSERT( id->getNumSamples() == g_numFrames );
+
+    for ( size_t f = 0; f < g_numFrames; ++f )
+    {
+        ABC::ArraySamplePtr samp;
+        id->getSample( f, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 10 );
+        const int32_t *data = static_cast<const int32_t *>( samp->getData() );
+        TESTING_ASSERT( data[3] == ( int32_t )( f * 100 + 3 ) );
+    }
+
+    TESTING_ASSERT( iObj->getNumChildren() == 1 );
+    ABC::ObjectReaderPtr leaf = iObj->getChild( "leaf" );
+    TESTING_ASSERT( leaf );
+
+    int32_t valValue = 0;
+    leaf->getProperties()->getScalarProperty( "val" )->
+        getSample( 0, &valValue );
+    TESTING_ASSERT( valValue == 42 );
+}
+
+//-*****************************************************************************
+void checkInstances( const std::string &iName )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName );
+    ABC::ObjectReaderPtr top = a->getTop();
+    TESTING_ASSERT( top->getNumChildren() == 2 );
+    TESTING_ASSERT( !top->isInstanceRoot() );
+    TESTING_ASSERT( !top->isChildInstance( "proto" ) );
+
+    ABC::ObjectReaderPtr proto = top->getChild( "proto" );
+    TESTING_ASSERT( !proto->isInstanceRoot() );
+    TESTING_ASSERT( !proto->isInstanceDescendant() );
+    TESTING_ASSERT( proto->getInstanceSourcePath().empty() );
+    checkProto( proto );
+
+    ABC::ObjectReaderPtr set = top->getChild( "set" );
+    TESTING_ASSERT( set->getNumChildren() == 3 );
+
+    const char *names[] = { "inst0", "inst1" };
+    for ( size_t i = 0; i < 2; ++i )
+    {
+        TESTING_ASSERT( set->isChildInstance( i ) );
+        TESTING_ASSERT( set->isChildInstance( names[i] ) );
+
+        ABC::ObjectReaderPtr inst = set->getChild( names[i] );
+        TESTING_ASSERT( inst->isInstanceRoot() );
+        TESTING_ASSERT( inst->isInstanceDescendant() );
+        TESTING_ASSERT( inst->getInstanceSourcePath() == "/proto" );
+        TESTING_ASSERT( inst->getFullName() ==
+                        std::string( "/set/" ) + names[i] );
+        checkProto( inst );
+
+        // Below an instance, but not one itself.
+        ABC::ObjectReaderPtr leaf = inst->getChild( "leaf" );
+        TESTING_ASSERT( !leaf->isInstanceRoot() );
+        TESTING_ASSERT( leaf->isInstanceDescendant() );
+    }
+
+    ABC::ObjectReaderPtr leafInst = set->getChild( "leafInst" );
+    TESTING_ASSERT( leafInst->isInstanceRoot() );
+    TESTING_ASSERT( leafInst->getInstanceSourcePath() == "/proto/leaf" );
+}
+
+//-*****************************************************************************
+void testInstances()
+{
+    std::string name = "instances.abc";
+    writeInstances( name );
+    checkInstances( name );
+
+    // Repacking keeps them instances.
+    std::string repacked = "instancesRepacked.abc";
+    A5::RepackArchive( name, repacked );
+    checkInstances( repacked );
+}
+
+//-*****************************************************************************
+// Appending keeps the instances that were there, and can add more, but
+// can't write into an instance.
+void testAppendInstances()
+{
+    std::string name = "instancesAppend.abc";
+    writeInstances( name );
+
+    {
+        ABC::ArchiveWriterPtr a = A5::AppendArchive()( name );
+        ABC::ObjectWriterPtr proto = a->getTop()->createChild(
+            ABC::ObjectHeader( "proto", ABC::MetaData() ) );
+        ABC::ObjectWriterPtr set = a->getTop()->createChild(
+            ABC::ObjectHeader( "set", ABC::MetaData() ) );
+
+        TESTING_ASSERT_THROW( set->createChild(
+                                  ABC::ObjectHeader( "inst0",
+                                                     ABC::MetaData() ) ),
+                              Alembic::Util::Exception );
+        TESTING_ASSERT_THROW( set->addChildInstance( proto, "inst1" ),
+                              Alembic::Util::Exception );
+
+        // The instances /set was written with still count.
+        TESTING_ASSERT_THROW( proto->addChildInstance( set, "sibling" ),
+                              Alembic::Util::Exception );
+
+        set->addChildInstance( proto, "inst2" );
+    }
+
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( name );
+    ABC::ObjectReaderPtr set = a->getTop()->getChild( "set" );
+    TESTING_ASSERT( set->getNumChildren() == 4 );
+    TESTING_ASSERT( set->isChildInstance( "inst0" ) );
+    TESTING_ASSERT( set->isChildInstance( "leafInst" ) );
+
+    ABC::ObjectReaderPtr inst = set->getChild( "inst2" );
+    TESTING_ASSERT( inst->isInstanceRoot() );
+    TESTING_ASSERT( inst->getInstanceSourcePath() == "/proto" );
+    checkProto( inst );
+}
+
+//-*****************************************************************************
+// Objects that aren't each other's ancestors can't instance each other
+// either, however many instances apart they are.
+void testInstanceCycles()
+{
+    ABC::ArchiveWriterPtr a =
+        A5::WriteArchive()( "instanceCycles.abc", ABC::MetaData() );
+
+    ABC::ObjectWriterPtr A = a->getTop()->createChild(
+        ABC::ObjectHeader( "A", ABC::MetaData() ) );
+    ABC::ObjectWriterPtr B = a->getTop()->createChild(
+        ABC::ObjectHeader( "B", ABC::MetaData() ) );
+    ABC::ObjectWriterPtr C = a->getTop()->createChild(
+        ABC::ObjectHeader( "C", ABC::MetaData() ) );
+    ABC::ObjectWriterPtr Cchild = C->createChild(
+        ABC::ObjectHeader( "child", ABC::MetaData() ) );
+
+    A->addChildInstance( B, "x" );
+    TESTING_ASSERT_THROW( B->addChildInstance( A, "y" ),
+                          Alembic::Util::Exception );
+
+    // /B/z is /C, so /C/child can't hold /A, which holds /B.
+    B->addChildInstance( C, "z" );
+    TESTING_ASSERT_THROW( Cchild->addChildInstance( A, "w" ),
+                          Alembic::Util::Exception );
+
+    // Holding the same object twice is not a cycle.
+    A->addChildInstance( C, "z" );
+    TESTING_ASSERT( A->getNumChildren() == 2 );
+    TESTING_ASSERT( B->getNumChildren() == 1 );
+    TESTING_ASSERT( Cchild->getNumChildren() == 0 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testInstances();
+    testAppendInstances();
+    testInstanceCycles();
+    return 0;
+}
@@ -0,0 +1,232 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <iostream>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hdf5.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numVals = 1000;
+static const size_t g_numSamples = 5;
+
+//-*****************************************************************************
+void writeContents( ABC::ArchiveWriterPtr iArchive )
+{
+    ABC::ObjectWriterPtr top = iArchive->getTop();
+    ABC::ObjectWriterPtr child =
+        top->createChild( ABC::ObjectHeader( "child", ABC::MetaData() ) );
+
+    ABC::DataType i32d( Alembic::Util::kInt32POD, 1 );
+    ABC::ArrayPropertyWriterPtr awp =
+        child->getProperties()->createArrayProperty( "ints",
+            ABC::MetaData(), i32d, 0 );
+
+    std::vector<int32_t> vals( g_numVals );
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        for ( size_t i = 0; i < g_numVals; ++i )
+        {
+            vals[i] = s * 10000 + i;
+        }
+        awp->setSample( ABC::ArraySample( &vals.front(), i32d,
+                                          Dimensions( g_numVals ) ) );
+    }
+}
+
+//-*****************************************************************************
+void checkContents( ABC::ArchiveReaderPtr iArchive )
+{
+    ABC::ObjectReaderPtr top = iArchive->getTop();
+    TESTING_ASSERT( top->getNumChildren() == 1 );
+    TESTING_ASSERT( top->getMetaData().get( "potato" ) == "salad" );
+
+    ABC::ObjectReaderPtr child = top->getChild( 0 );
+    ABC::ArrayPropertyReaderPtr ap =
+        child->getProperties()->getArrayProperty( "ints" );
+    TESTING_ASSERT( ap->getNumSamples() == g_numSamples );
+
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        ap->getSample( s, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == g_numVals );
+
+        const int32_t *data = ( const int32_t * ) samp->getData();
+        for ( size_t i = 0; i < g_numVals; ++i )
+        {
+            TESTING_ASSERT( data[i] == ( int32_t )( s * 10000 + i ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+bool fileExists( const std::string &iName )
+{
+    FILE *f = fopen( iName.c_str(), "rb" );
+    if ( f )
+    {
+        fclose( f );
+        return true;
+    }
+    return false;
+}
+
+//-*****************************************************************************
+void testMemoryRoundTrip()
+{
+    std::string name = "memoryArchive.abc";
+    remove( name.c_str() );
+
+    ABC::MetaData md;
+    md.set( "potato", "salad" );
+
+    A5::ArchiveImagePtr image( new A5::ArchiveImage );
+    {
+        A5::WriteMemoryArchive w( image );
+        ABC::ArchiveWriterPtr a = w( name, md );
+        writeContents( a );
+
+        // nothing shows up until the archive is closed
+        TESTING_ASSERT( image->empty() );
+    }
+
+    // the bytes are a regular HDF5 file, and nothing was put on disk
+    TESTING_ASSERT( image->size() > 8 );
+    TESTING_ASSERT( memcmp( &image->front(), "\211HDF\r\n\032\n", 8 ) == 0 );
+    TESTING_ASSERT( !fileExists( name ) );
+
+    // read from the image, which the reader keeps alive
+    ABC::ArchiveReaderPtr fromImage;
+    {
+        A5::ArchiveImagePtr held = image;
+        A5::ReadMemoryArchive r( held );
+        fromImage = r( name );
+    }
+    checkContents( fromImage );
+
+    // read from a caller owned span, eg shared memory, with our own cache
+    std::vector<Alembic::Util::uint8_t> span( *image );
+    {
+        A5::ReadMemoryArchive r( &span.front(), span.size() );
+        ABC::ArchiveReaderPtr a = r( name, A5::CreateCache() );
+        checkContents( a );
+
+        // several readers over the same bytes at once are fine
+        ABC::ArchiveReaderPtr b = r( name );
+        checkContents( b );
+    }
+
+    // the same bytes written to disk are a normal archive
+    std::string diskName = "memoryArchiveOnDisk.abc";
+    {
+        FILE *f = fopen( diskName.c_str(), "wb" );
+        TESTING_ASSERT( f != NULL );
+        fwrite( &span.front(), 1, span.size(), f );
+        fclose( f );
+
+        A5::ReadArchive r;
+        checkContents( r( diskName ) );
+    }
+
+    // and a file on disk can be handed around as an image
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( diskName, md );
+        writeContents( a );
+    }
+    {
+        FILE *f = fopen( diskName.c_str(), "rb" );
+        TESTING_ASSERT( f != NULL );
+        fseek( f, 0, SEEK_END );
+        A5::ArchiveImagePtr loaded( new A5::ArchiveImage( ftell( f ) ) );
+        fseek( f, 0, SEEK_SET );
+        TESTING_ASSERT( fread( &loaded->front(), 1, loaded->size(), f ) ==
+                        loaded->size() );
+        fclose( f );
+
+        A5::ReadMemoryArchive r( loaded );
+        checkContents( r( diskName ) );
+    }
+}
+
+//-*****************************************************************************
+void testBadImages()
+{
+    A5::ArchiveImagePtr empty( new A5::ArchiveImage );
+    A5::ReadMemoryArchive r( empty );
+    TESTING_ASSERT_THROW( r( "empty" ), Alembic::Util::Exception );
+
+    TESTING_ASSERT_THROW( A5::WriteMemoryArchive( A5::ArchiveImagePtr() )(
+        "noImage", ABC::MetaData() ), Alembic::Util::Exception );
+
+    // turn off HDF5's own reporting, we expect it to complain
+    H5E_auto_t func;
+    void * client_data;
+    H5Eget_auto2( H5E_DEFAULT, &func, &client_data );
+    H5Eset_auto2( H5E_DEFAULT, NULL, NULL );
+
+    std::vector<char> garbage( 4096, 'x' );
+    A5::ReadMemoryArchive g( &garbage.front(), garbage.size() );
+    TESTING_ASSERT_THROW( g( "garbage" ), Alembic::Util::Exception );
+
+    H5Eset_auto2( H5E_DEFAULT, func, client_data );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testMemoryRoundTrip();
+    testBadImages();
+    return 0;
+}
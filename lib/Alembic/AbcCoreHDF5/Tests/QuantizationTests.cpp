@@ -0,0 +1,338 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <limits>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::float64_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numSamples = 10;
+static const size_t g_numPoints = 5000;
+
+//-*****************************************************************************
+template <class T>
+std::vector<T> samplePoints( size_t iSample, size_t iExtent )
+{
+    std::vector<T> vals( g_numPoints * iExtent );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( T )( sin( i * 0.37 + iSample * 0.1 ) * ( 1.0 + i % 7 ) -
+                         ( i % iExtent ) * 100.0 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+template <class T>
+void writeSamples( ABC::ArrayPropertyWriterPtr iProp,
+                   const ABC::DataType &iType )
+{
+    for ( size_t s = 0; s < g_numSamples; ++s )
+    {
+        // sample 4 is a repeat of 3
+        std::vector<T> vals = samplePoints<T>( s == 4 ? 3 : s,
+                                               iType.getExtent() );
+        iProp->setSample( ABC::ArraySample( &vals.front(), iType,
+                                            Dimensions( g_numPoints ) ) );
+    }
+}
+
+//-*****************************************************************************
+template <class T>
+void checkSamples( ABC::ArrayPropertyReaderPtr iProp, float64_t iTolerance )
+{
+    size_t extent = iProp->getDataType().getExtent();
+    TESTING_ASSERT( iProp->getNumSamples() == g_numSamples );
+
+    for ( size_t s = g_numSamples; s > 0; --s )
+    {
+        ABC::ArraySamplePtr samp;
+        iProp->getSample( s - 1, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+        std::vector<T> expected = samplePoints<T>( s - 1 == 4 ? 3 : s - 1,
+                                                   extent );
+        const T *data = static_cast<const T *>( samp->getData() );
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            TESTING_ASSERT( fabs( ( float64_t )data[i] - expected[i] ) <=
+                            iTolerance );
+        }
+
+        // keys are those of what is read back
+        ABC::ArraySampleKey key;
+        TESTING_ASSERT( iProp->getKey( s - 1, key ) );
+        TESTING_ASSERT( key.digest == samp->getKey().digest );
+    }
+}
+
+//-*****************************************************************************
+size_t fileSize( const std::string &iName )
+{
+    FILE *f = fopen( iName.c_str(), "rb" );
+    TESTING_ASSERT( f != NULL );
+    fseek( f, 0, SEEK_END );
+    long size = ftell( f );
+    fclose( f );
+    return ( size_t )size;
+}
+
+//-*****************************************************************************
+// Writes iExtent component float32 samples alone in an archive, so the
+// size of the file tells us how well they were packed.
+size_t writeAlone( const std::string &iName, size_t iExtent,
+                   const ABC::MetaData &iMetaData )
+{
+    ABC::DataType fd( Alembic::Util::kFloat32POD, iExtent );
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+        writeSamples<float32_t>( a->getTop()->getProperties()->
+            createArrayProperty( "P", iMetaData, fd, 0 ), fd );
+    }
+    return fileSize( iName );
+}
+
+//-*****************************************************************************
+void testQuantization()
+{
+    std::string name = "quantization.abc";
+    float64_t tolerance = 1e-3;
+    ABC::MetaData md;
+    A5::SetQuantization( md, tolerance );
+
+    float64_t readTolerance = -1.0;
+    TESTING_ASSERT( A5::GetQuantization( md, readTolerance ) );
+    TESTING_ASSERT( readTolerance == tolerance );
+    TESTING_ASSERT( !A5::GetQuantization( ABC::MetaData(), readTolerance ) );
+
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+
+        // every unrolled extent, and one that isn't
+        for ( size_t extent = 1; extent <= 5; ++extent )
+        {
+            ABC::DataType fd( Alembic::Util::kFloat32POD, extent );
+            ABC::DataType dd( Alembic::Util::kFloat64POD, extent );
+            char c = '0' + extent;
+            writeSamples<float32_t>( props->createArrayProperty(
+                std::string( "f" ) + c, md, fd, 0 ), fd );
+            writeSamples<float64_t>( props->createArrayProperty(
+                std::string( "d" ) + c, md, dd, 0 ), dd );
+        }
+
+        // quantized keyframes with deltas between them
+        ABC::MetaData deltaMd( md );
+        A5::SetDeltaEncoding( deltaMd, 3, tolerance );
+        ABC::DataType f3d( Alembic::Util::kFloat32POD, 3 );
+        writeSamples<float32_t>( props->createArrayProperty(
+            "delta", deltaMd, f3d, 0 ), f3d );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+    for ( size_t extent = 1; extent <= 5; ++extent )
+    {
+        char c = '0' + extent;
+        checkSamples<float32_t>(
+            props->getArrayProperty( std::string( "f" ) + c ), tolerance );
+        checkSamples<float64_t>(
+            props->getArrayProperty( std::string( "d" ) + c ), tolerance );
+    }
+
+    // the deltas are taken against the quantized keyframes, so the error
+    // of each is within the one tolerance
+    checkSamples<float32_t>( props->getArrayProperty( "delta" ), tolerance );
+}
+
+//-*****************************************************************************
+void testFallback()
+{
+    std::string name = "quantizationFallback.abc";
+    ABC::DataType fd( Alembic::Util::kFloat32POD, 1 );
+
+    std::vector< std::vector<float32_t> > written;
+    std::vector<float32_t> vals( 10, 1.0f );
+    written.push_back( vals );
+
+    // not finite
+    vals[2] = std::numeric_limits<float32_t>::quiet_NaN();
+    written.push_back( vals );
+
+    vals[2] = std::numeric_limits<float32_t>::infinity();
+    written.push_back( vals );
+
+    // too wide a range for 32 bits
+    vals[2] = 1e30f;
+    written.push_back( vals );
+
+    vals[2] = 3.0f;
+    written.push_back( vals );
+
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+
+        ABC::MetaData md;
+        A5::SetQuantization( md, 1e-4 );
+        ABC::ArrayPropertyWriterPtr p =
+            a->getTop()->getProperties()->createArrayProperty( "vals", md,
+                                                               fd, 0 );
+        for ( size_t s = 0; s < written.size(); ++s )
+        {
+            p->setSample( ABC::ArraySample( &written[s].front(), fd,
+                                            Dimensions( 10 ) ) );
+        }
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::ArrayPropertyReaderPtr p =
+        a->getTop()->getProperties()->getArrayProperty( "vals" );
+
+    for ( size_t s = 0; s < written.size(); ++s )
+    {
+        ABC::ArraySamplePtr samp;
+        p->getSample( s, samp );
+        const float32_t *data = ( const float32_t * ) samp->getData();
+        for ( size_t i = 0; i < 10; ++i )
+        {
+            if ( written[s][i] != written[s][i] )
+            {
+                TESTING_ASSERT( data[i] != data[i] );
+            }
+            else if ( s == 2 || s == 3 )
+            {
+                // written losslessly
+                TESTING_ASSERT( data[i] == written[s][i] );
+            }
+            else
+            {
+                TESTING_ASSERT( fabs( data[i] - written[s][i] ) <= 1e-4 );
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void testPacking()
+{
+    ABC::MetaData md;
+    A5::SetQuantization( md, 1e-2 );
+
+    size_t plain = writeAlone( "quantizationPlain.abc", 3, ABC::MetaData() );
+    size_t quantized = writeAlone( "quantizationPacked.abc", 3, md );
+
+    // about 10 bits a value instead of 32
+    TESTING_ASSERT( quantized * 2 < plain );
+}
+
+//-*****************************************************************************
+// The same samples quantized to the same tolerance are written once, in
+// another property or another object, but not to another tolerance.
+void testSharing()
+{
+    std::string name = "quantizationShared.abc";
+    ABC::DataType fd( Alembic::Util::kFloat32POD, 3 );
+    ABC::MetaData coarse;
+    A5::SetQuantization( coarse, 1e-2 );
+    ABC::MetaData fine;
+    A5::SetQuantization( fine, 1e-4 );
+
+    size_t alone = writeAlone( "quantizationAlone.abc", 3, coarse );
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+        ABC::ObjectWriterPtr child = a->getTop()->createChild(
+            ABC::ObjectHeader( "child", ABC::MetaData() ) );
+
+        writeSamples<float32_t>( a->getTop()->getProperties()->
+            createArrayProperty( "P", coarse, fd, 0 ), fd );
+        writeSamples<float32_t>( a->getTop()->getProperties()->
+            createArrayProperty( "P2", coarse, fd, 0 ), fd );
+        writeSamples<float32_t>( child->getProperties()->
+            createArrayProperty( "P", coarse, fd, 0 ), fd );
+    }
+
+    // Only the links and headers of the copies are added.
+    TESTING_ASSERT( fileSize( name ) < alone + alone / 4 );
+
+    {
+        A5::WriteArchive w;
+        ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+        ABC::CompoundPropertyWriterPtr props = a->getTop()->getProperties();
+        writeSamples<float32_t>( props->createArrayProperty(
+            "coarse", coarse, fd, 0 ), fd );
+        writeSamples<float32_t>( props->createArrayProperty(
+            "fine", fine, fd, 0 ), fd );
+    }
+
+    A5::ReadArchive r;
+    ABC::ArchiveReaderPtr a = r( name );
+    ABC::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+    checkSamples<float32_t>( props->getArrayProperty( "coarse" ), 1e-2 );
+    checkSamples<float32_t>( props->getArrayProperty( "fine" ), 1e-4 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testQuantization();
+    testFallback();
+    testPacking();
+    testSharing();
+    return 0;
+}
@@ -0,0 +1,303 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <vector>
+#include <sstream>
+
+#include <math.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::uint64_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numObjects = 6;
+static const size_t g_numFrames = 12;
+static const size_t g_numPoints = 50;
+
+//-*****************************************************************************
+std::string objectName( size_t iObject )
+{
+    std::ostringstream strm;
+    strm << "geo" << iObject;
+    return strm.str();
+}
+
+//-*****************************************************************************
+std::vector<float32_t> frameValues( size_t iObject, size_t iFrame )
+{
+    std::vector<float32_t> vals( g_numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t ) sin( i * 0.37 + iFrame * 0.1 +
+                                     iObject * 10.0 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+// Writes the archive the usual way, one object after another, each with
+// all of its frames.
+void writeObjectMajor( const std::string &iName,
+                       const A5::FileAccessProfile &iProfile )
+{
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+    ABC::DataType s1( Alembic::Util::kStringPOD, 1 );
+
+    A5::WriteArchive w( iProfile );
+    ABC::ArchiveWriterPtr a = w( iName, ABC::MetaData() );
+    uint32_t tsIndex = a->addTimeSampling(
+        ABC::TimeSampling( 1.0 / 24.0, 1.0 ) );
+
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+            ABC::ObjectHeader( objectName( o ), ABC::MetaData() ) );
+        ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+
+        ABC::ArrayPropertyWriterPtr P =
+            props->createArrayProperty( "P", ABC::MetaData(), f3, tsIndex );
+        ABC::CompoundPropertyWriterPtr arb =
+            props->createCompoundProperty( "arb", ABC::MetaData() );
+        ABC::ScalarPropertyWriterPtr frame =
+            arb->createScalarProperty( "frame", ABC::MetaData(), i1,
+                                       tsIndex );
+        ABC::ScalarPropertyWriterPtr name =
+            props->createScalarProperty( "name", ABC::MetaData(), s1, 0 );
+
+        for ( size_t f = 0; f < g_numFrames; ++f )
+        {
+            std::vector<float32_t> vals = frameValues( o, f );
+            P->setSample( ABC::ArraySample( &vals.front(), f3,
+                                            Dimensions( g_numPoints ) ) );
+
+            int32_t frameValue = ( int32_t ) f;
+            frame->setSample( &frameValue );
+        }
+
+        std::string nameValue = objectName( o );
+        name->setSample( &nameValue );
+    }
+}
+
+//-*****************************************************************************
+void checkArchive( const std::string &iName )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName );
+    TESTING_ASSERT( a->getNumTimeSamplings() == 2 );
+    TESTING_ASSERT( a->getTimeSampling( 1 )->getSampleTime( 0 ) == 1.0 );
+
+    ABC::ObjectReaderPtr top = a->getTop();
+    TESTING_ASSERT( top->getNumChildren() == g_numObjects );
+
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        ABC::ObjectReaderPtr geo = top->getChild( objectName( o ) );
+        TESTING_ASSERT( geo );
+
+        ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+        TESTING_ASSERT( props->getNumProperties() == 3 );
+
+        ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+        ABC::ScalarPropertyReaderPtr frame =
+            props->getCompoundProperty( "arb" )->getScalarProperty( "frame" );
+        TESTING_ASSERT( P->getNumSamples() == g_numFrames );
+        TESTING_ASSERT( frame->getNumSamples() == g_numFrames );
+        TESTING_ASSERT( P->getTimeSampling() == a->getTimeSampling( 1 ) );
+
+        for ( size_t f = 0; f < g_numFrames; ++f )
+        {
+            ABC::ArraySamplePtr samp;
+            P->getSample( f, samp );
+            TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+            std::vector<float32_t> expected = frameValues( o, f );
+            const float32_t *data =
+                static_cast<const float32_t *>( samp->getData() );
+            for ( size_t i = 0; i < expected.size(); ++i )
+            {
+                TESTING_ASSERT( data[i] == expected[i] );
+            }
+
+            int32_t frameValue = -1;
+            frame->getSample( f, &frameValue );
+            TESTING_ASSERT( frameValue == ( int32_t ) f );
+        }
+
+        ABC::ScalarPropertyReaderPtr name = props->getScalarProperty( "name" );
+        std::string nameValue;
+        name->getSample( 0, &nameValue );
+        TESTING_ASSERT( nameValue == objectName( o ) );
+    }
+}
+
+//-*****************************************************************************
+// Each frame's P samples, one per object.
+void checkIndex( const A5::FrameIndex &iIndex )
+{
+    TESTING_ASSERT( !iIndex.empty() );
+
+    size_t numTimes = 1;
+    uint64_t totalSize = iIndex[0].size;
+    for ( size_t i = 1; i < iIndex.size(); ++i )
+    {
+        const A5::FrameExtent &prev = iIndex[i - 1];
+        const A5::FrameExtent &cur = iIndex[i];
+
+        TESTING_ASSERT( prev.time < cur.time ||
+                        ( prev.time == cur.time &&
+                          prev.offset + prev.size <= cur.offset ) );
+
+        numTimes += prev.time < cur.time ? 1 : 0;
+        totalSize += cur.size;
+    }
+
+    TESTING_ASSERT( numTimes == g_numFrames );
+    TESTING_ASSERT( totalSize >=
+                    g_numFrames * g_numObjects * g_numPoints * 12 );
+}
+
+//-*****************************************************************************
+void testRepack()
+{
+    std::string objectMajor = "objectMajor.abc";
+    std::string timeMajor = "timeMajor.abc";
+
+    writeObjectMajor( objectMajor, A5::FileAccessProfile() );
+    checkArchive( objectMajor );
+
+    A5::FrameIndex index;
+    TESTING_ASSERT( !A5::ReadFrameIndex( objectMajor, index ) );
+
+    A5::RepackArchive( objectMajor, timeMajor );
+    checkArchive( timeMajor );
+
+    TESTING_ASSERT( A5::ReadFrameIndex( timeMajor, index ) );
+    checkIndex( index );
+
+    // Written a frame at a time, every frame comes after the one before.
+    for ( size_t i = 1; i < index.size(); ++i )
+    {
+        if ( index[i - 1].time < index[i].time )
+        {
+            TESTING_ASSERT( index[i - 1].offset + index[i - 1].size <=
+                            index[i].offset );
+        }
+    }
+
+    A5::FramePrefetcher prefetcher( timeMajor );
+    TESTING_ASSERT( prefetcher.hasIndex() );
+
+    // Frame 3, and nearer to frame 3 than to frame 4.
+    uint64_t frameSize = 0;
+    for ( size_t i = 0; i < index.size(); ++i )
+    {
+        if ( fabs( index[i].time - ( 1.0 + 3.0 / 24.0 ) ) < 1e-9 )
+        {
+            frameSize += index[i].size;
+        }
+    }
+
+    TESTING_ASSERT( frameSize > 0 );
+    TESTING_ASSERT( prefetcher.prefetch( 1.0 + 3.0 / 24.0 ) == frameSize );
+    TESTING_ASSERT( prefetcher.prefetch( 1.0 + 3.4 / 24.0 ) == frameSize );
+
+    // Way past the end is the last frame.
+    TESTING_ASSERT( prefetcher.prefetch( 1000.0 ) > 0 );
+
+    A5::FramePrefetcher noIndex( objectMajor );
+    TESTING_ASSERT( !noIndex.hasIndex() );
+    TESTING_ASSERT( noIndex.prefetch( 1.0 ) == 0 );
+}
+
+//-*****************************************************************************
+// The writer option on its own indexes the archive as it is written, in
+// whatever order that is.
+void testWriterIndex()
+{
+    std::string name = "objectMajorIndexed.abc";
+
+    A5::FileAccessProfile profile;
+    profile.recordFrameIndex = true;
+    writeObjectMajor( name, profile );
+    checkArchive( name );
+
+    A5::FrameIndex index;
+    TESTING_ASSERT( A5::ReadFrameIndex( name, index ) );
+    checkIndex( index );
+
+    // Appending keeps the index going, even without asking for it.
+    {
+        ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+
+        ABC::ArchiveWriterPtr a = A5::AppendArchive()( name );
+        ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+            ABC::ObjectHeader( objectName( 0 ), ABC::MetaData() ) );
+        ABC::ArrayPropertyWriterPtr P = geo->getProperties()->
+            createArrayProperty( "P", ABC::MetaData(), f3, 1 );
+
+        std::vector<float32_t> vals = frameValues( 0, g_numFrames );
+        P->setSample( ABC::ArraySample( &vals.front(), f3,
+                                        Dimensions( g_numPoints ) ) );
+    }
+
+    A5::FrameIndex appended;
+    TESTING_ASSERT( A5::ReadFrameIndex( name, appended ) );
+    TESTING_ASSERT( appended.size() == index.size() + 1 );
+    TESTING_ASSERT( fabs( appended.back().time -
+                          ( 1.0 + g_numFrames / 24.0 ) ) < 1e-9 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testRepack();
+    testWriterIndex();
+    return 0;
+}
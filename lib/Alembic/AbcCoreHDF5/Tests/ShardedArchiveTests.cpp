@@ -0,0 +1,239 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/AbcCoreHDF5/ShardedArImpl.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <vector>
+#include <sstream>
+
+#include <math.h>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numPoints = 100;
+static const size_t g_framesPerShard = 10;
+
+//-*****************************************************************************
+std::vector<float32_t> frameValues( size_t iFrame )
+{
+    std::vector<float32_t> vals( g_numPoints * 3 );
+    for ( size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = ( float32_t ) sin( i * 0.37 + iFrame * 0.1 );
+    }
+    return vals;
+}
+
+//-*****************************************************************************
+// Writes frames iFirstFrame on of a shot into their own archive, with P and
+// frame sampled on every frame, and id written once.
+std::string writeShard( size_t iFirstFrame )
+{
+    std::ostringstream strm;
+    strm << "shard." << iFirstFrame << ".abc";
+    std::string name = strm.str();
+
+    ABC::DataType f3( Alembic::Util::kFloat32POD, 3 );
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+
+    A5::WriteArchive w;
+    ABC::ArchiveWriterPtr a = w( name, ABC::MetaData() );
+    uint32_t tsIndex = a->addTimeSampling(
+        ABC::TimeSampling( 1.0 / 24.0, iFirstFrame / 24.0 ) );
+
+    ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+        ABC::ObjectHeader( "geo", ABC::MetaData() ) );
+    ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+
+    ABC::ArrayPropertyWriterPtr P =
+        props->createArrayProperty( "P", ABC::MetaData(), f3, tsIndex );
+    ABC::CompoundPropertyWriterPtr arb =
+        props->createCompoundProperty( "arb", ABC::MetaData() );
+    ABC::ScalarPropertyWriterPtr frame =
+        arb->createScalarProperty( "frame", ABC::MetaData(), i1, tsIndex );
+    ABC::ScalarPropertyWriterPtr id =
+        props->createScalarProperty( "id", ABC::MetaData(), i1, tsIndex );
+
+    for ( size_t f = iFirstFrame; f < iFirstFrame + g_framesPerShard; ++f )
+    {
+        std::vector<float32_t> vals = frameValues( f );
+        P->setSample( ABC::ArraySample( &vals.front(), f3,
+                                        Dimensions( g_numPoints ) ) );
+
+        int32_t frameValue = ( int32_t ) f;
+        frame->setSample( &frameValue );
+    }
+
+    int32_t idValue = 7;
+    id->setSample( &idValue );
+
+    return name;
+}
+
+//-*****************************************************************************
+void checkFrame( ABC::ArrayPropertyReaderPtr iP,
+                 ABC::ScalarPropertyReaderPtr iFrame,
+                 size_t iFrameIndex )
+{
+    ABC::ArraySamplePtr samp;
+    iP->getSample( iFrameIndex, samp );
+    TESTING_ASSERT( samp->getDimensions().numPoints() == g_numPoints );
+
+    std::vector<float32_t> expected = frameValues( iFrameIndex );
+    const float32_t *data = static_cast<const float32_t *>( samp->getData() );
+    for ( size_t i = 0; i < expected.size(); ++i )
+    {
+        TESTING_ASSERT( data[i] == expected[i] );
+    }
+
+    int32_t frame = -1;
+    iFrame->getSample( iFrameIndex, &frame );
+    TESTING_ASSERT( frame == ( int32_t ) iFrameIndex );
+}
+
+//-*****************************************************************************
+void testShards()
+{
+    // Out of order, the archive sorts them.
+    std::vector<std::string> names;
+    names.push_back( writeShard( 20 ) );
+    names.push_back( writeShard( 0 ) );
+    names.push_back( writeShard( 10 ) );
+
+    ABC::ArchiveReaderPtr a = A5::ReadShardedArchive( names, 1 )( "shot" );
+    TESTING_ASSERT( a->getName() == "shot" );
+    TESTING_ASSERT( a->getNumTimeSamplings() == 2 );
+    TESTING_ASSERT( a->getTimeSampling( 1 )->getSampleTime( 0 ) == 0.0 );
+
+    A5::ShardedArImpl *sharded = dynamic_cast<A5::ShardedArImpl *>( a.get() );
+    TESTING_ASSERT( sharded && sharded->getNumShards() == 3 );
+
+    TESTING_ASSERT( a->getTop()->getNumChildren() == 1 );
+    ABC::ObjectReaderPtr geo = a->getTop()->getChild( "geo" );
+    TESTING_ASSERT( geo->getFullName() == "/geo" );
+    TESTING_ASSERT( geo->getArchive() == a );
+
+    ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+    TESTING_ASSERT( props->getNumProperties() == 3 );
+
+    ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+    ABC::ScalarPropertyReaderPtr frame =
+        props->getCompoundProperty( "arb" )->getScalarProperty( "frame" );
+    TESTING_ASSERT( P->getTimeSampling() == a->getTimeSampling( 1 ) );
+
+    size_t numFrames = 3 * g_framesPerShard;
+    TESTING_ASSERT( P->getNumSamples() == numFrames );
+    TESTING_ASSERT( frame->getNumSamples() == numFrames );
+    TESTING_ASSERT( !P->isConstant() );
+    TESTING_ASSERT( !frame->isConstant() );
+
+    // Back and forth across the shards, with only one of them open at a
+    // time.
+    for ( size_t f = 0; f < numFrames; ++f )
+    {
+        checkFrame( P, frame, f );
+        checkFrame( P, frame, numFrames - 1 - f );
+        TESTING_ASSERT( sharded->getNumOpenShards() == 1 );
+    }
+
+    std::vector<ABC::ArraySamplePtr> samps;
+    P->getSamples( 8, 12, samps );
+    TESTING_ASSERT( samps.size() == 5 );
+
+    TESTING_ASSERT( P->getFloorIndex( 15.5 / 24.0 ).first == 15 );
+    TESTING_ASSERT( P->getNearIndex( 100.0 ).first == ( ABC::index_t )
+                    numFrames - 1 );
+
+    // id was only written once per shard, so it holds until the last
+    // shard starts.
+    ABC::ScalarPropertyReaderPtr id = props->getScalarProperty( "id" );
+    TESTING_ASSERT( id->getNumSamples() == 2 * g_framesPerShard + 1 );
+    TESTING_ASSERT( id->isConstant() );
+    int32_t idValue = -1;
+    id->getSample( 15, &idValue );
+    TESTING_ASSERT( idValue == 7 );
+
+    TESTING_ASSERT_THROW( P->getSample( numFrames, samps[0] ),
+                          Alembic::Util::Exception );
+}
+
+//-*****************************************************************************
+void testGapsAndOverlaps()
+{
+    // Frames 10 to 19 are missing.
+    std::vector<std::string> names;
+    names.push_back( writeShard( 0 ) );
+    names.push_back( writeShard( 20 ) );
+
+    ABC::ArchiveReaderPtr a = A5::ReadShardedArchive( names )( "gap" );
+    ABC::ObjectReaderPtr geo = a->getTop()->getChild( "geo" );
+    ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+    ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+    TESTING_ASSERT( P->getNumSamples() == 3 * g_framesPerShard );
+
+    ABC::ArraySamplePtr samp;
+    P->getSample( 5, samp );
+    P->getSample( 25, samp );
+    TESTING_ASSERT_THROW( P->getSample( 15, samp ),
+                          Alembic::Util::Exception );
+
+    // Two shards starting on the same frame.
+    names.push_back( names[0] );
+    A5::ReadShardedArchive overlapping( names );
+    TESTING_ASSERT_THROW( overlapping( "overlap" ),
+                          Alembic::Util::Exception );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testShards();
+    testGapsAndOverlaps();
+    return 0;
+}
@@ -0,0 +1,319 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreHDF5/Tests/Assert.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+#include <sstream>
+
+//-*****************************************************************************
+namespace A5 = Alembic::AbcCoreHDF5;
+
+namespace ABC = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::float32_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::uint64_t;
+using Alembic::Util::Dimensions;
+
+//-*****************************************************************************
+static const size_t g_numObjects = 4;
+static const size_t g_numFrames = 10;
+
+//-*****************************************************************************
+// Each object is bigger than the one before it, so the hottest is the last.
+size_t numPoints( size_t iObject )
+{
+    return 500 * ( iObject + 1 );
+}
+
+//-*****************************************************************************
+std::string objectName( size_t iObject )
+{
+    std::ostringstream strm;
+    strm << "geo" << iObject;
+    return strm.str();
+}
+
+//-*****************************************************************************
+uint64_t dataBytes()
+{
+    uint64_t ret = 0;
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        ret += numPoints( o ) * sizeof( float32_t ) * g_numFrames;
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    ABC::ArchiveWriterPtr a = A5::WriteArchive()( iName, ABC::MetaData() );
+    a->setCompressionHint( -1 );
+
+    ABC::DataType f1( Alembic::Util::kFloat32POD, 1 );
+    ABC::DataType i1( Alembic::Util::kInt32POD, 1 );
+
+    std::vector<ABC::ObjectWriterPtr> geos;
+    std::vector<ABC::ArrayPropertyWriterPtr> P;
+    std::vector<ABC::ScalarPropertyWriterPtr> frame;
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        ABC::ObjectWriterPtr geo = a->getTop()->createChild(
+            ABC::ObjectHeader( objectName( o ), ABC::MetaData() ) );
+        geos.push_back( geo );
+
+        ABC::CompoundPropertyWriterPtr props = geo->getProperties();
+        P.push_back( props->createArrayProperty( "P", ABC::MetaData(),
+                                                 f1, 0 ) );
+        frame.push_back( props->createScalarProperty( "frame",
+                                                      ABC::MetaData(),
+                                                      i1, 0 ) );
+    }
+
+    for ( size_t f = 0; f < g_numFrames; ++f )
+    {
+        for ( size_t o = 0; o < g_numObjects; ++o )
+        {
+            std::vector<float32_t> vals( numPoints( o ) );
+            for ( size_t i = 0; i < vals.size(); ++i )
+            {
+                vals[i] = ( float32_t ) ( i + f * 1000 + o * 0.5 );
+            }
+            P[o]->setSample( ABC::ArraySample( &vals.front(), f1,
+                                               Dimensions( vals.size() ) ) );
+
+            int32_t frameValue = ( int32_t ) f;
+            frame[o]->setSample( &frameValue );
+        }
+    }
+
+    ABC::ArchiveStats stats = a->getStats();
+    TESTING_ASSERT( stats.arraySamplesWritten ==
+                    g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.scalarSamplesWritten ==
+                    g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.bytesWritten >= dataBytes() );
+    TESTING_ASSERT( stats.bytesRead == 0 );
+    TESTING_ASSERT( stats.storageCalls > 0 );
+
+    // Only the objects with samples, hottest first, named the way a
+    // reader would name them.
+    ABC::ObjectStatsVec objects;
+    a->getObjectStats( objects );
+    TESTING_ASSERT( objects.size() == g_numObjects );
+    for ( size_t i = 0; i < objects.size(); ++i )
+    {
+        size_t o = g_numObjects - 1 - i;
+        TESTING_ASSERT( objects[i].fullName == "/" + objectName( o ) );
+        TESTING_ASSERT( objects[i].stats.arraySamplesWritten == g_numFrames );
+        TESTING_ASSERT( objects[i].stats.scalarSamplesWritten ==
+                        g_numFrames );
+    }
+
+    a->resetStats();
+    stats = a->getStats();
+    TESTING_ASSERT( stats.totalBytes() == 0 );
+    TESTING_ASSERT( stats.arraySamplesWritten == 0 );
+    a->getObjectStats( objects );
+    TESTING_ASSERT( objects.empty() );
+}
+
+//-*****************************************************************************
+void readAll( ABC::ArchiveReaderPtr iArchive )
+{
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        // The object has to outlive its properties.
+        ABC::ObjectReaderPtr geo =
+            iArchive->getTop()->getChild( objectName( o ) );
+        ABC::CompoundPropertyReaderPtr props = geo->getProperties();
+        ABC::ArrayPropertyReaderPtr P = props->getArrayProperty( "P" );
+        ABC::ScalarPropertyReaderPtr frame =
+            props->getScalarProperty( "frame" );
+
+        for ( size_t f = 0; f < g_numFrames; ++f )
+        {
+            ABC::ArraySamplePtr samp;
+            P->getSample( f, samp );
+            TESTING_ASSERT( samp->size() == numPoints( o ) );
+
+            int32_t frameValue = -1;
+            frame->getSample( f, &frameValue );
+            TESTING_ASSERT( frameValue == ( int32_t ) f );
+        }
+    }
+}
+
+//-*****************************************************************************
+void testCachedRead( const std::string &iName )
+{
+    ABC::ArchiveReaderPtr a = A5::ReadArchive()( iName );
+    a->resetStats();
+
+    // Everything is read from the file the first time.
+    readAll( a );
+    ABC::ArchiveStats stats = a->getStats();
+    TESTING_ASSERT( stats.arraySamplesRead == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.scalarSamplesRead == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.cacheMisses == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.cacheHits == 0 );
+    TESTING_ASSERT( stats.bytesRead >= dataBytes() );
+    TESTING_ASSERT( stats.bytesWritten == 0 );
+    TESTING_ASSERT( stats.storageSeconds >= 0.0 );
+
+    // And the array samples are found in the cache the second.
+    uint64_t bytesRead = stats.bytesRead;
+    readAll( a );
+    stats = a->getStats();
+    TESTING_ASSERT( stats.arraySamplesRead ==
+                    2 * g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.cacheHits == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.cacheMisses == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.bytesRead - bytesRead <
+                    numPoints( 0 ) * sizeof( float32_t ) );
+
+    ABC::ObjectStatsVec objects;
+    a->getObjectStats( objects );
+    TESTING_ASSERT( objects.size() == g_numObjects );
+    TESTING_ASSERT( objects[0].fullName == "/" + objectName( 3 ) );
+    TESTING_ASSERT( objects.back().fullName == "/" + objectName( 0 ) );
+
+    std::ostringstream strm;
+    ABC::PrintHotObjects( strm, objects, 2 );
+    TESTING_ASSERT( strm.str().find( objectName( 3 ) ) != std::string::npos );
+    TESTING_ASSERT( strm.str().find( objectName( 0 ) ) == std::string::npos );
+}
+
+//-*****************************************************************************
+// Reads the frames of one object.
+class ObjectReaderThread
+{
+public:
+    ObjectReaderThread( ABC::ArrayPropertyReaderPtr iP, std::string &oError )
+      : m_P( iP )
+      , m_error( oError )
+    {}
+
+    void operator()()
+    {
+        try
+        {
+            for ( size_t f = 0; f < g_numFrames; ++f )
+            {
+                ABC::ArraySamplePtr samp;
+                m_P->getSample( f, samp );
+            }
+        }
+        catch ( std::exception &exc )
+        {
+            m_error = exc.what();
+        }
+    }
+
+private:
+    ABC::ArrayPropertyReaderPtr m_P;
+    std::string &m_error;
+};
+
+//-*****************************************************************************
+void testConcurrentRead( const std::string &iName )
+{
+    // Without a cache, so every thread reads the file.
+    ABC::ArchiveReaderPtr a =
+        A5::ReadArchive()( iName, ABC::ReadArraySampleCachePtr() );
+
+    std::vector<ABC::ObjectReaderPtr> geos;
+    std::vector<ABC::ArrayPropertyReaderPtr> P;
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        geos.push_back( a->getTop()->getChild( objectName( o ) ) );
+        P.push_back( geos.back()->getProperties()->getArrayProperty( "P" ) );
+    }
+
+    std::vector<std::string> errors( g_numObjects );
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        ObjectReaderThread( P[o], errors[o] )();
+    }
+    ABC::ArchiveStats serial = a->getStats();
+    a->resetStats();
+
+    boost::thread_group threads;
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        threads.create_thread( ObjectReaderThread( P[o], errors[o] ) );
+    }
+    threads.join_all();
+
+    for ( size_t o = 0; o < g_numObjects; ++o )
+    {
+        TESTING_ASSERT( errors[o].empty() );
+    }
+
+    // What each thread counted adds up to what one thread did.
+    ABC::ArchiveStats stats = a->getStats();
+    TESTING_ASSERT( stats.arraySamplesRead == g_numObjects * g_numFrames );
+    TESTING_ASSERT( stats.arraySamplesRead == serial.arraySamplesRead );
+    TESTING_ASSERT( stats.bytesRead == serial.bytesRead );
+    TESTING_ASSERT( stats.storageCalls == serial.storageCalls );
+    TESTING_ASSERT( stats.cacheHits == 0 && stats.cacheMisses == 0 );
+
+    ABC::ObjectStatsVec objects;
+    a->getObjectStats( objects );
+    TESTING_ASSERT( objects.size() == g_numObjects );
+    for ( size_t i = 0; i < objects.size(); ++i )
+    {
+        TESTING_ASSERT( objects[i].stats.arraySamplesRead == g_numFrames );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    writeArchive( "stats.abc" );
+    testCachedRead( "stats.abc" );
+    testConcurrentRead( "stats.abc" );
+
+    return 0;
+}
@@ -47,12 +47,15 @@ namespace ALEMBIC_VERSION_NS {
 TopCpwImpl::TopCpwImpl( BaseOwImpl &iObject,
                         hid_t iParentGroup,
                         const AbcA::MetaData &iMetaData )
-  : BaseCpwImpl( iParentGroup )
+  : BaseCpwImpl( iObject.getWriteMutex(), iParentGroup )
   , m_objectRef( iObject )
   , m_header( ".prop", iMetaData )
 {
-    // Write just the meta data.
-    WriteMetaData( iParentGroup, ".prop.meta", iMetaData );
+    // Write just the meta data. A reopened object keeps what it has.
+    if ( H5Aexists( iParentGroup, ".prop.meta" ) <= 0 )
+    {
+        WriteMetaData( iParentGroup, ".prop.meta", iMetaData );
+    }
 }
 
 //-*****************************************************************************
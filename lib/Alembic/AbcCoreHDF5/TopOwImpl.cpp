@@ -46,7 +46,7 @@ namespace ALEMBIC_VERSION_NS {
 TopOwImpl::TopOwImpl( AwImpl &iArchive,
                       hid_t iParentGroup,
                       const AbcA::MetaData &iMetaData )
-  : BaseOwImpl( iParentGroup, "ABC", iMetaData )
+  : BaseOwImpl( iArchive.getWriteMutex(), iParentGroup, "ABC", iMetaData )
   , m_archiveRef( iArchive )
   , m_header( "ABC", "/", iMetaData )
 {
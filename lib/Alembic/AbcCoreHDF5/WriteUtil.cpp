@@ -40,6 +40,8 @@
 #include <Alembic/AbcCoreHDF5/AwImpl.h>
 #include <Alembic/AbcCoreHDF5/HDF5Util.h>
 
+#include <zlib.h>
+
 namespace Alembic {
 namespace AbcCoreHDF5 {
 namespace ALEMBIC_VERSION_NS {
@@ -57,6 +59,24 @@ GetWrittenArraySampleMap( AbcA::ArchiveWriterPtr iVal )
     return ptr->getWrittenArraySampleMap();
 }
 
+//-*****************************************************************************
+boost::recursive_mutex &
+GetWriteMutex( AbcA::ArchiveWriterPtr iVal )
+{
+    AwImpl *ptr = dynamic_cast<AwImpl*>( iVal.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+    return ptr->getWriteMutex();
+}
+
+//-*****************************************************************************
+StatsCollector &
+GetStatsCollector( AbcA::ArchiveWriterPtr iVal )
+{
+    AwImpl *ptr = dynamic_cast<AwImpl*>( iVal.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+    return ptr->getStatsCollector();
+}
+
 //-*****************************************************************************
 void
 WriteDataToAttr( hid_t iParent,
@@ -71,7 +91,7 @@ WriteDataToAttr( hid_t iParent,
                                H5P_DEFAULT, H5P_DEFAULT );
     AttrCloser attrCloser( attrId );
 
-    herr_t status = H5Awrite( attrId, iNativeType, iData );
+    herr_t status = StatsH5Awrite( attrId, iNativeType, iData );
 
     ABCA_ASSERT( status >= 0, "Couldn't write attribute: " << iAttrName );
 }
@@ -226,6 +246,113 @@ WriteTimeSamplingType( hid_t iGroup,
     }
 }
 
+//-*****************************************************************************
+// Writing chunks that were compressed elsewhere came in with 1.8.11, and
+// moved from the high level library into the core one in 1.10.3.
+#if H5_VERSION_GE( 1, 8, 11 )
+#define ALEMBIC_HDF5_WRITE_CHUNK 1
+#endif
+
+//-*****************************************************************************
+static bool IsLittleEndianHost()
+{
+    uint16_t one = 1;
+    return *( reinterpret_cast<uint8_t*>( &one ) ) == 1;
+}
+
+//-*****************************************************************************
+CompressedArrayPtr
+CompressArray( const AbcA::ArraySample &iSamp,
+               const AbcA::ArraySample::Key &iKey,
+               int iCompressionLevel )
+{
+#ifdef ALEMBIC_HDF5_WRITE_CHUNK
+    // Files are little endian, so the bytes in memory are the ones that
+    // HDF5 would have compressed only when we are too.
+    PlainOldDataType pod = iSamp.getDataType().getPod();
+    if ( iCompressionLevel < 0 || pod == kStringPOD || pod == kWstringPOD ||
+         iSamp.getDimensions().numPoints() == 0 || !IsLittleEndianHost() )
+    {
+        return CompressedArrayPtr();
+    }
+
+    // A chunk can't be 4GB or more.
+    uint64_t numBytes = iSamp.getDimensions().numPoints() *
+        iSamp.getDataType().getNumBytes();
+    if ( numBytes >= 0xffffffffULL )
+    {
+        return CompressedArrayPtr();
+    }
+
+    CompressedArrayPtr ret( new CompressedArray );
+    ret->key = iKey;
+    ret->level = iCompressionLevel > 9 ? 9 : iCompressionLevel;
+    ret->bytes.resize( compressBound( ( uLong ) numBytes ) );
+
+    uLongf compressedBytes = ret->bytes.size();
+    int status = compress2( reinterpret_cast<Bytef*>( &ret->bytes.front() ),
+                            &compressedBytes,
+                            reinterpret_cast<const Bytef*>( iSamp.getData() ),
+                            ( uLong ) numBytes, ret->level );
+    ABCA_ASSERT( status == Z_OK, "CompressArray() compress2 failed" );
+
+    ret->bytes.resize( compressedBytes );
+    return ret;
+#else
+    return CompressedArrayPtr();
+#endif
+}
+
+//-*****************************************************************************
+// Writes iCompressed as the only chunk of a gzip dataset of iNumVals
+// values. The filtered path below chunks by the number of points instead,
+// so it writes one chunk per component; readers only ever read whole
+// datasets, and HDF5 handles either layout the same way there.
+static hid_t
+WriteCompressedArray( hid_t iGroup,
+                      const std::string &iName,
+                      hid_t iFileType,
+                      hid_t iDspace,
+                      hsize_t iNumVals,
+                      const CompressedArray &iCompressed )
+{
+#ifdef ALEMBIC_HDF5_WRITE_CHUNK
+    hid_t zipPlist = DsetGzipCreatePlist( Dimensions( iNumVals ),
+                                          iCompressed.level );
+    PlistCloser plistCloser( zipPlist );
+
+    hid_t dsetId = H5Dcreate2( iGroup, iName.c_str(), iFileType, iDspace,
+                               H5P_DEFAULT, zipPlist, H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0,
+                 "WriteArray() Failed in dataset constructor" );
+
+    StatsTimer timer( &AbcA::ArchiveStats::storageSeconds,
+                      &AbcA::ArchiveStats::storageCalls );
+    CountStats( &AbcA::ArchiveStats::bytesWritten, iCompressed.bytes.size() );
+
+    hsize_t offset = 0;
+#if H5_VERSION_GE( 1, 10, 3 )
+    herr_t status = H5Dwrite_chunk( dsetId, H5P_DEFAULT, 0, &offset,
+                                    iCompressed.bytes.size(),
+                                    &iCompressed.bytes.front() );
+#else
+    herr_t status = H5DOwrite_chunk( dsetId, H5P_DEFAULT, 0, &offset,
+                                     iCompressed.bytes.size(),
+                                     &iCompressed.bytes.front() );
+#endif
+    if ( status < 0 )
+    {
+        H5Dclose( dsetId );
+        ABCA_THROW( "WriteArray() Failed to write chunk: " << iName );
+    }
+
+    return dsetId;
+#else
+    ABCA_THROW( "WriteArray() Can't write compressed chunks" );
+    return -1;
+#endif
+}
+
 //-*****************************************************************************
 WrittenArraySampleIDPtr
 WriteArray( WrittenArraySampleMap &iMap,
@@ -235,7 +362,8 @@ WriteArray( WrittenArraySampleMap &iMap,
             const AbcA::ArraySample::Key &iKey,
             hid_t iFileType,
             hid_t iNativeType,
-            int iCompressionLevel )
+            int iCompressionLevel,
+            CompressedArrayPtr iCompressed )
 {
 
     // Dispatch to string writing utils.
@@ -295,7 +423,16 @@ WriteArray( WrittenArraySampleMap &iMap,
     DspaceCloser dspaceCloser( dspaceId );
 
     hid_t dsetId = -1;
-    if ( iCompressionLevel >= 0 && hasData )
+    bool wasWritten = false;
+    if ( iCompressed && iCompressed->key == iKey && hasData )
+    {
+        dsetId = WriteCompressedArray( iGroup, iName, iFileType, dspaceId,
+                                       dims.numPoints() *
+                                       dataType.getExtent(),
+                                       *iCompressed );
+        wasWritten = true;
+    }
+    else if ( iCompressionLevel >= 0 && hasData )
     {
         // Make a compression plist
         hid_t zipPlist = DsetGzipCreatePlist( dims,
@@ -318,10 +455,9 @@ WriteArray( WrittenArraySampleMap &iMap,
                  "WriteArray() Failed in dataset constructor" );
 
     // Write the data.
-    if ( hasData )
+    if ( hasData && !wasWritten )
     {
-        H5Dwrite( dsetId, iNativeType, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                  iSamp.getData() );
+        StatsH5Dwrite( dsetId, iNativeType, iSamp.getData() );
     }
 
     // Write the array sample key.
@@ -458,7 +594,39 @@ void WritePropertyInfo( hid_t iGroup,
 
     }
 
-    WriteSmallArray( iGroup, iName + ".info",
+    // Properties of a reopened archive replace the info they were written
+    // with. It's rewritten in place when it can be, so that the property
+    // keeps its place in the attribute creation order.
+    const std::string infoName = iName + ".info";
+    if ( H5Aexists( iGroup, infoName.c_str() ) > 0 )
+    {
+        bool sameSize = false;
+        {
+            hid_t attrId = H5Aopen( iGroup, infoName.c_str(), H5P_DEFAULT );
+            AttrCloser attrCloser( attrId );
+
+            hid_t dspaceId = H5Aget_space( attrId );
+            DspaceCloser dspaceCloser( dspaceId );
+
+            sameSize = H5Sget_simple_extent_npoints( dspaceId ) ==
+                ( hssize_t )numFields;
+            if ( sameSize )
+            {
+                herr_t status = H5Awrite( attrId, H5T_NATIVE_UINT32, info );
+                ABCA_ASSERT( status >= 0,
+                             "Couldn't write attribute: " << infoName );
+            }
+        }
+
+        if ( sameSize )
+        {
+            return;
+        }
+
+        H5Adelete( iGroup, infoName.c_str() );
+    }
+
+    WriteSmallArray( iGroup, infoName,
         H5T_STD_U32LE, H5T_NATIVE_UINT32, numFields,
         ( const void * ) info );
 }
@@ -483,6 +651,83 @@ void WriteTimeSampling( hid_t iGroup,
         &samps.front(), samps.size() );
 }
 
+//-*****************************************************************************
+void
+WriteFrameIndex( hid_t iFile, const FrameIndex &iIndex )
+{
+    // An appended archive has the index it was first written with.
+    if ( H5Lexists( iFile, kFrameIndexName, H5P_DEFAULT ) > 0 )
+    {
+        H5Ldelete( iFile, kFrameIndexName, H5P_DEFAULT );
+    }
+
+    if ( iIndex.empty() )
+    {
+        return;
+    }
+
+    hsize_t dims[1] = { iIndex.size() };
+    hid_t dspaceId = H5Screate_simple( 1, dims, NULL );
+    ABCA_ASSERT( dspaceId >= 0, "Could not create frame index dataspace" );
+    DspaceCloser dspaceCloser( dspaceId );
+
+    hid_t typeId = FrameExtentType();
+    DtypeCloser dtypeCloser( typeId );
+
+    hid_t dsetId = H5Dcreate2( iFile, kFrameIndexName, typeId, dspaceId,
+                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Could not create frame index" );
+    DsetCloser dsetCloser( dsetId );
+
+    herr_t status = H5Dwrite( dsetId, typeId, H5S_ALL, H5S_ALL,
+                              H5P_DEFAULT, &iIndex.front() );
+    ABCA_ASSERT( status >= 0, "Could not write frame index" );
+}
+
+//-*****************************************************************************
+void
+RecordFrameExtent( AbcA::ArchiveWriterPtr iArchive,
+                   hid_t iGroup,
+                   const std::string &iSampleName,
+                   uint32_t iTimeSamplingIndex,
+                   index_t iSampleIndex )
+{
+    AwImpl *ptr = dynamic_cast<AwImpl*>( iArchive.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+
+    if ( !ptr->isRecordingFrameIndex() )
+    {
+        return;
+    }
+
+    // Samples that repeat one written before are hard links to its
+    // dataset, which is already in the index at the time it was written.
+    H5O_info_t oinfo;
+    herr_t status = H5Oget_info_by_name( iGroup, iSampleName.c_str(),
+                                         &oinfo, H5P_DEFAULT );
+    if ( status < 0 || oinfo.type != H5O_TYPE_DATASET || oinfo.rc != 1 )
+    {
+        return;
+    }
+
+    hid_t dsetId = H5Dopen( iGroup, iSampleName.c_str(), H5P_DEFAULT );
+    ABCA_ASSERT( dsetId >= 0, "Cannot open dataset: " << iSampleName );
+    DsetCloser dsetCloser( dsetId );
+
+    // Chunked datasets don't have a single address.
+    haddr_t offset = H5Dget_offset( dsetId );
+    hsize_t size = H5Dget_storage_size( dsetId );
+    if ( offset == HADDR_UNDEF || size == 0 )
+    {
+        return;
+    }
+
+    chrono_t time = ptr->getTimeSampling( iTimeSamplingIndex )->
+        getSampleTime( iSampleIndex );
+
+    ptr->addFrameExtent( time, offset, size );
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreHDF5
 } // End namespace Alembic
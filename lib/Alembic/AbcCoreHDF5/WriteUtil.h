@@ -40,6 +40,10 @@
 #include <Alembic/AbcCoreHDF5/Foundation.h>
 #include <Alembic/AbcCoreHDF5/WrittenArraySampleMap.h>
 #include <Alembic/AbcCoreHDF5/StringWriteUtil.h>
+#include <Alembic/AbcCoreHDF5/FrameIndex.h>
+#include <Alembic/AbcCoreHDF5/StatsCollector.h>
+
+#include <boost/thread/recursive_mutex.hpp>
 
 namespace Alembic {
 namespace AbcCoreHDF5 {
@@ -49,6 +53,15 @@ namespace ALEMBIC_VERSION_NS {
 WrittenArraySampleMap& GetWrittenArraySampleMap(
     AbcA::ArchiveWriterPtr iArchive );
 
+//-*****************************************************************************
+// The mutex that serializes everything written to iArchive, see
+// AwImpl::getWriteMutex.
+boost::recursive_mutex& GetWriteMutex( AbcA::ArchiveWriterPtr iArchive );
+
+//-*****************************************************************************
+// What iArchive's property writers count to, see AwImpl::getStatsCollector.
+StatsCollector& GetStatsCollector( AbcA::ArchiveWriterPtr iArchive );
+
 //-*****************************************************************************
 void
 WriteDimensions( hid_t iParent,
@@ -100,6 +113,30 @@ CopyWrittenArray( hid_t iParent,
                   WrittenArraySampleIDPtr iRef );
 
 //-*****************************************************************************
+// An array sample that was deflated before it got to WriteArray, so that
+// the work can be done without holding the archive's write mutex.
+struct CompressedArray
+{
+    AbcA::ArraySample::Key key;
+    int level;
+    std::vector<char> bytes;
+};
+
+typedef boost::shared_ptr<CompressedArray> CompressedArrayPtr;
+
+//-*****************************************************************************
+// Deflates iSamp the way HDF5's gzip filter would. This doesn't touch
+// HDF5, so it needs no locking. An empty pointer is returned when the
+// sample has to go through the filter as usual: strings, empty samples,
+// and hosts whose byte order isn't the file's.
+CompressedArrayPtr
+CompressArray( const AbcA::ArraySample &iSamp,
+               const AbcA::ArraySample::Key &iKey,
+               int iCompressionLevel );
+
+//-*****************************************************************************
+// iCompressed, if given, is iSamp already deflated by CompressArray, and
+// is written as the dataset's only chunk.
 WrittenArraySampleIDPtr
 WriteArray( WrittenArraySampleMap &iMap,
             hid_t iGroup,
@@ -108,7 +145,8 @@ WriteArray( WrittenArraySampleMap &iMap,
             const AbcA::ArraySample::Key &iKey,
             hid_t iFileType,
             hid_t iNativeType,
-            int iCompressionLevel );
+            int iCompressionLevel,
+            CompressedArrayPtr iCompressed = CompressedArrayPtr() );
 
 //-*****************************************************************************
 void
@@ -128,6 +166,23 @@ WriteTimeSampling( hid_t iGroup,
                    const std::string &iName,
                    const AbcA::TimeSampling &iTsmp );
 
+//-*****************************************************************************
+// Replaces the frame index at the root of iFile with iIndex.
+void
+WriteFrameIndex( hid_t iFile, const FrameIndex &iIndex );
+
+//-*****************************************************************************
+// If the archive is recording a frame index, adds the dataset iSampleName
+// that was just written for the sample at iSampleIndex to it. Datasets
+// that are links to samples written before, or that are chunked, are
+// left out.
+void
+RecordFrameExtent( AbcA::ArchiveWriterPtr iArchive,
+                   hid_t iGroup,
+                   const std::string &iSampleName,
+                   uint32_t iTimeSamplingIndex,
+                   index_t iSampleIndex );
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
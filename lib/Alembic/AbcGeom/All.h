@@ -38,6 +38,7 @@
 #define _Alembic_AbcGeom_All_h_
 
 #include <Alembic/AbcGeom/ArchiveBounds.h>
+#include <Alembic/AbcGeom/ArchiveBVH.h>
 
 #include <Alembic/AbcGeom/GeometryScope.h>
 
@@ -46,6 +47,7 @@
 #include <Alembic/AbcGeom/Basis.h>
 #include <Alembic/AbcGeom/OCurves.h>
 #include <Alembic/AbcGeom/ICurves.h>
+#include <Alembic/AbcGeom/CurveTessellation.h>
 
 #include <Alembic/AbcGeom/OFaceSet.h>
 #include <Alembic/AbcGeom/IFaceSet.h>
@@ -58,26 +60,36 @@
 
 #include <Alembic/AbcGeom/FilmBackXformOp.h>
 #include <Alembic/AbcGeom/CameraSample.h>
+#include <Alembic/AbcGeom/Frustum.h>
 #include <Alembic/AbcGeom/OCamera.h>
 #include <Alembic/AbcGeom/ICamera.h>
 
 #include <Alembic/AbcGeom/INuPatch.h>
 #include <Alembic/AbcGeom/ONuPatch.h>
+#include <Alembic/AbcGeom/NuPatchTessellation.h>
 
 #include <Alembic/AbcGeom/OPoints.h>
 #include <Alembic/AbcGeom/IPoints.h>
+#include <Alembic/AbcGeom/PointsMotion.h>
 
 #include <Alembic/AbcGeom/OPolyMesh.h>
 #include <Alembic/AbcGeom/IPolyMesh.h>
+#include <Alembic/AbcGeom/MeshTopology.h>
+#include <Alembic/AbcGeom/MeshNormals.h>
 
 #include <Alembic/AbcGeom/OSubD.h>
 #include <Alembic/AbcGeom/ISubD.h>
+#include <Alembic/AbcGeom/SubDRefinement.h>
 
 #include <Alembic/AbcGeom/XformOp.h>
 #include <Alembic/AbcGeom/XformSample.h>
 #include <Alembic/AbcGeom/OXform.h>
 #include <Alembic/AbcGeom/IXform.h>
+#include <Alembic/AbcGeom/Instancing.h>
+
+#include <Alembic/AbcGeom/Interpolation.h>
 
 #include <Alembic/AbcGeom/Visibility.h>
+#include <Alembic/AbcGeom/Culling.h>
 
 #endif
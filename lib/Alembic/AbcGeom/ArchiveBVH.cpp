@@ -0,0 +1,598 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/ArchiveBVH.h>
+#include <Alembic/AbcGeom/IGeomBase.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <ImathBoxAlgo.h>
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many objects, a slice or subtree isn't worth a thread.
+static const size_t MIN_OBJECTS_PER_THREAD = 1 << 12;
+
+//-*****************************************************************************
+static const size_t MAX_LEAF_OBJECTS = 4;
+
+typedef ArchiveBVH::Node Node;
+
+//-*****************************************************************************
+// Takes the local bounds of some of the objects into world space.
+struct TransformTask
+{
+    const int32_t *indices;
+    const Box3d *bounds;
+    const int32_t *xforms;
+    const M44d *matrices;
+    Box3d *out;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t k = iBegin; k < iEnd; ++k )
+        {
+            int32_t i = indices[k];
+            out[i] = xforms[i] < 0 ? bounds[i] :
+                Imath::transform( bounds[i], matrices[xforms[i]] );
+        }
+    }
+};
+
+//-*****************************************************************************
+struct CenterLess
+{
+    const V3d *centers;
+    int axis;
+
+    bool operator()( int32_t iA, int32_t iB ) const
+    {
+        return centers[iA][axis] < centers[iB][axis];
+    }
+};
+
+//-*****************************************************************************
+struct BuildContext
+{
+    const Box3d *bounds;
+    const V3d *centers;
+    int32_t *order;
+    size_t threadDepth;
+};
+
+//-*****************************************************************************
+// Builds the subtree over order[iBegin, iEnd) onto oNodes, splitting at
+// the median center along the axis the centers spread furthest on. Near
+// the top of the tree the first child is built on another thread into its
+// own nodes; as children are found by relative offsets, they can be
+// appended as they are.
+void BuildNode( const BuildContext &iContext, size_t iBegin, size_t iEnd,
+                size_t iDepth, std::vector<Node> &oNodes )
+{
+    Node node;
+    node.bounds.makeEmpty();
+    node.first = ( int32_t ) iBegin;
+    node.count = ( int32_t ) ( iEnd - iBegin );
+    node.skip = 0;
+
+    Box3d centers;
+    centers.makeEmpty();
+    for ( size_t i = iBegin; i < iEnd; ++i )
+    {
+        node.bounds.extendBy( iContext.bounds[iContext.order[i]] );
+        centers.extendBy( iContext.centers[iContext.order[i]] );
+    }
+
+    size_t self = oNodes.size();
+    oNodes.push_back( node );
+
+    if ( iEnd - iBegin <= MAX_LEAF_OBJECTS )
+    {
+        return;
+    }
+
+    CenterLess less;
+    less.centers = iContext.centers;
+    less.axis = centers.majorAxis();
+    if ( centers.size()[less.axis] <= 0.0 )
+    {
+        // all in the same place, so there's no splitting them
+        return;
+    }
+
+    size_t mid = ( iBegin + iEnd ) / 2;
+    std::nth_element( iContext.order + iBegin, iContext.order + mid,
+                      iContext.order + iEnd, less );
+
+    if ( iDepth < iContext.threadDepth &&
+         iEnd - iBegin >= MIN_OBJECTS_PER_THREAD * 2 )
+    {
+        std::vector<Node> first;
+        std::vector<Node> second;
+        boost::thread thread( boost::bind( &BuildNode, boost::cref( iContext ),
+            iBegin, mid, iDepth + 1, boost::ref( first ) ) );
+        try
+        {
+            BuildNode( iContext, mid, iEnd, iDepth + 1, second );
+        }
+        catch ( ... )
+        {
+            // the other half is still writing to first
+            thread.join();
+            throw;
+        }
+        thread.join();
+
+        oNodes.insert( oNodes.end(), first.begin(), first.end() );
+        oNodes[self].skip = ( int32_t ) ( oNodes.size() - self );
+        oNodes.insert( oNodes.end(), second.begin(), second.end() );
+    }
+    else
+    {
+        BuildNode( iContext, iBegin, mid, iDepth + 1, oNodes );
+        oNodes[self].skip = ( int32_t ) ( oNodes.size() - self );
+        BuildNode( iContext, mid, iEnd, iDepth + 1, oNodes );
+    }
+}
+
+//-*****************************************************************************
+// Where the ray enters iBounds, if it does before iMaxDistance.
+bool RayEnters( const V3d &iOrigin, const V3d &iDirection,
+                const Box3d &iBounds, double iMaxDistance, double &oEnter )
+{
+    if ( iBounds.isEmpty() )
+    {
+        return false;
+    }
+
+    double enter = 0.0;
+    double exit = iMaxDistance;
+    for ( int a = 0; a < 3; ++a )
+    {
+        if ( iDirection[a] == 0.0 )
+        {
+            if ( iOrigin[a] < iBounds.min[a] || iOrigin[a] > iBounds.max[a] )
+            {
+                return false;
+            }
+            continue;
+        }
+
+        double t0 = ( iBounds.min[a] - iOrigin[a] ) / iDirection[a];
+        double t1 = ( iBounds.max[a] - iOrigin[a] ) / iDirection[a];
+        if ( t0 > t1 )
+        {
+            std::swap( t0, t1 );
+        }
+
+        enter = std::max( enter, t0 );
+        exit = std::min( exit, t1 );
+        if ( enter > exit )
+        {
+            return false;
+        }
+    }
+
+    oEnter = enter;
+    return true;
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+ArchiveBVH::ArchiveBVH( IArchive &iArchive, chrono_t iTime )
+  : m_time( iTime )
+{
+    build( iArchive.getTop() );
+}
+
+//-*****************************************************************************
+ArchiveBVH::ArchiveBVH( IObject iRoot, chrono_t iTime )
+  : m_time( iTime )
+{
+    build( iRoot );
+}
+
+//-*****************************************************************************
+void ArchiveBVH::build( IObject iRoot )
+{
+    // the xforms and objects in hierarchy order, so every xform comes
+    // after its parent
+    std::vector<char> animated;
+    std::vector< std::pair<IObject, int32_t> > stack;
+    stack.push_back( std::make_pair( iRoot, -1 ) );
+    while ( !stack.empty() )
+    {
+        IObject obj = stack.back().first;
+        int32_t xform = stack.back().second;
+        stack.pop_back();
+
+        const AbcA::MetaData &md = obj.getMetaData();
+        if ( IXform::matches( obj.getHeader() ) )
+        {
+            Xform x;
+            x.schema = IXform( obj, kWrapExisting ).getSchema();
+            x.parent = xform;
+            x.animated = !x.schema.isConstant() ||
+                ( xform >= 0 && m_xforms[xform].animated );
+            x.inherits = true;
+            x.local.makeIdentity();
+            x.world.makeIdentity();
+
+            xform = ( int32_t ) m_xforms.size();
+            m_xforms.push_back( x );
+        }
+        else if ( IGeomBase::matches( md ) )
+        {
+            Object o;
+            o.fullName = obj.getFullName();
+            o.selfBounds = IGeomBaseObject( obj, kWrapExisting ).getSchema().
+                getSelfBoundsProperty();
+            o.xform = xform;
+            o.bounds.makeEmpty();
+
+            bool isAnimated = ( xform >= 0 && m_xforms[xform].animated ) ||
+                ( o.selfBounds && !o.selfBounds.isConstant() );
+            if ( isAnimated )
+            {
+                m_animatedObjects.push_back( ( int32_t ) m_objects.size() );
+            }
+            animated.push_back( isAnimated );
+            m_objects.push_back( o );
+        }
+
+        // pushed backwards, so they come off in order
+        for ( size_t i = obj.getNumChildren(); i > 0; --i )
+        {
+            stack.push_back( std::make_pair(
+                IObject( obj, obj.getChildHeader( i - 1 ).getName() ),
+                xform ) );
+        }
+    }
+
+    m_worldBounds.resize( m_objects.size() );
+    read( true );
+
+    if ( m_objects.empty() )
+    {
+        return;
+    }
+
+    std::vector<V3d> centers( m_objects.size() );
+    m_order.resize( m_objects.size() );
+    for ( size_t i = 0; i < m_objects.size(); ++i )
+    {
+        centers[i] = m_worldBounds[i].center();
+        m_order[i] = ( int32_t ) i;
+    }
+
+    BuildContext context;
+    context.bounds = &m_worldBounds.front();
+    context.centers = &centers.front();
+    context.order = &m_order.front();
+    context.threadDepth = 0;
+    while ( ( ( size_t ) 1 << context.threadDepth ) <
+            ( size_t ) boost::thread::hardware_concurrency() )
+    {
+        ++context.threadDepth;
+    }
+    BuildNode( context, 0, m_order.size(), 0, m_nodes );
+
+    // only the nodes over something animated are refit
+    m_animatedNodes.assign( m_nodes.size(), 0 );
+    for ( size_t n = m_nodes.size(); n > 0; --n )
+    {
+        const Node &node = m_nodes[n - 1];
+        char &nodeAnimated = m_animatedNodes[n - 1];
+        if ( node.skip == 0 )
+        {
+            for ( int32_t i = node.first; i < node.first + node.count; ++i )
+            {
+                nodeAnimated = nodeAnimated || animated[m_order[i]];
+            }
+        }
+        else
+        {
+            nodeAnimated = m_animatedNodes[n] ||
+                m_animatedNodes[n - 1 + node.skip];
+        }
+    }
+}
+
+//-*****************************************************************************
+// Reads everything, or just what is animated, and takes the objects'
+// bounds into world space.
+void ArchiveBVH::read( bool iAll )
+{
+    Abc::ISampleSelector ss( m_time );
+
+    std::vector<M44d> matrices( m_xforms.size() );
+    for ( size_t i = 0; i < m_xforms.size(); ++i )
+    {
+        Xform &x = m_xforms[i];
+        if ( iAll || !x.schema.isConstant() )
+        {
+            XformSample samp;
+            x.schema.get( samp, ss );
+            x.local = samp.getMatrix();
+            x.inherits = samp.getInheritsXforms();
+        }
+
+        if ( iAll || x.animated )
+        {
+            x.world = x.local;
+            if ( x.inherits && x.parent >= 0 )
+            {
+                x.world *= m_xforms[x.parent].world;
+            }
+        }
+        matrices[i] = x.world;
+    }
+
+    std::vector<int32_t> all;
+    if ( iAll )
+    {
+        all.resize( m_objects.size() );
+        for ( size_t i = 0; i < all.size(); ++i )
+        {
+            all[i] = ( int32_t ) i;
+        }
+    }
+    const std::vector<int32_t> &indices = iAll ? all : m_animatedObjects;
+    if ( indices.empty() )
+    {
+        return;
+    }
+
+    std::vector<Box3d> bounds( m_objects.size() );
+    std::vector<int32_t> xforms( m_objects.size() );
+    for ( size_t k = 0; k < indices.size(); ++k )
+    {
+        Object &o = m_objects[indices[k]];
+        if ( o.selfBounds && o.selfBounds.getNumSamples() > 0 &&
+             ( iAll || !o.selfBounds.isConstant() ) )
+        {
+            o.selfBounds.get( o.bounds, ss );
+        }
+        bounds[indices[k]] = o.bounds;
+        xforms[indices[k]] = o.xform;
+    }
+
+    TransformTask task;
+    task.indices = &indices.front();
+    task.bounds = &bounds.front();
+    task.xforms = &xforms.front();
+    task.matrices = matrices.empty() ? NULL : &matrices.front();
+    task.out = &m_worldBounds.front();
+    RunSlices( indices.size(), MIN_OBJECTS_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+void ArchiveBVH::setTime( chrono_t iTime )
+{
+    m_time = iTime;
+    if ( m_animatedObjects.empty() )
+    {
+        return;
+    }
+
+    read( false );
+
+    // children come after their parents, so backwards is bottom up
+    for ( size_t n = m_nodes.size(); n > 0; --n )
+    {
+        if ( !m_animatedNodes[n - 1] )
+        {
+            continue;
+        }
+
+        Node &node = m_nodes[n - 1];
+        if ( node.skip == 0 )
+        {
+            node.bounds.makeEmpty();
+            for ( int32_t i = node.first; i < node.first + node.count; ++i )
+            {
+                node.bounds.extendBy( m_worldBounds[m_order[i]] );
+            }
+        }
+        else
+        {
+            node.bounds = m_nodes[n].bounds;
+            node.bounds.extendBy( m_nodes[n - 1 + node.skip].bounds );
+        }
+    }
+}
+
+//-*****************************************************************************
+Box3d ArchiveBVH::getBounds() const
+{
+    if ( m_nodes.empty() )
+    {
+        Box3d bounds;
+        bounds.makeEmpty();
+        return bounds;
+    }
+    return m_nodes.front().bounds;
+}
+
+//-*****************************************************************************
+void ArchiveBVH::findInBox( const Box3d &iBox,
+                            std::vector<size_t> &oObjects ) const
+{
+    oObjects.clear();
+    if ( m_nodes.empty() || iBox.isEmpty() )
+    {
+        return;
+    }
+
+    std::vector<int32_t> stack( 1, 0 );
+    while ( !stack.empty() )
+    {
+        int32_t n = stack.back();
+        stack.pop_back();
+
+        const Node &node = m_nodes[n];
+        if ( !node.bounds.intersects( iBox ) )
+        {
+            continue;
+        }
+
+        if ( node.skip != 0 )
+        {
+            stack.push_back( n + node.skip );
+            stack.push_back( n + 1 );
+            continue;
+        }
+
+        for ( int32_t i = node.first; i < node.first + node.count; ++i )
+        {
+            const Box3d &bounds = m_worldBounds[m_order[i]];
+            if ( !bounds.isEmpty() && bounds.intersects( iBox ) )
+            {
+                oObjects.push_back( m_order[i] );
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void ArchiveBVH::findInFrustum( const Frustum &iFrustum,
+                                std::vector<size_t> &oObjects ) const
+{
+    oObjects.clear();
+    if ( m_nodes.empty() )
+    {
+        return;
+    }
+
+    std::vector<int32_t> stack( 1, 0 );
+    while ( !stack.empty() )
+    {
+        int32_t n = stack.back();
+        stack.pop_back();
+
+        const Node &node = m_nodes[n];
+        bool contained = iFrustum.contains( node.bounds );
+        if ( !contained && !iFrustum.intersects( node.bounds ) )
+        {
+            continue;
+        }
+
+        // everything under a node wholly inside is in, untested
+        if ( node.skip != 0 && !contained )
+        {
+            stack.push_back( n + node.skip );
+            stack.push_back( n + 1 );
+            continue;
+        }
+
+        for ( int32_t i = node.first; i < node.first + node.count; ++i )
+        {
+            const Box3d &bounds = m_worldBounds[m_order[i]];
+            if ( contained ? !bounds.isEmpty() :
+                 iFrustum.intersects( bounds ) )
+            {
+                oObjects.push_back( m_order[i] );
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void ArchiveBVH::findAlongRay( const V3d &iOrigin, const V3d &iDirection,
+                               std::vector<size_t> &oObjects,
+                               double iMaxDistance ) const
+{
+    oObjects.clear();
+    if ( m_nodes.empty() )
+    {
+        return;
+    }
+
+    std::vector< std::pair<double, size_t> > hits;
+    std::vector<int32_t> stack( 1, 0 );
+    while ( !stack.empty() )
+    {
+        int32_t n = stack.back();
+        stack.pop_back();
+
+        const Node &node = m_nodes[n];
+        double enter;
+        if ( !RayEnters( iOrigin, iDirection, node.bounds, iMaxDistance,
+                         enter ) )
+        {
+            continue;
+        }
+
+        if ( node.skip != 0 )
+        {
+            stack.push_back( n + node.skip );
+            stack.push_back( n + 1 );
+            continue;
+        }
+
+        for ( int32_t i = node.first; i < node.first + node.count; ++i )
+        {
+            if ( RayEnters( iOrigin, iDirection, m_worldBounds[m_order[i]],
+                            iMaxDistance, enter ) )
+            {
+                hits.push_back( std::make_pair( enter,
+                                                ( size_t ) m_order[i] ) );
+            }
+        }
+    }
+
+    std::sort( hits.begin(), hits.end() );
+    oObjects.resize( hits.size() );
+    for ( size_t i = 0; i < hits.size(); ++i )
+    {
+        oObjects[i] = hits[i].second;
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
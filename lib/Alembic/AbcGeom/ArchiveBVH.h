@@ -0,0 +1,162 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_ArchiveBVH_h_
+#define _Alembic_AbcGeom_ArchiveBVH_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/Frustum.h>
+#include <Alembic/AbcGeom/IXform.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <limits>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A bounding volume hierarchy over the world space self bounds of every
+//! geometric object under a root, at one time, for finding the objects in
+//! a box, a camera's view or along a ray without visiting the rest.
+//!
+//! Objects are read in hierarchy order, and their world bounds and the
+//! tree are then worked out across threads. Moving to another time only
+//! re-reads the xforms and bounds that are animated and refits the nodes
+//! above them; the shape of the tree is kept, so if things move a long way
+//! from where they were built it is worth building a new one.
+class ArchiveBVH : private boost::noncopyable
+{
+public:
+    //! Everything under the archive's top object.
+    ArchiveBVH( IArchive &iArchive, chrono_t iTime );
+
+    //! Everything under iRoot, including iRoot itself, in iRoot's world
+    //! space: the xforms above iRoot aren't read.
+    ArchiveBVH( IObject iRoot, chrono_t iTime );
+
+    chrono_t getTime() const { return m_time; }
+
+    //! Re-reads what is animated at iTime and refits the tree to it.
+    void setTime( chrono_t iTime );
+
+    size_t getNumObjects() const { return m_objects.size(); }
+
+    size_t getNumAnimatedObjects() const { return m_animatedObjects.size(); }
+
+    const std::string &getObjectFullName( size_t i ) const
+    { return m_objects[i].fullName; }
+
+    const Box3d &getObjectBounds( size_t i ) const
+    { return m_worldBounds[i]; }
+
+    //! The bounds of everything.
+    Box3d getBounds() const;
+
+    //! The objects whose bounds overlap iBox, in no particular order.
+    void findInBox( const Box3d &iBox,
+                    std::vector<size_t> &oObjects ) const;
+
+    //! The objects whose bounds intersect iFrustum, in no particular
+    //! order.
+    void findInFrustum( const Frustum &iFrustum,
+                        std::vector<size_t> &oObjects ) const;
+
+    //! The objects whose bounds the ray from iOrigin along iDirection goes
+    //! through within iMaxDistance, nearest first. Distances are in units
+    //! of iDirection's length.
+    void findAlongRay( const V3d &iOrigin, const V3d &iDirection,
+                       std::vector<size_t> &oObjects,
+                       double iMaxDistance =
+                       std::numeric_limits<double>::max() ) const;
+
+    //! A node of the tree. Its objects are getOrder()[first] up to
+    //! getOrder()[first + count]. Its first child is the next node and
+    //! its second is skip nodes on, unless skip is 0 and it is a leaf.
+    struct Node
+    {
+        Box3d bounds;
+        int32_t first;
+        int32_t count;
+        int32_t skip;
+    };
+
+    const std::vector<Node> &getNodes() const { return m_nodes; }
+
+    const std::vector<int32_t> &getOrder() const { return m_order; }
+
+private:
+    void build( IObject iRoot );
+
+    void read( bool iAll );
+
+    struct Xform
+    {
+        IXformSchema schema;
+        int32_t parent;
+        bool animated;
+        bool inherits;
+        M44d local;
+        M44d world;
+    };
+
+    struct Object
+    {
+        std::string fullName;
+        Abc::IBox3dProperty selfBounds;
+        int32_t xform;
+        Box3d bounds;
+    };
+
+    chrono_t m_time;
+    std::vector<Xform> m_xforms;
+    std::vector<Object> m_objects;
+    std::vector<Box3d> m_worldBounds;
+    std::vector<int32_t> m_animatedObjects;
+    std::vector<Node> m_nodes;
+    std::vector<char> m_animatedNodes;
+    std::vector<int32_t> m_order;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
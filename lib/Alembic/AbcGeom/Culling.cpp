@@ -0,0 +1,214 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/Culling.h>
+#include <Alembic/AbcGeom/IFaceSet.h>
+#include <Alembic/AbcGeom/IGeomBase.h>
+#include <Alembic/AbcGeom/IXform.h>
+
+#include <ImathBoxAlgo.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+Frustum GetWorldFrustum( ICamera iCamera, const Abc::ISampleSelector &iSS )
+{
+    CameraSample samp;
+    iCamera.getSchema().get( samp, iSS );
+
+    M44d world;
+    world.makeIdentity();
+
+    IObject parent = iCamera.getParent();
+    while ( parent )
+    {
+        if ( IXform::matches( parent.getHeader() ) )
+        {
+            XformSample xs;
+            IXform( parent, kWrapExisting ).getSchema().get( xs, iSS );
+            world *= xs.getMatrix();
+            if ( !xs.getInheritsXforms() )
+            {
+                break;
+            }
+        }
+        parent = parent.getParent();
+    }
+
+    return Frustum( samp, world );
+}
+
+//-*****************************************************************************
+ObjectCuller::ObjectCuller( chrono_t iTime )
+  : m_useFrustum( false )
+  , m_numTimes( 1 )
+  , m_numOutside( 0 )
+  , m_numHidden( 0 )
+  , m_numKept( 0 )
+{
+    m_times[0] = m_times[1] = iTime;
+}
+
+//-*****************************************************************************
+ObjectCuller::ObjectCuller( const Frustum &iFrustum, chrono_t iShutterOpen,
+                            chrono_t iShutterClose )
+  : m_frustum( iFrustum )
+  , m_useFrustum( true )
+  , m_numTimes( iShutterOpen == iShutterClose ? 1 : 2 )
+  , m_numOutside( 0 )
+  , m_numHidden( 0 )
+  , m_numKept( 0 )
+{
+    m_times[0] = iShutterOpen;
+    m_times[1] = iShutterClose;
+}
+
+//-*****************************************************************************
+ObjectCuller::State ObjectCuller::getTopState() const
+{
+    State state;
+    state.world[0].makeIdentity();
+    state.world[1].makeIdentity();
+    state.visible = true;
+    state.inside = !m_useFrustum;
+    return state;
+}
+
+//-*****************************************************************************
+ObjectCuller::CullResult
+ObjectCuller::cull( IObject iObject, const State &iParent, State &oState )
+{
+    oState = iParent;
+
+    // the bounds of the object and everything below it, in its own space
+    Abc::IBox3dProperty bounds[2];
+    const AbcA::ObjectHeader &header = iObject.getHeader();
+    if ( IXform::matches( header ) )
+    {
+        IXform xform( iObject, kWrapExisting );
+        IXformSchema &xs = xform.getSchema();
+        if ( !iParent.inside )
+        {
+            for ( size_t t = 0; t < m_numTimes; ++t )
+            {
+                XformSample samp;
+                xs.get( samp, Abc::ISampleSelector( m_times[t] ) );
+                oState.world[t] = samp.getMatrix();
+                if ( samp.getInheritsXforms() )
+                {
+                    oState.world[t] *= iParent.world[t];
+                }
+            }
+            bounds[0] = xs.getChildBoundsProperty();
+        }
+    }
+    else if ( IGeomBase::matches( header.getMetaData() ) &&
+              !IFaceSet::matches( header ) && !iParent.inside )
+    {
+        IGeomBaseObject geomObject( iObject, kWrapExisting );
+        IGeomBase &geom = geomObject.getSchema();
+        bounds[0] = geom.getSelfBoundsProperty();
+        bounds[1] = geom.getChildBoundsProperty();
+
+        // face sets are within their mesh, but with other children and
+        // nothing saying where they are, there's no telling
+        if ( !( bounds[1] && bounds[1].getNumSamples() > 0 ) )
+        {
+            for ( size_t i = 0; i < iObject.getNumChildren(); ++i )
+            {
+                if ( !IFaceSet::matches( iObject.getChildHeader( i ) ) )
+                {
+                    bounds[0].reset();
+                    break;
+                }
+            }
+        }
+    }
+
+    if ( !iParent.inside && bounds[0] && bounds[0].getNumSamples() > 0 )
+    {
+        // Empty bounds don't mean there's nothing there. Xforms fill the
+        // samples before their first child bounds with empty boxes, and
+        // geometry can be written with them, so those are bounds we don't
+        // know, and nothing is culled by them.
+        Box3d world;
+        world.makeEmpty();
+        bool known = true;
+        for ( size_t t = 0; t < m_numTimes && known; ++t )
+        {
+            Abc::ISampleSelector ss( m_times[t] );
+            Box3d local = bounds[0].getValue( ss );
+            if ( bounds[1] && bounds[1].getNumSamples() > 0 )
+            {
+                local.extendBy( bounds[1].getValue( ss ) );
+            }
+            known = !local.isEmpty();
+            world.extendBy( Imath::transform( local, oState.world[t] ) );
+        }
+
+        if ( known && !world.isEmpty() )
+        {
+            if ( !m_frustum.intersects( world ) )
+            {
+                ++m_numOutside;
+                return kCullSubtree;
+            }
+            oState.inside = m_frustum.contains( world );
+        }
+    }
+
+    ObjectVisibility visibility = GetVisibility( iObject,
+        Abc::ISampleSelector( m_times[0] ) );
+    if ( visibility != kVisibilityDeferred )
+    {
+        oState.visible = visibility != kVisibilityHidden;
+    }
+
+    if ( !oState.visible )
+    {
+        ++m_numHidden;
+        return kCullObject;
+    }
+
+    ++m_numKept;
+    return kKeep;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
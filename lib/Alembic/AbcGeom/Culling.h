@@ -0,0 +1,143 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_Culling_h_
+#define _Alembic_AbcGeom_Culling_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/Frustum.h>
+#include <Alembic/AbcGeom/ICamera.h>
+#include <Alembic/AbcGeom/Visibility.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! The frustum of iCamera at iSS in world space, with the xforms above the
+//! camera taken into account.
+Frustum GetWorldFrustum( ICamera iCamera,
+                         const Abc::ISampleSelector &iSS =
+                         Abc::ISampleSelector() );
+
+//-*****************************************************************************
+//! Decides, for a walk down an archive's hierarchy, which objects are worth
+//! emitting. Each object is asked about once, with the State its parent
+//! was given, so inherited visibility and world matrices are worked out on
+//! the way down instead of by walking back up from every object as
+//! IsAncestorInvisible does.
+//!
+//! Objects with .childBnds, or geometry with .selfBnds, that are wholly
+//! outside the frustum at both the shutter open and close times are culled
+//! with everything below them. Bounds are read in the object's own space,
+//! which for an xform is the space of its children. Anything below an
+//! object wholly inside the frustum isn't tested again. Objects without
+//! bounds, or whose bounds are empty at either time, and face sets, are
+//! never culled by the frustum.
+//!
+//! Visibility is resolved as IsAncestorInvisible resolves it, at the
+//! shutter open time: a hidden object isn't emitted, but its children are
+//! still walked, since one of them may be explicitly visible.
+class ObjectCuller
+{
+public:
+    //! What is carried down from an object to its children.
+    struct State
+    {
+        //! The world matrix at shutter open and close.
+        M44d world[2];
+
+        bool visible;
+
+        //! Whether the object is known to be wholly inside the frustum.
+        bool inside;
+    };
+
+    enum CullResult
+    {
+        //! Outside the frustum, along with everything below it.
+        kCullSubtree,
+
+        //! Hidden, but its children still need walking.
+        kCullObject,
+
+        kKeep
+    };
+
+    //! Culls by visibility only.
+    explicit ObjectCuller( chrono_t iTime );
+
+    //! Culls by visibility, and by iFrustum over the shutter.
+    ObjectCuller( const Frustum &iFrustum, chrono_t iShutterOpen,
+                  chrono_t iShutterClose );
+
+    //! The state above the archive's top object: visible, with identity
+    //! world matrices.
+    State getTopState() const;
+
+    //! What to do with iObject, given its parent's state. oState is what
+    //! to pass to iObject's children, when they are walked.
+    CullResult cull( IObject iObject, const State &iParent, State &oState );
+
+    //! Objects culled by the frustum, each taking everything below it too.
+    size_t getNumOutside() const { return m_numOutside; }
+
+    //! Objects culled for being hidden.
+    size_t getNumHidden() const { return m_numHidden; }
+
+    size_t getNumCulled() const { return m_numOutside + m_numHidden; }
+
+    size_t getNumKept() const { return m_numKept; }
+
+private:
+    Frustum m_frustum;
+    bool m_useFrustum;
+    chrono_t m_times[2];
+    size_t m_numTimes;
+
+    size_t m_numOutside;
+    size_t m_numHidden;
+    size_t m_numKept;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,574 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/CurveTessellation.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many curves per thread, starting threads costs more than
+// the work.
+static const size_t MIN_CURVES_PER_THREAD = 1 << 12;
+
+//-*****************************************************************************
+enum WidthsScope
+{
+    kNoWidths,
+    kConstantWidths,
+    kVertexWidths,
+    kUniformWidths,
+    kVaryingWidths
+};
+
+//-*****************************************************************************
+inline bool IsCubic( CurveType iType, BasisType iBasis, int32_t iNumVertices )
+{
+    return iType == kCubic && iBasis != kNoBasis && iNumVertices >= 4;
+}
+
+//-*****************************************************************************
+// Every basis is turned into the four Bezier points of the same span, so
+// only one evaluator is needed. T is V3f for positions and float32_t for
+// widths.
+template <class T>
+void ToBezier( BasisType iBasis, const T iP[4], T oB[4] )
+{
+    switch ( iBasis )
+    {
+    case kBsplineBasis:
+        oB[0] = ( iP[0] + iP[1] * 4.0f + iP[2] ) / 6.0f;
+        oB[1] = ( iP[1] * 4.0f + iP[2] * 2.0f ) / 6.0f;
+        oB[2] = ( iP[1] * 2.0f + iP[2] * 4.0f ) / 6.0f;
+        oB[3] = ( iP[1] + iP[2] * 4.0f + iP[3] ) / 6.0f;
+        break;
+
+    case kCatmullromBasis:
+        oB[0] = iP[1];
+        oB[1] = iP[1] + ( iP[2] - iP[0] ) / 6.0f;
+        oB[2] = iP[2] - ( iP[3] - iP[1] ) / 6.0f;
+        oB[3] = iP[2];
+        break;
+
+    // point, tangent, point, tangent
+    case kHermiteBasis:
+        oB[0] = iP[0];
+        oB[1] = iP[0] + iP[1] / 3.0f;
+        oB[2] = iP[2] - iP[3] / 3.0f;
+        oB[3] = iP[2];
+        break;
+
+    // the coefficients of t^3, t^2, t and 1
+    case kPowerBasis:
+        oB[0] = iP[3];
+        oB[1] = iP[3] + iP[2] / 3.0f;
+        oB[2] = iP[3] + iP[2] * ( 2.0f / 3.0f ) + iP[1] / 3.0f;
+        oB[3] = iP[3] + iP[2] + iP[1] + iP[0];
+        break;
+
+    default:
+        std::copy( iP, iP + 4, oB );
+        break;
+    }
+}
+
+//-*****************************************************************************
+template <class T>
+inline T EvalBezier( const T iB[4], float32_t iT )
+{
+    float32_t s = 1.0f - iT;
+    return iB[0] * ( s * s * s ) + iB[1] * ( 3.0f * s * s * iT ) +
+        iB[2] * ( 3.0f * s * iT * iT ) + iB[3] * ( iT * iT * iT );
+}
+
+//-*****************************************************************************
+// A polyline of n steps strays at most 6m / 8n^2 from a Bezier span, where
+// m bounds its second differences.
+int32_t GetSpanSteps( const V3f iB[4], float32_t iTolerance,
+                      int32_t iMaxSteps )
+{
+    if ( iTolerance <= 0.0f )
+    {
+        return iMaxSteps;
+    }
+
+    float32_t m = std::max( ( iB[0] - iB[1] * 2.0f + iB[2] ).length(),
+                            ( iB[1] - iB[2] * 2.0f + iB[3] ).length() );
+    float32_t steps = std::ceil( std::sqrt( 0.75f * m / iTolerance ) );
+
+    if ( !( steps < ( float32_t ) iMaxSteps ) )
+    {
+        return iMaxSteps;
+    }
+    return std::max( ( int32_t ) steps, 1 );
+}
+
+//-*****************************************************************************
+// Counts the polyline vertices of each curve when outOffsets is NULL, and
+// fills them in once it isn't.
+struct TessellateTask
+{
+    CurveType type;
+    BasisType basis;
+    bool periodic;
+    int32_t step;
+    float32_t tolerance;
+    int32_t maxSteps;
+
+    const int32_t *numVertices;
+    const int32_t *inOffsets;
+    const int32_t *varyingOffsets;
+    const V3f *positions;
+    const float32_t *widths;
+    WidthsScope widthsScope;
+
+    int32_t *outCounts;
+    const size_t *outOffsets;
+    V3f *outPositions;
+    float32_t *outWidths;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t c = iBegin; c < iEnd; ++c )
+        {
+            if ( outOffsets )
+            {
+                fill( c );
+            }
+            else
+            {
+                outCounts[c] = count( c );
+            }
+        }
+    }
+
+    template <class T>
+    void gather( const T *iCvs, int32_t iNumVertices, size_t iSpan,
+                 T oB[4] ) const
+    {
+        T p[4];
+        size_t first = iSpan * step;
+        for ( size_t k = 0; k < 4; ++k )
+        {
+            p[k] = iCvs[( first + k ) % iNumVertices];
+        }
+        ToBezier( basis, p, oB );
+    }
+
+    int32_t count( size_t iCurve ) const
+    {
+        int32_t n = numVertices[iCurve];
+        if ( n <= 0 )
+        {
+            return 0;
+        }
+
+        if ( !IsCubic( type, basis, n ) )
+        {
+            return n + ( periodic ? 1 : 0 );
+        }
+
+        const V3f *cvs = positions + inOffsets[iCurve];
+        size_t spans = GetNumCurveSpans( type, basis,
+            periodic ? kPeriodic : kNonPeriodic, n );
+
+        int32_t total = 1;
+        for ( size_t s = 0; s < spans; ++s )
+        {
+            V3f b[4];
+            gather( cvs, n, s, b );
+            total += GetSpanSteps( b, tolerance, maxSteps );
+        }
+        return total;
+    }
+
+    // vertex widths are handled by the caller, as they follow the basis
+    float32_t width( size_t iCurve, size_t iVarying, size_t iNextVarying,
+                     float32_t iT ) const
+    {
+        switch ( widthsScope )
+        {
+        case kConstantWidths:
+            return widths[0];
+
+        case kUniformWidths:
+            return widths[iCurve];
+
+        case kVaryingWidths:
+        {
+            const float32_t *w = widths + varyingOffsets[iCurve];
+            return w[iVarying] + ( w[iNextVarying] - w[iVarying] ) * iT;
+        }
+
+        default:
+            return 0.0f;
+        }
+    }
+
+    void fill( size_t iCurve ) const
+    {
+        int32_t n = numVertices[iCurve];
+        if ( n <= 0 )
+        {
+            return;
+        }
+
+        const V3f *cvs = positions + inOffsets[iCurve];
+        const float32_t *cvWidths = ( widthsScope == kVertexWidths ) ?
+            widths + inOffsets[iCurve] : NULL;
+        V3f *out = outPositions + outOffsets[iCurve];
+        float32_t *outW = outWidths ? outWidths + outOffsets[iCurve] : NULL;
+
+        if ( !IsCubic( type, basis, n ) )
+        {
+            int32_t total = n + ( periodic ? 1 : 0 );
+            for ( int32_t i = 0; i < total; ++i )
+            {
+                int32_t v = i % n;
+                out[i] = cvs[v];
+                if ( cvWidths )
+                {
+                    outW[i] = cvWidths[v];
+                }
+                else if ( outW )
+                {
+                    outW[i] = width( iCurve, v, v, 0.0f );
+                }
+            }
+            return;
+        }
+
+        size_t spans = GetNumCurveSpans( type, basis,
+            periodic ? kPeriodic : kNonPeriodic, n );
+        size_t numVarying = varyingOffsets[iCurve + 1] -
+            varyingOffsets[iCurve];
+
+        V3f b[4];
+        float32_t wb[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for ( size_t s = 0; s < spans; ++s )
+        {
+            gather( cvs, n, s, b );
+            if ( cvWidths )
+            {
+                gather( cvWidths, n, s, wb );
+            }
+
+            int32_t steps = GetSpanSteps( b, tolerance, maxSteps );
+            float32_t dt = 1.0f / ( float32_t ) steps;
+            for ( int32_t k = 0; k < steps; ++k )
+            {
+                float32_t t = dt * ( float32_t ) k;
+                *( out++ ) = EvalBezier( b, t );
+                if ( cvWidths )
+                {
+                    *( outW++ ) = EvalBezier( wb, t );
+                }
+                else if ( outW )
+                {
+                    *( outW++ ) = width( iCurve, s, ( s + 1 ) % numVarying,
+                                         t );
+                }
+            }
+        }
+
+        // the end of the last span closes the polyline
+        *out = b[3];
+        if ( cvWidths )
+        {
+            *outW = wb[3];
+        }
+        else if ( outW )
+        {
+            *outW = width( iCurve, spans - 1, spans % numVarying, 1.0f );
+        }
+    }
+};
+
+//-*****************************************************************************
+// Faces the two sides of each polyline vertex away from each other across
+// the line of sight, so the quads wind clockwise seen from iViewPoint.
+struct RibbonTask
+{
+    const V3f *positions;
+    const float32_t *widths;
+    float32_t defaultWidth;
+    V3f viewPoint;
+    const int32_t *numVertices;
+    const size_t *vertexOffsets;
+    const size_t *faceOffsets;
+
+    V3f *outPositions;
+    int32_t *outIndices;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t c = iBegin; c < iEnd; ++c )
+        {
+            size_t first = vertexOffsets[c];
+            int32_t m = numVertices[c];
+            const V3f *p = positions + first;
+
+            for ( int32_t i = 0; i < m; ++i )
+            {
+                V3f tangent = p[std::min( i + 1, m - 1 )] -
+                    p[std::max( i - 1, 0 )];
+                V3f side = tangent.cross( viewPoint - p[i] );
+                float32_t len = side.length();
+                float32_t w = widths ? widths[first + i] : defaultWidth;
+                if ( len > 0.0f )
+                {
+                    side *= 0.5f * w / len;
+                }
+
+                outPositions[( first + i ) * 2] = p[i] - side;
+                outPositions[( first + i ) * 2 + 1] = p[i] + side;
+            }
+
+            int32_t *face = outIndices + faceOffsets[c] * 4;
+            for ( int32_t i = 0; i + 1 < m; ++i )
+            {
+                int32_t v = ( int32_t ) ( first + i ) * 2;
+                face[0] = v;
+                face[1] = v + 2;
+                face[2] = v + 3;
+                face[3] = v + 1;
+                face += 4;
+            }
+        }
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+size_t GetNumCurveSpans( CurveType iType, BasisType iBasis,
+                         CurvePeriodicity iWrap, int32_t iNumVertices )
+{
+    if ( iNumVertices <= 1 )
+    {
+        return ( iNumVertices == 1 && iWrap == kPeriodic ) ? 1 : 0;
+    }
+
+    if ( !IsCubic( iType, iBasis, iNumVertices ) )
+    {
+        return iWrap == kPeriodic ? iNumVertices : iNumVertices - 1;
+    }
+
+    int32_t step = GetStepFromBasisType( iBasis );
+    if ( iWrap == kPeriodic )
+    {
+        return std::max( iNumVertices / step, 1 );
+    }
+    return ( iNumVertices - 4 ) / step + 1;
+}
+
+//-*****************************************************************************
+void TessellateCurves( CurveType iType, BasisType iBasis,
+                       CurvePeriodicity iWrap,
+                       const Int32ArraySample &iNumVertices,
+                       const P3fArraySample &iPositions,
+                       const FloatArraySamplePtr &iWidths,
+                       float32_t iTolerance, int32_t iMaxSteps,
+                       CurvePolylines &oPolylines )
+{
+    oPolylines.clear();
+
+    ABCA_ASSERT( iMaxSteps > 0, "Curves need at least one step per span, not "
+                 << iMaxSteps );
+
+    size_t numCurves = iNumVertices.size();
+    std::vector<int32_t> inOffsets( numCurves + 1, 0 );
+    std::vector<int32_t> varyingOffsets( numCurves + 1, 0 );
+    for ( size_t c = 0; c < numCurves; ++c )
+    {
+        int32_t n = iNumVertices[c];
+        ABCA_ASSERT( n >= 0, "Curve " << c << " has " << n << " vertices" );
+
+        size_t spans = GetNumCurveSpans( iType, iBasis, iWrap, n );
+        int32_t numVarying = n;
+        if ( IsCubic( iType, iBasis, n ) )
+        {
+            numVarying = ( int32_t ) spans + ( iWrap == kPeriodic ? 0 : 1 );
+        }
+
+        inOffsets[c + 1] = inOffsets[c] + n;
+        varyingOffsets[c + 1] = varyingOffsets[c] + numVarying;
+    }
+
+    ABCA_ASSERT( ( size_t ) inOffsets.back() <= iPositions.size(),
+                 "Curves use " << inOffsets.back()
+                 << " positions but the sample only has "
+                 << iPositions.size() );
+
+    if ( numCurves == 0 )
+    {
+        return;
+    }
+
+    size_t numWidths = iWidths ? iWidths->size() : 0;
+    WidthsScope widthsScope = kNoWidths;
+    if ( numWidths == 1 )
+    {
+        widthsScope = kConstantWidths;
+    }
+    else if ( numWidths > 0 )
+    {
+        if ( numWidths == iPositions.size() )
+        {
+            widthsScope = kVertexWidths;
+        }
+        else if ( numWidths == numCurves )
+        {
+            widthsScope = kUniformWidths;
+        }
+        else if ( numWidths == ( size_t ) varyingOffsets.back() )
+        {
+            widthsScope = kVaryingWidths;
+        }
+        else
+        {
+            ABCA_THROW( "Can't match " << numWidths << " widths to "
+                        << numCurves << " curves with "
+                        << iPositions.size() << " positions" );
+        }
+    }
+
+    oPolylines.numVertices.resize( numCurves );
+
+    TessellateTask task;
+    task.type = iType;
+    task.basis = iBasis;
+    task.periodic = ( iWrap == kPeriodic );
+    task.step = GetStepFromBasisType( iBasis );
+    task.tolerance = iTolerance;
+    task.maxSteps = iMaxSteps;
+    task.numVertices = iNumVertices.get();
+    task.inOffsets = &inOffsets.front();
+    task.varyingOffsets = &varyingOffsets.front();
+    task.positions = iPositions.get();
+    task.widths = numWidths > 0 ? iWidths->get() : NULL;
+    task.widthsScope = widthsScope;
+    task.outCounts = &oPolylines.numVertices.front();
+    task.outOffsets = NULL;
+    task.outPositions = NULL;
+    task.outWidths = NULL;
+    RunSlices( numCurves, MIN_CURVES_PER_THREAD, task );
+
+    std::vector<size_t> outOffsets( numCurves + 1, 0 );
+    for ( size_t c = 0; c < numCurves; ++c )
+    {
+        outOffsets[c + 1] = outOffsets[c] + oPolylines.numVertices[c];
+    }
+
+    if ( outOffsets.back() == 0 )
+    {
+        return;
+    }
+
+    oPolylines.positions.resize( outOffsets.back() );
+    if ( widthsScope != kNoWidths )
+    {
+        oPolylines.widths.resize( outOffsets.back() );
+        task.outWidths = &oPolylines.widths.front();
+    }
+
+    task.outOffsets = &outOffsets.front();
+    task.outPositions = &oPolylines.positions.front();
+    RunSlices( numCurves, MIN_CURVES_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+void BuildCurveRibbons( const CurvePolylines &iPolylines,
+                        const V3f &iViewPoint,
+                        float32_t iDefaultWidth,
+                        std::vector<V3f> &oPositions,
+                        std::vector<int32_t> &oFaceCounts,
+                        std::vector<int32_t> &oFaceIndices )
+{
+    size_t numCurves = iPolylines.numVertices.size();
+    std::vector<size_t> vertexOffsets( numCurves + 1, 0 );
+    std::vector<size_t> faceOffsets( numCurves + 1, 0 );
+    for ( size_t c = 0; c < numCurves; ++c )
+    {
+        int32_t m = iPolylines.numVertices[c];
+        vertexOffsets[c + 1] = vertexOffsets[c] + m;
+        faceOffsets[c + 1] = faceOffsets[c] + ( m > 1 ? m - 1 : 0 );
+    }
+
+    ABCA_ASSERT( vertexOffsets.back() == iPolylines.positions.size(),
+                 "Polylines have " << vertexOffsets.back()
+                 << " vertices but " << iPolylines.positions.size()
+                 << " positions" );
+
+    ABCA_ASSERT( iPolylines.widths.empty() ||
+                 iPolylines.widths.size() == iPolylines.positions.size(),
+                 "Polylines have " << iPolylines.widths.size()
+                 << " widths for " << iPolylines.positions.size()
+                 << " positions" );
+
+    oPositions.resize( iPolylines.positions.size() * 2 );
+    oFaceCounts.assign( faceOffsets.back(), 4 );
+    oFaceIndices.resize( faceOffsets.back() * 4 );
+
+    if ( iPolylines.positions.empty() )
+    {
+        return;
+    }
+
+    RibbonTask task;
+    task.positions = &iPolylines.positions.front();
+    task.widths = iPolylines.widths.empty() ? NULL :
+        &iPolylines.widths.front();
+    task.defaultWidth = iDefaultWidth;
+    task.viewPoint = iViewPoint;
+    task.numVertices = &iPolylines.numVertices.front();
+    task.vertexOffsets = &vertexOffsets.front();
+    task.faceOffsets = &faceOffsets.front();
+    task.outPositions = &oPositions.front();
+    task.outIndices = oFaceIndices.empty() ? NULL : &oFaceIndices.front();
+    RunSlices( numCurves, MIN_CURVES_PER_THREAD, task );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
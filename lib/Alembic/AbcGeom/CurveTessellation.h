@@ -0,0 +1,127 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_CurveTessellation_h_
+#define _Alembic_AbcGeom_CurveTessellation_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/ICurves.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Curves turned into polylines, one after another. Periodic curves end
+//! with a copy of their first point, so every polyline can be drawn as is.
+//! widths has one value per position, and is empty if no widths were given.
+struct CurvePolylines
+{
+    std::vector<V3f> positions;
+    std::vector<float32_t> widths;
+    std::vector<int32_t> numVertices;
+
+    void clear()
+    {
+        positions.clear();
+        widths.clear();
+        numVertices.clear();
+    }
+};
+
+//-*****************************************************************************
+//! The number of spans in one curve of iNumVertices vertices. A cubic span
+//! takes four vertices, and each one after the first starts
+//! GetStepFromBasisType( iBasis ) vertices after the last. Periodic curves
+//! wrap around to their first vertices. Cubic curves with fewer than four
+//! vertices, or without a basis, are treated as linear: one span per pair
+//! of vertices.
+size_t GetNumCurveSpans( CurveType iType, BasisType iBasis,
+                         CurvePeriodicity iWrap, int32_t iNumVertices );
+
+//-*****************************************************************************
+//! Evaluates every curve into a polyline. Bezier, b-spline, catmull-rom,
+//! hermite and power bases follow their RenderMan definitions.
+//!
+//! With iTolerance above zero, each span is split into as few steps as
+//! keep the polyline within iTolerance of the curve, up to iMaxSteps.
+//! Otherwise each span gets iMaxSteps.
+//!
+//! iWidths may be NULL. Otherwise it holds one width for everything, one
+//! per vertex, one per curve, or one per span end (varying), told apart
+//! by its size in that order.
+//!
+//! Large batches are split across threads a curve at a time.
+void TessellateCurves( CurveType iType, BasisType iBasis,
+                       CurvePeriodicity iWrap,
+                       const Int32ArraySample &iNumVertices,
+                       const P3fArraySample &iPositions,
+                       const FloatArraySamplePtr &iWidths,
+                       float32_t iTolerance, int32_t iMaxSteps,
+                       CurvePolylines &oPolylines );
+
+//-*****************************************************************************
+//! The same for a curves sample, with widths from its widths param.
+inline void TessellateCurves( const ICurvesSchema::Sample &iSample,
+                              const FloatArraySamplePtr &iWidths,
+                              float32_t iTolerance, int32_t iMaxSteps,
+                              CurvePolylines &oPolylines )
+{
+    TessellateCurves( iSample.getType(), iSample.getBasis(),
+                      iSample.getWrap(), *iSample.getCurvesNumVertices(),
+                      *iSample.getPositions(), iWidths, iTolerance,
+                      iMaxSteps, oPolylines );
+}
+
+//-*****************************************************************************
+//! Widens polylines into ribbons that face iViewPoint, as a polymesh with
+//! two positions per polyline vertex and a quad per polyline segment.
+//! iDefaultWidth is used when the polylines have no widths.
+void BuildCurveRibbons( const CurvePolylines &iPolylines,
+                        const V3f &iViewPoint,
+                        float32_t iDefaultWidth,
+                        std::vector<V3f> &oPositions,
+                        std::vector<int32_t> &oFaceCounts,
+                        std::vector<int32_t> &oFaceIndices );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,167 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Points are walked four at a time, so the twelve floats of a block line
+// up with twelve independent min and max lanes. Each lane only ever sees
+// one axis, so the loop has no cross-lane dependency and the compiler
+// turns it into packed min/max instructions. The lanes are folded back
+// down to x, y and z at the end.
+static const size_t BLOCK_POINTS = 4;
+static const size_t BLOCK_FLOATS = BLOCK_POINTS * 3;
+
+// Below this many points per thread, starting threads costs more than
+// the scan.
+static const size_t MIN_POINTS_PER_THREAD = 1 << 18;
+
+//-*****************************************************************************
+// Comparisons are written so that a NaN coordinate never replaces the
+// current min or max, the same as Imath::Box::extendBy.
+void ScanBounds( const float32_t *iData, size_t iNumPoints,
+                 float32_t oMin[3], float32_t oMax[3] )
+{
+    float32_t lo[BLOCK_FLOATS];
+    float32_t hi[BLOCK_FLOATS];
+    std::fill( lo, lo + BLOCK_FLOATS, std::numeric_limits<float32_t>::max() );
+    std::fill( hi, hi + BLOCK_FLOATS, -std::numeric_limits<float32_t>::max() );
+
+    size_t numBlocks = iNumPoints / BLOCK_POINTS;
+    const float32_t *p = iData;
+    for ( size_t b = 0; b < numBlocks; ++b, p += BLOCK_FLOATS )
+    {
+        for ( size_t j = 0; j < BLOCK_FLOATS; ++j )
+        {
+            lo[j] = p[j] < lo[j] ? p[j] : lo[j];
+            hi[j] = p[j] > hi[j] ? p[j] : hi[j];
+        }
+    }
+
+    // the leftover points that don't fill a block
+    size_t numLeft = ( iNumPoints - numBlocks * BLOCK_POINTS ) * 3;
+    for ( size_t j = 0; j < numLeft; ++j )
+    {
+        lo[j] = p[j] < lo[j] ? p[j] : lo[j];
+        hi[j] = p[j] > hi[j] ? p[j] : hi[j];
+    }
+
+    for ( size_t k = 0; k < 3; ++k )
+    {
+        oMin[k] = lo[k];
+        oMax[k] = hi[k];
+        for ( size_t j = k + 3; j < BLOCK_FLOATS; j += 3 )
+        {
+            oMin[k] = lo[j] < oMin[k] ? lo[j] : oMin[k];
+            oMax[k] = hi[j] > oMax[k] ? hi[j] : oMax[k];
+        }
+    }
+}
+
+//-*****************************************************************************
+// Each slice keeps its own box, at the slice's index in min and max.
+struct ScanBoundsTask
+{
+    const float32_t *data;
+    size_t slice;
+    float32_t *min;
+    float32_t *max;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        size_t t = iBegin / slice;
+        ScanBounds( data + iBegin * 3, iEnd - iBegin,
+                    min + t * 3, max + t * 3 );
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+Abc::Box3d ComputeBoundsFromPositions( const P3fArraySample &iSamp )
+{
+    Abc::Box3d ret;
+
+    size_t numPoints = iSamp.size();
+    if ( numPoints == 0 )
+    {
+        return ret;
+    }
+
+    const float32_t *data =
+        reinterpret_cast<const float32_t *>( iSamp.get() );
+
+    size_t numSlices = NumSlices( numPoints, MIN_POINTS_PER_THREAD );
+
+    std::vector<float32_t> mins( 3 * numSlices );
+    std::vector<float32_t> maxs( mins.size() );
+
+    ScanBoundsTask task;
+    task.data = data;
+    task.slice = numPoints / numSlices;
+    task.min = &mins[0];
+    task.max = &maxs[0];
+    RunSlices( numPoints, MIN_POINTS_PER_THREAD, task );
+
+    for ( size_t t = 0; t < mins.size(); t += 3 )
+    {
+        // a slice made up of only NaNs leaves its box inverted
+        if ( mins[t] > maxs[t] || mins[t+1] > maxs[t+1] ||
+             mins[t+2] > maxs[t+2] )
+        {
+            continue;
+        }
+
+        ret.extendBy( V3d( mins[t], mins[t+1], mins[t+2] ) );
+        ret.extendBy( V3d( maxs[t], maxs[t+1], maxs[t+2] ) );
+    }
+
+    return ret;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
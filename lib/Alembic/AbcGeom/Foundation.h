@@ -146,6 +146,12 @@ static Abc::Box3d ComputeBoundsFromPositions( const ARRAYSAMP &iSamp )
     return ret;
 }
 
+//-*****************************************************************************
+//! This overload is what all the geometry schemas use for positions. It
+//! scans the floats in vectorizable blocks instead of extending a Box3d
+//! point by point, and splits very large samples across threads.
+Abc::Box3d ComputeBoundsFromPositions( const P3fArraySample &iSamp );
+
 //-*****************************************************************************
 //! used in xform rotation conversion
 inline double DegreesToRadians( double iDegrees )
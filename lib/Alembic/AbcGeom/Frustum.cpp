@@ -0,0 +1,169 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/Frustum.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// The corners each plane goes through, as indices into the frustum's eight
+// corners, numbered with 1 for right, 2 for top and 4 for far.
+static const int PLANE_CORNERS[6][3] = {
+    { 0, 2, 4 },    // left
+    { 1, 3, 5 },    // right
+    { 0, 1, 4 },    // bottom
+    { 2, 3, 6 },    // top
+    { 0, 1, 2 },    // near
+    { 4, 5, 6 } };  // far
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+Frustum::Frustum()
+{
+    for ( size_t i = 0; i < 6; ++i )
+    {
+        m_normals[i] = V3d( 0.0, 0.0, 0.0 );
+        m_distances[i] = 0.0;
+    }
+}
+
+//-*****************************************************************************
+Frustum::Frustum( const CameraSample &iCamera, const M44d &iCameraToWorld )
+{
+    // getScreenWindow isn't const
+    CameraSample camera = iCamera;
+    double top, bottom, left, right;
+    camera.getScreenWindow( top, bottom, left, right );
+
+    double scale = tan( DegreesToRadians( camera.getFieldOfView() ) * 0.5 );
+    double depths[2] = { camera.getNearClippingPlane(),
+                         camera.getFarClippingPlane() };
+
+    V3d corners[8];
+    V3d center( 0.0, 0.0, 0.0 );
+    for ( int i = 0; i < 8; ++i )
+    {
+        double depth = depths[( i >> 2 ) & 1];
+        V3d p( ( i & 1 ? right : left ) * scale * depth,
+               ( i & 2 ? top : bottom ) * scale * depth,
+               -depth );
+        iCameraToWorld.multVecMatrix( p, corners[i] );
+        center += corners[i] * 0.125;
+    }
+
+    // the planes face whichever way the middle of the frustum is, so a
+    // mirroring camera matrix doesn't turn them inside out
+    for ( size_t i = 0; i < 6; ++i )
+    {
+        const V3d &a = corners[PLANE_CORNERS[i][0]];
+        const V3d &b = corners[PLANE_CORNERS[i][1]];
+        const V3d &c = corners[PLANE_CORNERS[i][2]];
+
+        V3d n = ( b - a ).cross( c - a );
+        double length = n.length();
+        if ( length > 0.0 )
+        {
+            n /= length;
+        }
+
+        double d = -n.dot( a );
+        if ( n.dot( center ) + d < 0.0 )
+        {
+            n = -n;
+            d = -d;
+        }
+
+        m_normals[i] = n;
+        m_distances[i] = d;
+    }
+}
+
+//-*****************************************************************************
+bool Frustum::intersects( const Box3d &iBounds ) const
+{
+    if ( iBounds.isEmpty() )
+    {
+        return false;
+    }
+
+    for ( size_t i = 0; i < 6; ++i )
+    {
+        // the corner furthest along the normal
+        const V3d &n = m_normals[i];
+        V3d p( n.x >= 0.0 ? iBounds.max.x : iBounds.min.x,
+               n.y >= 0.0 ? iBounds.max.y : iBounds.min.y,
+               n.z >= 0.0 ? iBounds.max.z : iBounds.min.z );
+
+        if ( n.dot( p ) + m_distances[i] < 0.0 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-*****************************************************************************
+bool Frustum::contains( const Box3d &iBounds ) const
+{
+    if ( iBounds.isEmpty() )
+    {
+        return false;
+    }
+
+    for ( size_t i = 0; i < 6; ++i )
+    {
+        // the corner furthest against the normal
+        const V3d &n = m_normals[i];
+        V3d p( n.x >= 0.0 ? iBounds.min.x : iBounds.max.x,
+               n.y >= 0.0 ? iBounds.min.y : iBounds.max.y,
+               n.z >= 0.0 ? iBounds.min.z : iBounds.max.z );
+
+        if ( n.dot( p ) + m_distances[i] < 0.0 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
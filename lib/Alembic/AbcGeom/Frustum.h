@@ -0,0 +1,85 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_Frustum_h_
+#define _Alembic_AbcGeom_Frustum_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/CameraSample.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! The volume a camera sees, as six planes facing in, for culling bounds
+//! against. The default frustum contains everything.
+class Frustum
+{
+public:
+    Frustum();
+
+    //! The frustum of iCamera's screen window between its clipping planes,
+    //! with iCameraToWorld its world matrix. The camera looks down -z, and
+    //! a screen window from -1 to 1 spans the horizontal field of view.
+    Frustum( const CameraSample &iCamera, const M44d &iCameraToWorld );
+
+    //! False only if iBounds is wholly outside one of the planes, so some
+    //! bounds just off a corner of the frustum are kept. Empty bounds never
+    //! intersect.
+    bool intersects( const Box3d &iBounds ) const;
+
+    //! Whether iBounds is wholly inside every plane.
+    bool contains( const Box3d &iBounds ) const;
+
+    //! Plane i is the points p with dot( normal, p ) + distance >= 0 on
+    //! the inside, in the order left, right, bottom, top, near, far.
+    const V3d &getNormal( size_t i ) const { return m_normals[i]; }
+    double getDistance( size_t i ) const { return m_distances[i]; }
+
+private:
+    V3d m_normals[6];
+    double m_distances[6];
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,414 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/Instancing.h>
+#include <Alembic/AbcGeom/IFaceSet.h>
+#include <Alembic/AbcGeom/IGeomBase.h>
+#include <Alembic/AbcGeom/IXform.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many objects, a slice isn't worth a thread.
+static const size_t MIN_OBJECTS_PER_THREAD = 1 << 12;
+
+//-*****************************************************************************
+void AppendBytes( const void *iData, size_t iNumBytes, std::string &oSig )
+{
+    oSig.append( static_cast<const char *>( iData ), iNumBytes );
+}
+
+//-*****************************************************************************
+// Variable length pieces carry their length, so that no two different
+// sequences of them can run together into the same signature.
+void AppendSized( const void *iData, size_t iNumBytes, std::string &oSig )
+{
+    uint64_t numBytes = iNumBytes;
+    AppendBytes( &numBytes, sizeof( numBytes ), oSig );
+    AppendBytes( iData, iNumBytes, oSig );
+}
+
+//-*****************************************************************************
+void AppendString( const std::string &iStr, std::string &oSig )
+{
+    AppendSized( iStr.data(), iStr.size(), oSig );
+}
+
+//-*****************************************************************************
+void AppendWstring( const std::wstring &iStr, std::string &oSig )
+{
+    AppendSized( iStr.data(), iStr.size() * sizeof( wchar_t ), oSig );
+}
+
+//-*****************************************************************************
+void AppendArray( IArrayProperty iProp, const Abc::ISampleSelector &iSS,
+                  std::string &oSig )
+{
+    if ( iProp.getNumSamples() == 0 )
+    {
+        return;
+    }
+
+    AbcA::ArraySampleKey key;
+    if ( iProp.getKey( key, iSS ) )
+    {
+        AppendBytes( &key.numBytes, sizeof( key.numBytes ), oSig );
+        AppendBytes( &key.origPOD, sizeof( key.origPOD ), oSig );
+        AppendBytes( &key.readPOD, sizeof( key.readPOD ), oSig );
+        AppendBytes( key.digest.d, sizeof( key.digest.d ), oSig );
+        return;
+    }
+
+    // no key, so the sample has to stand for itself
+    AbcA::ArraySamplePtr samp;
+    iProp.get( samp, iSS );
+
+    const AbcA::DataType &dataType = samp->getDataType();
+    size_t numValues = samp->size() * dataType.getExtent();
+    if ( dataType.getPod() == kStringPOD )
+    {
+        const std::string *strs =
+            static_cast<const std::string *>( samp->getData() );
+        for ( size_t i = 0; i < numValues; ++i )
+        {
+            AppendString( strs[i], oSig );
+        }
+    }
+    else if ( dataType.getPod() == kWstringPOD )
+    {
+        const std::wstring *strs =
+            static_cast<const std::wstring *>( samp->getData() );
+        for ( size_t i = 0; i < numValues; ++i )
+        {
+            AppendWstring( strs[i], oSig );
+        }
+    }
+    else
+    {
+        AppendSized( samp->getData(), samp->size() * dataType.getNumBytes(),
+                     oSig );
+    }
+}
+
+//-*****************************************************************************
+void AppendScalar( IScalarProperty iProp, const Abc::ISampleSelector &iSS,
+                   std::string &oSig )
+{
+    if ( iProp.getNumSamples() == 0 )
+    {
+        return;
+    }
+
+    const AbcA::DataType &dataType = iProp.getDataType();
+    if ( dataType.getPod() == kStringPOD )
+    {
+        std::vector<std::string> strs( dataType.getExtent() );
+        iProp.get( &strs.front(), iSS );
+        for ( size_t i = 0; i < strs.size(); ++i )
+        {
+            AppendString( strs[i], oSig );
+        }
+    }
+    else if ( dataType.getPod() == kWstringPOD )
+    {
+        std::vector<std::wstring> strs( dataType.getExtent() );
+        iProp.get( &strs.front(), iSS );
+        for ( size_t i = 0; i < strs.size(); ++i )
+        {
+            AppendWstring( strs[i], oSig );
+        }
+    }
+    else
+    {
+        std::vector<char> value( dataType.getNumBytes() );
+        iProp.get( &value.front(), iSS );
+        AppendBytes( &value.front(), value.size(), oSig );
+    }
+}
+
+//-*****************************************************************************
+void AppendCompound( ICompoundProperty iProp, const Abc::ISampleSelector &iSS,
+                     std::string &oSig )
+{
+    for ( size_t i = 0; i < iProp.getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader &header = iProp.getPropertyHeader( i );
+        const std::string &name = header.getName();
+
+        // neither changes what gets drawn
+        if ( name == ".selfBnds" || name == ".childBnds" ||
+             name == ".userProperties" )
+        {
+            continue;
+        }
+
+        AppendString( name, oSig );
+
+        if ( header.isCompound() )
+        {
+            AppendCompound( ICompoundProperty( iProp, name ), iSS, oSig );
+        }
+        else if ( header.isArray() )
+        {
+            AppendArray( IArrayProperty( iProp, name ), iSS, oSig );
+        }
+        else
+        {
+            AppendScalar( IScalarProperty( iProp, name ), iSS, oSig );
+        }
+
+        // closes the compound, so what follows can't be mistaken for
+        // one of its children
+        oSig.push_back( '\0' );
+    }
+}
+
+//-*****************************************************************************
+// Orders objects by signature, and by where they are in the hierarchy
+// among those with the same one.
+struct SignatureLess
+{
+    const std::string *signatures;
+
+    bool operator()( size_t iLhs, size_t iRhs ) const
+    {
+        int c = signatures[iLhs].compare( signatures[iRhs] );
+        return c < 0 || ( c == 0 && iLhs < iRhs );
+    }
+};
+
+//-*****************************************************************************
+struct SortTask
+{
+    size_t *indices;
+    SignatureLess less;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        std::sort( indices + iBegin, indices + iEnd, less );
+    }
+};
+
+//-*****************************************************************************
+// Sorts slices of ioIndices on their own threads, with the calling thread
+// taking the last one itself, then merges them.
+void SortIndices( std::vector<size_t> &ioIndices, const SignatureLess &iLess )
+{
+    size_t numItems = ioIndices.size();
+    size_t numThreads = NumSlices( numItems, MIN_OBJECTS_PER_THREAD );
+
+    SortTask task;
+    task.indices = numItems ? &ioIndices.front() : NULL;
+    task.less = iLess;
+    RunSlices( numItems, MIN_OBJECTS_PER_THREAD, task );
+
+    if ( numThreads < 2 )
+    {
+        return;
+    }
+
+    // the same slices RunSlices sorted
+    std::vector<size_t> bounds( numThreads + 1 );
+    for ( size_t t = 0; t < numThreads; ++t )
+    {
+        bounds[t] = t * ( numItems / numThreads );
+    }
+    bounds[numThreads] = numItems;
+
+    // pairs of neighbouring slices, until there is one
+    for ( size_t step = 1; step < numThreads; step *= 2 )
+    {
+        for ( size_t t = 0; t + step < numThreads; t += 2 * step )
+        {
+            size_t end = bounds[std::min( t + 2 * step, numThreads )];
+            std::inplace_merge( ioIndices.begin() + bounds[t],
+                                ioIndices.begin() + bounds[t + step],
+                                ioIndices.begin() + end, iLess );
+        }
+    }
+}
+
+//-*****************************************************************************
+struct FirstInstanceLess
+{
+    bool operator()( const std::pair<size_t, size_t> &iLhs,
+                     const std::pair<size_t, size_t> &iRhs ) const
+    {
+        return iLhs.first < iRhs.first;
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+std::string GetGeometrySignature( IObject iObject,
+                                  const Abc::ISampleSelector &iSS )
+{
+    std::string sig;
+
+    // only the schema's own properties; arbitrary ones beside it aren't
+    // part of the geometry
+    ICompoundProperty props = iObject.getProperties();
+    for ( size_t i = 0; i < props.getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader &header = props.getPropertyHeader( i );
+        if ( header.isCompound() &&
+             !header.getMetaData().get( "schema" ).empty() )
+        {
+            AppendString( header.getName(), sig );
+            AppendCompound( ICompoundProperty( props, header.getName() ),
+                            iSS, sig );
+        }
+    }
+
+    for ( size_t i = 0; i < iObject.getNumChildren(); ++i )
+    {
+        const AbcA::ObjectHeader &header = iObject.getChildHeader( i );
+        if ( IFaceSet::matches( header ) )
+        {
+            AppendString( header.getName(), sig );
+            AppendString( GetGeometrySignature(
+                iObject.getChild( header.getName() ), iSS ), sig );
+        }
+    }
+
+    return sig;
+}
+
+//-*****************************************************************************
+InstanceTable::InstanceTable( IArchive &iArchive,
+                              const Abc::ISampleSelector &iSS )
+{
+    build( iArchive.getTop(), iSS );
+}
+
+//-*****************************************************************************
+InstanceTable::InstanceTable( IObject iRoot,
+                              const Abc::ISampleSelector &iSS )
+{
+    build( iRoot, iSS );
+}
+
+//-*****************************************************************************
+void InstanceTable::build( IObject iRoot, const Abc::ISampleSelector &iSS )
+{
+    std::vector<std::string> signatures;
+    std::vector<Instance> objects;
+
+    // archive reads aren't thread safe, so the walk is serial
+    M44d identity;
+    identity.makeIdentity();
+
+    std::vector<std::pair<IObject, M44d> > stack;
+    stack.push_back( std::make_pair( iRoot, identity ) );
+    while ( !stack.empty() )
+    {
+        IObject obj = stack.back().first;
+        M44d world = stack.back().second;
+        stack.pop_back();
+
+        const AbcA::ObjectHeader &header = obj.getHeader();
+        if ( IXform::matches( header ) )
+        {
+            IXform xform( obj, kWrapExisting );
+            XformSample samp;
+            xform.getSchema().get( samp, iSS );
+            world = samp.getInheritsXforms() ?
+                samp.getMatrix() * world : samp.getMatrix();
+        }
+        else if ( IGeomBase::matches( header.getMetaData() ) &&
+                  !IFaceSet::matches( header ) )
+        {
+            Instance inst;
+            inst.fullName = obj.getFullName();
+            inst.world = world;
+            objects.push_back( inst );
+            signatures.push_back( GetGeometrySignature( obj, iSS ) );
+        }
+
+        // backwards, so that they come off the stack in order
+        for ( size_t i = obj.getNumChildren(); i > 0; --i )
+        {
+            stack.push_back( std::make_pair( obj.getChild( i - 1 ), world ) );
+        }
+    }
+
+    m_numObjects = objects.size();
+    m_prototypes.clear();
+
+    std::vector<size_t> indices( m_numObjects );
+    for ( size_t i = 0; i < m_numObjects; ++i )
+    {
+        indices[i] = i;
+    }
+
+    SignatureLess less;
+    less.signatures = signatures.empty() ? NULL : &signatures.front();
+    SortIndices( indices, less );
+
+    // each run of one signature starts with its first instance
+    std::vector<std::pair<size_t, size_t> > runs;
+    for ( size_t i = 0; i < m_numObjects; ++i )
+    {
+        if ( i == 0 || signatures[indices[i]] != signatures[indices[i - 1]] )
+        {
+            runs.push_back( std::make_pair( indices[i], i ) );
+        }
+    }
+    std::sort( runs.begin(), runs.end(), FirstInstanceLess() );
+
+    m_prototypes.resize( runs.size() );
+    for ( size_t r = 0; r < runs.size(); ++r )
+    {
+        std::vector<Instance> &instances = m_prototypes[r].instances;
+        for ( size_t i = runs[r].second; i < m_numObjects &&
+              signatures[indices[i]] == signatures[runs[r].first]; ++i )
+        {
+            instances.push_back( objects[indices[i]] );
+        }
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
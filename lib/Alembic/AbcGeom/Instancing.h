@@ -0,0 +1,120 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_Instancing_h_
+#define _Alembic_AbcGeom_Instancing_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Everything that makes iObject's geometry what it is at iSS, as a string
+//! that is the same for two objects exactly when their geometry is. It is
+//! built from the sample keys of every array property under the schema,
+//! positions, indices, counts and geom params such as uvs and normals
+//! alike, the values of its scalar properties, and the same for any face
+//! sets under it. Bounds and user properties are left out. Where a key
+//! isn't available the sample itself is used instead.
+std::string GetGeometrySignature( IObject iObject,
+                                  const Abc::ISampleSelector &iSS =
+                                  Abc::ISampleSelector() );
+
+//-*****************************************************************************
+//! Groups the geometric objects under a root whose geometry is identical,
+//! by GetGeometrySignature, so that each group can be loaded once and
+//! drawn at every instance's world matrix.
+//!
+//! The hierarchy is read serially, since reads from one archive aren't
+//! thread safe; the grouping is split across threads.
+class InstanceTable : private boost::noncopyable
+{
+public:
+    struct Instance
+    {
+        std::string fullName;
+        M44d world;
+    };
+
+    //! Instances of the same geometry, in hierarchy order. The first is
+    //! the one to load.
+    struct Prototype
+    {
+        std::vector<Instance> instances;
+    };
+
+    //! Everything under the archive's top object.
+    InstanceTable( IArchive &iArchive,
+                   const Abc::ISampleSelector &iSS = Abc::ISampleSelector() );
+
+    //! Everything under iRoot, including iRoot itself, with world matrices
+    //! relative to iRoot's parent.
+    InstanceTable( IObject iRoot,
+                   const Abc::ISampleSelector &iSS = Abc::ISampleSelector() );
+
+    //! The geometric objects found, not counting face sets.
+    size_t getNumObjects() const { return m_numObjects; }
+
+    //! In order of their first instances.
+    size_t getNumPrototypes() const { return m_prototypes.size(); }
+
+    const Prototype &getPrototype( size_t i ) const
+    { return m_prototypes[i]; }
+
+    //! How many objects needn't be loaded, since they are another's
+    //! instance.
+    size_t getNumSaved() const
+    { return m_numObjects - m_prototypes.size(); }
+
+private:
+    void build( IObject iRoot, const Abc::ISampleSelector &iSS );
+
+    size_t m_numObjects;
+    std::vector<Prototype> m_prototypes;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,437 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/Interpolation.h>
+
+#include <ImathQuat.h>
+
+#include <math.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// No reductions and no branches, so this vectorizes as written.
+template <class T>
+void Lerp( const T *iA, const T *iB, size_t iNumVals, T iAlpha, T *oVals )
+{
+    for ( size_t i = 0; i < iNumVals; ++i )
+    {
+        oVals[i] = iA[i] + ( iB[i] - iA[i] ) * iAlpha;
+    }
+}
+
+//-*****************************************************************************
+void Normalize( float32_t *ioVals, size_t iNumVectors )
+{
+    for ( size_t i = 0; i < iNumVectors; ++i, ioVals += 3 )
+    {
+        float32_t len2 = ioVals[0] * ioVals[0] + ioVals[1] * ioVals[1] +
+            ioVals[2] * ioVals[2];
+        if ( len2 > 0.0f )
+        {
+            float32_t scale = 1.0f / sqrtf( len2 );
+            ioVals[0] *= scale;
+            ioVals[1] *= scale;
+            ioVals[2] *= scale;
+        }
+    }
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr Interpolate( Abc::IArrayProperty iProp,
+                                  chrono_t iTime,
+                                  InterpolationCachePtr iCache,
+                                  bool iNormalize )
+{
+    index_t floorIndex = 0;
+    index_t ceilIndex = 0;
+    chrono_t alpha = GetSampleBlend( iProp.getTimeSampling(),
+                                     iProp.getNumSamples(), iTime,
+                                     floorIndex, ceilIndex );
+
+    AbcA::ArraySamplePtr floorSamp;
+    iProp.get( floorSamp, Abc::ISampleSelector( floorIndex ) );
+
+    const AbcA::DataType &dataType = iProp.getHeader().getDataType();
+    if ( alpha == 0.0 || ( dataType.getPod() != kFloat32POD &&
+                           dataType.getPod() != kFloat64POD ) )
+    {
+        return floorSamp;
+    }
+
+    AbcA::ArraySampleKey floorKey;
+    AbcA::ArraySampleKey ceilKey;
+    bool keyed = iProp.getKey( floorKey, Abc::ISampleSelector( floorIndex ) ) &&
+        iProp.getKey( ceilKey, Abc::ISampleSelector( ceilIndex ) );
+
+    // a held sample blends to itself
+    if ( keyed && floorKey == ceilKey )
+    {
+        return floorSamp;
+    }
+
+    if ( keyed && iCache )
+    {
+        AbcA::ArraySamplePtr found =
+            iCache->find( floorKey, ceilKey, alpha, iNormalize );
+        if ( found )
+        {
+            return found;
+        }
+    }
+
+    AbcA::ArraySamplePtr ceilSamp;
+    iProp.get( ceilSamp, Abc::ISampleSelector( ceilIndex ) );
+
+    const Dimensions &dims = floorSamp->getDimensions();
+    if ( dims != ceilSamp->getDimensions() )
+    {
+        return floorSamp;
+    }
+
+    AbcA::ArraySamplePtr ret = AbcA::AllocateArraySample( dataType, dims );
+    size_t numVals = dims.numPoints() * dataType.getExtent();
+    void *data = const_cast<void *>( ret->getData() );
+    if ( dataType.getPod() == kFloat32POD )
+    {
+        Lerp( static_cast<const float32_t *>( floorSamp->getData() ),
+              static_cast<const float32_t *>( ceilSamp->getData() ),
+              numVals, static_cast<float32_t>( alpha ),
+              static_cast<float32_t *>( data ) );
+
+        if ( iNormalize && dataType.getExtent() == 3 )
+        {
+            Normalize( static_cast<float32_t *>( data ), dims.numPoints() );
+        }
+    }
+    else
+    {
+        Lerp( static_cast<const float64_t *>( floorSamp->getData() ),
+              static_cast<const float64_t *>( ceilSamp->getData() ),
+              numVals, alpha, static_cast<float64_t *>( data ) );
+    }
+
+    if ( keyed && iCache )
+    {
+        ret = iCache->store( floorKey, ceilKey, alpha, iNormalize, ret );
+    }
+
+    return ret;
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+bool SameKeys( Abc::IArrayProperty iProp, index_t iA, index_t iB )
+{
+    if ( iA == iB )
+    {
+        return true;
+    }
+
+    AbcA::ArraySampleKey keyA;
+    AbcA::ArraySampleKey keyB;
+    return iProp.getKey( keyA, Abc::ISampleSelector( iA ) ) &&
+        iProp.getKey( keyB, Abc::ISampleSelector( iB ) ) && keyA == keyB;
+}
+
+//-*****************************************************************************
+chrono_t GetSampleBlend( AbcA::TimeSamplingPtr iTimeSampling,
+                         size_t iNumSamples,
+                         chrono_t iTime,
+                         index_t &oFloor,
+                         index_t &oCeil )
+{
+    oFloor = 0;
+    oCeil = 0;
+    if ( !iTimeSampling || iNumSamples == 0 )
+    {
+        return 0.0;
+    }
+
+    std::pair<index_t, chrono_t> floorIndex =
+        iTimeSampling->getFloorIndex( iTime, iNumSamples );
+    std::pair<index_t, chrono_t> ceilIndex =
+        iTimeSampling->getCeilIndex( iTime, iNumSamples );
+
+    oFloor = floorIndex.first;
+    oCeil = floorIndex.first;
+    if ( ceilIndex.first == floorIndex.first ||
+         ceilIndex.second <= floorIndex.second )
+    {
+        return 0.0;
+    }
+
+    chrono_t alpha = ( iTime - floorIndex.second ) /
+        ( ceilIndex.second - floorIndex.second );
+    if ( alpha <= 0.0 )
+    {
+        return 0.0;
+    }
+    if ( alpha >= 1.0 )
+    {
+        oFloor = ceilIndex.first;
+        oCeil = ceilIndex.first;
+        return 0.0;
+    }
+
+    oCeil = ceilIndex.first;
+    return alpha;
+}
+
+//-*****************************************************************************
+void LerpArray( const float32_t *iA, const float32_t *iB, size_t iNumVals,
+                float32_t iAlpha, float32_t *oVals )
+{
+    Lerp( iA, iB, iNumVals, iAlpha, oVals );
+}
+
+//-*****************************************************************************
+void LerpArray( const float64_t *iA, const float64_t *iB, size_t iNumVals,
+                float64_t iAlpha, float64_t *oVals )
+{
+    Lerp( iA, iB, iNumVals, iAlpha, oVals );
+}
+
+//-*****************************************************************************
+Abc::M44d InterpolateMatrix( const Abc::M44d &iA, const Abc::M44d &iB,
+                             chrono_t iAlpha )
+{
+    Abc::M44d a( iA );
+    Abc::M44d b( iB );
+    Abc::V3d scaleA, shearA, scaleB, shearB;
+    if ( !Imath::extractAndRemoveScalingAndShear( a, scaleA, shearA, false ) ||
+         !Imath::extractAndRemoveScalingAndShear( b, scaleB, shearB, false ) )
+    {
+        Abc::M44d ret;
+        Lerp( &iA.x[0][0], &iB.x[0][0], 16, iAlpha, &ret.x[0][0] );
+        return ret;
+    }
+
+    Imath::Quatd rotA = Imath::extractQuat( a );
+    Imath::Quatd rotB = Imath::extractQuat( b );
+
+    // slerp the short way around
+    if ( ( rotA ^ rotB ) < 0.0 )
+    {
+        rotB = -rotB;
+    }
+
+    Abc::V3d scale, shear, translate;
+    Lerp( &scaleA.x, &scaleB.x, 3, iAlpha, &scale.x );
+    Lerp( &shearA.x, &shearB.x, 3, iAlpha, &shear.x );
+    Lerp( &a.x[3][0], &b.x[3][0], 3, iAlpha, &translate.x );
+
+    Abc::M44d scaleMtx, shearMtx, translateMtx;
+    scaleMtx.setScale( scale );
+    shearMtx.setShear( shear );
+    translateMtx.setTranslation( translate );
+
+    return scaleMtx * shearMtx *
+        Imath::slerp( rotA, rotB, iAlpha ).toMatrix44() * translateMtx;
+}
+
+//-*****************************************************************************
+bool InterpolationCache::Key::operator<( const Key &iRhs ) const
+{
+    if ( floorKey != iRhs.floorKey ) { return floorKey < iRhs.floorKey; }
+    if ( ceilKey != iRhs.ceilKey ) { return ceilKey < iRhs.ceilKey; }
+    if ( alpha != iRhs.alpha ) { return alpha < iRhs.alpha; }
+    return normalized < iRhs.normalized;
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+InterpolationCache::find( const AbcA::ArraySampleKey &iFloorKey,
+                          const AbcA::ArraySampleKey &iCeilKey,
+                          chrono_t iAlpha,
+                          bool iNormalized )
+{
+    Key key;
+    key.floorKey = iFloorKey;
+    key.ceilKey = iCeilKey;
+    key.alpha = iAlpha;
+    key.normalized = iNormalized;
+
+    boost::mutex::scoped_lock l( m_mutex );
+    SampleMap::iterator found = m_samples.find( key );
+    if ( found == m_samples.end() )
+    {
+        return AbcA::ArraySamplePtr();
+    }
+
+    AbcA::ArraySamplePtr ret = found->second.lock();
+    if ( !ret )
+    {
+        m_samples.erase( found );
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr
+InterpolationCache::store( const AbcA::ArraySampleKey &iFloorKey,
+                           const AbcA::ArraySampleKey &iCeilKey,
+                           chrono_t iAlpha,
+                           bool iNormalized,
+                           AbcA::ArraySamplePtr iSample )
+{
+    Key key;
+    key.floorKey = iFloorKey;
+    key.ceilKey = iCeilKey;
+    key.alpha = iAlpha;
+    key.normalized = iNormalized;
+
+    boost::mutex::scoped_lock l( m_mutex );
+
+    // drop whatever nobody holds anymore, but only once the map has
+    // doubled since the last sweep, so that sweeping stays linear in the
+    // number of stores
+    if ( m_samples.size() >= 2 * m_sweepSize + 16 )
+    {
+        for ( SampleMap::iterator it = m_samples.begin();
+              it != m_samples.end(); )
+        {
+            if ( it->second.expired() ) { m_samples.erase( it++ ); }
+            else { ++it; }
+        }
+        m_sweepSize = m_samples.size();
+    }
+
+    ArraySampleWeakPtr &stored = m_samples[key];
+    AbcA::ArraySamplePtr existing = stored.lock();
+    if ( existing )
+    {
+        return existing;
+    }
+
+    stored = iSample;
+    return iSample;
+}
+
+//-*****************************************************************************
+size_t InterpolationCache::size()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+
+    size_t ret = 0;
+    for ( SampleMap::iterator it = m_samples.begin(); it != m_samples.end();
+          ++it )
+    {
+        if ( !it->second.expired() ) { ++ret; }
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+N3fArraySamplePtr InterpolateNormals( IN3fGeomParam &iParam,
+                                      chrono_t iTime,
+                                      InterpolationCachePtr iCache )
+{
+    Abc::IN3fArrayProperty vals = iParam.getValueProperty();
+    if ( iParam.isIndexed() )
+    {
+        index_t floorIndex = 0;
+        index_t ceilIndex = 0;
+        GetSampleBlend( iParam.getTimeSampling(), iParam.getNumSamples(),
+                        iTime, floorIndex, ceilIndex );
+
+        if ( !SameKeys( iParam.getIndexProperty(), floorIndex, ceilIndex ) )
+        {
+            return vals.getValue( Abc::ISampleSelector( floorIndex ) );
+        }
+    }
+
+    return boost::static_pointer_cast<N3fArraySample, AbcA::ArraySample>(
+        Interpolate( vals, iTime, iCache, true ) );
+}
+
+//-*****************************************************************************
+P3fArraySamplePtr InterpolatePositions( IPointsSchema &iSchema,
+                                        chrono_t iTime,
+                                        InterpolationCachePtr iCache )
+{
+    Abc::IP3fArrayProperty positions = iSchema.getPositionsProperty();
+
+    index_t floorIndex = 0;
+    index_t ceilIndex = 0;
+    GetSampleBlend( positions.getTimeSampling(), positions.getNumSamples(),
+                    iTime, floorIndex, ceilIndex );
+
+    if ( !SameKeys( iSchema.getIdsProperty(), floorIndex, ceilIndex ) )
+    {
+        return positions.getValue( Abc::ISampleSelector( floorIndex ) );
+    }
+
+    return InterpolateArray( positions, iTime, iCache );
+}
+
+//-*****************************************************************************
+Abc::M44d InterpolateXform( IXformSchema &iSchema, chrono_t iTime )
+{
+    index_t floorIndex = 0;
+    index_t ceilIndex = 0;
+    chrono_t alpha = GetSampleBlend( iSchema.getTimeSampling(),
+                                     iSchema.getNumSamples(), iTime,
+                                     floorIndex, ceilIndex );
+
+    Abc::M44d floorMtx =
+        iSchema.getValue( Abc::ISampleSelector( floorIndex ) ).getMatrix();
+    if ( alpha == 0.0 )
+    {
+        return floorMtx;
+    }
+
+    return InterpolateMatrix( floorMtx,
+        iSchema.getValue( Abc::ISampleSelector( ceilIndex ) ).getMatrix(),
+        alpha );
+}
+
+//-*****************************************************************************
+AbcA::ArraySamplePtr InterpolateArraySample( Abc::IArrayProperty iProp,
+                                             chrono_t iTime,
+                                             InterpolationCachePtr iCache )
+{
+    return Interpolate( iProp, iTime, iCache, false );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
@@ -0,0 +1,257 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_Interpolation_h_
+#define _Alembic_AbcGeom_Interpolation_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/IGeomParam.h>
+#include <Alembic/AbcGeom/IPoints.h>
+#include <Alembic/AbcGeom/IXform.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Sub-frame evaluation. Everything here finds the samples either side of
+//! a time and blends them: linearly for arrays, and by decomposing the
+//! matrices and slerping their rotations for transforms. Times on a sample,
+//! or outside the sampled range, give that sample back unblended.
+//-*****************************************************************************
+
+//-*****************************************************************************
+//! Whether iProp has the same sample at iA and iB, judged by their keys.
+//! False if either has no key.
+bool SameKeys( Abc::IArrayProperty iProp, index_t iA, index_t iB );
+
+//-*****************************************************************************
+//! Finds the samples either side of iTime, and returns how far iTime is
+//! from the first to the second, from 0 to 1. When there is nothing to
+//! blend, oCeil is set to oFloor and 0 is returned.
+chrono_t GetSampleBlend( AbcA::TimeSamplingPtr iTimeSampling,
+                         size_t iNumSamples,
+                         chrono_t iTime,
+                         index_t &oFloor,
+                         index_t &oCeil );
+
+//-*****************************************************************************
+//! oVals[i] = iA[i] + ( iB[i] - iA[i] ) * iAlpha, in a loop the compiler
+//! vectorizes. oVals may be either of the inputs.
+void LerpArray( const float32_t *iA, const float32_t *iB, size_t iNumVals,
+                float32_t iAlpha, float32_t *oVals );
+
+void LerpArray( const float64_t *iA, const float64_t *iB, size_t iNumVals,
+                float64_t iAlpha, float64_t *oVals );
+
+//-*****************************************************************************
+//! Blends two transforms by decomposing them into scale, shear, rotation
+//! and translation, lerping all but the rotation, which is slerped the
+//! short way around. Transforms that can't be decomposed are lerped
+//! element by element instead.
+Abc::M44d InterpolateMatrix( const Abc::M44d &iA, const Abc::M44d &iB,
+                             chrono_t iAlpha );
+
+//-*****************************************************************************
+//! Blended array samples, shared between everyone asking for the same
+//! blend. Entries are looked up by the keys of the two samples blended and
+//! how far between them, so the same blend asked of different properties,
+//! or of different archives, is only done once. The cache doesn't own the
+//! samples it hands out; they live as long as someone holds them.
+//! This class is multithread safe.
+class InterpolationCache : private boost::noncopyable
+{
+public:
+    InterpolationCache() : m_sweepSize( 0 ) {}
+
+    //! Returns the sample that was stored for this blend, or an invalid
+    //! pointer if there isn't one. iNormalized is whether 3 vectors were
+    //! scaled back to unit length after blending.
+    AbcA::ArraySamplePtr find( const AbcA::ArraySampleKey &iFloorKey,
+                               const AbcA::ArraySampleKey &iCeilKey,
+                               chrono_t iAlpha,
+                               bool iNormalized );
+
+    //! Stores iSample for this blend, returning what is stored, which is
+    //! someone else's sample if they stored it first.
+    AbcA::ArraySamplePtr store( const AbcA::ArraySampleKey &iFloorKey,
+                                const AbcA::ArraySampleKey &iCeilKey,
+                                chrono_t iAlpha,
+                                bool iNormalized,
+                                AbcA::ArraySamplePtr iSample );
+
+    //! How many blended samples are still held by someone.
+    size_t size();
+
+private:
+    struct Key
+    {
+        AbcA::ArraySampleKey floorKey;
+        AbcA::ArraySampleKey ceilKey;
+        chrono_t alpha;
+        bool normalized;
+
+        bool operator<( const Key &iRhs ) const;
+    };
+
+    typedef boost::weak_ptr<AbcA::ArraySample> ArraySampleWeakPtr;
+    typedef std::map<Key, ArraySampleWeakPtr> SampleMap;
+
+    boost::mutex m_mutex;
+    SampleMap m_samples;
+
+    // How many entries were left after the last sweep of expired ones.
+    size_t m_sweepSize;
+};
+
+typedef boost::shared_ptr<InterpolationCache> InterpolationCachePtr;
+
+//-*****************************************************************************
+//! Returns iProp blended at iTime. Only float32 and float64 arrays blend;
+//! anything else, or two samples with different dimensions, gives back
+//! the floor sample. iCache may be an invalid pointer.
+AbcA::ArraySamplePtr
+InterpolateArraySample( Abc::IArrayProperty iProp,
+                        chrono_t iTime,
+                        InterpolationCachePtr iCache = InterpolationCachePtr() );
+
+//-*****************************************************************************
+//! Typed version of the above.
+template <class TRAITS>
+boost::shared_ptr< Abc::TypedArraySample<TRAITS> >
+InterpolateArray( Abc::ITypedArrayProperty<TRAITS> iProp,
+                  chrono_t iTime,
+                  InterpolationCachePtr iCache = InterpolationCachePtr() )
+{
+    return boost::static_pointer_cast< Abc::TypedArraySample<TRAITS>,
+        AbcA::ArraySample >( InterpolateArraySample( iProp, iTime, iCache ) );
+}
+
+//-*****************************************************************************
+//! The values of iParam blended at iTime. An indexed param only blends
+//! when its indices are the same on both sides, so the floor sample's
+//! indices go with the returned values.
+template <class TRAITS>
+boost::shared_ptr< Abc::TypedArraySample<TRAITS> >
+InterpolateGeomParam( ITypedGeomParam<TRAITS> &iParam,
+                      chrono_t iTime,
+                      InterpolationCachePtr iCache = InterpolationCachePtr() );
+
+//-*****************************************************************************
+//! Normals blended at iTime, scaled back to unit length.
+N3fArraySamplePtr
+InterpolateNormals( IN3fGeomParam &iParam,
+                    chrono_t iTime,
+                    InterpolationCachePtr iCache = InterpolationCachePtr() );
+
+//-*****************************************************************************
+//! Positions of a mesh, subd, curves or patch blended at iTime.
+//! Heterogeneous topology never blends, since the points on either side
+//! needn't correspond even when there are as many of them.
+template <class SCHEMA>
+P3fArraySamplePtr
+InterpolatePositions( SCHEMA &iSchema,
+                      chrono_t iTime,
+                      InterpolationCachePtr iCache = InterpolationCachePtr() )
+{
+    Abc::IP3fArrayProperty positions = iSchema.getPositionsProperty();
+    if ( iSchema.getTopologyVariance() == kHeterogenousTopology )
+    {
+        index_t floorIndex = 0;
+        index_t ceilIndex = 0;
+        GetSampleBlend( positions.getTimeSampling(),
+                        positions.getNumSamples(), iTime,
+                        floorIndex, ceilIndex );
+        return positions.getValue( Abc::ISampleSelector( floorIndex ) );
+    }
+
+    return InterpolateArray( positions, iTime, iCache );
+}
+
+//-*****************************************************************************
+//! Points have no topology; they only blend when their ids are the same
+//! on both sides.
+P3fArraySamplePtr
+InterpolatePositions( IPointsSchema &iSchema,
+                      chrono_t iTime,
+                      InterpolationCachePtr iCache = InterpolationCachePtr() );
+
+//-*****************************************************************************
+//! The local transform of iSchema at iTime.
+Abc::M44d InterpolateXform( IXformSchema &iSchema, chrono_t iTime );
+
+//-*****************************************************************************
+// TEMPLATED METHODS
+//-*****************************************************************************
+
+//-*****************************************************************************
+template <class TRAITS>
+boost::shared_ptr< Abc::TypedArraySample<TRAITS> >
+InterpolateGeomParam( ITypedGeomParam<TRAITS> &iParam,
+                      chrono_t iTime,
+                      InterpolationCachePtr iCache )
+{
+    typename ITypedGeomParam<TRAITS>::prop_type vals =
+        iParam.getValueProperty();
+    if ( iParam.isIndexed() )
+    {
+        index_t floorIndex = 0;
+        index_t ceilIndex = 0;
+        GetSampleBlend( iParam.getTimeSampling(), iParam.getNumSamples(),
+                        iTime, floorIndex, ceilIndex );
+
+        if ( !SameKeys( iParam.getIndexProperty(), floorIndex, ceilIndex ) )
+        {
+            return vals.getValue( Abc::ISampleSelector( floorIndex ) );
+        }
+    }
+
+    return InterpolateArray( vals, iTime, iCache );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
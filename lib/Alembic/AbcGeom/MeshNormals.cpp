@@ -0,0 +1,302 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/MeshNormals.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many faces or vertices per thread, starting threads costs
+// more than the work.
+static const size_t MIN_ITEMS_PER_THREAD = 1 << 15;
+
+//-*****************************************************************************
+inline V3f SafeNormalized( const V3f &iVec )
+{
+    float32_t len = iVec.length();
+    return len > 0.0f ? iVec / len : V3f( 0.0f, 0.0f, 0.0f );
+}
+
+//-*****************************************************************************
+// Twice the area of each face along its normal, summed over the fan of
+// triangles around its first vertex. The cross products are taken
+// (C-A)x(B-A) because the faces wind clockwise.
+struct FaceAreaTask
+{
+    const int32_t *offsets;
+    const int32_t *indices;
+    const V3f *positions;
+    V3f *areas;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t f = iBegin; f < iEnd; ++f )
+        {
+            const int32_t *face = indices + offsets[f];
+            int32_t count = offsets[f + 1] - offsets[f];
+
+            V3f sum( 0.0f, 0.0f, 0.0f );
+            if ( count > 2 )
+            {
+                const V3f &p0 = positions[face[0]];
+                V3f a = positions[face[1]] - p0;
+                for ( int32_t k = 2; k < count; ++k )
+                {
+                    V3f b = positions[face[k]] - p0;
+                    sum += b.cross( a );
+                    a = b;
+                }
+            }
+            areas[f] = sum;
+        }
+    }
+};
+
+//-*****************************************************************************
+struct NormalizeTask
+{
+    const V3f *vecs;
+    N3f *normals;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t i = iBegin; i < iEnd; ++i )
+        {
+            normals[i] = SafeNormalized( vecs[i] );
+        }
+    }
+};
+
+//-*****************************************************************************
+// Each vertex gathers the areas of its own faces from the topology's
+// adjacency, rather than each face scattering into its vertices, so no
+// two threads ever write the same normal.
+struct VertexNormalTask
+{
+    const int32_t *vertexFaceOffsets;
+    const int32_t *vertexFaces;
+    const V3f *areas;
+    N3f *normals;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t v = iBegin; v < iEnd; ++v )
+        {
+            V3f sum( 0.0f, 0.0f, 0.0f );
+            for ( int32_t i = vertexFaceOffsets[v];
+                  i < vertexFaceOffsets[v + 1]; ++i )
+            {
+                sum += areas[vertexFaces[i]];
+            }
+            normals[v] = SafeNormalized( sum );
+        }
+    }
+};
+
+//-*****************************************************************************
+// Like VertexNormalTask, per corner, only taking the faces close enough
+// to the corner's own face. The face itself always counts, so a corner
+// with every neighbour past the crease gets the face normal.
+struct FaceVaryingNormalTask
+{
+    const int32_t *offsets;
+    const int32_t *indices;
+    const int32_t *vertexFaceOffsets;
+    const int32_t *vertexFaces;
+    const V3f *areas;
+    const N3f *faceNormals;
+    float32_t minCos;
+    N3f *normals;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t f = iBegin; f < iEnd; ++f )
+        {
+            const N3f &faceN = faceNormals[f];
+            for ( int32_t i = offsets[f]; i < offsets[f + 1]; ++i )
+            {
+                int32_t v = indices[i];
+                V3f sum = areas[f];
+                for ( int32_t j = vertexFaceOffsets[v];
+                      j < vertexFaceOffsets[v + 1]; ++j )
+                {
+                    int32_t g = vertexFaces[j];
+                    if ( g != ( int32_t ) f &&
+                         faceN.dot( faceNormals[g] ) >= minCos )
+                    {
+                        sum += areas[g];
+                    }
+                }
+                normals[i] = SafeNormalized( sum );
+            }
+        }
+    }
+};
+
+//-*****************************************************************************
+void CheckInputs( const MeshTopology &iTopology,
+                  const Int32ArraySample &iFaceIndices,
+                  const P3fArraySample &iPositions )
+{
+    ABCA_ASSERT( ( size_t ) iTopology.getFaceOffsets().back() ==
+                 iFaceIndices.size(),
+                 "Topology has " << iTopology.getFaceOffsets().back()
+                 << " face indices but the sample has "
+                 << iFaceIndices.size() );
+
+    ABCA_ASSERT( iTopology.getNumVertices() <= iPositions.size(),
+                 "Faces use " << iTopology.getNumVertices()
+                 << " positions but the sample only has "
+                 << iPositions.size() );
+}
+
+//-*****************************************************************************
+void ComputeFaceAreas( const MeshTopology &iTopology,
+                       const Int32ArraySample &iFaceIndices,
+                       const P3fArraySample &iPositions,
+                       std::vector<V3f> &oAreas )
+{
+    CheckInputs( iTopology, iFaceIndices, iPositions );
+
+    size_t numFaces = iTopology.getNumFaces();
+    oAreas.resize( numFaces );
+    if ( numFaces == 0 )
+    {
+        return;
+    }
+
+    FaceAreaTask task;
+    task.offsets = &iTopology.getFaceOffsets().front();
+    task.indices = iFaceIndices.get();
+    task.positions = iPositions.get();
+    task.areas = &oAreas.front();
+    RunSlices( numFaces, MIN_ITEMS_PER_THREAD, task );
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+void ComputeFaceNormals( const MeshTopology &iTopology,
+                         const Int32ArraySample &iFaceIndices,
+                         const P3fArraySample &iPositions,
+                         std::vector<N3f> &oNormals )
+{
+    std::vector<V3f> areas;
+    ComputeFaceAreas( iTopology, iFaceIndices, iPositions, areas );
+
+    oNormals.resize( areas.size() );
+    if ( areas.empty() )
+    {
+        return;
+    }
+
+    NormalizeTask task;
+    task.vecs = &areas.front();
+    task.normals = &oNormals.front();
+    RunSlices( areas.size(), MIN_ITEMS_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+void ComputeVertexNormals( const MeshTopology &iTopology,
+                           const Int32ArraySample &iFaceIndices,
+                           const P3fArraySample &iPositions,
+                           std::vector<N3f> &oNormals )
+{
+    std::vector<V3f> areas;
+    ComputeFaceAreas( iTopology, iFaceIndices, iPositions, areas );
+
+    oNormals.assign( iPositions.size(), N3f( 0.0f, 0.0f, 0.0f ) );
+
+    size_t numVertices = iTopology.getNumVertices();
+    if ( numVertices == 0 )
+    {
+        return;
+    }
+
+    VertexNormalTask task;
+    task.vertexFaceOffsets = &iTopology.getVertexFaceOffsets().front();
+    task.vertexFaces = iTopology.getVertexFaces().empty() ? NULL :
+        &iTopology.getVertexFaces().front();
+    task.areas = &areas.front();
+    task.normals = &oNormals.front();
+    RunSlices( numVertices, MIN_ITEMS_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+void ComputeFaceVaryingNormals( const MeshTopology &iTopology,
+                                const Int32ArraySample &iFaceIndices,
+                                const P3fArraySample &iPositions,
+                                float64_t iCreaseAngle,
+                                std::vector<N3f> &oNormals )
+{
+    std::vector<V3f> areas;
+    ComputeFaceAreas( iTopology, iFaceIndices, iPositions, areas );
+
+    oNormals.resize( iFaceIndices.size() );
+    if ( areas.empty() || oNormals.empty() )
+    {
+        return;
+    }
+
+    std::vector<N3f> faceNormals( areas.size() );
+    NormalizeTask normalize;
+    normalize.vecs = &areas.front();
+    normalize.normals = &faceNormals.front();
+    RunSlices( areas.size(), MIN_ITEMS_PER_THREAD, normalize );
+
+    FaceVaryingNormalTask task;
+    task.offsets = &iTopology.getFaceOffsets().front();
+    task.indices = iFaceIndices.get();
+    task.vertexFaceOffsets = &iTopology.getVertexFaceOffsets().front();
+    task.vertexFaces = &iTopology.getVertexFaces().front();
+    task.areas = &areas.front();
+    task.faceNormals = &faceNormals.front();
+    task.minCos = ( float32_t ) std::cos( DegreesToRadians( iCreaseAngle ) );
+    task.normals = &oNormals.front();
+    RunSlices( areas.size(), MIN_ITEMS_PER_THREAD, task );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
@@ -0,0 +1,119 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_MeshNormals_h_
+#define _Alembic_AbcGeom_MeshNormals_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/IPolyMesh.h>
+#include <Alembic/AbcGeom/MeshTopology.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Normals for meshes that were written without them. Polygons in Alembic
+//! wind clockwise when seen from the front, and the normals point out of
+//! the front. iTopology has to have been built from the same face counts
+//! and face indices; getting it from a MeshTopologyCache means only the
+//! per frame math is redone while a mesh deforms.
+//!
+//! Every function here is split across threads for large meshes, and each
+//! thread only ever writes its own normals, so there is no locking.
+//-*****************************************************************************
+
+//-*****************************************************************************
+//! One unit normal per face.
+void ComputeFaceNormals( const MeshTopology &iTopology,
+                         const Int32ArraySample &iFaceIndices,
+                         const P3fArraySample &iPositions,
+                         std::vector<N3f> &oNormals );
+
+//-*****************************************************************************
+//! One unit normal per position: the normals of the faces around it,
+//! weighted by their areas. Positions that no face uses get a zero normal.
+void ComputeVertexNormals( const MeshTopology &iTopology,
+                           const Int32ArraySample &iFaceIndices,
+                           const P3fArraySample &iPositions,
+                           std::vector<N3f> &oNormals );
+
+//-*****************************************************************************
+//! One unit normal per face index, in the same order. Like the vertex
+//! normals, but only faces within iCreaseAngle degrees of the face a
+//! corner belongs to are blended, so edges sharper than it stay sharp.
+void ComputeFaceVaryingNormals( const MeshTopology &iTopology,
+                                const Int32ArraySample &iFaceIndices,
+                                const P3fArraySample &iPositions,
+                                float64_t iCreaseAngle,
+                                std::vector<N3f> &oNormals );
+
+//-*****************************************************************************
+//! The same for a polymesh sample.
+inline void ComputeFaceNormals( const MeshTopology &iTopology,
+                                const IPolyMeshSchema::Sample &iSample,
+                                std::vector<N3f> &oNormals )
+{
+    ComputeFaceNormals( iTopology, *iSample.getFaceIndices(),
+                        *iSample.getPositions(), oNormals );
+}
+
+inline void ComputeVertexNormals( const MeshTopology &iTopology,
+                                  const IPolyMeshSchema::Sample &iSample,
+                                  std::vector<N3f> &oNormals )
+{
+    ComputeVertexNormals( iTopology, *iSample.getFaceIndices(),
+                          *iSample.getPositions(), oNormals );
+}
+
+inline void ComputeFaceVaryingNormals( const MeshTopology &iTopology,
+                                       const IPolyMeshSchema::Sample &iSample,
+                                       float64_t iCreaseAngle,
+                                       std::vector<N3f> &oNormals )
+{
+    ComputeFaceVaryingNormals( iTopology, *iSample.getFaceIndices(),
+                               *iSample.getPositions(), iCreaseAngle,
+                               oNormals );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,384 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/MeshTopology.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Meshes with fewer face indices than this are built on one thread.
+static const size_t MIN_INDICES_FOR_THREADS = 1 << 16;
+
+//-*****************************************************************************
+// Each of these fills in one part of a MeshTopology from inputs that have
+// already been checked.
+struct TopologyInputs
+{
+    const int32_t *counts;
+    const int32_t *indices;
+    const int32_t *offsets;
+    size_t numFaces;
+    size_t numVertices;
+};
+
+//-*****************************************************************************
+struct TriangulateTask
+{
+    TopologyInputs in;
+    std::vector<int32_t> *triangles;
+    std::vector<int32_t> *triangleFaces;
+
+    void operator()() const
+    {
+        int32_t *tri = triangles->empty() ? NULL : &triangles->front();
+        int32_t *triFace =
+            triangleFaces->empty() ? NULL : &triangleFaces->front();
+
+        for ( size_t f = 0; f < in.numFaces; ++f )
+        {
+            const int32_t *face = in.indices + in.offsets[f];
+            for ( int32_t k = 1; k + 1 < in.counts[f]; ++k )
+            {
+                tri[0] = face[0];
+                tri[1] = face[k];
+                tri[2] = face[k + 1];
+                tri += 3;
+                *( triFace++ ) = ( int32_t ) f;
+            }
+        }
+    }
+};
+
+//-*****************************************************************************
+// Counts the faces of each vertex, then fills them in, in face order.
+// lastFace keeps a face that uses a vertex twice from listing it twice.
+struct AdjacencyTask
+{
+    TopologyInputs in;
+    std::vector<int32_t> *offsets;
+    std::vector<int32_t> *faces;
+
+    void operator()() const
+    {
+        std::vector<int32_t> lastFace( in.numVertices, -1 );
+        offsets->assign( in.numVertices + 1, 0 );
+        for ( size_t f = 0; f < in.numFaces; ++f )
+        {
+            for ( int32_t i = in.offsets[f]; i < in.offsets[f + 1]; ++i )
+            {
+                int32_t v = in.indices[i];
+                if ( lastFace[v] != ( int32_t ) f )
+                {
+                    lastFace[v] = ( int32_t ) f;
+                    ++( *offsets )[v + 1];
+                }
+            }
+        }
+
+        for ( size_t v = 0; v < in.numVertices; ++v )
+        {
+            ( *offsets )[v + 1] += ( *offsets )[v];
+        }
+
+        faces->resize( offsets->back() );
+        std::vector<int32_t> next( offsets->begin(), offsets->end() - 1 );
+        std::fill( lastFace.begin(), lastFace.end(), -1 );
+        for ( size_t f = 0; f < in.numFaces; ++f )
+        {
+            for ( int32_t i = in.offsets[f]; i < in.offsets[f + 1]; ++i )
+            {
+                int32_t v = in.indices[i];
+                if ( lastFace[v] != ( int32_t ) f )
+                {
+                    lastFace[v] = ( int32_t ) f;
+                    ( *faces )[next[v]++] = ( int32_t ) f;
+                }
+            }
+        }
+    }
+};
+
+//-*****************************************************************************
+// Packs each edge into 64 bits with the lower vertex on top, so sorting
+// and removing repeats leaves them in order.
+struct EdgesTask
+{
+    TopologyInputs in;
+    std::vector<int32_t> *edges;
+
+    void operator()() const
+    {
+        std::vector<uint64_t> packed;
+        packed.reserve( in.offsets[in.numFaces] );
+        for ( size_t f = 0; f < in.numFaces; ++f )
+        {
+            int32_t count = in.counts[f];
+            const int32_t *face = in.indices + in.offsets[f];
+            for ( int32_t k = 0; count > 1 && k < count; ++k )
+            {
+                uint64_t a = ( uint64_t ) face[k];
+                uint64_t b = ( uint64_t ) face[( k + 1 ) % count];
+                if ( a != b )
+                {
+                    packed.push_back( a < b ? ( a << 32 ) | b :
+                                      ( b << 32 ) | a );
+                }
+            }
+        }
+
+        std::sort( packed.begin(), packed.end() );
+        packed.erase( std::unique( packed.begin(), packed.end() ),
+                      packed.end() );
+
+        edges->resize( packed.size() * 2 );
+        for ( size_t e = 0; e < packed.size(); ++e )
+        {
+            ( *edges )[e * 2] = ( int32_t ) ( packed[e] >> 32 );
+            ( *edges )[e * 2 + 1] = ( int32_t ) ( packed[e] & 0xffffffff );
+        }
+    }
+};
+
+//-*****************************************************************************
+// The three parts as items for RunSlices. Sorting the edges is the
+// slowest, so it goes last, where the calling thread takes it.
+struct TopologyTasks
+{
+    TriangulateTask triangulate;
+    AdjacencyTask adjacency;
+    EdgesTask edges;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t i = iBegin; i < iEnd; ++i )
+        {
+            switch ( i )
+            {
+            case 0: triangulate(); break;
+            case 1: adjacency(); break;
+            default: edges(); break;
+            }
+        }
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+MeshTopology::MeshTopology( const Int32ArraySample &iFaceCounts,
+                            const Int32ArraySample &iFaceIndices )
+{
+    size_t numFaces = iFaceCounts.size();
+    size_t numIndices = iFaceIndices.size();
+    const int32_t *counts = iFaceCounts.get();
+    const int32_t *indices = iFaceIndices.get();
+
+    m_faceOffsets.resize( numFaces + 1 );
+    m_faceOffsets[0] = 0;
+    size_t total = 0;
+    size_t numTriangles = 0;
+    for ( size_t f = 0; f < numFaces; ++f )
+    {
+        ABCA_ASSERT( counts[f] >= 0, "Face " << f << " has a negative count" );
+        total += counts[f];
+        ABCA_ASSERT( total <= numIndices, "Face counts add up to more than "
+                     << "the " << numIndices << " face indices" );
+        m_faceOffsets[f + 1] = ( int32_t ) total;
+        numTriangles += counts[f] > 2 ? counts[f] - 2 : 0;
+    }
+    ABCA_ASSERT( total == numIndices, "Face counts add up to " << total
+                 << " but there are " << numIndices << " face indices" );
+
+    int32_t maxIndex = -1;
+    for ( size_t i = 0; i < numIndices; ++i )
+    {
+        ABCA_ASSERT( indices[i] >= 0, "Face index " << i << " is negative" );
+        maxIndex = indices[i] > maxIndex ? indices[i] : maxIndex;
+    }
+
+    TopologyInputs in;
+    in.counts = counts;
+    in.indices = indices;
+    in.offsets = &m_faceOffsets.front();
+    in.numFaces = numFaces;
+    in.numVertices = ( size_t ) ( maxIndex + 1 );
+
+    m_triangles.resize( numTriangles * 3 );
+    m_triangleFaces.resize( numTriangles );
+
+    TopologyTasks tasks;
+    tasks.triangulate.in = in;
+    tasks.triangulate.triangles = &m_triangles;
+    tasks.triangulate.triangleFaces = &m_triangleFaces;
+
+    tasks.adjacency.in = in;
+    tasks.adjacency.offsets = &m_vertexFaceOffsets;
+    tasks.adjacency.faces = &m_vertexFaces;
+
+    tasks.edges.in = in;
+    tasks.edges.edges = &m_edges;
+
+    if ( numIndices < MIN_INDICES_FOR_THREADS )
+    {
+        tasks( 0, 3 );
+        return;
+    }
+
+    RunSlices( 3, 1, tasks );
+}
+
+//-*****************************************************************************
+size_t MeshTopology::getMemoryUsage() const
+{
+    return sizeof( MeshTopology ) + sizeof( int32_t ) *
+        ( m_faceOffsets.capacity() + m_triangles.capacity() +
+          m_triangleFaces.capacity() + m_vertexFaceOffsets.capacity() +
+          m_vertexFaces.capacity() + m_edges.capacity() );
+}
+
+//-*****************************************************************************
+MeshTopologyCache::MeshTopologyCache( size_t iMaxBytes )
+  : m_maxBytes( iMaxBytes )
+  , m_bytes( 0 )
+{
+}
+
+//-*****************************************************************************
+MeshTopologyPtr
+MeshTopologyCache::get( Abc::IInt32ArrayProperty iFaceCounts,
+                        Abc::IInt32ArrayProperty iFaceIndices,
+                        const Abc::ISampleSelector &iSS )
+{
+    Key key;
+    bool keyed = iFaceCounts.getKey( key.first, iSS ) &&
+        iFaceIndices.getKey( key.second, iSS );
+
+    if ( keyed )
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        EntryMap::iterator found = m_map.find( key );
+        if ( found != m_map.end() )
+        {
+            m_entries.splice( m_entries.begin(), m_entries, found->second );
+            return found->second->second;
+        }
+    }
+
+    // built without the lock, so other meshes aren't held up
+    Int32ArraySamplePtr counts = iFaceCounts.getValue( iSS );
+    Int32ArraySamplePtr indices = iFaceIndices.getValue( iSS );
+    MeshTopologyPtr ret( new MeshTopology( *counts, *indices ) );
+
+    if ( !keyed )
+    {
+        return ret;
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    EntryMap::iterator found = m_map.find( key );
+    if ( found != m_map.end() )
+    {
+        m_entries.splice( m_entries.begin(), m_entries, found->second );
+        return found->second->second;
+    }
+
+    m_entries.push_front( Entry( key, ret ) );
+    m_map[key] = m_entries.begin();
+    m_bytes += ret->getMemoryUsage();
+    evict();
+
+    return ret;
+}
+
+//-*****************************************************************************
+void MeshTopologyCache::evict()
+{
+    while ( m_bytes > m_maxBytes && !m_entries.empty() )
+    {
+        m_bytes -= m_entries.back().second->getMemoryUsage();
+        m_map.erase( m_entries.back().first );
+        m_entries.pop_back();
+    }
+}
+
+//-*****************************************************************************
+size_t MeshTopologyCache::getMaxBytes()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_maxBytes;
+}
+
+//-*****************************************************************************
+void MeshTopologyCache::setMaxBytes( size_t iMaxBytes )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    m_maxBytes = iMaxBytes;
+    evict();
+}
+
+//-*****************************************************************************
+size_t MeshTopologyCache::getMemoryUsage()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_bytes;
+}
+
+//-*****************************************************************************
+size_t MeshTopologyCache::size()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_entries.size();
+}
+
+//-*****************************************************************************
+void MeshTopologyCache::clear()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    m_entries.clear();
+    m_map.clear();
+    m_bytes = 0;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
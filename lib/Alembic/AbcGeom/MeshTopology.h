@@ -0,0 +1,177 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_MeshTopology_h_
+#define _Alembic_AbcGeom_MeshTopology_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! What viewers and renderers derive from a polygon mesh's face counts
+//! and face indices: face offsets, triangles, vertex to face adjacency and
+//! edges. It is all built once, on construction, and never changes after.
+class MeshTopology : private boost::noncopyable
+{
+public:
+    //! Builds everything, with the triangles, adjacency and edges each on
+    //! their own thread. Throws if the counts and indices don't agree.
+    MeshTopology( const Int32ArraySample &iFaceCounts,
+                  const Int32ArraySample &iFaceIndices );
+
+    size_t getNumFaces() const { return m_faceOffsets.size() - 1; }
+
+    //! One more than the largest index used.
+    size_t getNumVertices() const
+    { return m_vertexFaceOffsets.size() - 1; }
+
+    //! Where each face starts in the face indices, with the number of face
+    //! indices at the end, so face f is [ offsets[f], offsets[f+1] ).
+    const std::vector<int32_t> &getFaceOffsets() const
+    { return m_faceOffsets; }
+
+    //! Each face fanned out from its first vertex, keeping its winding,
+    //! three vertex indices a triangle. Faces with fewer than three
+    //! vertices have no triangles.
+    const std::vector<int32_t> &getTriangles() const
+    { return m_triangles; }
+
+    //! The face each triangle came from.
+    const std::vector<int32_t> &getTriangleFaces() const
+    { return m_triangleFaces; }
+
+    //! The faces using vertex v are getVertexFaces()[ offsets[v] ] up to
+    //! getVertexFaces()[ offsets[v+1] ], in face order.
+    const std::vector<int32_t> &getVertexFaceOffsets() const
+    { return m_vertexFaceOffsets; }
+
+    const std::vector<int32_t> &getVertexFaces() const
+    { return m_vertexFaces; }
+
+    //! Every edge once, as two vertex indices with the lower first, sorted.
+    const std::vector<int32_t> &getEdges() const
+    { return m_edges; }
+
+    //! Bytes used by all of the above.
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<int32_t> m_faceOffsets;
+    std::vector<int32_t> m_triangles;
+    std::vector<int32_t> m_triangleFaces;
+    std::vector<int32_t> m_vertexFaceOffsets;
+    std::vector<int32_t> m_vertexFaces;
+    std::vector<int32_t> m_edges;
+};
+
+typedef boost::shared_ptr<const MeshTopology> MeshTopologyPtr;
+
+//-*****************************************************************************
+//! Shares MeshTopology between every mesh and frame with the same face
+//! counts and face indices, as told by their sample keys, so a constant
+//! topology is only built once however many times it is drawn. The least
+//! recently used topologies are dropped once the cache is over its memory
+//! budget; anyone still holding one keeps it.
+//! This class is multithread safe. Two threads missing on the same
+//! topology at once may both build it, but only one is kept.
+class MeshTopologyCache : private boost::noncopyable
+{
+public:
+    explicit MeshTopologyCache( size_t iMaxBytes = 256 * 1024 * 1024 );
+
+    //! The topology of iSchema at iSS, for polymeshes and subds.
+    template <class SCHEMA>
+    MeshTopologyPtr get( SCHEMA &iSchema,
+                         const Abc::ISampleSelector &iSS =
+                         Abc::ISampleSelector() )
+    {
+        return get( iSchema.getFaceCountsProperty(),
+                    iSchema.getFaceIndicesProperty(), iSS );
+    }
+
+    MeshTopologyPtr get( Abc::IInt32ArrayProperty iFaceCounts,
+                         Abc::IInt32ArrayProperty iFaceIndices,
+                         const Abc::ISampleSelector &iSS =
+                         Abc::ISampleSelector() );
+
+    size_t getMaxBytes();
+
+    //! Drops topologies until the cache is within iMaxBytes.
+    void setMaxBytes( size_t iMaxBytes );
+
+    size_t getMemoryUsage();
+
+    //! How many topologies are held.
+    size_t size();
+
+    void clear();
+
+private:
+    typedef std::pair<AbcA::ArraySampleKey, AbcA::ArraySampleKey> Key;
+    typedef std::pair<Key, MeshTopologyPtr> Entry;
+
+    // most recently used first
+    typedef std::list<Entry> EntryList;
+    typedef std::map<Key, EntryList::iterator> EntryMap;
+
+    void evict();
+
+    boost::mutex m_mutex;
+    EntryList m_entries;
+    EntryMap m_map;
+    size_t m_maxBytes;
+    size_t m_bytes;
+};
+
+typedef boost::shared_ptr<MeshTopologyCache> MeshTopologyCachePtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,1294 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/NuPatchTessellation.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Patches are heavy enough that a few of them pay for a thread.
+static const size_t MIN_PATCHES_PER_THREAD = 4;
+
+//-*****************************************************************************
+// Higher orders than this don't turn up in practice, and capping them
+// keeps the basis scratch space on the stack.
+static const int32_t MAX_ORDER = 32;
+
+//-*****************************************************************************
+// The knot span holding iT, from The NURBS Book, A2.1. iT has to be within
+// iKnots[iDegree] and iKnots[iNumCvs].
+int32_t FindSpan( int32_t iNumCvs, int32_t iDegree, float32_t iT,
+                  const float32_t *iKnots )
+{
+    if ( iT >= iKnots[iNumCvs] )
+    {
+        // the last span that isn't empty
+        int32_t span = iNumCvs - 1;
+        while ( span > iDegree && iKnots[span] == iKnots[iNumCvs] )
+        {
+            --span;
+        }
+        return span;
+    }
+
+    int32_t low = iDegree;
+    int32_t high = iNumCvs;
+    int32_t mid = ( low + high ) / 2;
+    while ( iT < iKnots[mid] || iT >= iKnots[mid + 1] )
+    {
+        if ( iT < iKnots[mid] )
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid;
+        }
+        mid = ( low + high ) / 2;
+    }
+    return mid;
+}
+
+//-*****************************************************************************
+// The iDegree + 1 basis functions that aren't zero in iSpan, from The
+// NURBS Book, A2.2.
+void BasisFuns( int32_t iSpan, float32_t iT, int32_t iDegree,
+                const float32_t *iKnots, float32_t *oN )
+{
+    float32_t left[MAX_ORDER];
+    float32_t right[MAX_ORDER];
+
+    oN[0] = 1.0f;
+    for ( int32_t j = 1; j <= iDegree; ++j )
+    {
+        left[j] = iT - iKnots[iSpan + 1 - j];
+        right[j] = iKnots[iSpan + j] - iT;
+        float32_t saved = 0.0f;
+        for ( int32_t r = 0; r < j; ++r )
+        {
+            float32_t denom = right[r + 1] + left[j - r];
+            float32_t temp = denom != 0.0f ? oN[r] / denom : 0.0f;
+            oN[r] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+        oN[j] = saved;
+    }
+}
+
+//-*****************************************************************************
+// The basis functions along one direction, worked out once per grid line
+// instead of once per grid point.
+struct BasisCache
+{
+    int32_t order;
+    std::vector<float32_t> params;
+    std::vector<int32_t> firstCvs;
+    std::vector<float32_t> weights;
+
+    void build( int32_t iNumCvs, int32_t iOrder, const float32_t *iKnots,
+                int32_t iStepsPerSpan )
+    {
+        order = iOrder;
+        params.clear();
+        for ( int32_t s = iOrder - 1; s < iNumCvs; ++s )
+        {
+            float32_t a = iKnots[s];
+            float32_t b = iKnots[s + 1];
+            if ( b > a )
+            {
+                for ( int32_t k = 0; k < iStepsPerSpan; ++k )
+                {
+                    params.push_back( a + ( b - a ) * ( float32_t ) k /
+                                      ( float32_t ) iStepsPerSpan );
+                }
+            }
+        }
+        params.push_back( iKnots[iNumCvs] );
+
+        firstCvs.resize( params.size() );
+        weights.resize( params.size() * iOrder );
+        for ( size_t i = 0; i < params.size(); ++i )
+        {
+            int32_t span = FindSpan( iNumCvs, iOrder - 1, params[i],
+                                     iKnots );
+            BasisFuns( span, params[i], iOrder - 1, iKnots,
+                       &weights[i * iOrder] );
+            firstCvs[i] = span - ( iOrder - 1 );
+        }
+    }
+};
+
+//-*****************************************************************************
+// A polyline strays about 6m / 8n^2 from a span whose control points bend
+// by m, the same estimate the curves use.
+int32_t GetStepsPerSpan( const V3f *iCvs, int32_t iNumU, int32_t iNumV,
+                         bool iAlongU, int32_t iOrder, float32_t iTolerance,
+                         int32_t iMaxSteps )
+{
+    if ( iOrder <= 2 )
+    {
+        return 1;
+    }
+
+    if ( iTolerance <= 0.0f )
+    {
+        return iMaxSteps;
+    }
+
+    int32_t numLines = iAlongU ? iNumV : iNumU;
+    int32_t numCvs = iAlongU ? iNumU : iNumV;
+    size_t stride = iAlongU ? 1 : iNumU;
+
+    float32_t m = 0.0f;
+    for ( int32_t line = 0; line < numLines; ++line )
+    {
+        const V3f *cv = iCvs + ( iAlongU ? line * iNumU : line );
+        for ( int32_t i = 1; i + 1 < numCvs; ++i )
+        {
+            m = std::max( m, ( cv[( i - 1 ) * stride] -
+                               cv[i * stride] * 2.0f +
+                               cv[( i + 1 ) * stride] ).length() );
+        }
+    }
+
+    float32_t steps = std::ceil( std::sqrt( 0.75f * m / iTolerance ) );
+    if ( !( steps < ( float32_t ) iMaxSteps ) )
+    {
+        return iMaxSteps;
+    }
+    return std::max( ( int32_t ) steps, 1 );
+}
+
+//-*****************************************************************************
+// How far the patch can move for a unit step in its parameter along one
+// direction, from the control points of its derivative, which are
+// p ( P[i+1] - P[i] ) / ( t[i+p+1] - t[i+1] ), The NURBS Book, 3.3. As in
+// GetStepsPerSpan, the weights are left out.
+float32_t GetMaxSpeed( const V3f *iCvs, int32_t iNumU, int32_t iNumV,
+                       bool iAlongU, int32_t iOrder, const float32_t *iKnots )
+{
+    int32_t degree = iOrder - 1;
+    int32_t numLines = iAlongU ? iNumV : iNumU;
+    int32_t numCvs = iAlongU ? iNumU : iNumV;
+    size_t stride = iAlongU ? 1 : iNumU;
+
+    float32_t ret = 0.0f;
+    for ( int32_t i = 0; degree > 0 && i + 1 < numCvs; ++i )
+    {
+        float32_t span = iKnots[i + degree + 1] - iKnots[i + 1];
+        if ( !( span > 0.0f ) )
+        {
+            continue;
+        }
+
+        for ( int32_t line = 0; line < numLines; ++line )
+        {
+            const V3f *cv = iCvs + ( iAlongU ? line * iNumU : line );
+            ret = std::max( ret, ( cv[( i + 1 ) * stride] -
+                                   cv[i * stride] ).length() *
+                            ( float32_t ) degree / span );
+        }
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+// The estimate GetStepsPerSpan makes, on the control points of one trim
+// curve, with iTolerance in parameter space.
+int32_t GetTrimStepsPerSpan( const float32_t *iU, const float32_t *iV,
+                             int32_t iNumCvs, int32_t iOrder,
+                             float32_t iTolerance, int32_t iMaxSteps )
+{
+    if ( iOrder <= 2 )
+    {
+        return 1;
+    }
+
+    if ( iTolerance <= 0.0f )
+    {
+        return iMaxSteps;
+    }
+
+    float32_t m = 0.0f;
+    for ( int32_t i = 1; i + 1 < iNumCvs; ++i )
+    {
+        V2f bend( iU[i - 1] - iU[i] * 2.0f + iU[i + 1],
+                  iV[i - 1] - iV[i] * 2.0f + iV[i + 1] );
+        m = std::max( m, bend.length() );
+    }
+
+    float32_t steps = std::ceil( std::sqrt( 0.75f * m / iTolerance ) );
+    if ( !( steps < ( float32_t ) iMaxSteps ) )
+    {
+        return iMaxSteps;
+    }
+    return std::max( ( int32_t ) steps, 1 );
+}
+
+//-*****************************************************************************
+// Turns every trim loop into a closed polygon in parameter space, all of
+// whose edges go into one list: a point is inside an odd number of loops
+// exactly when a ray from it crosses an odd number of these edges. The
+// curves are stepped to within iTolerance, in parameter space.
+void GetTrimEdges( const INuPatchSchema::Sample &iSample,
+                   float32_t iTolerance, int32_t iMaxSteps,
+                   std::vector<V2f> &oStarts, std::vector<V2f> &oEnds )
+{
+    const int32_t *numCurves = iSample.getTrimNumCurves()->get();
+    const int32_t *numVertices = iSample.getTrimNumVertices()->get();
+    const int32_t *orders = iSample.getTrimOrders()->get();
+    const float32_t *knots = iSample.getTrimKnots()->get();
+    const float32_t *mins = iSample.getTrimMins()->get();
+    const float32_t *maxes = iSample.getTrimMaxes()->get();
+    const float32_t *u = iSample.getTrimU()->get();
+    const float32_t *v = iSample.getTrimV()->get();
+    const float32_t *w = iSample.getTrimW()->get();
+
+    float32_t n[MAX_ORDER];
+    std::vector<V2f> loop;
+    size_t curve = 0;
+    for ( int32_t l = 0; l < iSample.getTrimNumLoops(); ++l )
+    {
+        loop.clear();
+        for ( int32_t c = 0; c < numCurves[l]; ++c, ++curve )
+        {
+            int32_t numCvs = numVertices[curve];
+            int32_t order = orders[curve];
+            int32_t steps = GetTrimStepsPerSpan( u, v, numCvs, order,
+                                                 iTolerance, iMaxSteps );
+
+            std::vector<float32_t> params;
+            for ( int32_t s = order - 1; s < numCvs; ++s )
+            {
+                float32_t a = std::max( knots[s], mins[curve] );
+                float32_t b = std::min( knots[s + 1], maxes[curve] );
+                for ( int32_t k = 0; b > a && k < steps; ++k )
+                {
+                    params.push_back( a + ( b - a ) * ( float32_t ) k /
+                                      ( float32_t ) steps );
+                }
+            }
+            params.push_back( std::min( maxes[curve], knots[numCvs] ) );
+
+            for ( size_t i = 0; i < params.size(); ++i )
+            {
+                float32_t t = std::max( params[i], knots[order - 1] );
+                int32_t span = FindSpan( numCvs, order - 1, t, knots );
+                BasisFuns( span, t, order - 1, knots, n );
+
+                V2f sum( 0.0f, 0.0f );
+                float32_t wsum = 0.0f;
+                for ( int32_t k = 0; k < order; ++k )
+                {
+                    int32_t cv = span - ( order - 1 ) + k;
+                    float32_t c = n[k] * w[cv];
+                    sum += V2f( u[cv], v[cv] ) * c;
+                    wsum += c;
+                }
+                loop.push_back( wsum != 0.0f ? sum / wsum : sum );
+            }
+
+            knots += numCvs + order;
+            u += numCvs;
+            v += numCvs;
+            w += numCvs;
+        }
+
+        for ( size_t i = 0; i < loop.size(); ++i )
+        {
+            oStarts.push_back( loop[i] );
+            oEnds.push_back( loop[( i + 1 ) % loop.size()] );
+        }
+    }
+}
+
+//-*****************************************************************************
+// Which grid cells are inside the trims, a row at a time: the edges
+// crossing a row's center line are sorted once, and each cell counts those
+// to the left of its center. Cells the trims pass through are cut up by
+// CutTrimmedCells instead.
+void GetKeptCells( const INuPatchSchema::Sample &iSample,
+                   const std::vector<V2f> &iStarts,
+                   const std::vector<V2f> &iEnds,
+                   const std::vector<float32_t> &iUParams,
+                   const std::vector<float32_t> &iVParams,
+                   std::vector<bool> &oKept )
+{
+    size_t cellsU = iUParams.size() - 1;
+    size_t cellsV = iVParams.size() - 1;
+    oKept.assign( cellsU * cellsV, true );
+
+    if ( !iSample.hasTrimCurve() )
+    {
+        return;
+    }
+
+    std::vector<float32_t> crossings;
+    for ( size_t j = 0; j < cellsV; ++j )
+    {
+        float32_t vc = 0.5f * ( iVParams[j] + iVParams[j + 1] );
+
+        crossings.clear();
+        for ( size_t e = 0; e < iStarts.size(); ++e )
+        {
+            const V2f &a = iStarts[e];
+            const V2f &b = iEnds[e];
+            if ( ( a.y <= vc ) != ( b.y <= vc ) )
+            {
+                crossings.push_back( a.x + ( vc - a.y ) * ( b.x - a.x ) /
+                                     ( b.y - a.y ) );
+            }
+        }
+        std::sort( crossings.begin(), crossings.end() );
+
+        for ( size_t i = 0; i < cellsU; ++i )
+        {
+            float32_t uc = 0.5f * ( iUParams[i] + iUParams[i + 1] );
+            size_t left = std::lower_bound( crossings.begin(),
+                crossings.end(), uc ) - crossings.begin();
+            oKept[j * cellsU + i] = ( left % 2 ) == 1;
+        }
+    }
+}
+
+//-*****************************************************************************
+// The part of a cell between two lines of constant v that the trims keep.
+// Its sides are the cell's own sides or straight pieces of trim edges, and
+// run from left0 and right0 at v0 up to left1 and right1 at v1.
+struct Trapezoid
+{
+    float32_t v0;
+    float32_t v1;
+    float32_t left0;
+    float32_t right0;
+    float32_t left1;
+    float32_t right1;
+    float32_t cellLeft;
+    float32_t cellRight;
+};
+
+//-*****************************************************************************
+// By the u or v of a line, the v or u of the points the cut cells put on
+// it. Anything else with an edge along the line puts them on that edge
+// too, so that no crack opens where a cut cell meets its neighbours.
+typedef std::map<float32_t, std::vector<float32_t> > LinePoints;
+
+//-*****************************************************************************
+struct CutCells
+{
+    std::vector<bool> cut;
+    std::vector<Trapezoid> pieces;
+    LinePoints onU;
+    LinePoints onV;
+};
+
+//-*****************************************************************************
+inline float32_t Clamp( float32_t iX, float32_t iLo, float32_t iHi )
+{
+    return std::min( std::max( iX, iLo ), iHi );
+}
+
+//-*****************************************************************************
+// Where the line through iA and iB is at v = iV, and at u = iU. Every cell
+// works these out from the same two ends in the same order, so the cells
+// either side of a grid line agree exactly on where an edge crosses it.
+float32_t UAtV( const V2f &iA, const V2f &iB, float32_t iV )
+{
+    if ( iV == iA.y ) { return iA.x; }
+    if ( iV == iB.y ) { return iB.x; }
+    return iA.x + ( iV - iA.y ) * ( iB.x - iA.x ) / ( iB.y - iA.y );
+}
+
+float32_t VAtU( const V2f &iA, const V2f &iB, float32_t iU )
+{
+    if ( iU == iA.x ) { return iA.y; }
+    if ( iU == iB.x ) { return iB.y; }
+    return iA.y + ( iU - iA.x ) * ( iB.y - iA.y ) / ( iB.x - iA.x );
+}
+
+//-*****************************************************************************
+// Clips the trim edge from iA to iB to a cell, Liang-Barsky style, giving
+// false unless some of it is strictly inside: edges along the cell's sides,
+// or through one of its corners, don't cut it.
+bool ClipEdge( const V2f &iA, const V2f &iB, float32_t iU0, float32_t iU1,
+               float32_t iV0, float32_t iV1, V2f &oP, V2f &oQ )
+{
+    V2f d = iB - iA;
+    float32_t p[4] = { -d.x, d.x, -d.y, d.y };
+    float32_t q[4] = { iA.x - iU0, iU1 - iA.x, iA.y - iV0, iV1 - iA.y };
+
+    float32_t t0 = 0.0f;
+    float32_t t1 = 1.0f;
+    int32_t side0 = -1;
+    int32_t side1 = -1;
+    for ( int32_t k = 0; k < 4; ++k )
+    {
+        if ( p[k] == 0.0f )
+        {
+            if ( q[k] < 0.0f ) { return false; }
+            continue;
+        }
+
+        float32_t r = q[k] / p[k];
+        if ( p[k] < 0.0f )
+        {
+            if ( r > t1 ) { return false; }
+            if ( r > t0 ) { t0 = r; side0 = k; }
+        }
+        else
+        {
+            if ( r < t0 ) { return false; }
+            if ( r < t1 ) { t1 = r; side1 = k; }
+        }
+    }
+
+    // where it leaves through a side, the point is put exactly on it
+    float32_t sides[4] = { iU0, iU1, iV0, iV1 };
+    int32_t limits[2] = { side0, side1 };
+    V2f *ends[2] = { &oP, &oQ };
+    for ( int32_t k = 0; k < 2; ++k )
+    {
+        int32_t s = limits[k];
+        if ( s < 0 )
+        {
+            *ends[k] = k == 0 ? iA : iB;
+        }
+        else if ( s < 2 )
+        {
+            *ends[k] = V2f( sides[s],
+                            Clamp( VAtU( iA, iB, sides[s] ), iV0, iV1 ) );
+        }
+        else
+        {
+            *ends[k] = V2f( Clamp( UAtV( iA, iB, sides[s] ), iU0, iU1 ),
+                            sides[s] );
+        }
+    }
+
+    V2f mid = ( oP + oQ ) * 0.5f;
+    return oP != oQ && mid.x > iU0 && mid.x < iU1 &&
+        mid.y > iV0 && mid.y < iV1;
+}
+
+//-*****************************************************************************
+// The cells, between iFirst and iLast, whose span of iParams overlaps
+// iLo to iHi, or false if none do.
+bool GetCellRange( const std::vector<float32_t> &iParams, float32_t iLo,
+                   float32_t iHi, size_t &oFirst, size_t &oLast )
+{
+    if ( iHi < iParams.front() || iLo > iParams.back() )
+    {
+        return false;
+    }
+
+    size_t lo = std::lower_bound( iParams.begin(), iParams.end(), iLo ) -
+        iParams.begin();
+    size_t hi = std::upper_bound( iParams.begin(), iParams.end(), iHi ) -
+        iParams.begin();
+    oFirst = lo > 0 ? lo - 1 : 0;
+    oLast = std::min( hi, iParams.size() - 1 ) - 1;
+    return true;
+}
+
+//-*****************************************************************************
+void AddTrapezoid( float32_t iV0, float32_t iV1, float32_t iLeft0,
+                   float32_t iRight0, float32_t iLeft1, float32_t iRight1,
+                   float32_t iCellLeft, float32_t iCellRight,
+                   CutCells &ioCut )
+{
+    if ( !( iRight0 > iLeft0 ) && !( iRight1 > iLeft1 ) )
+    {
+        return;
+    }
+
+    Trapezoid piece = { iV0, iV1, iLeft0, iRight0, iLeft1, iRight1,
+                        iCellLeft, iCellRight };
+    ioCut.pieces.push_back( piece );
+
+    float32_t us[4] = { iLeft0, iRight0, iLeft1, iRight1 };
+    float32_t vs[4] = { iV0, iV0, iV1, iV1 };
+    for ( int32_t k = 0; k < 4; ++k )
+    {
+        ioCut.onV[vs[k]].push_back( us[k] );
+        if ( us[k] == iCellLeft || us[k] == iCellRight )
+        {
+            ioCut.onU[us[k]].push_back( vs[k] );
+        }
+    }
+}
+
+//-*****************************************************************************
+// Cuts the cells the trim edges pass through into the trapezoids that the
+// trims keep, so the trimmed edge follows the trim curves rather than the
+// grid. Each cell is split at the v of every edge end inside it, so that
+// between those lines the edges run straight across without meeting, and
+// the edges entirely to the left of the cell say, as in GetKeptCells,
+// which of the gaps between them are inside.
+void CutTrimmedCells( const std::vector<V2f> &iStarts,
+                      const std::vector<V2f> &iEnds,
+                      const std::vector<float32_t> &iUParams,
+                      const std::vector<float32_t> &iVParams,
+                      CutCells &oCut )
+{
+    size_t cellsU = iUParams.size() - 1;
+    size_t cellsV = iVParams.size() - 1;
+    oCut.cut.assign( cellsU * cellsV, false );
+
+    // the rows each edge spans, and the cells it might pass through
+    std::vector<std::vector<size_t> > rowEdges( cellsV );
+    std::vector<std::pair<size_t, size_t> > candidates;
+    for ( size_t e = 0; e < iStarts.size(); ++e )
+    {
+        const V2f &a = iStarts[e];
+        const V2f &b = iEnds[e];
+
+        size_t i0, i1, j0, j1;
+        if ( !GetCellRange( iVParams, std::min( a.y, b.y ),
+                            std::max( a.y, b.y ), j0, j1 ) )
+        {
+            continue;
+        }
+
+        bool inU = GetCellRange( iUParams, std::min( a.x, b.x ),
+                                 std::max( a.x, b.x ), i0, i1 );
+        for ( size_t j = j0; j <= j1; ++j )
+        {
+            rowEdges[j].push_back( e );
+            for ( size_t i = i0; inU && i <= i1; ++i )
+            {
+                candidates.push_back( std::make_pair( j * cellsU + i, e ) );
+            }
+        }
+    }
+    std::sort( candidates.begin(), candidates.end() );
+
+    std::vector<size_t> edges;
+    std::vector<V2f> ps;
+    std::vector<V2f> qs;
+    std::vector<float32_t> lines;
+    std::vector<std::pair<double, size_t> > crossings;
+    for ( size_t c = 0; c < candidates.size(); )
+    {
+        size_t cell = candidates[c].first;
+        size_t i = cell % cellsU;
+        size_t j = cell / cellsU;
+        float32_t u0 = iUParams[i];
+        float32_t u1 = iUParams[i + 1];
+        float32_t v0 = iVParams[j];
+        float32_t v1 = iVParams[j + 1];
+
+        // the pieces of edges inside, each from p up to q
+        edges.clear();
+        ps.clear();
+        qs.clear();
+        for ( ; c < candidates.size() && candidates[c].first == cell; ++c )
+        {
+            size_t e = candidates[c].second;
+            V2f a = iStarts[e];
+            V2f b = iEnds[e];
+            if ( b.y < a.y || ( b.y == a.y && b.x < a.x ) )
+            {
+                std::swap( a, b );
+            }
+
+            V2f p, q;
+            if ( ClipEdge( a, b, u0, u1, v0, v1, p, q ) )
+            {
+                edges.push_back( e );
+                ps.push_back( p );
+                qs.push_back( q );
+            }
+        }
+
+        if ( edges.empty() )
+        {
+            continue;
+        }
+        oCut.cut[cell] = true;
+
+        lines.clear();
+        lines.push_back( v0 );
+        lines.push_back( v1 );
+        for ( size_t k = 0; k < edges.size(); ++k )
+        {
+            lines.push_back( ps[k].y );
+            lines.push_back( qs[k].y );
+        }
+        std::sort( lines.begin(), lines.end() );
+        lines.erase( std::unique( lines.begin(), lines.end() ), lines.end() );
+
+        const std::vector<size_t> &row = rowEdges[j];
+        for ( size_t s = 0; s + 1 < lines.size(); ++s )
+        {
+            // in double, as two lines can be neighbouring floats
+            float32_t va = lines[s];
+            float32_t vb = lines[s + 1];
+            double vm = 0.5 * ( ( double ) va + ( double ) vb );
+
+            bool inside = false;
+            for ( size_t r = 0; r < row.size(); ++r )
+            {
+                const V2f &a = iStarts[row[r]];
+                const V2f &b = iEnds[row[r]];
+                if ( ( a.y <= vm ) == ( b.y <= vm ) )
+                {
+                    continue;
+                }
+
+                // the pieces inside the cell are counted below
+                std::vector<size_t>::iterator found = std::lower_bound(
+                    edges.begin(), edges.end(), row[r] );
+                size_t k = found - edges.begin();
+                if ( found != edges.end() && *found == row[r] &&
+                     ps[k].y < vm && qs[k].y > vm )
+                {
+                    continue;
+                }
+
+                if ( a.x + ( vm - a.y ) * ( ( double ) b.x - a.x ) /
+                     ( ( double ) b.y - a.y ) <= u0 )
+                {
+                    inside = !inside;
+                }
+            }
+
+            crossings.clear();
+            for ( size_t k = 0; k < edges.size(); ++k )
+            {
+                const V2f &a = ps[k];
+                const V2f &b = qs[k];
+                if ( a.y < vm && b.y > vm )
+                {
+                    crossings.push_back( std::make_pair( a.x + ( vm - a.y ) *
+                        ( ( double ) b.x - a.x ) / ( ( double ) b.y - a.y ),
+                        k ) );
+                }
+            }
+            std::sort( crossings.begin(), crossings.end() );
+
+            float32_t left0 = u0;
+            float32_t left1 = u0;
+            for ( size_t x = 0; x < crossings.size(); ++x )
+            {
+                size_t k = crossings[x].second;
+                float32_t right0 = Clamp( UAtV( ps[k], qs[k], va ), u0, u1 );
+                float32_t right1 = Clamp( UAtV( ps[k], qs[k], vb ), u0, u1 );
+                if ( inside )
+                {
+                    AddTrapezoid( va, vb, left0, right0, left1, right1,
+                                  u0, u1, oCut );
+                }
+                left0 = right0;
+                left1 = right1;
+                inside = !inside;
+            }
+
+            if ( inside )
+            {
+                AddTrapezoid( va, vb, left0, u1, left1, u1, u0, u1, oCut );
+            }
+        }
+    }
+
+    LinePoints *all[2] = { &oCut.onU, &oCut.onV };
+    for ( int32_t k = 0; k < 2; ++k )
+    {
+        for ( LinePoints::iterator it = all[k]->begin();
+              it != all[k]->end(); ++it )
+        {
+            std::vector<float32_t> &points = it->second;
+            std::sort( points.begin(), points.end() );
+            points.erase( std::unique( points.begin(), points.end() ),
+                          points.end() );
+        }
+    }
+}
+
+//-*****************************************************************************
+// Appends the points iLines has on line iKey strictly between iFrom and
+// iTo, in order from iFrom. iConstantU is whether iKey is a u.
+void AppendLinePoints( const LinePoints &iLines, float32_t iKey,
+                       float32_t iFrom, float32_t iTo, bool iConstantU,
+                       std::vector<V2f> &ioPolygon )
+{
+    LinePoints::const_iterator found = iLines.find( iKey );
+    if ( found == iLines.end() )
+    {
+        return;
+    }
+
+    const std::vector<float32_t> &points = found->second;
+    std::vector<float32_t>::const_iterator first = std::upper_bound(
+        points.begin(), points.end(), std::min( iFrom, iTo ) );
+    std::vector<float32_t>::const_iterator last = std::lower_bound(
+        first, points.end(), std::max( iFrom, iTo ) );
+
+    size_t start = ioPolygon.size();
+    for ( ; first != last; ++first )
+    {
+        ioPolygon.push_back( iConstantU ? V2f( iKey, *first ) :
+                             V2f( *first, iKey ) );
+    }
+
+    if ( iFrom > iTo )
+    {
+        std::reverse( ioPolygon.begin() + start, ioPolygon.end() );
+    }
+}
+
+//-*****************************************************************************
+struct PatchSurface
+{
+    const V3f *cvs;
+    const float32_t *weights;
+    int32_t numU;
+    int32_t numV;
+    int32_t uOrder;
+    int32_t vOrder;
+    const float32_t *uKnot;
+    const float32_t *vKnot;
+
+    // The point whose basis functions are iNu from control point iFirstU
+    // along u, and iNv from iFirstV along v.
+    V3f blend( const float32_t *iNu, int32_t iFirstU,
+               const float32_t *iNv, int32_t iFirstV ) const
+    {
+        V3f sum( 0.0f, 0.0f, 0.0f );
+        float32_t wsum = 0.0f;
+        for ( int32_t a = 0; a < vOrder; ++a )
+        {
+            size_t row = ( size_t ) ( iFirstV + a ) * numU + iFirstU;
+            for ( int32_t b = 0; b < uOrder; ++b )
+            {
+                float32_t c = iNv[a] * iNu[b] *
+                    ( weights ? weights[row + b] : 1.0f );
+                sum += cvs[row + b] * c;
+                wsum += c;
+            }
+        }
+        return wsum != 0.0f ? sum / wsum : sum;
+    }
+
+    V3f at( float32_t iU, float32_t iV ) const
+    {
+        float32_t nu[MAX_ORDER];
+        float32_t nv[MAX_ORDER];
+
+        iU = Clamp( iU, uKnot[uOrder - 1], uKnot[numU] );
+        iV = Clamp( iV, vKnot[vOrder - 1], vKnot[numV] );
+        int32_t spanU = FindSpan( numU, uOrder - 1, iU, uKnot );
+        int32_t spanV = FindSpan( numV, vOrder - 1, iV, vKnot );
+        BasisFuns( spanU, iU, uOrder - 1, uKnot, nu );
+        BasisFuns( spanV, iV, vOrder - 1, vKnot, nv );
+        return blend( nu, spanU - ( uOrder - 1 ), nv, spanV - ( vOrder - 1 ) );
+    }
+};
+
+//-*****************************************************************************
+// Hands out the mesh's index for a point in parameter space, adding it the
+// first time. Grid points are shared with the uncut cells through iRemap.
+struct VertexCache
+{
+    const PatchSurface *surface;
+    const std::vector<float32_t> *uParams;
+    const std::vector<float32_t> *vParams;
+    std::vector<int32_t> *remap;
+    NuPatchMesh *mesh;
+    std::map<std::pair<float32_t, float32_t>, int32_t> points;
+
+    int32_t add( float32_t iU, float32_t iV )
+    {
+        mesh->positions.push_back( surface->at( iU, iV ) );
+        mesh->uvs.push_back( V2f( iU, iV ) );
+        return ( int32_t ) mesh->positions.size() - 1;
+    }
+
+    int32_t get( const V2f &iUv )
+    {
+        std::vector<float32_t>::const_iterator u = std::lower_bound(
+            uParams->begin(), uParams->end(), iUv.x );
+        std::vector<float32_t>::const_iterator v = std::lower_bound(
+            vParams->begin(), vParams->end(), iUv.y );
+        if ( u != uParams->end() && *u == iUv.x &&
+             v != vParams->end() && *v == iUv.y )
+        {
+            int32_t &index = ( *remap )[( v - vParams->begin() ) *
+                uParams->size() + ( u - uParams->begin() )];
+            if ( index < 0 )
+            {
+                index = add( iUv.x, iUv.y );
+            }
+            return index;
+        }
+
+        std::pair<std::map<std::pair<float32_t, float32_t>,
+                           int32_t>::iterator, bool> found =
+            points.insert( std::make_pair(
+                std::make_pair( iUv.x, iUv.y ), -1 ) );
+        if ( found.second )
+        {
+            found.first->second = add( iUv.x, iUv.y );
+        }
+        return found.first->second;
+    }
+};
+
+//-*****************************************************************************
+// Adds a trapezoid, or a whole cell, wound clockwise in parameter space
+// like the grid. The points other cells put on its edges go in too, and
+// then it is fanned around its center so that none of them are left in the
+// middle of a triangle's edge.
+void AddTrapezoidTriangles( const Trapezoid &iPiece, const CutCells &iCut,
+                            VertexCache &ioVerts, std::vector<V2f> &ioScratch,
+                            std::vector<int32_t> &ioIndexScratch,
+                            std::vector<int32_t> &oTriangles )
+{
+    const Trapezoid &t = iPiece;
+    std::vector<V2f> &poly = ioScratch;
+    poly.clear();
+
+    poly.push_back( V2f( t.left0, t.v0 ) );
+    if ( t.left0 == t.cellLeft && t.left1 == t.cellLeft )
+    {
+        AppendLinePoints( iCut.onU, t.cellLeft, t.v0, t.v1, true, poly );
+    }
+    poly.push_back( V2f( t.left1, t.v1 ) );
+    AppendLinePoints( iCut.onV, t.v1, t.left1, t.right1, false, poly );
+    poly.push_back( V2f( t.right1, t.v1 ) );
+    if ( t.right0 == t.cellRight && t.right1 == t.cellRight )
+    {
+        AppendLinePoints( iCut.onU, t.cellRight, t.v1, t.v0, true, poly );
+    }
+    poly.push_back( V2f( t.right0, t.v0 ) );
+    AppendLinePoints( iCut.onV, t.v0, t.right0, t.left0, false, poly );
+
+    bool fan = poly.size() > 4;
+
+    // a side that narrows to a point leaves it in twice
+    poly.erase( std::unique( poly.begin(), poly.end() ), poly.end() );
+    if ( poly.size() > 1 && poly.front() == poly.back() )
+    {
+        poly.pop_back();
+    }
+    if ( poly.size() < 3 )
+    {
+        return;
+    }
+
+    std::vector<int32_t> &indices = ioIndexScratch;
+    indices.resize( poly.size() );
+    V2f center( 0.0f, 0.0f );
+    for ( size_t k = 0; k < poly.size(); ++k )
+    {
+        indices[k] = ioVerts.get( poly[k] );
+        center += poly[k];
+    }
+
+    if ( !fan )
+    {
+        for ( size_t k = 1; k + 1 < poly.size(); ++k )
+        {
+            oTriangles.push_back( indices[0] );
+            oTriangles.push_back( indices[k] );
+            oTriangles.push_back( indices[k + 1] );
+        }
+        return;
+    }
+
+    int32_t middle = ioVerts.get( center / ( float32_t ) poly.size() );
+    for ( size_t k = 0; k < poly.size(); ++k )
+    {
+        oTriangles.push_back( middle );
+        oTriangles.push_back( indices[k] );
+        oTriangles.push_back( indices[( k + 1 ) % poly.size()] );
+    }
+}
+
+//-*****************************************************************************
+// FindSpan's search only ends if the knots never decrease, and NaNs compare
+// as neither, so both are checked for before anything is evaluated.
+bool KnotsAreValid( const float32_t *iKnots, size_t iNumKnots )
+{
+    for ( size_t i = 0; i < iNumKnots; ++i )
+    {
+        if ( !( std::abs( iKnots[i] ) <=
+                std::numeric_limits<float32_t>::max() ) ||
+             ( i > 0 && iKnots[i] < iKnots[i - 1] ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-*****************************************************************************
+void CheckNuPatch( const INuPatchSchema::Sample &iSample )
+{
+    ABCA_ASSERT( iSample.valid(),
+                 "NuPatch sample is missing its positions, knots or orders" );
+
+    int32_t numU = iSample.getNumU();
+    int32_t numV = iSample.getNumV();
+    int32_t uOrder = iSample.getUOrder();
+    int32_t vOrder = iSample.getVOrder();
+
+    ABCA_ASSERT( uOrder >= 1 && uOrder <= MAX_ORDER &&
+                 vOrder >= 1 && vOrder <= MAX_ORDER,
+                 "NuPatch orders " << uOrder << " and " << vOrder
+                 << " aren't between 1 and " << MAX_ORDER );
+
+    ABCA_ASSERT( numU >= uOrder && numV >= vOrder,
+                 "NuPatch has " << numU << " by " << numV
+                 << " control points, fewer than its orders" );
+
+    size_t numCvs = ( size_t ) numU * ( size_t ) numV;
+    ABCA_ASSERT( iSample.getPositions()->size() >= numCvs,
+                 "NuPatch has " << iSample.getPositions()->size()
+                 << " positions for " << numCvs << " control points" );
+
+    ABCA_ASSERT( !iSample.getPositionWeights() ||
+                 iSample.getPositionWeights()->size() >= numCvs,
+                 "NuPatch has " << iSample.getPositionWeights()->size()
+                 << " weights for " << numCvs << " control points" );
+
+    const FloatArraySample &uKnot = *iSample.getUKnot();
+    const FloatArraySample &vKnot = *iSample.getVKnot();
+    ABCA_ASSERT( uKnot.size() == ( size_t ) ( numU + uOrder ) &&
+                 vKnot.size() == ( size_t ) ( numV + vOrder ),
+                 "NuPatch knot vectors have " << uKnot.size() << " and "
+                 << vKnot.size() << " values, not numU + uOrder and "
+                 "numV + vOrder" );
+
+    ABCA_ASSERT( KnotsAreValid( uKnot.get(), uKnot.size() ) &&
+                 KnotsAreValid( vKnot.get(), vKnot.size() ),
+                 "NuPatch knot vectors aren't finite and non-decreasing" );
+
+    ABCA_ASSERT( uKnot[numU] > uKnot[uOrder - 1] &&
+                 vKnot[numV] > vKnot[vOrder - 1],
+                 "NuPatch knot vectors don't span any parameter range" );
+
+    if ( !iSample.hasTrimCurve() )
+    {
+        return;
+    }
+
+    ABCA_ASSERT( iSample.getTrimNumCurves() && iSample.getTrimNumVertices() &&
+                 iSample.getTrimOrders() && iSample.getTrimKnots() &&
+                 iSample.getTrimMins() && iSample.getTrimMaxes() &&
+                 iSample.getTrimU() && iSample.getTrimV() &&
+                 iSample.getTrimW(),
+                 "NuPatch trim curves are missing some of their data" );
+
+    const Int32ArraySample &numCurves = *iSample.getTrimNumCurves();
+    const Int32ArraySample &numVertices = *iSample.getTrimNumVertices();
+    const Int32ArraySample &orders = *iSample.getTrimOrders();
+
+    ABCA_ASSERT( numCurves.size() == ( size_t ) iSample.getTrimNumLoops(),
+                 "NuPatch has " << iSample.getTrimNumLoops()
+                 << " trim loops but curve counts for " << numCurves.size() );
+
+    size_t totalCurves = 0;
+    for ( size_t l = 0; l < numCurves.size(); ++l )
+    {
+        ABCA_ASSERT( numCurves[l] >= 0, "Trim loop " << l << " has "
+                     << numCurves[l] << " curves" );
+        totalCurves += numCurves[l];
+    }
+
+    ABCA_ASSERT( numVertices.size() == totalCurves &&
+                 orders.size() == totalCurves &&
+                 iSample.getTrimMins()->size() == totalCurves &&
+                 iSample.getTrimMaxes()->size() == totalCurves,
+                 "NuPatch trim loops have " << totalCurves
+                 << " curves, but not as many vertex counts, orders, mins "
+                 "and maxes" );
+
+    size_t totalCvs = 0;
+    size_t totalKnots = 0;
+    for ( size_t c = 0; c < totalCurves; ++c )
+    {
+        ABCA_ASSERT( orders[c] >= 1 && orders[c] <= MAX_ORDER &&
+                     numVertices[c] >= orders[c],
+                     "Trim curve " << c << " has " << numVertices[c]
+                     << " vertices and order " << orders[c] );
+        totalCvs += numVertices[c];
+        totalKnots += numVertices[c] + orders[c];
+    }
+
+    ABCA_ASSERT( iSample.getTrimKnots()->size() == totalKnots,
+                 "NuPatch trim curves need " << totalKnots << " knots, not "
+                 << iSample.getTrimKnots()->size() );
+
+    const float32_t *knots = iSample.getTrimKnots()->get();
+    for ( size_t c = 0; c < totalCurves; ++c )
+    {
+        size_t numKnots = numVertices[c] + orders[c];
+        ABCA_ASSERT( KnotsAreValid( knots, numKnots ),
+                     "Trim curve " << c << "'s knots aren't finite and "
+                     "non-decreasing" );
+        knots += numKnots;
+    }
+
+    ABCA_ASSERT( iSample.getTrimU()->size() == totalCvs &&
+                 iSample.getTrimV()->size() == totalCvs &&
+                 iSample.getTrimW()->size() == totalCvs,
+                 "NuPatch trim curves need " << totalCvs
+                 << " u, v and w values" );
+}
+
+//-*****************************************************************************
+// The rest of the work, once CheckNuPatch has passed.
+void TessellateChecked( const INuPatchSchema::Sample &iSample,
+                        float32_t iTolerance, int32_t iMaxSteps,
+                        NuPatchMesh &oMesh )
+{
+    oMesh.clear();
+
+    PatchSurface surface;
+    surface.cvs = iSample.getPositions()->get();
+    surface.weights = iSample.getPositionWeights() ?
+        iSample.getPositionWeights()->get() : NULL;
+    surface.numU = iSample.getNumU();
+    surface.numV = iSample.getNumV();
+    surface.uOrder = iSample.getUOrder();
+    surface.vOrder = iSample.getVOrder();
+    surface.uKnot = iSample.getUKnot()->get();
+    surface.vKnot = iSample.getVKnot()->get();
+
+    int32_t numU = surface.numU;
+    int32_t numV = surface.numV;
+    int32_t uOrder = surface.uOrder;
+    int32_t vOrder = surface.vOrder;
+    const V3f *cvs = surface.cvs;
+
+    BasisCache uBasis;
+    BasisCache vBasis;
+    uBasis.build( numU, uOrder, surface.uKnot,
+                  GetStepsPerSpan( cvs, numU, numV, true, uOrder,
+                                   iTolerance, iMaxSteps ) );
+    vBasis.build( numV, vOrder, surface.vKnot,
+                  GetStepsPerSpan( cvs, numU, numV, false, vOrder,
+                                   iTolerance, iMaxSteps ) );
+
+    size_t gridU = uBasis.params.size();
+    size_t gridV = vBasis.params.size();
+
+    // the trims are stepped finely enough that where they put the edge on
+    // the patch is within iTolerance of the trim curves
+    std::vector<V2f> trimStarts;
+    std::vector<V2f> trimEnds;
+    if ( iSample.hasTrimCurve() )
+    {
+        float32_t speedU = GetMaxSpeed( cvs, numU, numV, true, uOrder,
+                                        surface.uKnot );
+        float32_t speedV = GetMaxSpeed( cvs, numU, numV, false, vOrder,
+                                        surface.vKnot );
+        float32_t speed = std::sqrt( speedU * speedU + speedV * speedV );
+        GetTrimEdges( iSample, speed > 0.0f ? iTolerance / speed : iTolerance,
+                      iMaxSteps, trimStarts, trimEnds );
+    }
+
+    std::vector<bool> kept;
+    GetKeptCells( iSample, trimStarts, trimEnds, uBasis.params, vBasis.params,
+                  kept );
+
+    CutCells cut;
+    CutTrimmedCells( trimStarts, trimEnds, uBasis.params, vBasis.params, cut );
+
+    // only the grid points of kept cells are evaluated here, the cut ones
+    // get theirs as they need them
+    std::vector<int32_t> remap( gridU * gridV, -1 );
+    for ( size_t j = 0; j + 1 < gridV; ++j )
+    {
+        for ( size_t i = 0; i + 1 < gridU; ++i )
+        {
+            size_t cell = j * ( gridU - 1 ) + i;
+            if ( kept[cell] && !cut.cut[cell] )
+            {
+                remap[j * gridU + i] = 0;
+                remap[j * gridU + i + 1] = 0;
+                remap[( j + 1 ) * gridU + i] = 0;
+                remap[( j + 1 ) * gridU + i + 1] = 0;
+            }
+        }
+    }
+
+    for ( size_t j = 0; j < gridV; ++j )
+    {
+        const float32_t *nv = &vBasis.weights[j * vOrder];
+        int32_t firstV = vBasis.firstCvs[j];
+
+        for ( size_t i = 0; i < gridU; ++i )
+        {
+            if ( remap[j * gridU + i] < 0 )
+            {
+                continue;
+            }
+
+            remap[j * gridU + i] = ( int32_t ) oMesh.positions.size();
+            oMesh.positions.push_back( surface.blend(
+                &uBasis.weights[i * uOrder], uBasis.firstCvs[i],
+                nv, firstV ) );
+            oMesh.uvs.push_back( V2f( uBasis.params[i], vBasis.params[j] ) );
+        }
+    }
+
+    VertexCache verts;
+    verts.surface = &surface;
+    verts.uParams = &uBasis.params;
+    verts.vParams = &vBasis.params;
+    verts.remap = &remap;
+    verts.mesh = &oMesh;
+    std::vector<V2f> scratch;
+    std::vector<int32_t> indexScratch;
+
+    for ( size_t j = 0; j + 1 < gridV; ++j )
+    {
+        for ( size_t i = 0; i + 1 < gridU; ++i )
+        {
+            size_t cell = j * ( gridU - 1 ) + i;
+            if ( !kept[cell] || cut.cut[cell] )
+            {
+                continue;
+            }
+
+            // next to a cut cell, there may be more points on the edges
+            if ( ( i > 0 && cut.cut[cell - 1] ) ||
+                 ( i + 2 < gridU && cut.cut[cell + 1] ) ||
+                 ( j > 0 && cut.cut[cell - ( gridU - 1 )] ) ||
+                 ( j + 2 < gridV && cut.cut[cell + ( gridU - 1 )] ) )
+            {
+                Trapezoid whole = { vBasis.params[j], vBasis.params[j + 1],
+                                    uBasis.params[i], uBasis.params[i + 1],
+                                    uBasis.params[i], uBasis.params[i + 1],
+                                    uBasis.params[i], uBasis.params[i + 1] };
+                AddTrapezoidTriangles( whole, cut, verts, scratch,
+                                       indexScratch, oMesh.triangles );
+                continue;
+            }
+
+            int32_t p00 = remap[j * gridU + i];
+            int32_t p10 = remap[j * gridU + i + 1];
+            int32_t p01 = remap[( j + 1 ) * gridU + i];
+            int32_t p11 = remap[( j + 1 ) * gridU + i + 1];
+
+            oMesh.triangles.push_back( p00 );
+            oMesh.triangles.push_back( p01 );
+            oMesh.triangles.push_back( p11 );
+
+            oMesh.triangles.push_back( p00 );
+            oMesh.triangles.push_back( p11 );
+            oMesh.triangles.push_back( p10 );
+        }
+    }
+
+    for ( size_t p = 0; p < cut.pieces.size(); ++p )
+    {
+        AddTrapezoidTriangles( cut.pieces[p], cut, verts, scratch,
+                               indexScratch, oMesh.triangles );
+    }
+}
+
+//-*****************************************************************************
+struct PatchTask
+{
+    const INuPatchSchema::Sample *samples;
+    float32_t tolerance;
+    int32_t maxSteps;
+    NuPatchMesh *meshes;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t p = iBegin; p < iEnd; ++p )
+        {
+            TessellateChecked( samples[p], tolerance, maxSteps, meshes[p] );
+        }
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+void TessellateNuPatch( const INuPatchSchema::Sample &iSample,
+                        float32_t iTolerance, int32_t iMaxSteps,
+                        NuPatchMesh &oMesh )
+{
+    ABCA_ASSERT( iMaxSteps > 0, "NuPatches need at least one step per span, "
+                 "not " << iMaxSteps );
+    CheckNuPatch( iSample );
+    TessellateChecked( iSample, iTolerance, iMaxSteps, oMesh );
+}
+
+//-*****************************************************************************
+void TessellateNuPatches( const std::vector<INuPatchSchema::Sample> &iSamples,
+                          float32_t iTolerance, int32_t iMaxSteps,
+                          std::vector<NuPatchMesh> &oMeshes )
+{
+    ABCA_ASSERT( iMaxSteps > 0, "NuPatches need at least one step per span, "
+                 "not " << iMaxSteps );
+
+    for ( size_t p = 0; p < iSamples.size(); ++p )
+    {
+        CheckNuPatch( iSamples[p] );
+    }
+
+    oMeshes.resize( iSamples.size() );
+    if ( iSamples.empty() )
+    {
+        return;
+    }
+
+    PatchTask task;
+    task.samples = &iSamples.front();
+    task.tolerance = iTolerance;
+    task.maxSteps = iMaxSteps;
+    task.meshes = &oMeshes.front();
+    RunSlices( iSamples.size(), MIN_PATCHES_PER_THREAD, task );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
@@ -0,0 +1,99 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_NuPatchTessellation_h_
+#define _Alembic_AbcGeom_NuPatchTessellation_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/INuPatch.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A NURBS patch turned into triangles. uvs holds the (u, v) parameter of
+//! each position. triangles holds three position indices per triangle,
+//! wound clockwise like polymesh faces, so their normals point along
+//! dS/du x dS/dv.
+struct NuPatchMesh
+{
+    std::vector<V3f> positions;
+    std::vector<V2f> uvs;
+    std::vector<int32_t> triangles;
+
+    void clear()
+    {
+        positions.clear();
+        uvs.clear();
+        triangles.clear();
+    }
+};
+
+//-*****************************************************************************
+//! Tessellates one patch on a grid in parameter space. Each knot span is
+//! split into as many steps as keep the control net's bend within
+//! iTolerance, up to iMaxSteps, so flat directions get a single step.
+//!
+//! Control points are rational with the sample's position weights, and
+//! trim curves are rational with their w values. Knot vectors hold
+//! numU + uOrder and numV + vOrder values, as they are written.
+//!
+//! With trim loops, what is inside an odd number of loops is kept, so an
+//! outer boundary with holes in it works as expected. Grid cells the trims
+//! pass through are cut along them, and the trim curves are stepped finely
+//! enough that the trimmed edge stays within iTolerance of them on the
+//! patch.
+void TessellateNuPatch( const INuPatchSchema::Sample &iSample,
+                        float32_t iTolerance, int32_t iMaxSteps,
+                        NuPatchMesh &oMesh );
+
+//-*****************************************************************************
+//! TessellateNuPatch over many patches, split across threads a patch at
+//! a time. Every sample is checked before any thread starts, so a bad one
+//! throws here without leaving anything half done.
+void TessellateNuPatches( const std::vector<INuPatchSchema::Sample> &iSamples,
+                          float32_t iTolerance, int32_t iMaxSteps,
+                          std::vector<NuPatchMesh> &oMeshes );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,309 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/PointsMotion.h>
+#include <Alembic/AbcGeom/Interpolation.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many points per thread, starting threads costs more than
+// the work.
+static const size_t MIN_POINTS_PER_THREAD = 1 << 16;
+
+typedef boost::unordered_map<uint64_t, int64_t> IdMap;
+
+//-*****************************************************************************
+// Without a map, only points whose id is at the same index in the next
+// sample are matched. With one, the points still unmatched are looked up.
+struct MatchTask
+{
+    const uint64_t *ids;
+    const uint64_t *nextIds;
+    size_t numNext;
+    const IdMap *nextMap;
+    int64_t *matches;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        if ( !nextMap )
+        {
+            for ( size_t i = iBegin; i < iEnd; ++i )
+            {
+                matches[i] = ( i < numNext && nextIds[i] == ids[i] ) ?
+                    ( int64_t ) i : -1;
+            }
+            return;
+        }
+
+        for ( size_t i = iBegin; i < iEnd; ++i )
+        {
+            if ( matches[i] < 0 )
+            {
+                IdMap::const_iterator found = nextMap->find( ids[i] );
+                if ( found != nextMap->end() )
+                {
+                    matches[i] = found->second;
+                }
+            }
+        }
+    }
+};
+
+//-*****************************************************************************
+// Moves every point along its velocity, then moves the matched ones
+// towards the next sample instead. When every point matches the one at
+// the same index, it is a plain lerp.
+struct MoveTask
+{
+    const float32_t *positions;
+    const float32_t *velocities;
+    const float32_t *nextPositions;
+    const int64_t *matches;
+    bool sameOrder;
+    float32_t dt;
+    float32_t alpha;
+    float32_t *out;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        const float32_t *p = positions + iBegin * 3;
+        float32_t *o = out + iBegin * 3;
+        size_t numVals = ( iEnd - iBegin ) * 3;
+
+        if ( nextPositions && sameOrder )
+        {
+            LerpArray( p, nextPositions + iBegin * 3, numVals, alpha, o );
+            return;
+        }
+
+        if ( velocities )
+        {
+            const float32_t *v = velocities + iBegin * 3;
+            for ( size_t i = 0; i < numVals; ++i )
+            {
+                o[i] = p[i] + v[i] * dt;
+            }
+        }
+        else
+        {
+            std::copy( p, p + numVals, o );
+        }
+
+        if ( !nextPositions )
+        {
+            return;
+        }
+
+        for ( size_t i = iBegin; i < iEnd; ++i )
+        {
+            if ( matches[i] >= 0 )
+            {
+                const float32_t *a = positions + i * 3;
+                const float32_t *b = nextPositions + matches[i] * 3;
+                float32_t *c = out + i * 3;
+                c[0] = a[0] + ( b[0] - a[0] ) * alpha;
+                c[1] = a[1] + ( b[1] - a[1] ) * alpha;
+                c[2] = a[2] + ( b[2] - a[2] ) * alpha;
+            }
+        }
+    }
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+void MatchPointIds( const Abc::UInt64ArraySample &iIds,
+                    const Abc::UInt64ArraySample &iNextIds,
+                    std::vector<int64_t> &oMatches )
+{
+    size_t numIds = iIds.size();
+    oMatches.resize( numIds );
+    if ( numIds == 0 )
+    {
+        return;
+    }
+
+    MatchTask task;
+    task.ids = iIds.get();
+    task.nextIds = iNextIds.get();
+    task.numNext = iNextIds.size();
+    task.nextMap = NULL;
+    task.matches = &oMatches.front();
+    RunSlices( numIds, MIN_POINTS_PER_THREAD, task );
+
+    if ( std::find( oMatches.begin(), oMatches.end(), -1 ) ==
+         oMatches.end() )
+    {
+        return;
+    }
+
+    // the first of any repeated ids wins
+    IdMap nextMap( task.numNext );
+    for ( size_t i = 0; i < task.numNext; ++i )
+    {
+        nextMap.insert( IdMap::value_type( task.nextIds[i], i ) );
+    }
+
+    task.nextMap = &nextMap;
+    RunSlices( numIds, MIN_POINTS_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+index_t GetPointsMotion( IPointsSchema &iSchema,
+                         const std::vector<chrono_t> &iTimes,
+                         std::vector<P3fArraySamplePtr> &oPositions )
+{
+    oPositions.clear();
+
+    size_t numSamples = iSchema.getNumSamples();
+    if ( iTimes.empty() || numSamples == 0 )
+    {
+        return 0;
+    }
+
+    AbcA::TimeSamplingPtr ts = iSchema.getTimeSampling();
+    chrono_t firstTime = *std::min_element( iTimes.begin(), iTimes.end() );
+    index_t ref = ts->getFloorIndex( firstTime, numSamples ).first;
+    chrono_t refTime = ts->getSampleTime( ref );
+
+    Abc::ISampleSelector refSel( ref );
+    Abc::IP3fArrayProperty positionsProp = iSchema.getPositionsProperty();
+    P3fArraySamplePtr positions = positionsProp.getValue( refSel );
+    size_t numPoints = positions->size();
+
+    V3fArraySamplePtr velocities;
+    Abc::IV3fArrayProperty velocitiesProp = iSchema.getVelocitiesProperty();
+    if ( velocitiesProp && velocitiesProp.getNumSamples() > 0 )
+    {
+        velocities = velocitiesProp.getValue( refSel );
+        if ( velocities->size() != numPoints )
+        {
+            velocities.reset();
+        }
+    }
+
+    // Match the points up with the next sample, if any of iTimes need it.
+    index_t next = ref + 1;
+    chrono_t nextTime = refTime;
+    P3fArraySamplePtr nextPositions;
+    std::vector<int64_t> matches;
+    bool sameOrder = false;
+    bool moving = false;
+    for ( size_t i = 0; i < iTimes.size(); ++i )
+    {
+        moving = moving || iTimes[i] != refTime;
+    }
+
+    if ( moving && next < ( index_t ) positionsProp.getNumSamples() )
+    {
+        Abc::ISampleSelector nextSel( next );
+        nextTime = ts->getSampleTime( next );
+        nextPositions = positionsProp.getValue( nextSel );
+
+        Abc::IUInt64ArrayProperty idsProp = iSchema.getIdsProperty();
+        UInt64ArraySamplePtr ids = idsProp.getValue( refSel );
+        UInt64ArraySamplePtr nextIds = idsProp.getValue( nextSel );
+
+        if ( nextTime <= refTime || ids->size() != numPoints ||
+             nextIds->size() != nextPositions->size() )
+        {
+            nextPositions.reset();
+        }
+        else if ( SameKeys( idsProp, ref, next ) )
+        {
+            sameOrder = true;
+        }
+        else
+        {
+            MatchPointIds( *ids, *nextIds, matches );
+        }
+    }
+
+    for ( size_t t = 0; t < iTimes.size(); ++t )
+    {
+        chrono_t dt = iTimes[t] - refTime;
+        if ( dt == 0.0 )
+        {
+            oPositions.push_back( positions );
+            continue;
+        }
+
+        P3fArraySamplePtr out =
+            boost::static_pointer_cast<P3fArraySample, AbcA::ArraySample>(
+                AbcA::AllocateArraySample( P3fTPTraits::dataType(),
+                                           Dimensions( numPoints ) ) );
+
+        if ( numPoints > 0 )
+        {
+            MoveTask task;
+            task.positions =
+                reinterpret_cast<const float32_t *>( positions->get() );
+            task.velocities = velocities ?
+                reinterpret_cast<const float32_t *>( velocities->get() ) :
+                NULL;
+            task.nextPositions = nextPositions ?
+                reinterpret_cast<const float32_t *>( nextPositions->get() ) :
+                NULL;
+            task.matches = matches.empty() ? NULL : &matches.front();
+            task.sameOrder = sameOrder;
+            task.dt = ( float32_t ) dt;
+            task.alpha = nextPositions ?
+                ( float32_t ) ( dt / ( nextTime - refTime ) ) : 0.0f;
+            task.out = reinterpret_cast<float32_t *>(
+                const_cast<V3f *>( out->get() ) );
+
+            RunSlices( numPoints, MIN_POINTS_PER_THREAD, task );
+        }
+
+        oPositions.push_back( out );
+    }
+
+    return ref;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
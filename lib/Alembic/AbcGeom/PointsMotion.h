@@ -0,0 +1,80 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_PointsMotion_h_
+#define _Alembic_AbcGeom_PointsMotion_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/IPoints.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Sets oMatches[i] to the index of iIds[i] in iNextIds, or to -1 if it
+//! isn't there. Points that kept their place are matched without a
+//! lookup; the rest go through a hash table of iNextIds.
+void MatchPointIds( const Abc::UInt64ArraySample &iIds,
+                    const Abc::UInt64ArraySample &iNextIds,
+                    std::vector<int64_t> &oMatches );
+
+//-*****************************************************************************
+//! Motion blurred positions of iSchema at each of iTimes, such as the
+//! shutter times of a render, even when points are born and die between
+//! samples.
+//!
+//! Every sample in oPositions has the points of the reference sample,
+//! the one at or before the earliest of iTimes, in its order. The index
+//! of the reference sample is returned, so that its ids, widths and
+//! anything else per point go with all of oPositions. Points that are
+//! also in the sample after the reference, by id, move in a straight line
+//! towards where they are in it. The rest move along their velocities,
+//! taken to be in units per second, or stay put without them.
+//!
+//! Large samples are split across threads.
+index_t GetPointsMotion( IPointsSchema &iSchema,
+                         const std::vector<chrono_t> &iTimes,
+                         std::vector<P3fArraySamplePtr> &oPositions );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,838 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/SubDRefinement.h>
+#include <Alembic/AbcGeom/ThreadUtil.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Below this many refined points per thread, starting threads costs more
+// than the work.
+static const size_t MIN_POINTS_PER_THREAD = 1 << 14;
+
+//-*****************************************************************************
+// Boundary and non-manifold edges stay sharp however far they're refined.
+static const float32_t INFINITELY_SHARP = 1.0e6f;
+
+typedef boost::unordered_map<uint64_t, float32_t> CreaseMap;
+typedef boost::unordered_map<uint64_t, int32_t> EdgeMap;
+
+//-*****************************************************************************
+inline uint64_t EdgeKey( int32_t iA, int32_t iB )
+{
+    if ( iA > iB )
+    {
+        std::swap( iA, iB );
+    }
+    return ( ( uint64_t ) ( uint32_t ) iA << 32 ) | ( uint32_t ) iB;
+}
+
+//-*****************************************************************************
+// One level of the mesh as it is refined. Creases are keyed by their
+// vertex pairs, since edges are only numbered while a level is refined.
+struct Level
+{
+    size_t numVertices;
+    std::vector<int32_t> faceOffsets;
+    std::vector<int32_t> faceIndices;
+    std::vector<char> holes;
+    CreaseMap creases;
+    std::vector<float32_t> corners;
+};
+
+//-*****************************************************************************
+// Every point of a level as a weighted sum of control points.
+struct Stencils
+{
+    std::vector<int32_t> offsets;
+    std::vector<int32_t> indices;
+    std::vector<float32_t> weights;
+};
+
+//-*****************************************************************************
+// Sums weighted stencils of one level into a stencil of the next, in a
+// dense row over the control points with a list of what it touched, so
+// each new stencil only costs its own terms.
+class StencilBuilder
+{
+public:
+    StencilBuilder( const Stencils &iPrev, size_t iNumControlPoints,
+                    Stencils &oNext )
+      : m_prev( iPrev )
+      , m_next( oNext )
+      , m_row( iNumControlPoints, 0.0f )
+      , m_used( iNumControlPoints, 0 )
+    {
+        m_next.offsets.assign( 1, 0 );
+        m_next.indices.clear();
+        m_next.weights.clear();
+    }
+
+    void add( int32_t iPoint, float32_t iWeight )
+    {
+        for ( int32_t i = m_prev.offsets[iPoint];
+              i < m_prev.offsets[iPoint + 1]; ++i )
+        {
+            int32_t c = m_prev.indices[i];
+            if ( !m_used[c] )
+            {
+                m_used[c] = 1;
+                m_touched.push_back( c );
+            }
+            m_row[c] += iWeight * m_prev.weights[i];
+        }
+    }
+
+    // sorted, so applying a stencil reads the positions in order
+    void emit()
+    {
+        std::sort( m_touched.begin(), m_touched.end() );
+        for ( size_t i = 0; i < m_touched.size(); ++i )
+        {
+            int32_t c = m_touched[i];
+            if ( m_row[c] != 0.0f )
+            {
+                m_next.indices.push_back( c );
+                m_next.weights.push_back( m_row[c] );
+            }
+            m_row[c] = 0.0f;
+            m_used[c] = 0;
+        }
+        m_touched.clear();
+        m_next.offsets.push_back( ( int32_t ) m_next.indices.size() );
+    }
+
+private:
+    const Stencils &m_prev;
+    Stencils &m_next;
+    std::vector<float32_t> m_row;
+    std::vector<char> m_used;
+    std::vector<int32_t> m_touched;
+};
+
+//-*****************************************************************************
+// Builds a compressed row list from parallel ( row, value ) pairs.
+void BuildAdjacency( size_t iNumRows, const std::vector<int32_t> &iRows,
+                     const std::vector<int32_t> &iValues,
+                     std::vector<int32_t> &oOffsets,
+                     std::vector<int32_t> &oValues )
+{
+    oOffsets.assign( iNumRows + 1, 0 );
+    for ( size_t i = 0; i < iRows.size(); ++i )
+    {
+        ++oOffsets[iRows[i] + 1];
+    }
+    for ( size_t r = 0; r < iNumRows; ++r )
+    {
+        oOffsets[r + 1] += oOffsets[r];
+    }
+
+    oValues.resize( iValues.size() );
+    std::vector<int32_t> next( oOffsets.begin(), oOffsets.end() - 1 );
+    for ( size_t i = 0; i < iRows.size(); ++i )
+    {
+        oValues[next[iRows[i]]++] = iValues[i];
+    }
+}
+
+//-*****************************************************************************
+// One level of Catmull-Clark. The next level's points are numbered vertex
+// points first, then face points, then edge points, and every face is
+// split into one quad per corner, keeping its winding.
+void RefineLevel( const Level &iLevel, int32_t iInterpolateBoundary,
+                  const Stencils &iPrev, size_t iNumControlPoints,
+                  Level &oLevel, Stencils &oNext )
+{
+    size_t numVerts = iLevel.numVertices;
+    size_t numFaces = iLevel.faceOffsets.size() - 1;
+    const std::vector<int32_t> &offsets = iLevel.faceOffsets;
+    const std::vector<int32_t> &indices = iLevel.faceIndices;
+
+    // number the edges, each corner's edge going to the next corner
+    EdgeMap edgeMap;
+    std::vector<int32_t> edgeVerts;
+    std::vector<int32_t> edgeFaces;
+    std::vector<int32_t> edgeNumFaces;
+    std::vector<int32_t> cornerEdges( indices.size() );
+    for ( size_t f = 0; f < numFaces; ++f )
+    {
+        int32_t n = offsets[f + 1] - offsets[f];
+        for ( int32_t i = 0; i < n; ++i )
+        {
+            int32_t a = indices[offsets[f] + i];
+            int32_t b = indices[offsets[f] + ( i + 1 ) % n];
+            std::pair<EdgeMap::iterator, bool> found = edgeMap.insert(
+                EdgeMap::value_type( EdgeKey( a, b ),
+                                     ( int32_t ) edgeNumFaces.size() ) );
+            int32_t e = found.first->second;
+            if ( found.second )
+            {
+                edgeVerts.push_back( a );
+                edgeVerts.push_back( b );
+                edgeFaces.push_back( -1 );
+                edgeFaces.push_back( -1 );
+                edgeNumFaces.push_back( 0 );
+            }
+
+            if ( edgeNumFaces[e] < 2 )
+            {
+                edgeFaces[e * 2 + edgeNumFaces[e]] = ( int32_t ) f;
+            }
+            ++edgeNumFaces[e];
+            cornerEdges[offsets[f] + i] = e;
+        }
+    }
+    size_t numEdges = edgeNumFaces.size();
+
+    std::vector<float32_t> creases( numEdges, 0.0f );
+    std::vector<float32_t> sharpness( numEdges, INFINITELY_SHARP );
+    for ( size_t e = 0; e < numEdges; ++e )
+    {
+        CreaseMap::const_iterator found = iLevel.creases.find(
+            EdgeKey( edgeVerts[e * 2], edgeVerts[e * 2 + 1] ) );
+        if ( found != iLevel.creases.end() )
+        {
+            creases[e] = found->second;
+        }
+        if ( edgeNumFaces[e] == 2 )
+        {
+            sharpness[e] = creases[e];
+        }
+    }
+
+    // the faces and edges around each vertex
+    std::vector<int32_t> rows;
+    std::vector<int32_t> values;
+    for ( size_t f = 0; f < numFaces; ++f )
+    {
+        for ( int32_t i = offsets[f]; i < offsets[f + 1]; ++i )
+        {
+            rows.push_back( indices[i] );
+            values.push_back( ( int32_t ) f );
+        }
+    }
+    std::vector<int32_t> vertexFaceOffsets;
+    std::vector<int32_t> vertexFaces;
+    BuildAdjacency( numVerts, rows, values, vertexFaceOffsets, vertexFaces );
+
+    rows.clear();
+    values.clear();
+    for ( size_t e = 0; e < numEdges; ++e )
+    {
+        rows.push_back( edgeVerts[e * 2] );
+        values.push_back( ( int32_t ) e );
+        rows.push_back( edgeVerts[e * 2 + 1] );
+        values.push_back( ( int32_t ) e );
+    }
+    std::vector<int32_t> vertexEdgeOffsets;
+    std::vector<int32_t> vertexEdges;
+    BuildAdjacency( numVerts, rows, values, vertexEdgeOffsets, vertexEdges );
+
+    StencilBuilder builder( iPrev, iNumControlPoints, oNext );
+
+    // vertex points
+    for ( size_t v = 0; v < numVerts; ++v )
+    {
+        int32_t vi = ( int32_t ) v;
+        int32_t numVertEdges = vertexEdgeOffsets[v + 1] -
+            vertexEdgeOffsets[v];
+        int32_t numVertFaces = vertexFaceOffsets[v + 1] -
+            vertexFaceOffsets[v];
+
+        if ( numVertEdges == 0 )
+        {
+            builder.add( vi, 1.0f );
+            builder.emit();
+            continue;
+        }
+
+        int32_t numSharp = 0;
+        int32_t numBoundary = 0;
+        float32_t sharpSum = 0.0f;
+        int32_t sharpEnds[2] = { vi, vi };
+        for ( int32_t i = vertexEdgeOffsets[v];
+              i < vertexEdgeOffsets[v + 1]; ++i )
+        {
+            int32_t e = vertexEdges[i];
+            if ( edgeNumFaces[e] != 2 )
+            {
+                ++numBoundary;
+            }
+            if ( sharpness[e] > 0.0f )
+            {
+                if ( numSharp < 2 )
+                {
+                    sharpEnds[numSharp] = edgeVerts[e * 2] == vi ?
+                        edgeVerts[e * 2 + 1] : edgeVerts[e * 2];
+                }
+                ++numSharp;
+                sharpSum += sharpness[e];
+            }
+        }
+
+        float32_t corner = iLevel.corners[v];
+        if ( iInterpolateBoundary == 1 && numVertFaces == 1 &&
+             numBoundary == 2 )
+        {
+            corner = INFINITELY_SHARP;
+        }
+
+        float32_t sharpT = numSharp > 0 ?
+            std::min( sharpSum / numSharp, 1.0f ) : 0.0f;
+        float32_t cornerT = std::min( corner, 1.0f );
+        if ( numSharp > 2 )
+        {
+            cornerT = std::max( cornerT, sharpT );
+        }
+        float32_t creaseT = numSharp == 2 ? sharpT : 0.0f;
+        float32_t creaseW = creaseT * ( 1.0f - cornerT );
+        float32_t smoothW = ( 1.0f - creaseT ) * ( 1.0f - cornerT );
+
+        // a corner stays put
+        builder.add( vi, cornerT );
+
+        // ( a + 6v + b ) / 8 along a crease
+        if ( creaseW > 0.0f )
+        {
+            builder.add( vi, creaseW * 0.75f );
+            builder.add( sharpEnds[0], creaseW * 0.125f );
+            builder.add( sharpEnds[1], creaseW * 0.125f );
+        }
+
+        // ( F + 2R + ( n - 3 ) v ) / n, with F the average face point and
+        // R the average edge midpoint
+        if ( smoothW > 0.0f )
+        {
+            float32_t n = ( float32_t ) numVertEdges;
+            for ( int32_t i = vertexFaceOffsets[v];
+                  i < vertexFaceOffsets[v + 1]; ++i )
+            {
+                int32_t f = vertexFaces[i];
+                float32_t w = smoothW /
+                    ( n * numVertFaces * ( offsets[f + 1] - offsets[f] ) );
+                for ( int32_t j = offsets[f]; j < offsets[f + 1]; ++j )
+                {
+                    builder.add( indices[j], w );
+                }
+            }
+
+            float32_t w = smoothW / ( n * n );
+            for ( int32_t i = vertexEdgeOffsets[v];
+                  i < vertexEdgeOffsets[v + 1]; ++i )
+            {
+                int32_t e = vertexEdges[i];
+                builder.add( edgeVerts[e * 2], w );
+                builder.add( edgeVerts[e * 2 + 1], w );
+            }
+
+            builder.add( vi, smoothW * ( n - 3.0f ) / n );
+        }
+
+        builder.emit();
+    }
+
+    // face points
+    for ( size_t f = 0; f < numFaces; ++f )
+    {
+        float32_t w = 1.0f / ( offsets[f + 1] - offsets[f] );
+        for ( int32_t i = offsets[f]; i < offsets[f + 1]; ++i )
+        {
+            builder.add( indices[i], w );
+        }
+        builder.emit();
+    }
+
+    // edge points, between the midpoint and the average of the ends and
+    // the face points
+    for ( size_t e = 0; e < numEdges; ++e )
+    {
+        int32_t a = edgeVerts[e * 2];
+        int32_t b = edgeVerts[e * 2 + 1];
+        float32_t sharpT = std::min( sharpness[e], 1.0f );
+
+        builder.add( a, 0.5f * sharpT );
+        builder.add( b, 0.5f * sharpT );
+
+        if ( sharpT < 1.0f )
+        {
+            float32_t smoothW = 1.0f - sharpT;
+            builder.add( a, 0.25f * smoothW );
+            builder.add( b, 0.25f * smoothW );
+            for ( size_t k = 0; k < 2; ++k )
+            {
+                int32_t f = edgeFaces[e * 2 + k];
+                float32_t w = 0.25f * smoothW / ( offsets[f + 1] - offsets[f] );
+                for ( int32_t i = offsets[f]; i < offsets[f + 1]; ++i )
+                {
+                    builder.add( indices[i], w );
+                }
+            }
+        }
+        builder.emit();
+    }
+
+    // the next level's faces
+    int32_t firstFacePoint = ( int32_t ) numVerts;
+    int32_t firstEdgePoint = ( int32_t ) ( numVerts + numFaces );
+
+    oLevel.numVertices = numVerts + numFaces + numEdges;
+    oLevel.faceOffsets.assign( 1, 0 );
+    oLevel.faceIndices.clear();
+    oLevel.holes.clear();
+    for ( size_t f = 0; f < numFaces; ++f )
+    {
+        int32_t n = offsets[f + 1] - offsets[f];
+        for ( int32_t i = 0; i < n; ++i )
+        {
+            int32_t corner = offsets[f] + i;
+            int32_t prev = offsets[f] + ( i + n - 1 ) % n;
+            oLevel.faceIndices.push_back( indices[corner] );
+            oLevel.faceIndices.push_back( firstEdgePoint +
+                                          cornerEdges[corner] );
+            oLevel.faceIndices.push_back( firstFacePoint + ( int32_t ) f );
+            oLevel.faceIndices.push_back( firstEdgePoint +
+                                          cornerEdges[prev] );
+            oLevel.faceOffsets.push_back(
+                ( int32_t ) oLevel.faceIndices.size() );
+            oLevel.holes.push_back( iLevel.holes[f] );
+        }
+    }
+
+    // creases and corners lose a unit of sharpness a level
+    oLevel.creases.clear();
+    for ( size_t e = 0; e < numEdges; ++e )
+    {
+        if ( creases[e] > 1.0f )
+        {
+            int32_t mid = firstEdgePoint + ( int32_t ) e;
+            oLevel.creases[EdgeKey( edgeVerts[e * 2], mid )] =
+                creases[e] - 1.0f;
+            oLevel.creases[EdgeKey( mid, edgeVerts[e * 2 + 1] )] =
+                creases[e] - 1.0f;
+        }
+    }
+
+    oLevel.corners.assign( oLevel.numVertices, 0.0f );
+    for ( size_t v = 0; v < numVerts; ++v )
+    {
+        oLevel.corners[v] = std::max( iLevel.corners[v] - 1.0f, 0.0f );
+    }
+}
+
+//-*****************************************************************************
+// Reads the sample into the first level, checking it on the way.
+void GetBaseLevel( const ISubDSchema::Sample &iSample, Level &oLevel )
+{
+    ABCA_ASSERT( iSample.valid(), "SubD sample is missing its positions, "
+                 "face counts or face indices" );
+
+    ABCA_ASSERT( iSample.getSubdivisionScheme().empty() ||
+                 iSample.getSubdivisionScheme() == "catmull-clark",
+                 "Can't refine the " << iSample.getSubdivisionScheme()
+                 << " subdivision scheme" );
+
+    const Int32ArraySample &counts = *iSample.getFaceCounts();
+    const Int32ArraySample &indices = *iSample.getFaceIndices();
+    int32_t numPoints = ( int32_t ) iSample.getPositions()->size();
+
+    oLevel.numVertices = numPoints;
+    oLevel.faceOffsets.assign( 1, 0 );
+    for ( size_t f = 0; f < counts.size(); ++f )
+    {
+        ABCA_ASSERT( counts[f] >= 3, "Face " << f << " has " << counts[f]
+                     << " vertices" );
+        oLevel.faceOffsets.push_back( oLevel.faceOffsets.back() + counts[f] );
+    }
+
+    ABCA_ASSERT( ( size_t ) oLevel.faceOffsets.back() == indices.size(),
+                 "Face counts add up to " << oLevel.faceOffsets.back()
+                 << " but there are " << indices.size() << " face indices" );
+
+    oLevel.faceIndices.assign( indices.get(), indices.get() + indices.size() );
+    for ( size_t i = 0; i < indices.size(); ++i )
+    {
+        ABCA_ASSERT( indices[i] >= 0 && indices[i] < numPoints,
+                     "Face index " << i << " is " << indices[i]
+                     << " with only " << numPoints << " positions" );
+    }
+
+    oLevel.holes.assign( counts.size(), 0 );
+    if ( iSample.getHoles() )
+    {
+        const Int32ArraySample &holes = *iSample.getHoles();
+        for ( size_t i = 0; i < holes.size(); ++i )
+        {
+            ABCA_ASSERT( holes[i] >= 0 && ( size_t ) holes[i] < counts.size(),
+                         "Hole " << holes[i] << " isn't a face" );
+            oLevel.holes[holes[i]] = 1;
+        }
+    }
+
+    // each crease is a chain of vertices, with one sharpness for the whole
+    // chain or one for each of its edges
+    oLevel.creases.clear();
+    if ( iSample.getCreaseIndices() && iSample.getCreaseLengths() &&
+         iSample.getCreaseSharpnesses() )
+    {
+        const Int32ArraySample &creaseIndices = *iSample.getCreaseIndices();
+        const Int32ArraySample &lengths = *iSample.getCreaseLengths();
+        const FloatArraySample &sharpnesses =
+            *iSample.getCreaseSharpnesses();
+
+        size_t numIndices = 0;
+        size_t numEdges = 0;
+        for ( size_t c = 0; c < lengths.size(); ++c )
+        {
+            ABCA_ASSERT( lengths[c] >= 2, "Crease " << c << " has "
+                         << lengths[c] << " vertices" );
+            numIndices += lengths[c];
+            numEdges += lengths[c] - 1;
+        }
+
+        ABCA_ASSERT( numIndices == creaseIndices.size(),
+                     "Crease lengths add up to " << numIndices << " but "
+                     "there are " << creaseIndices.size()
+                     << " crease indices" );
+
+        bool perEdge = sharpnesses.size() != lengths.size();
+        ABCA_ASSERT( !perEdge || sharpnesses.size() == numEdges,
+                     "Can't match " << sharpnesses.size()
+                     << " crease sharpnesses to " << lengths.size()
+                     << " creases" );
+
+        size_t first = 0;
+        size_t edge = 0;
+        for ( size_t c = 0; c < lengths.size(); ++c )
+        {
+            for ( int32_t k = 0; k + 1 < lengths[c]; ++k, ++edge )
+            {
+                oLevel.creases[EdgeKey( creaseIndices[first + k],
+                                        creaseIndices[first + k + 1] )] =
+                    sharpnesses[perEdge ? edge : c];
+            }
+            first += lengths[c];
+        }
+    }
+
+    oLevel.corners.assign( numPoints, 0.0f );
+    if ( iSample.getCornerIndices() && iSample.getCornerSharpnesses() )
+    {
+        const Int32ArraySample &corners = *iSample.getCornerIndices();
+        const FloatArraySample &sharpnesses =
+            *iSample.getCornerSharpnesses();
+
+        ABCA_ASSERT( corners.size() == sharpnesses.size(),
+                     "There are " << corners.size() << " corners but "
+                     << sharpnesses.size() << " corner sharpnesses" );
+
+        for ( size_t i = 0; i < corners.size(); ++i )
+        {
+            ABCA_ASSERT( corners[i] >= 0 && corners[i] < numPoints,
+                         "Corner " << corners[i] << " isn't a position" );
+            oLevel.corners[corners[i]] = sharpnesses[i];
+        }
+    }
+}
+
+//-*****************************************************************************
+struct ApplyTask
+{
+    const int32_t *offsets;
+    const int32_t *indices;
+    const float32_t *weights;
+    const V3f *in;
+    V3f *out;
+
+    void operator()( size_t iBegin, size_t iEnd ) const
+    {
+        for ( size_t p = iBegin; p < iEnd; ++p )
+        {
+            float32_t x = 0.0f;
+            float32_t y = 0.0f;
+            float32_t z = 0.0f;
+            for ( int32_t i = offsets[p]; i < offsets[p + 1]; ++i )
+            {
+                const V3f &q = in[indices[i]];
+                float32_t w = weights[i];
+                x += q.x * w;
+                y += q.y * w;
+                z += q.z * w;
+            }
+            out[p] = V3f( x, y, z );
+        }
+    }
+};
+
+//-*****************************************************************************
+// A property that isn't there has the same key every time.
+template <class PROP>
+bool AppendKey( PROP iProp, const Abc::ISampleSelector &iSS,
+                std::vector<AbcA::ArraySampleKey> &oKeys )
+{
+    AbcA::ArraySampleKey key;
+    key.numBytes = 0;
+    key.origPOD = key.readPOD = kUnknownPOD;
+
+    if ( iProp && !iProp.getKey( key, iSS ) )
+    {
+        return false;
+    }
+    oKeys.push_back( key );
+    return true;
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+SubDRefinement::SubDRefinement( const ISubDSchema::Sample &iSample,
+                                size_t iLevels )
+  : m_levels( iLevels )
+{
+    Level level;
+    GetBaseLevel( iSample, level );
+    m_numControlPoints = level.numVertices;
+
+    // to start with, each point is itself
+    Stencils stencils;
+    stencils.offsets.resize( m_numControlPoints + 1 );
+    stencils.indices.resize( m_numControlPoints );
+    stencils.weights.assign( m_numControlPoints, 1.0f );
+    for ( size_t i = 0; i <= m_numControlPoints; ++i )
+    {
+        stencils.offsets[i] = ( int32_t ) i;
+        if ( i < m_numControlPoints )
+        {
+            stencils.indices[i] = ( int32_t ) i;
+        }
+    }
+
+    for ( size_t l = 0; l < iLevels; ++l )
+    {
+        Level next;
+        Stencils nextStencils;
+        RefineLevel( level, iSample.getInterpolateBoundary(), stencils,
+                     m_numControlPoints, next, nextStencils );
+        std::swap( level, next );
+        std::swap( stencils, nextStencils );
+    }
+
+    m_stencilOffsets.swap( stencils.offsets );
+    m_stencilIndices.swap( stencils.indices );
+    m_stencilWeights.swap( stencils.weights );
+
+    for ( size_t f = 0; f + 1 < level.faceOffsets.size(); ++f )
+    {
+        if ( !level.holes[f] )
+        {
+            m_faceCounts.push_back( level.faceOffsets[f + 1] -
+                                    level.faceOffsets[f] );
+            m_faceIndices.insert( m_faceIndices.end(),
+                level.faceIndices.begin() + level.faceOffsets[f],
+                level.faceIndices.begin() + level.faceOffsets[f + 1] );
+        }
+    }
+}
+
+//-*****************************************************************************
+void SubDRefinement::refine( const P3fArraySample &iPositions,
+                             std::vector<V3f> &oPositions ) const
+{
+    ABCA_ASSERT( iPositions.size() == m_numControlPoints,
+                 "SubD was refined for " << m_numControlPoints
+                 << " positions, not " << iPositions.size() );
+
+    oPositions.resize( getNumPoints() );
+    if ( oPositions.empty() )
+    {
+        return;
+    }
+
+    ApplyTask task;
+    task.offsets = &m_stencilOffsets.front();
+    task.indices = m_stencilIndices.empty() ? NULL :
+        &m_stencilIndices.front();
+    task.weights = m_stencilWeights.empty() ? NULL :
+        &m_stencilWeights.front();
+    task.in = iPositions.get();
+    task.out = &oPositions.front();
+    RunSlices( oPositions.size(), MIN_POINTS_PER_THREAD, task );
+}
+
+//-*****************************************************************************
+size_t SubDRefinement::getMemoryUsage() const
+{
+    return ( m_faceCounts.size() + m_faceIndices.size() +
+             m_stencilOffsets.size() + m_stencilIndices.size() ) *
+        sizeof( int32_t ) + m_stencilWeights.size() * sizeof( float32_t );
+}
+
+//-*****************************************************************************
+SubDRefinementCache::SubDRefinementCache( size_t iMaxBytes )
+  : m_maxBytes( iMaxBytes )
+  , m_bytes( 0 )
+{
+}
+
+//-*****************************************************************************
+SubDRefinementPtr
+SubDRefinementCache::get( ISubDSchema &iSchema, size_t iLevels,
+                          const Abc::ISampleSelector &iSS )
+{
+    Key key;
+    key.levels = iLevels;
+    key.interpolateBoundary = 0;
+
+    bool keyed =
+        AppendKey( iSchema.getFaceCountsProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getFaceIndicesProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getCreaseIndicesProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getCreaseLengthsProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getCreaseSharpnessesProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getCornerIndicesProperty(), iSS, key.keys ) &&
+        AppendKey( iSchema.getCornerSharpnessesProperty(), iSS,
+                   key.keys ) &&
+        AppendKey( iSchema.getHolesProperty(), iSS, key.keys );
+
+    // Positions past the last indexed one still get stencils, so the
+    // same topology with a different number of them refines differently.
+    Dimensions positionDims;
+    iSchema.getPositionsProperty().getDimensions( positionDims, iSS );
+    key.numPositions = positionDims.numPoints();
+
+    if ( iSchema.getInterpolateBoundaryProperty() )
+    {
+        key.interpolateBoundary =
+            iSchema.getInterpolateBoundaryProperty().getValue( iSS );
+    }
+
+    if ( keyed )
+    {
+        boost::mutex::scoped_lock l( m_mutex );
+        EntryMap::iterator found = m_map.find( key );
+        if ( found != m_map.end() )
+        {
+            m_entries.splice( m_entries.begin(), m_entries, found->second );
+            return found->second->second;
+        }
+    }
+
+    // built without the lock, so other subds aren't held up
+    ISubDSchema::Sample samp;
+    iSchema.get( samp, iSS );
+    SubDRefinementPtr ret( new SubDRefinement( samp, iLevels ) );
+
+    if ( !keyed )
+    {
+        return ret;
+    }
+
+    boost::mutex::scoped_lock l( m_mutex );
+    EntryMap::iterator found = m_map.find( key );
+    if ( found != m_map.end() )
+    {
+        m_entries.splice( m_entries.begin(), m_entries, found->second );
+        return found->second->second;
+    }
+
+    m_entries.push_front( Entry( key, ret ) );
+    m_map[key] = m_entries.begin();
+    m_bytes += ret->getMemoryUsage();
+    evict();
+
+    return ret;
+}
+
+//-*****************************************************************************
+void SubDRefinementCache::evict()
+{
+    while ( m_bytes > m_maxBytes && !m_entries.empty() )
+    {
+        m_bytes -= m_entries.back().second->getMemoryUsage();
+        m_map.erase( m_entries.back().first );
+        m_entries.pop_back();
+    }
+}
+
+//-*****************************************************************************
+size_t SubDRefinementCache::getMaxBytes()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_maxBytes;
+}
+
+//-*****************************************************************************
+void SubDRefinementCache::setMaxBytes( size_t iMaxBytes )
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    m_maxBytes = iMaxBytes;
+    evict();
+}
+
+//-*****************************************************************************
+size_t SubDRefinementCache::getMemoryUsage()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_bytes;
+}
+
+//-*****************************************************************************
+size_t SubDRefinementCache::size()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    return m_entries.size();
+}
+
+//-*****************************************************************************
+void SubDRefinementCache::clear()
+{
+    boost::mutex::scoped_lock l( m_mutex );
+    m_entries.clear();
+    m_map.clear();
+    m_bytes = 0;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
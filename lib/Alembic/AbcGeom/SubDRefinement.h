@@ -0,0 +1,188 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_SubDRefinement_h_
+#define _Alembic_AbcGeom_SubDRefinement_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/ISubD.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Catmull-Clark refinement of one subd topology by a number of levels,
+//! worked out once as stencils: each refined point is a weighted sum of
+//! control points. Refining a deforming frame then only applies the
+//! stencils to its positions.
+//!
+//! Creases follow the semi-sharp rules of DeRose et al., losing one unit
+//! of sharpness a level, and corners do the same. Boundary edges are
+//! always sharp; an interpolateBoundary of 1 also pins the corners of the
+//! boundary. Holes are refined like any other face, but none of their
+//! faces are output.
+class SubDRefinement : private boost::noncopyable
+{
+public:
+    //! Throws if the sample isn't a valid catmull-clark subd.
+    SubDRefinement( const ISubDSchema::Sample &iSample, size_t iLevels );
+
+    size_t getLevels() const { return m_levels; }
+
+    size_t getNumControlPoints() const { return m_numControlPoints; }
+
+    size_t getNumPoints() const { return m_stencilOffsets.size() - 1; }
+
+    //! The refined faces, all quads once there is a level of refinement,
+    //! without the holes.
+    const std::vector<int32_t> &getFaceCounts() const
+    { return m_faceCounts; }
+
+    const std::vector<int32_t> &getFaceIndices() const
+    { return m_faceIndices; }
+
+    //! The stencil of refined point p is getStencilIndices() and
+    //! getStencilWeights() from getStencilOffsets()[p] up to
+    //! getStencilOffsets()[p+1].
+    const std::vector<int32_t> &getStencilOffsets() const
+    { return m_stencilOffsets; }
+
+    const std::vector<int32_t> &getStencilIndices() const
+    { return m_stencilIndices; }
+
+    const std::vector<float32_t> &getStencilWeights() const
+    { return m_stencilWeights; }
+
+    //! The refined positions for one frame's control points, split across
+    //! threads for large meshes.
+    void refine( const P3fArraySample &iPositions,
+                 std::vector<V3f> &oPositions ) const;
+
+    //! Bytes used by the stencils and faces.
+    size_t getMemoryUsage() const;
+
+private:
+    size_t m_levels;
+    size_t m_numControlPoints;
+    std::vector<int32_t> m_faceCounts;
+    std::vector<int32_t> m_faceIndices;
+    std::vector<int32_t> m_stencilOffsets;
+    std::vector<int32_t> m_stencilIndices;
+    std::vector<float32_t> m_stencilWeights;
+};
+
+typedef boost::shared_ptr<const SubDRefinement> SubDRefinementPtr;
+
+//-*****************************************************************************
+//! Shares SubDRefinement between every subd and frame with the same
+//! topology, creases, corners, holes and boundary setting at the same
+//! level, as told by their sample keys. Like MeshTopologyCache, the least
+//! recently used are dropped once it is over its memory budget.
+//! This class is multithread safe.
+class SubDRefinementCache : private boost::noncopyable
+{
+public:
+    explicit SubDRefinementCache( size_t iMaxBytes = 256 * 1024 * 1024 );
+
+    SubDRefinementPtr get( ISubDSchema &iSchema, size_t iLevels,
+                           const Abc::ISampleSelector &iSS =
+                           Abc::ISampleSelector() );
+
+    size_t getMaxBytes();
+
+    //! Drops refinements until the cache is within iMaxBytes.
+    void setMaxBytes( size_t iMaxBytes );
+
+    size_t getMemoryUsage();
+
+    //! How many refinements are held.
+    size_t size();
+
+    void clear();
+
+private:
+    struct Key
+    {
+        std::vector<AbcA::ArraySampleKey> keys;
+        int32_t interpolateBoundary;
+        size_t levels;
+
+        // the stencils are built for this many control points
+        size_t numPositions;
+
+        bool operator<( const Key &iRhs ) const
+        {
+            if ( levels != iRhs.levels ) { return levels < iRhs.levels; }
+            if ( numPositions != iRhs.numPositions )
+            { return numPositions < iRhs.numPositions; }
+            if ( interpolateBoundary != iRhs.interpolateBoundary )
+            { return interpolateBoundary < iRhs.interpolateBoundary; }
+            return keys < iRhs.keys;
+        }
+    };
+
+    typedef std::pair<Key, SubDRefinementPtr> Entry;
+
+    // most recently used first
+    typedef std::list<Entry> EntryList;
+    typedef std::map<Key, EntryList::iterator> EntryMap;
+
+    void evict();
+
+    boost::mutex m_mutex;
+    EntryList m_entries;
+    EntryMap m_map;
+    size_t m_maxBytes;
+    size_t m_bytes;
+};
+
+typedef boost::shared_ptr<SubDRefinementCache> SubDRefinementCachePtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,277 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A grid of unit boxes two apart, a row of them under each xform, and one
+// more box moving up under its own animated xform.
+static const int32_t g_gridSize = 40;
+
+//-*****************************************************************************
+void writePoints( OObject iParent, const std::string &iName,
+                  const V3f &iMin )
+{
+    V3f p[2] = { iMin, iMin + V3f( 1.0f, 1.0f, 1.0f ) };
+    uint64_t ids[2] = { 0, 1 };
+
+    OPoints points( iParent, iName );
+    points.getSchema().set( OPointsSchema::Sample( P3fArraySample( p, 2 ),
+        UInt64ArraySample( ids, 2 ) ) );
+}
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+
+    for ( int32_t y = 0; y < g_gridSize; ++y )
+    {
+        std::ostringstream rowName;
+        rowName << "row" << y;
+        OXform row( archive.getTop(), rowName.str() );
+
+        XformSample samp;
+        samp.setTranslation( V3d( 0.0, 2.0 * y, 0.0 ) );
+        row.getSchema().set( samp );
+
+        for ( int32_t x = 0; x < g_gridSize; ++x )
+        {
+            std::ostringstream name;
+            name << "box" << x;
+            writePoints( row, name.str(), V3f( 2.0f * x, 0.0f, 0.0f ) );
+        }
+    }
+
+    // at time 0 and 1
+    OXform mover( archive.getTop(), "mover" );
+    for ( size_t s = 0; s < 2; ++s )
+    {
+        XformSample samp;
+        samp.setTranslation( V3d( -10.0, -10.0, 10.0 * s ) );
+        mover.getSchema().set( samp );
+    }
+    writePoints( mover, "box", V3f( 0.0f, 0.0f, 0.0f ) );
+}
+
+//-*****************************************************************************
+std::vector<size_t> sorted( std::vector<size_t> iObjects )
+{
+    std::sort( iObjects.begin(), iObjects.end() );
+    return iObjects;
+}
+
+//-*****************************************************************************
+// The tree has to find just what checking every object finds.
+void checkQueries( const ArchiveBVH &iBVH )
+{
+    std::vector<size_t> found;
+    std::vector<size_t> expected;
+
+    Box3d boxes[3] = {
+        Box3d( V3d( 3.5, 3.5, -1.0 ), V3d( 8.5, 6.5, 0.5 ) ),
+        Box3d( V3d( -100.0, -100.0, 9.5 ), V3d( 100.0, 100.0, 20.0 ) ),
+        Box3d( V3d( 1000.0, 1000.0, 1000.0 ), V3d( 1001.0, 1001.0, 1001.0 ) )
+    };
+    for ( size_t b = 0; b < 3; ++b )
+    {
+        iBVH.findInBox( boxes[b], found );
+        expected.clear();
+        for ( size_t i = 0; i < iBVH.getNumObjects(); ++i )
+        {
+            if ( iBVH.getObjectBounds( i ).intersects( boxes[b] ) )
+            {
+                expected.push_back( i );
+            }
+        }
+        TESTING_ASSERT( sorted( found ) == expected );
+    }
+
+    // looking straight down at part of the grid
+    CameraSample camera;
+    M44d cameraToWorld;
+    cameraToWorld.setTranslation( V3d( 20.0, 20.0, 30.0 ) );
+    Frustum frustum( camera, cameraToWorld );
+    iBVH.findInFrustum( frustum, found );
+    expected.clear();
+    for ( size_t i = 0; i < iBVH.getNumObjects(); ++i )
+    {
+        if ( frustum.intersects( iBVH.getObjectBounds( i ) ) )
+        {
+            expected.push_back( i );
+        }
+    }
+    TESTING_ASSERT( !found.empty() && found.size() < iBVH.getNumObjects() );
+    TESTING_ASSERT( sorted( found ) == expected );
+
+    // a ray across a row, through the boxes in order
+    iBVH.findAlongRay( V3d( -5.0, 6.5, 0.5 ), V3d( 1.0, 0.0, 0.0 ), found );
+    TESTING_ASSERT( found.size() == ( size_t ) g_gridSize );
+    for ( size_t i = 0; i < found.size(); ++i )
+    {
+        std::ostringstream name;
+        name << "/row3/box" << i;
+        TESTING_ASSERT( iBVH.getObjectFullName( found[i] ) == name.str() );
+    }
+
+    // and stopped short
+    iBVH.findAlongRay( V3d( -5.0, 6.5, 0.5 ), V3d( 1.0, 0.0, 0.0 ), found,
+                       10.0 );
+    TESTING_ASSERT( found.size() == 3 );
+}
+
+//-*****************************************************************************
+void testBVH( const std::string &iName )
+{
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), iName );
+    ArchiveBVH bvh( archive, 0.0 );
+
+    size_t numObjects = g_gridSize * g_gridSize + 1;
+    TESTING_ASSERT( bvh.getNumObjects() == numObjects );
+    TESTING_ASSERT( bvh.getNumAnimatedObjects() == 1 );
+    TESTING_ASSERT( bvh.getBounds() == Box3d( V3d( -10.0, -10.0, 0.0 ),
+        V3d( 2.0 * g_gridSize - 1.0, 2.0 * g_gridSize - 1.0, 1.0 ) ) );
+
+    // every object is in exactly one leaf
+    const std::vector<ArchiveBVH::Node> &nodes = bvh.getNodes();
+    std::vector<int32_t> order = bvh.getOrder();
+    std::sort( order.begin(), order.end() );
+    TESTING_ASSERT( order.size() == numObjects );
+    TESTING_ASSERT( order.front() == 0 &&
+                    order.back() == ( int32_t ) numObjects - 1 );
+    size_t inLeaves = 0;
+    for ( size_t n = 0; n < nodes.size(); ++n )
+    {
+        if ( nodes[n].skip == 0 )
+        {
+            inLeaves += nodes[n].count;
+        }
+    }
+    TESTING_ASSERT( inLeaves == numObjects );
+
+    checkQueries( bvh );
+
+    std::vector<size_t> found;
+    Box3d high( V3d( -100.0, -100.0, 9.5 ), V3d( 100.0, 100.0, 20.0 ) );
+    bvh.findInBox( high, found );
+    TESTING_ASSERT( found.empty() );
+
+    // only the mover is refit
+    bvh.setTime( 1.0 );
+    TESTING_ASSERT( bvh.getTime() == 1.0 );
+    bvh.findInBox( high, found );
+    TESTING_ASSERT( found.size() == 1 );
+    TESTING_ASSERT( bvh.getObjectFullName( found[0] ) == "/mover/box" );
+    TESTING_ASSERT( bvh.getObjectBounds( found[0] ) ==
+        Box3d( V3d( -10.0, -10.0, 10.0 ), V3d( -9.0, -9.0, 11.0 ) ) );
+    TESTING_ASSERT( bvh.getBounds().max.z == 11.0 );
+    checkQueries( bvh );
+
+    // and back
+    bvh.setTime( 0.0 );
+    bvh.findInBox( high, found );
+    TESTING_ASSERT( found.empty() );
+
+    // just one row, in its own space
+    ArchiveBVH row( IObject( archive.getTop(), "row3" ), 0.0 );
+    TESTING_ASSERT( row.getNumObjects() == ( size_t ) g_gridSize );
+    TESTING_ASSERT( row.getNumAnimatedObjects() == 0 );
+    TESTING_ASSERT( row.getBounds().min.y == 6.0 );
+}
+
+//-*****************************************************************************
+void testFrustum()
+{
+    CameraSample camera;
+    camera.setNearClippingPlane( 1.0 );
+    camera.setFarClippingPlane( 100.0 );
+
+    M44d cameraToWorld;
+    cameraToWorld.makeIdentity();
+    Frustum frustum( camera, cameraToWorld );
+
+    // in front of the camera, behind it, beyond the far plane and off to
+    // the side
+    TESTING_ASSERT( frustum.intersects(
+        Box3d( V3d( -1.0, -1.0, -11.0 ), V3d( 1.0, 1.0, -10.0 ) ) ) );
+    TESTING_ASSERT( frustum.contains(
+        Box3d( V3d( -1.0, -1.0, -11.0 ), V3d( 1.0, 1.0, -10.0 ) ) ) );
+    TESTING_ASSERT( !frustum.intersects(
+        Box3d( V3d( -1.0, -1.0, 10.0 ), V3d( 1.0, 1.0, 11.0 ) ) ) );
+    TESTING_ASSERT( !frustum.intersects(
+        Box3d( V3d( -1.0, -1.0, -201.0 ), V3d( 1.0, 1.0, -200.0 ) ) ) );
+    TESTING_ASSERT( !frustum.intersects(
+        Box3d( V3d( 50.0, -1.0, -11.0 ), V3d( 51.0, 1.0, -10.0 ) ) ) );
+
+    // straddling the near plane
+    Box3d straddle( V3d( -0.1, -0.1, -2.0 ), V3d( 0.1, 0.1, 0.0 ) );
+    TESTING_ASSERT( frustum.intersects( straddle ) );
+    TESTING_ASSERT( !frustum.contains( straddle ) );
+
+    Box3d empty;
+    empty.makeEmpty();
+    TESTING_ASSERT( !frustum.intersects( empty ) );
+
+    // the camera turned around to look down +z
+    cameraToWorld.setAxisAngle( V3d( 0.0, 1.0, 0.0 ), M_PI );
+    Frustum behind( camera, cameraToWorld );
+    TESTING_ASSERT( behind.intersects(
+        Box3d( V3d( -1.0, -1.0, 10.0 ), V3d( 1.0, 1.0, 11.0 ) ) ) );
+    TESTING_ASSERT( !behind.intersects(
+        Box3d( V3d( -1.0, -1.0, -11.0 ), V3d( 1.0, 1.0, -10.0 ) ) ) );
+
+    // the default frustum lets everything through
+    TESTING_ASSERT( Frustum().contains(
+        Box3d( V3d( 1e6, 1e6, 1e6 ), V3d( 1e7, 1e7, 1e7 ) ) ) );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "archiveBVH.abc";
+    writeArchive( name );
+    testBVH( name );
+    testFrustum();
+    return 0;
+}
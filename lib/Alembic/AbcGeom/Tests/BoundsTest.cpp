@@ -0,0 +1,147 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+#include <boost/random.hpp>
+
+#include "Assert.h"
+
+#include <limits>
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// ComputeBoundsFromPositions must match extending a Box3d point by point,
+// for sizes that do and don't fill whole blocks, and for samples big
+// enough to be split across threads.
+//-*****************************************************************************
+
+//-*****************************************************************************
+Box3d referenceBounds( const std::vector<V3f> &iPoints )
+{
+    Box3d ret;
+    for ( size_t i = 0; i < iPoints.size(); ++i )
+    {
+        ret.extendBy( iPoints[i] );
+    }
+    return ret;
+}
+
+//-*****************************************************************************
+void checkBounds( const std::vector<V3f> &iPoints )
+{
+    P3fArraySample samp( iPoints );
+    Box3d bnds = ComputeBoundsFromPositions( samp );
+    Box3d ref = referenceBounds( iPoints );
+
+    TESTING_ASSERT( bnds.min == ref.min );
+    TESTING_ASSERT( bnds.max == ref.max );
+}
+
+//-*****************************************************************************
+void testSizes()
+{
+    boost::mt19937 rng( 54321 );
+    boost::uniform_real<float> range( -1000.0f, 1000.0f );
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<float> >
+        gen( rng, range );
+
+    size_t sizes[] = { 1, 2, 3, 4, 5, 7, 8, 13, 100, 1001, 1 << 20,
+                       ( 1 << 20 ) + 3 };
+
+    for ( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); ++s )
+    {
+        std::vector<V3f> points( sizes[s] );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            points[i] = V3f( gen(), gen(), gen() );
+        }
+        checkBounds( points );
+
+        // put the extremes at the very end, in the leftover points
+        points.back() = V3f( 5000.0f, -5000.0f, 5000.0f );
+        checkBounds( points );
+    }
+
+    // nothing in, an empty box out
+    std::vector<V3f> empty;
+    TESTING_ASSERT( ComputeBoundsFromPositions(
+                        P3fArraySample( empty ) ).isEmpty() );
+
+    // NaNs are skipped, like Box3d::extendBy does
+    std::vector<V3f> withNan( 9, V3f( 1.0f, 2.0f, 3.0f ) );
+    withNan[4].x = std::numeric_limits<float>::quiet_NaN();
+    withNan[6] = V3f( -1.0f, 0.0f, 7.0f );
+    checkBounds( withNan );
+}
+
+//-*****************************************************************************
+void testSchemaBounds()
+{
+    std::string name = "boundsTest.abc";
+    std::vector<V3f> points;
+    for ( size_t i = 0; i < 37; ++i )
+    {
+        float f = ( float ) i;
+        points.push_back( V3f( f, -2.0f * f, 0.5f * f ) );
+    }
+
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OPoints ptsObj( OObject( archive, kTop ), "points" );
+        std::vector<Alembic::Util::uint64_t> ids( points.size(), 0 );
+        ptsObj.getSchema().set( OPointsSchema::Sample(
+            P3fArraySample( points ), UInt64ArraySample( ids ) ) );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IPoints ptsObj( IObject( archive, kTop ), "points" );
+    IPointsSchema::Sample samp;
+    ptsObj.getSchema().get( samp );
+
+    Box3d ref = referenceBounds( points );
+    TESTING_ASSERT( samp.getSelfBounds().min == ref.min );
+    TESTING_ASSERT( samp.getSelfBounds().max == ref.max );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testSizes();
+    testSchemaBounds();
+    return 0;
+}
@@ -0,0 +1,234 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+#include <set>
+
+using namespace Alembic::AbcGeom;
+
+typedef std::set<std::string> NameSet;
+
+//-*****************************************************************************
+OPoints writeBox( OObject iParent, const std::string &iName )
+{
+    V3f p[2] = { V3f( 0.0f, 0.0f, 0.0f ), V3f( 1.0f, 1.0f, 1.0f ) };
+    uint64_t ids[2] = { 0, 1 };
+
+    OPoints points( iParent, iName );
+    points.getSchema().set( OPointsSchema::Sample( P3fArraySample( p, 2 ),
+        UInt64ArraySample( ids, 2 ) ) );
+    return points;
+}
+
+//-*****************************************************************************
+OXform writeXform( OObject iParent, const std::string &iName,
+                   const V3d &iTranslation, bool iChildBounds )
+{
+    OXform xform( iParent, iName );
+    XformSample samp;
+    samp.setTranslation( iTranslation );
+    if ( iChildBounds )
+    {
+        samp.setChildBounds( Box3d( V3d( 0.0, 0.0, 0.0 ),
+                                    V3d( 1.0, 1.0, 1.0 ) ) );
+    }
+    xform.getSchema().set( samp );
+    return xform;
+}
+
+//-*****************************************************************************
+// A camera at z 20 looking down at the origin, and a box under each of
+// these xforms:
+//  near - in view
+//  far - out of view, with child bounds saying so
+//  noBounds - out of view, found from the box's own bounds
+//  hidden - hidden, with one box deferring to it and one shown anyway
+//  mover - out of view at time 0, moving into view at time 1
+//  late - in view, with child bounds only from time 1, so that its first
+//         child bounds sample is empty
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    OObject top = archive.getTop();
+
+    OXform cam = writeXform( top, "cam", V3d( 0.0, 0.0, 20.0 ), false );
+    OCamera camera( cam, "camera" );
+    camera.getSchema().set( CameraSample() );
+
+    writeBox( writeXform( top, "near", V3d( 0.0, 0.0, 0.0 ), true ), "box" );
+    writeBox( writeXform( top, "far", V3d( 1000.0, 0.0, 0.0 ), true ),
+              "box" );
+    writeBox( writeXform( top, "noBounds", V3d( 1000.0, 0.0, 0.0 ), false ),
+              "box" );
+
+    OXform hidden = writeXform( top, "hidden", V3d( 0.0, 0.0, 0.0 ), true );
+    CreateVisibilityProperty( hidden, 0 ).set( kVisibilityHidden );
+    writeBox( hidden, "deferred" );
+    OPoints shown = writeBox( hidden, "shown" );
+    CreateVisibilityProperty( shown, 0 ).set( kVisibilityVisible );
+
+    OXform mover( top, "mover" );
+    for ( size_t s = 0; s < 2; ++s )
+    {
+        XformSample samp;
+        samp.setTranslation( V3d( s == 0 ? 1000.0 : 0.0, 0.0, 0.0 ) );
+        samp.setChildBounds( Box3d( V3d( 0.0, 0.0, 0.0 ),
+                                    V3d( 1.0, 1.0, 1.0 ) ) );
+        mover.getSchema().set( samp );
+    }
+    writeBox( mover, "box" );
+
+    OXform late = writeXform( top, "late", V3d( 0.0, 0.0, 0.0 ), false );
+    XformSample lateSamp;
+    lateSamp.setChildBounds( Box3d( V3d( 0.0, 0.0, 0.0 ),
+                                    V3d( 1.0, 1.0, 1.0 ) ) );
+    late.getSchema().set( lateSamp );
+    writeBox( late, "box" );
+}
+
+//-*****************************************************************************
+void walk( ObjectCuller &iCuller, IObject iParent,
+           const ObjectCuller::State &iState, NameSet &oKept )
+{
+    for ( size_t i = 0; i < iParent.getNumChildren(); ++i )
+    {
+        IObject child( iParent, iParent.getChildHeader( i ).getName() );
+
+        ObjectCuller::State state;
+        ObjectCuller::CullResult result = iCuller.cull( child, iState, state );
+        if ( result == ObjectCuller::kKeep )
+        {
+            oKept.insert( child.getFullName() );
+        }
+
+        if ( result != ObjectCuller::kCullSubtree )
+        {
+            walk( iCuller, child, state, oKept );
+        }
+    }
+}
+
+//-*****************************************************************************
+// What's kept by visibility alone has to agree with IsAncestorInvisible,
+// which is true for visible objects.
+void checkVisibility( IObject iParent, const NameSet &iKept )
+{
+    for ( size_t i = 0; i < iParent.getNumChildren(); ++i )
+    {
+        IObject child( iParent, iParent.getChildHeader( i ).getName() );
+        TESTING_ASSERT( IsAncestorInvisible( child ) ==
+                        ( iKept.count( child.getFullName() ) == 1 ) );
+        checkVisibility( child, iKept );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "culling.abc";
+    writeArchive( name );
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject top = archive.getTop();
+
+    // by visibility alone, only the hidden xform and the box deferring to
+    // it go
+    {
+        ObjectCuller culler( 0.0 );
+        NameSet kept;
+        walk( culler, top, culler.getTopState(), kept );
+        TESTING_ASSERT( culler.getNumHidden() == 2 );
+        TESTING_ASSERT( culler.getNumOutside() == 0 );
+        TESTING_ASSERT( kept.count( "/hidden" ) == 0 );
+        TESTING_ASSERT( kept.count( "/hidden/deferred" ) == 0 );
+        TESTING_ASSERT( kept.count( "/hidden/shown" ) == 1 );
+        TESTING_ASSERT( kept.count( "/far/box" ) == 1 );
+        TESTING_ASSERT( kept.size() == culler.getNumKept() );
+        checkVisibility( top, kept );
+    }
+
+    ICamera camera( IObject( top, "cam" ), "camera" );
+    Frustum frustum = GetWorldFrustum( camera );
+    TESTING_ASSERT( frustum.contains(
+        Box3d( V3d( 0.0, 0.0, 0.0 ), V3d( 1.0, 1.0, 1.0 ) ) ) );
+    TESTING_ASSERT( !frustum.intersects(
+        Box3d( V3d( 0.0, 0.0, 30.0 ), V3d( 1.0, 1.0, 31.0 ) ) ) );
+
+    // at time 0, far and noBounds/box are out of view, and so is the mover
+    {
+        ObjectCuller culler( frustum, 0.0, 0.0 );
+        NameSet kept;
+        walk( culler, top, culler.getTopState(), kept );
+        TESTING_ASSERT( culler.getNumOutside() == 3 );
+        TESTING_ASSERT( culler.getNumHidden() == 2 );
+        TESTING_ASSERT( culler.getNumCulled() == 5 );
+
+        NameSet expected;
+        expected.insert( "/cam" );
+        expected.insert( "/cam/camera" );
+        expected.insert( "/near" );
+        expected.insert( "/near/box" );
+        expected.insert( "/noBounds" );
+        expected.insert( "/hidden/shown" );
+        expected.insert( "/late" );
+        expected.insert( "/late/box" );
+        TESTING_ASSERT( kept == expected );
+    }
+
+    // late's empty child bounds at time 0 aren't taken to be outside
+    {
+        IXform late( top, "late" );
+        Box3d empty = late.getSchema().getChildBoundsProperty().getValue(
+            ISampleSelector( 0.0 ) );
+        TESTING_ASSERT( empty.isEmpty() );
+    }
+
+    // over a shutter into time 1, the mover comes into view
+    {
+        ObjectCuller culler( frustum, 0.0, 1.0 );
+        NameSet kept;
+        walk( culler, top, culler.getTopState(), kept );
+        TESTING_ASSERT( culler.getNumOutside() == 2 );
+        TESTING_ASSERT( kept.count( "/mover" ) == 1 );
+        TESTING_ASSERT( kept.count( "/mover/box" ) == 1 );
+    }
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+bool near( const V3f &iA, const V3f &iB )
+{
+    return ( iA - iB ).length() < 1e-5f;
+}
+
+//-*****************************************************************************
+bool near( float32_t iA, float32_t iB )
+{
+    return std::abs( iA - iB ) < 1e-5f;
+}
+
+//-*****************************************************************************
+FloatArraySamplePtr makeWidths( const float32_t *iWidths, size_t iSize )
+{
+    return FloatArraySamplePtr( new FloatArraySample( iWidths, iSize ) );
+}
+
+//-*****************************************************************************
+void testLinear()
+{
+    V3f p[] = { V3f( 0, 0, 0 ), V3f( 1, 0, 0 ), V3f( 1, 1, 0 ) };
+    int32_t counts[] = { 3 };
+    float32_t widths[] = { 1, 2, 3 };
+
+    CurvePolylines lines;
+    TessellateCurves( kLinear, kNoBasis, kPeriodic,
+                      Int32ArraySample( counts, 1 ), P3fArraySample( p, 3 ),
+                      makeWidths( widths, 3 ), 0.0f, 8, lines );
+
+    TESTING_ASSERT( lines.numVertices.size() == 1 );
+    TESTING_ASSERT( lines.numVertices[0] == 4 );
+    TESTING_ASSERT( lines.positions[2] == p[2] );
+    TESTING_ASSERT( lines.positions[3] == p[0] );
+    TESTING_ASSERT( lines.widths.size() == 4 && lines.widths[3] == 1.0f );
+
+    TESTING_ASSERT( GetNumCurveSpans( kLinear, kNoBasis, kPeriodic, 3 ) == 3 );
+    TESTING_ASSERT( GetNumCurveSpans( kCubic, kBezierBasis, kNonPeriodic, 7 )
+                    == 2 );
+
+    // too few vertices to be cubic
+    TessellateCurves( kCubic, kBsplineBasis, kNonPeriodic,
+                      Int32ArraySample( counts, 1 ), P3fArraySample( p, 3 ),
+                      FloatArraySamplePtr(), 0.0f, 8, lines );
+    TESTING_ASSERT( lines.numVertices[0] == 3 && lines.widths.empty() );
+}
+
+//-*****************************************************************************
+void testBases()
+{
+    CurvePolylines lines;
+
+    // two bezier spans sharing a vertex
+    V3f bez[] = { V3f( 0, 0, 0 ), V3f( 0, 1, 0 ), V3f( 1, 1, 0 ),
+                  V3f( 1, 0, 0 ), V3f( 1, -1, 0 ), V3f( 2, -1, 0 ),
+                  V3f( 2, 0, 0 ) };
+    int32_t bezCount[] = { 7 };
+    TessellateCurves( kCubic, kBezierBasis, kNonPeriodic,
+                      Int32ArraySample( bezCount, 1 ),
+                      P3fArraySample( bez, 7 ), FloatArraySamplePtr(),
+                      0.0f, 4, lines );
+    TESTING_ASSERT( lines.positions.size() == 9 );
+    TESTING_ASSERT( near( lines.positions[0], bez[0] ) );
+    TESTING_ASSERT( near( lines.positions[4], bez[3] ) );
+    TESTING_ASSERT( near( lines.positions[8], bez[6] ) );
+    TESTING_ASSERT( near( lines.positions[2],
+        ( bez[0] + bez[1] * 3.0f + bez[2] * 3.0f + bez[3] ) / 8.0f ) );
+
+    // b-splines keep straight lines straight, so need one step a span
+    V3f line[] = { V3f( 0, 0, 0 ), V3f( 1, 0, 0 ), V3f( 2, 0, 0 ),
+                   V3f( 3, 0, 0 ), V3f( 4, 0, 0 ), V3f( 5, 0, 0 ) };
+    int32_t lineCount[] = { 6 };
+    TessellateCurves( kCubic, kBsplineBasis, kNonPeriodic,
+                      Int32ArraySample( lineCount, 1 ),
+                      P3fArraySample( line, 6 ), FloatArraySamplePtr(),
+                      0.01f, 16, lines );
+    TESTING_ASSERT( lines.positions.size() == 4 );
+    TESTING_ASSERT( near( lines.positions[0], V3f( 1, 0, 0 ) ) );
+    TESTING_ASSERT( near( lines.positions[3], V3f( 4, 0, 0 ) ) );
+
+    // catmull-rom passes through its inner vertices, and varying widths
+    // go from one span end to the next
+    V3f cr[] = { V3f( 0, 0, 0 ), V3f( 1, 1, 0 ), V3f( 2, 0, 0 ),
+                 V3f( 3, 1, 0 ), V3f( 4, 0, 0 ) };
+    int32_t crCount[] = { 5 };
+    float32_t varying[] = { 1, 2, 3 };
+    TessellateCurves( kCubic, kCatmullromBasis, kNonPeriodic,
+                      Int32ArraySample( crCount, 1 ),
+                      P3fArraySample( cr, 5 ), makeWidths( varying, 3 ),
+                      0.0f, 2, lines );
+    TESTING_ASSERT( lines.positions.size() == 5 );
+    TESTING_ASSERT( near( lines.positions[0], cr[1] ) );
+    TESTING_ASSERT( near( lines.positions[2], cr[2] ) );
+    TESTING_ASSERT( near( lines.positions[4], cr[3] ) );
+    float32_t crWidths[] = { 1.0f, 1.5f, 2.0f, 2.5f, 3.0f };
+    for ( size_t i = 0; i < 5; ++i )
+    {
+        TESTING_ASSERT( near( lines.widths[i], crWidths[i] ) );
+    }
+
+    // point, tangent, point, tangent
+    V3f herm[] = { V3f( 0, 0, 0 ), V3f( 1, 0, 0 ), V3f( 1, 0, 0 ),
+                   V3f( 1, 0, 0 ) };
+    int32_t cubicCount[] = { 4 };
+    TessellateCurves( kCubic, kHermiteBasis, kNonPeriodic,
+                      Int32ArraySample( cubicCount, 1 ),
+                      P3fArraySample( herm, 4 ), FloatArraySamplePtr(),
+                      0.0f, 2, lines );
+    TESTING_ASSERT( lines.positions.size() == 3 );
+    TESTING_ASSERT( near( lines.positions[1], V3f( 0.5f, 0, 0 ) ) );
+
+    // 1 + 2t
+    V3f power[] = { V3f( 0, 0, 0 ), V3f( 0, 0, 0 ), V3f( 2, 0, 0 ),
+                    V3f( 1, 0, 0 ) };
+    TessellateCurves( kCubic, kPowerBasis, kNonPeriodic,
+                      Int32ArraySample( cubicCount, 1 ),
+                      P3fArraySample( power, 4 ), FloatArraySamplePtr(),
+                      0.0f, 2, lines );
+    TESTING_ASSERT( near( lines.positions[0], V3f( 1, 0, 0 ) ) );
+    TESTING_ASSERT( near( lines.positions[1], V3f( 2, 0, 0 ) ) );
+    TESTING_ASSERT( near( lines.positions[2], V3f( 3, 0, 0 ) ) );
+}
+
+//-*****************************************************************************
+void testPeriodic()
+{
+    // two closed b-spline squares, one width each
+    V3f p[] = { V3f( 0, 0, 0 ), V3f( 1, 0, 0 ), V3f( 1, 1, 0 ),
+                V3f( 0, 1, 0 ), V3f( 0, 0, 1 ), V3f( 2, 0, 1 ),
+                V3f( 2, 2, 1 ), V3f( 0, 2, 1 ) };
+    int32_t counts[] = { 4, 4 };
+    float32_t widths[] = { 0.5f, 0.25f };
+
+    CurvePolylines lines;
+    TessellateCurves( kCubic, kBsplineBasis, kPeriodic,
+                      Int32ArraySample( counts, 2 ), P3fArraySample( p, 8 ),
+                      makeWidths( widths, 2 ), 0.0f, 1, lines );
+
+    TESTING_ASSERT( lines.numVertices[0] == 5 && lines.numVertices[1] == 5 );
+    TESTING_ASSERT( near( lines.positions[0], lines.positions[4] ) );
+    TESTING_ASSERT( near( lines.positions[5], lines.positions[9] ) );
+    TESTING_ASSERT( near( lines.positions[0],
+        ( p[0] + p[1] * 4.0f + p[2] ) / 6.0f ) );
+    TESTING_ASSERT( lines.widths[4] == 0.5f && lines.widths[5] == 0.25f );
+
+    // widths that fit no scope
+    float32_t badWidths[] = { 1, 2, 3 };
+    bool threw = false;
+    try
+    {
+        TessellateCurves( kCubic, kBsplineBasis, kPeriodic,
+                          Int32ArraySample( counts, 2 ),
+                          P3fArraySample( p, 8 ), makeWidths( badWidths, 3 ),
+                          0.0f, 1, lines );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+void testTolerance()
+{
+    V3f p[] = { V3f( 0, 0, 0 ), V3f( 0, 0.55f, 0 ), V3f( 0.45f, 1, 0 ),
+                V3f( 1, 1, 0 ) };
+    int32_t counts[] = { 4 };
+
+    CurvePolylines coarse;
+    CurvePolylines fine;
+    CurvePolylines capped;
+    TessellateCurves( kCubic, kBezierBasis, kNonPeriodic,
+                      Int32ArraySample( counts, 1 ), P3fArraySample( p, 4 ),
+                      FloatArraySamplePtr(), 0.1f, 64, coarse );
+    TessellateCurves( kCubic, kBezierBasis, kNonPeriodic,
+                      Int32ArraySample( counts, 1 ), P3fArraySample( p, 4 ),
+                      FloatArraySamplePtr(), 0.0001f, 64, fine );
+    TessellateCurves( kCubic, kBezierBasis, kNonPeriodic,
+                      Int32ArraySample( counts, 1 ), P3fArraySample( p, 4 ),
+                      FloatArraySamplePtr(), 0.0001f, 8, capped );
+
+    TESTING_ASSERT( coarse.positions.size() >= 2 );
+    TESTING_ASSERT( fine.positions.size() > coarse.positions.size() );
+    TESTING_ASSERT( capped.positions.size() == 9 );
+    TESTING_ASSERT( near( fine.positions.back(), p[3] ) );
+}
+
+//-*****************************************************************************
+void testRibbons()
+{
+    CurvePolylines lines;
+    lines.positions.push_back( V3f( 0, 0, 0 ) );
+    lines.positions.push_back( V3f( 1, 0, 0 ) );
+    lines.positions.push_back( V3f( 2, 0, 0 ) );
+    lines.numVertices.push_back( 3 );
+
+    std::vector<V3f> p;
+    std::vector<int32_t> counts;
+    std::vector<int32_t> indices;
+    BuildCurveRibbons( lines, V3f( 1, 0, 10 ), 0.2f, p, counts, indices );
+
+    TESTING_ASSERT( p.size() == 6 && counts.size() == 2 );
+    TESTING_ASSERT( near( p[0], V3f( 0, 0.1f, 0 ) ) );
+    TESTING_ASSERT( near( p[1], V3f( 0, -0.1f, 0 ) ) );
+    int32_t expected[] = { 0, 2, 3, 1, 2, 4, 5, 3 };
+    TESTING_ASSERT( indices.size() == 8 &&
+                    std::equal( indices.begin(), indices.end(), expected ) );
+
+    // the quads face the view point
+    MeshTopology topo( ( Int32ArraySample( counts ) ),
+                       ( Int32ArraySample( indices ) ) );
+    std::vector<N3f> normals;
+    ComputeFaceNormals( topo, Int32ArraySample( indices ),
+                        P3fArraySample( p ), normals );
+    TESTING_ASSERT( near( normals[0], V3f( 0, 0, 1 ) ) );
+    TESTING_ASSERT( near( normals[1], V3f( 0, 0, 1 ) ) );
+}
+
+//-*****************************************************************************
+// Written and read back as hair, big enough to be split across threads.
+void testHair()
+{
+    size_t numCurves = 20000;
+    std::vector<V3f> p;
+    std::vector<float32_t> w;
+    std::vector<int32_t> counts( numCurves, 5 );
+    for ( size_t c = 0; c < numCurves; ++c )
+    {
+        for ( size_t i = 0; i < 5; ++i )
+        {
+            float32_t x = ( float32_t ) ( c % 100 );
+            float32_t y = ( float32_t ) ( c / 100 );
+            p.push_back( V3f( x, y, ( float32_t ) i ) +
+                         V3f( ( float32_t ) ( i % 2 ), 0, 0 ) );
+            w.push_back( 0.1f * ( float32_t ) ( i + 1 ) );
+        }
+    }
+
+    std::string name = "curveTessellation.abc";
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OCurves curves( OObject( archive, kTop ), "hair" );
+        OFloatGeomParam::Sample widths( FloatArraySample( w ),
+                                        kVertexScope );
+        curves.getSchema().set( OCurvesSchema::Sample(
+            P3fArraySample( p ), Int32ArraySample( counts ), kCubic,
+            kNonPeriodic, widths, OV2fGeomParam::Sample(),
+            ON3fGeomParam::Sample(), kBsplineBasis ) );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    ICurves curves( IObject( archive, kTop ), "hair" );
+    ICurvesSchema &schema = curves.getSchema();
+
+    ICurvesSchema::Sample samp;
+    schema.get( samp );
+    TESTING_ASSERT( samp.getBasis() == kBsplineBasis );
+
+    IFloatGeomParam::Sample widths = schema.getWidthsParam().getExpandedValue();
+
+    CurvePolylines lines;
+    TessellateCurves( samp, widths.getVals(), 0.0f, 4, lines );
+    TESTING_ASSERT( lines.numVertices.size() == numCurves );
+    TESTING_ASSERT( lines.positions.size() == numCurves * 9 );
+    TESTING_ASSERT( lines.widths.size() == numCurves * 9 );
+
+    // the same as the last curve on its own
+    CurvePolylines last;
+    int32_t lastCount[] = { 5 };
+    TessellateCurves( kCubic, kBsplineBasis, kNonPeriodic,
+                      Int32ArraySample( lastCount, 1 ),
+                      P3fArraySample( &p[( numCurves - 1 ) * 5], 5 ),
+                      makeWidths( &w[( numCurves - 1 ) * 5], 5 ),
+                      0.0f, 4, last );
+    for ( size_t i = 0; i < 9; ++i )
+    {
+        size_t j = ( numCurves - 1 ) * 9 + i;
+        TESTING_ASSERT( near( lines.positions[j], last.positions[i] ) );
+        TESTING_ASSERT( near( lines.widths[j], last.widths[i] ) );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testLinear();
+    testBases();
+    testPeriodic();
+    testTolerance();
+    testRibbons();
+    testHair();
+    return 0;
+}
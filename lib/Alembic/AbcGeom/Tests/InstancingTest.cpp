@@ -0,0 +1,180 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A single quad, with its uvs shifted by iUVOffset and its winding reversed
+// if iFlip.
+OPolyMesh writeQuad( OObject iParent, const std::string &iName,
+                     float iUVOffset, bool iFlip )
+{
+    V3f p[4] = { V3f( 0.0f, 0.0f, 0.0f ), V3f( 1.0f, 0.0f, 0.0f ),
+                 V3f( 1.0f, 1.0f, 0.0f ), V3f( 0.0f, 1.0f, 0.0f ) };
+    int32_t indices[4] = { 0, 1, 2, 3 };
+    int32_t flipped[4] = { 3, 2, 1, 0 };
+    int32_t counts[1] = { 4 };
+    V2f uvs[4] = { V2f( iUVOffset, 0.0f ), V2f( iUVOffset + 1.0f, 0.0f ),
+                   V2f( iUVOffset + 1.0f, 1.0f ), V2f( iUVOffset, 1.0f ) };
+
+    OPolyMesh mesh( iParent, iName );
+    mesh.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p, 4 ),
+        Int32ArraySample( iFlip ? flipped : indices, 4 ),
+        Int32ArraySample( counts, 1 ),
+        OV2fGeomParam::Sample( V2fArraySample( uvs, 4 ), kVertexScope ) ) );
+    return mesh;
+}
+
+//-*****************************************************************************
+OXform writeXform( OObject iParent, const std::string &iName,
+                   const V3d &iTranslation )
+{
+    OXform xform( iParent, iName );
+    XformSample samp;
+    samp.setTranslation( iTranslation );
+    xform.getSchema().set( samp );
+    return xform;
+}
+
+//-*****************************************************************************
+// The same quad under a, b, b/c and at the top, and under d, e and f a
+// quad that differs from it only in its uvs, its indices, or a face set.
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    OObject top = archive.getTop();
+
+    writeQuad( writeXform( top, "a", V3d( 1.0, 0.0, 0.0 ) ), "mesh",
+               0.0f, false );
+    OXform b = writeXform( top, "b", V3d( 2.0, 0.0, 0.0 ) );
+    writeQuad( b, "mesh", 0.0f, false );
+    writeQuad( writeXform( b, "c", V3d( 0.0, 5.0, 0.0 ) ), "mesh",
+               0.0f, false );
+    writeQuad( writeXform( top, "d", V3d( 4.0, 0.0, 0.0 ) ), "mesh",
+               0.5f, false );
+    writeQuad( writeXform( top, "e", V3d( 5.0, 0.0, 0.0 ) ), "mesh",
+               0.0f, true );
+
+    OPolyMesh f = writeQuad( writeXform( top, "f", V3d( 6.0, 0.0, 0.0 ) ),
+                             "mesh", 0.0f, false );
+    int32_t faces[1] = { 0 };
+    f.getSchema().createFaceSet( "faces" ).getSchema().set(
+        OFaceSetSchema::Sample( Int32ArraySample( faces, 1 ) ) );
+
+    writeQuad( top, "loose", 0.0f, false );
+}
+
+//-*****************************************************************************
+void testSignatures( const std::string &iName )
+{
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), iName );
+    IObject top = archive.getTop();
+
+    std::string a = GetGeometrySignature(
+        top.getChild( "a" ).getChild( "mesh" ) );
+    std::string b = GetGeometrySignature(
+        top.getChild( "b" ).getChild( "mesh" ) );
+    std::string d = GetGeometrySignature(
+        top.getChild( "d" ).getChild( "mesh" ) );
+    std::string e = GetGeometrySignature(
+        top.getChild( "e" ).getChild( "mesh" ) );
+    std::string f = GetGeometrySignature(
+        top.getChild( "f" ).getChild( "mesh" ) );
+
+    TESTING_ASSERT( !a.empty() );
+    TESTING_ASSERT( a == b );
+    TESTING_ASSERT( a != d );
+    TESTING_ASSERT( a != e );
+    TESTING_ASSERT( a != f );
+    TESTING_ASSERT( d != e );
+}
+
+//-*****************************************************************************
+void testTable( const std::string &iName )
+{
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), iName );
+    InstanceTable table( archive );
+
+    TESTING_ASSERT( table.getNumObjects() == 7 );
+    TESTING_ASSERT( table.getNumPrototypes() == 4 );
+    TESTING_ASSERT( table.getNumSaved() == 3 );
+
+    const InstanceTable::Prototype &quad = table.getPrototype( 0 );
+    TESTING_ASSERT( quad.instances.size() == 4 );
+    TESTING_ASSERT( quad.instances[0].fullName == "/a/mesh" );
+    TESTING_ASSERT( quad.instances[1].fullName == "/b/mesh" );
+    TESTING_ASSERT( quad.instances[2].fullName == "/b/c/mesh" );
+    TESTING_ASSERT( quad.instances[3].fullName == "/loose" );
+
+    M44d expected;
+    expected.setTranslation( V3d( 1.0, 0.0, 0.0 ) );
+    TESTING_ASSERT( quad.instances[0].world == expected );
+    expected.setTranslation( V3d( 2.0, 5.0, 0.0 ) );
+    TESTING_ASSERT( quad.instances[2].world == expected );
+    expected.makeIdentity();
+    TESTING_ASSERT( quad.instances[3].world == expected );
+
+    TESTING_ASSERT( table.getPrototype( 1 ).instances.size() == 1 );
+    TESTING_ASSERT( table.getPrototype( 1 ).instances[0].fullName ==
+                    "/d/mesh" );
+    TESTING_ASSERT( table.getPrototype( 2 ).instances[0].fullName ==
+                    "/e/mesh" );
+    TESTING_ASSERT( table.getPrototype( 3 ).instances[0].fullName ==
+                    "/f/mesh" );
+
+    // just b and what is under it
+    InstanceTable sub( archive.getTop().getChild( "b" ) );
+    TESTING_ASSERT( sub.getNumObjects() == 2 );
+    TESTING_ASSERT( sub.getNumPrototypes() == 1 );
+    expected.setTranslation( V3d( 2.0, 0.0, 0.0 ) );
+    TESTING_ASSERT( sub.getPrototype( 0 ).instances[0].world == expected );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "instancingTest.abc";
+    writeArchive( name );
+    testSignatures( name );
+    testTable( name );
+    return 0;
+}
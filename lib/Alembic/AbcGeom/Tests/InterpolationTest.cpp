@@ -0,0 +1,280 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+#include <algorithm>
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// Samples are one second apart, so the time is also how far between them.
+//-*****************************************************************************
+
+//-*****************************************************************************
+static const size_t g_numPoints = 4;
+
+//-*****************************************************************************
+std::vector<V3f> meshPoints( float iOffset )
+{
+    std::vector<V3f> ret;
+    ret.push_back( V3f( 0.0f, 0.0f, 0.0f ) + V3f( iOffset ) );
+    ret.push_back( V3f( 1.0f, 0.0f, 0.0f ) + V3f( iOffset ) );
+    ret.push_back( V3f( 1.0f, 1.0f, 0.0f ) + V3f( iOffset ) );
+    ret.push_back( V3f( 0.0f, 1.0f, 0.0f ) + V3f( iOffset ) );
+    return ret;
+}
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    uint32_t tsidx = archive.addTimeSampling( TimeSampling( 1.0, 0.0 ) );
+    OObject top( archive, kTop );
+
+    int32_t quadIndices[] = { 0, 1, 2, 3 };
+    int32_t quadCounts[] = { 4 };
+    int32_t triIndices[] = { 0, 1, 2, 0, 2, 3 };
+    int32_t triCounts[] = { 3, 3 };
+
+    std::vector<N3f> normals0( g_numPoints, N3f( 0.0f, 0.0f, 1.0f ) );
+    std::vector<N3f> normals1( g_numPoints, N3f( 1.0f, 0.0f, 0.0f ) );
+
+    // the points move from 0 to 2 and then hold
+    OPolyMesh mesh( top, "mesh", tsidx );
+    std::vector<V3f> p0 = meshPoints( 0.0f );
+    std::vector<V3f> p1 = meshPoints( 2.0f );
+    mesh.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p0 ), Int32ArraySample( quadIndices, 4 ),
+        Int32ArraySample( quadCounts, 1 ), OV2fGeomParam::Sample(),
+        ON3fGeomParam::Sample( N3fArraySample( normals0 ), kVertexScope ) ) );
+    mesh.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p1 ), Int32ArraySample(), Int32ArraySample(),
+        OV2fGeomParam::Sample(),
+        ON3fGeomParam::Sample( N3fArraySample( normals1 ), kVertexScope ) ) );
+    mesh.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p1 ), Int32ArraySample(), Int32ArraySample(),
+        OV2fGeomParam::Sample(),
+        ON3fGeomParam::Sample( N3fArraySample( normals1 ), kVertexScope ) ) );
+
+    // as many points, but they don't correspond
+    OPolyMesh changing( top, "changing", tsidx );
+    changing.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p0 ), Int32ArraySample( quadIndices, 4 ),
+        Int32ArraySample( quadCounts, 1 ) ) );
+    changing.getSchema().set( OPolyMeshSchema::Sample(
+        P3fArraySample( p1 ), Int32ArraySample( triIndices, 6 ),
+        Int32ArraySample( triCounts, 2 ) ) );
+
+    // the ids are the same for the first two samples only
+    OPoints points( top, "points", tsidx );
+    std::vector<uint64_t> ids;
+    for ( size_t i = 0; i < g_numPoints; ++i ) { ids.push_back( i ); }
+    points.getSchema().set( OPointsSchema::Sample(
+        P3fArraySample( p0 ), UInt64ArraySample( ids ) ) );
+    points.getSchema().set( OPointsSchema::Sample(
+        P3fArraySample( p1 ), UInt64ArraySample( ids ) ) );
+    std::reverse( ids.begin(), ids.end() );
+    points.getSchema().set( OPointsSchema::Sample(
+        P3fArraySample( p0 ), UInt64ArraySample( ids ) ) );
+
+    // a quarter turn about z while moving along x
+    OXform xform( top, "xform", tsidx );
+    XformSample xs;
+    xs.setTranslation( V3d( 0.0, 0.0, 0.0 ) );
+    xs.setRotation( V3d( 0.0, 0.0, 1.0 ), 0.0 );
+    xform.getSchema().set( xs );
+    xs = XformSample();
+    xs.setTranslation( V3d( 2.0, 0.0, 0.0 ) );
+    xs.setRotation( V3d( 0.0, 0.0, 1.0 ), 90.0 );
+    xform.getSchema().set( xs );
+}
+
+//-*****************************************************************************
+void testSampleBlend()
+{
+    TimeSamplingPtr ts( new TimeSampling( 1.0, 0.0 ) );
+    index_t floorIndex = -1;
+    index_t ceilIndex = -1;
+
+    TESTING_ASSERT( GetSampleBlend( ts, 3, 0.25, floorIndex,
+                                    ceilIndex ) == 0.25 );
+    TESTING_ASSERT( floorIndex == 0 && ceilIndex == 1 );
+
+    TESTING_ASSERT( GetSampleBlend( ts, 3, 1.0, floorIndex,
+                                    ceilIndex ) == 0.0 );
+    TESTING_ASSERT( floorIndex == 1 && ceilIndex == 1 );
+
+    TESTING_ASSERT( GetSampleBlend( ts, 3, 7.5, floorIndex,
+                                    ceilIndex ) == 0.0 );
+    TESTING_ASSERT( floorIndex == 2 && ceilIndex == 2 );
+
+    TESTING_ASSERT( GetSampleBlend( ts, 3, -1.0, floorIndex,
+                                    ceilIndex ) == 0.0 );
+    TESTING_ASSERT( floorIndex == 0 && ceilIndex == 0 );
+
+    float32_t a[] = { 0.0f, 1.0f, -2.0f, 10.0f, 3.0f };
+    float32_t b[] = { 4.0f, 1.0f, 2.0f, 20.0f, -3.0f };
+    float32_t out[5];
+    LerpArray( a, b, 5, 0.25f, out );
+    TESTING_ASSERT( out[0] == 1.0f && out[1] == 1.0f && out[2] == -1.0f &&
+                    out[3] == 12.5f && out[4] == 1.5f );
+}
+
+//-*****************************************************************************
+void testMesh( IObject iTop )
+{
+    InterpolationCachePtr cache( new InterpolationCache() );
+
+    IPolyMesh meshObj( iTop, "mesh" );
+    IPolyMeshSchema &mesh = meshObj.getSchema();
+
+    P3fArraySamplePtr p = InterpolatePositions( mesh, 0.25, cache );
+    TESTING_ASSERT( p->size() == g_numPoints );
+    std::vector<V3f> expected = meshPoints( 0.5f );
+    for ( size_t i = 0; i < g_numPoints; ++i )
+    {
+        TESTING_ASSERT( ( *p )[i] == expected[i] );
+    }
+
+    // asked again, through another reader of the same property, it's the
+    // same sample
+    TESTING_ASSERT( cache->size() == 1 );
+    IPolyMesh againObj( iTop, "mesh" );
+    IPolyMeshSchema &again = againObj.getSchema();
+    TESTING_ASSERT( InterpolatePositions( again, 0.25, cache ) == p );
+    TESTING_ASSERT( cache->size() == 1 );
+
+    // on a sample, and while held, nothing is blended
+    P3fArraySamplePtr onSample = mesh.getPositionsProperty().getValue(
+        ISampleSelector( ( index_t ) 1 ) );
+    TESTING_ASSERT( InterpolatePositions( mesh, 1.0, cache ) == onSample );
+    P3fArraySamplePtr held = InterpolatePositions( mesh, 1.5, cache );
+    for ( size_t i = 0; i < g_numPoints; ++i )
+    {
+        TESTING_ASSERT( ( *held )[i] == ( *onSample )[i] );
+    }
+
+    // blended normals are unit length
+    N3fArraySamplePtr n = InterpolateNormals( mesh.getNormalsParam(), 0.5,
+                                              cache );
+    for ( size_t i = 0; i < n->size(); ++i )
+    {
+        TESTING_ASSERT( fabs( ( *n )[i].length() - 1.0f ) < 1e-6f );
+        TESTING_ASSERT( fabs( ( *n )[i].x - ( *n )[i].z ) < 1e-6f );
+    }
+
+    // which is a different blend from the plain one
+    N3fArraySamplePtr plain = InterpolateGeomParam( mesh.getNormalsParam(),
+                                                    0.5, cache );
+    TESTING_ASSERT( ( *plain )[0] == N3f( 0.5f, 0.0f, 0.5f ) );
+    TESTING_ASSERT( cache->size() == 3 );
+
+    p.reset();
+    n.reset();
+    plain.reset();
+    TESTING_ASSERT( cache->size() == 0 );
+
+    // heterogeneous topology snaps to the floor sample
+    IPolyMesh changingObj( iTop, "changing" );
+    IPolyMeshSchema &changing = changingObj.getSchema();
+    P3fArraySamplePtr snapped = InterpolatePositions( changing, 0.75 );
+    expected = meshPoints( 0.0f );
+    for ( size_t i = 0; i < g_numPoints; ++i )
+    {
+        TESTING_ASSERT( ( *snapped )[i] == expected[i] );
+    }
+}
+
+//-*****************************************************************************
+void testPoints( IObject iTop )
+{
+    IPoints pointsObj( iTop, "points" );
+    IPointsSchema &points = pointsObj.getSchema();
+
+    P3fArraySamplePtr p = InterpolatePositions( points, 0.5 );
+    std::vector<V3f> expected = meshPoints( 1.0f );
+    for ( size_t i = 0; i < g_numPoints; ++i )
+    {
+        TESTING_ASSERT( ( *p )[i] == expected[i] );
+    }
+
+    // the ids change, so sample 1 comes back as is
+    p = InterpolatePositions( points, 1.5 );
+    expected = meshPoints( 2.0f );
+    for ( size_t i = 0; i < g_numPoints; ++i )
+    {
+        TESTING_ASSERT( ( *p )[i] == expected[i] );
+    }
+}
+
+//-*****************************************************************************
+void testXform( IObject iTop )
+{
+    IXform xformObj( iTop, "xform" );
+    IXformSchema &xform = xformObj.getSchema();
+
+    M44d m = InterpolateXform( xform, 0.5 );
+    V3d x = V3d( 1.0, 0.0, 0.0 ) * m;
+
+    // a linear blend of the matrices would shrink this
+    double h = sqrt( 0.5 );
+    TESTING_ASSERT( ( x - V3d( 1.0 + h, h, 0.0 ) ).length() < 1e-9 );
+
+    TESTING_ASSERT( InterpolateXform( xform, 1.0 ) ==
+                    xform.getValue( ISampleSelector( ( index_t ) 1 ) ).
+                    getMatrix() );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "interpolation.abc";
+    writeArchive( name );
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject top( archive, kTop );
+
+    testSampleBlend();
+    testMesh( top );
+    testPoints( top );
+    testXform( top );
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A unit quad on the ground facing up, and one standing on its +x edge
+// facing +x, folded 90 degrees along the edge 1-2.
+static int32_t g_counts[] = { 4, 4 };
+static int32_t g_indices[] = { 3, 2, 1, 0, 5, 4, 2, 1 };
+static float32_t g_points[] = { 0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,
+                                1, 1, 1,  1, 0, 1,
+                                // not used by any face
+                                5, 5, 5 };
+
+//-*****************************************************************************
+bool near( const N3f &iA, const N3f &iB )
+{
+    return ( iA - iB ).length() < 1e-5f;
+}
+
+//-*****************************************************************************
+void testFold( const P3fArraySample &iPositions )
+{
+    MeshTopology topo( Int32ArraySample( g_counts, 2 ),
+                       Int32ArraySample( g_indices, 8 ) );
+    Int32ArraySample indices( g_indices, 8 );
+
+    N3f up( 0.0f, 0.0f, 1.0f );
+    N3f side( 1.0f, 0.0f, 0.0f );
+    float32_t h = sqrtf( 0.5f );
+    N3f fold( h, 0.0f, h );
+    N3f zero( 0.0f, 0.0f, 0.0f );
+
+    std::vector<N3f> normals;
+    ComputeFaceNormals( topo, indices, iPositions, normals );
+    TESTING_ASSERT( normals.size() == 2 );
+    TESTING_ASSERT( near( normals[0], up ) && near( normals[1], side ) );
+
+    ComputeVertexNormals( topo, indices, iPositions, normals );
+    TESTING_ASSERT( normals.size() == 7 );
+    TESTING_ASSERT( near( normals[0], up ) && near( normals[3], up ) );
+    TESTING_ASSERT( near( normals[1], fold ) && near( normals[2], fold ) );
+    TESTING_ASSERT( near( normals[4], side ) && near( normals[5], side ) );
+    TESTING_ASSERT( near( normals[6], zero ) );
+
+    // a fold sharper than the crease angle stays sharp
+    ComputeFaceVaryingNormals( topo, indices, iPositions, 30.0, normals );
+    TESTING_ASSERT( normals.size() == 8 );
+    for ( size_t i = 0; i < 4; ++i )
+    {
+        TESTING_ASSERT( near( normals[i], up ) );
+        TESTING_ASSERT( near( normals[i + 4], side ) );
+    }
+
+    // and one within it is smoothed over
+    ComputeFaceVaryingNormals( topo, indices, iPositions, 100.0, normals );
+    TESTING_ASSERT( near( normals[0], up ) && near( normals[3], up ) );
+    TESTING_ASSERT( near( normals[1], fold ) && near( normals[2], fold ) );
+    TESTING_ASSERT( near( normals[6], fold ) && near( normals[7], fold ) );
+    TESTING_ASSERT( near( normals[4], side ) && near( normals[5], side ) );
+}
+
+//-*****************************************************************************
+// Big enough to be split across threads.
+void testGrid()
+{
+    size_t n = 300;
+    std::vector<int32_t> counts( n * n, 4 );
+    std::vector<int32_t> indices;
+    std::vector<V3f> p;
+    for ( size_t y = 0; y <= n; ++y )
+    {
+        for ( size_t x = 0; x <= n; ++x )
+        {
+            p.push_back( V3f( ( float32_t ) x, ( float32_t ) y, 0.0f ) );
+            if ( x < n && y < n )
+            {
+                int32_t v = ( int32_t ) ( y * ( n + 1 ) + x );
+                indices.push_back( v );
+                indices.push_back( v + 1 );
+                indices.push_back( v + 1 + ( int32_t ) ( n + 1 ) );
+                indices.push_back( v + ( int32_t ) ( n + 1 ) );
+            }
+        }
+    }
+
+    MeshTopology topo( ( Int32ArraySample( counts ) ),
+                       ( Int32ArraySample( indices ) ) );
+
+    // counter-clockwise seen from above, so it faces down
+    N3f down( 0.0f, 0.0f, -1.0f );
+    std::vector<N3f> normals;
+    ComputeVertexNormals( topo, Int32ArraySample( indices ),
+                          P3fArraySample( p ), normals );
+    TESTING_ASSERT( normals.size() == p.size() );
+    for ( size_t i = 0; i < normals.size(); ++i )
+    {
+        TESTING_ASSERT( near( normals[i], down ) );
+    }
+
+    ComputeFaceVaryingNormals( topo, Int32ArraySample( indices ),
+                               P3fArraySample( p ), 45.0, normals );
+    TESTING_ASSERT( normals.size() == indices.size() );
+    TESTING_ASSERT( near( normals.front(), down ) );
+    TESTING_ASSERT( near( normals.back(), down ) );
+
+    // the wrong number of positions for the topology
+    bool threw = false;
+    try
+    {
+        ComputeFaceNormals( topo, Int32ArraySample( indices ),
+                            P3fArraySample( &p.front(), 4 ), normals );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+// Normals of a deforming mesh read back, with one topology for all frames.
+void testSamples()
+{
+    std::string name = "meshNormals.abc";
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OPolyMesh mesh( OObject( archive, kTop ), "fold" );
+        for ( size_t s = 0; s < 2; ++s )
+        {
+            std::vector<V3f> p( ( const V3f * ) g_points,
+                                ( const V3f * ) g_points + 7 );
+            for ( size_t i = 0; i < p.size(); ++i )
+            {
+                p[i] *= ( float32_t ) ( s + 1 );
+            }
+
+            mesh.getSchema().set( OPolyMeshSchema::Sample(
+                P3fArraySample( p ),
+                Int32ArraySample( g_indices, 8 ),
+                Int32ArraySample( g_counts, 2 ) ) );
+        }
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IPolyMesh mesh( IObject( archive, kTop ), "fold" );
+    IPolyMeshSchema &schema = mesh.getSchema();
+
+    MeshTopologyCache cache;
+    for ( index_t s = 0; s < 2; ++s )
+    {
+        MeshTopologyPtr topo = cache.get( schema, s );
+
+        IPolyMeshSchema::Sample samp;
+        schema.get( samp, s );
+
+        std::vector<N3f> normals;
+        ComputeFaceNormals( *topo, samp, normals );
+        TESTING_ASSERT( near( normals[1], N3f( 1.0f, 0.0f, 0.0f ) ) );
+
+        ComputeVertexNormals( *topo, samp, normals );
+        TESTING_ASSERT( normals.size() == 7 );
+
+        ComputeFaceVaryingNormals( *topo, samp, 30.0, normals );
+        TESTING_ASSERT( near( normals[2], N3f( 0.0f, 0.0f, 1.0f ) ) );
+    }
+    TESTING_ASSERT( cache.size() == 1 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testFold( P3fArraySample( ( const V3f * ) g_points, 7 ) );
+    testGrid();
+    testSamples();
+    return 0;
+}
@@ -0,0 +1,206 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A quad and a triangle sharing the edge 1-2.
+static int32_t g_counts[] = { 4, 3 };
+static int32_t g_indices[] = { 0, 1, 2, 3, 2, 1, 4 };
+
+//-*****************************************************************************
+template <class T>
+bool equals( const std::vector<T> &iVec, const T *iExpected, size_t iSize )
+{
+    return iVec.size() == iSize &&
+        std::equal( iVec.begin(), iVec.end(), iExpected );
+}
+
+//-*****************************************************************************
+void testTopology()
+{
+    MeshTopology topo( Int32ArraySample( g_counts, 2 ),
+                       Int32ArraySample( g_indices, 7 ) );
+
+    TESTING_ASSERT( topo.getNumFaces() == 2 );
+    TESTING_ASSERT( topo.getNumVertices() == 5 );
+
+    int32_t offsets[] = { 0, 4, 7 };
+    TESTING_ASSERT( equals( topo.getFaceOffsets(), offsets, 3 ) );
+
+    int32_t triangles[] = { 0, 1, 2, 0, 2, 3, 2, 1, 4 };
+    int32_t triangleFaces[] = { 0, 0, 1 };
+    TESTING_ASSERT( equals( topo.getTriangles(), triangles, 9 ) );
+    TESTING_ASSERT( equals( topo.getTriangleFaces(), triangleFaces, 3 ) );
+
+    int32_t vertexFaceOffsets[] = { 0, 1, 3, 5, 6, 7 };
+    int32_t vertexFaces[] = { 0, 0, 1, 0, 1, 0, 1 };
+    TESTING_ASSERT( equals( topo.getVertexFaceOffsets(), vertexFaceOffsets,
+                            6 ) );
+    TESTING_ASSERT( equals( topo.getVertexFaces(), vertexFaces, 7 ) );
+
+    int32_t edges[] = { 0, 1, 0, 3, 1, 2, 1, 4, 2, 3, 2, 4 };
+    TESTING_ASSERT( equals( topo.getEdges(), edges, 12 ) );
+
+    // the counts don't cover the indices
+    bool threw = false;
+    try
+    {
+        MeshTopology bad( Int32ArraySample( g_counts, 1 ),
+                          Int32ArraySample( g_indices, 7 ) );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+// Big enough to be built on several threads.
+void testGrid()
+{
+    size_t n = 300;
+    std::vector<int32_t> counts( n * n, 4 );
+    std::vector<int32_t> indices;
+    for ( size_t y = 0; y < n; ++y )
+    {
+        for ( size_t x = 0; x < n; ++x )
+        {
+            int32_t v = ( int32_t ) ( y * ( n + 1 ) + x );
+            indices.push_back( v );
+            indices.push_back( v + 1 );
+            indices.push_back( v + 1 + ( int32_t ) ( n + 1 ) );
+            indices.push_back( v + ( int32_t ) ( n + 1 ) );
+        }
+    }
+
+    MeshTopology topo( ( Int32ArraySample( counts ) ),
+                       ( Int32ArraySample( indices ) ) );
+
+    TESTING_ASSERT( topo.getNumVertices() == ( n + 1 ) * ( n + 1 ) );
+    TESTING_ASSERT( topo.getTriangles().size() == n * n * 6 );
+    TESTING_ASSERT( topo.getEdges().size() == n * ( n + 1 ) * 2 * 2 );
+
+    // inner vertices have four faces, corners one
+    const std::vector<int32_t> &offsets = topo.getVertexFaceOffsets();
+    size_t inner = ( n + 1 ) + 1;
+    TESTING_ASSERT( offsets[inner + 1] - offsets[inner] == 4 );
+    TESTING_ASSERT( offsets[1] - offsets[0] == 1 );
+    TESTING_ASSERT( topo.getVertexFaces()[offsets[inner]] == 0 );
+}
+
+//-*****************************************************************************
+void testCache()
+{
+    std::string name = "meshTopology.abc";
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OObject top( archive, kTop );
+
+        std::vector<V3f> p( 5, V3f( 0.0f ) );
+        int32_t otherIndices[] = { 3, 2, 1, 0, 2, 1, 4 };
+
+        // two meshes with the same constant topology, and one that changes
+        OPolyMesh a( top, "a" );
+        OPolyMesh b( top, "b" );
+        OPolyMesh c( top, "c" );
+        for ( size_t s = 0; s < 3; ++s )
+        {
+            OPolyMeshSchema::Sample samp( P3fArraySample( p ),
+                Int32ArraySample( g_indices, 7 ),
+                Int32ArraySample( g_counts, 2 ) );
+            a.getSchema().set( samp );
+            b.getSchema().set( samp );
+
+            if ( s == 2 )
+            {
+                samp.setFaceIndices( Int32ArraySample( otherIndices, 7 ) );
+            }
+            c.getSchema().set( samp );
+        }
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject top( archive, kTop );
+    IPolyMesh a( top, "a" );
+    IPolyMesh b( top, "b" );
+    IPolyMesh c( top, "c" );
+
+    MeshTopologyCache cache;
+    MeshTopologyPtr topo = cache.get( a.getSchema() );
+    TESTING_ASSERT( topo->getTriangles().size() == 9 );
+
+    for ( index_t s = 0; s < 3; ++s )
+    {
+        TESTING_ASSERT( cache.get( a.getSchema(), s ) == topo );
+        TESTING_ASSERT( cache.get( b.getSchema(), s ) == topo );
+    }
+    TESTING_ASSERT( cache.get( c.getSchema(), 1 ) == topo );
+    TESTING_ASSERT( cache.size() == 1 );
+
+    MeshTopologyPtr changed = cache.get( c.getSchema(), 2 );
+    TESTING_ASSERT( changed != topo );
+    TESTING_ASSERT( changed->getTriangles()[0] == 3 );
+    TESTING_ASSERT( cache.size() == 2 );
+    TESTING_ASSERT( cache.getMemoryUsage() ==
+                    topo->getMemoryUsage() + changed->getMemoryUsage() );
+
+    // over budget, the least recently used goes first
+    cache.setMaxBytes( changed->getMemoryUsage() );
+    TESTING_ASSERT( cache.size() == 1 );
+    TESTING_ASSERT( cache.get( c.getSchema(), 2 ) == changed );
+
+    // and what's still held outlives the cache's copy
+    cache.setMaxBytes( 0 );
+    TESTING_ASSERT( cache.size() == 0 && cache.getMemoryUsage() == 0 );
+    TESTING_ASSERT( topo->getEdges().size() == 12 );
+    TESTING_ASSERT( cache.get( a.getSchema() ) != topo );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testTopology();
+    testGrid();
+    testCache();
+    return 0;
+}
@@ -0,0 +1,199 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+//-*****************************************************************************
+// Times tessellating every NuPatch in an archive, one patch at a time and
+// then split across threads. Without an archive, a stand-in for a CAD
+// export is written first: a grid of bicubic patches with trim holes.
+// Not run as part of the test suite.
+//
+//     AbcGeom_NuPatchTessellationBenchmark [archive] [tolerance] [maxSteps]
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <cmath>
+#include <iostream>
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+static double secondsSince( const boost::posix_time::ptime &iStart )
+{
+    boost::posix_time::time_duration d =
+        boost::posix_time::microsec_clock::local_time() - iStart;
+    return d.total_microseconds() / 1.0e6;
+}
+
+//-*****************************************************************************
+// 40 by 40 wavy patches of 8 by 8 control points, each with a circular
+// hole trimmed out of it.
+void writeStandIn( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+    OObject top( archive, kTop );
+
+    const int32_t numCvs = 8;
+    const int32_t order = 4;
+    std::vector<float32_t> knot;
+    for ( int32_t i = 0; i < numCvs + order; ++i )
+    {
+        knot.push_back( ( float32_t ) std::min( std::max( i - order + 1, 0 ),
+                                                numCvs - order + 1 ) );
+    }
+    float32_t domain = knot.back();
+
+    // an outer boundary and a rational circle for the hole
+    int32_t trimNumCurves[] = { 1, 1 };
+    int32_t trimN[] = { 5, 9 };
+    int32_t trimOrder[] = { 2, 3 };
+    float32_t trimKnot[] = { 0, 0, 1, 2, 3, 4, 4,
+                             0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4 };
+    float32_t trimMin[] = { 0, 0 };
+    float32_t trimMax[] = { 4, 4 };
+    float32_t c = domain * 0.5f;
+    float32_t r = domain * 0.25f;
+    float32_t trimU[] = { 0, domain, domain, 0, 0,
+                          c + r, c + r, c, c - r, c - r, c - r, c, c + r,
+                          c + r };
+    float32_t trimV[] = { 0, 0, domain, domain, 0,
+                          c, c + r, c + r, c + r, c, c - r, c - r, c - r, c };
+    float32_t h = sqrtf( 0.5f );
+    float32_t trimW[] = { 1, 1, 1, 1, 1, 1, h, 1, h, 1, h, 1, h, 1 };
+
+    std::vector<V3f> p( numCvs * numCvs );
+    for ( size_t y = 0; y < 40; ++y )
+    {
+        for ( size_t x = 0; x < 40; ++x )
+        {
+            for ( int32_t j = 0; j < numCvs; ++j )
+            {
+                for ( int32_t i = 0; i < numCvs; ++i )
+                {
+                    float32_t u = x + i / ( numCvs - 1.0f );
+                    float32_t v = y + j / ( numCvs - 1.0f );
+                    p[j * numCvs + i] = V3f( u, v, 0.2f * sinf( u ) *
+                                             cosf( v ) );
+                }
+            }
+
+            ONuPatchSchema::Sample samp( P3fArraySample( p ), numCvs,
+                numCvs, order, order, FloatArraySample( knot ),
+                FloatArraySample( knot ) );
+            samp.setTrimCurve( 2, Int32ArraySample( trimNumCurves, 2 ),
+                Int32ArraySample( trimN, 2 ),
+                Int32ArraySample( trimOrder, 2 ),
+                FloatArraySample( trimKnot, 19 ),
+                FloatArraySample( trimMin, 2 ),
+                FloatArraySample( trimMax, 2 ),
+                FloatArraySample( trimU, 14 ),
+                FloatArraySample( trimV, 14 ),
+                FloatArraySample( trimW, 14 ) );
+
+            ONuPatch patch( top, "patch" +
+                boost::lexical_cast<std::string>( y * 40 + x ) );
+            patch.getSchema().set( samp );
+        }
+    }
+}
+
+//-*****************************************************************************
+void gatherPatches( IObject iObj, std::vector<INuPatchSchema::Sample> &oSamps )
+{
+    for ( size_t i = 0; i < iObj.getNumChildren(); ++i )
+    {
+        IObject child( iObj, iObj.getChildHeader( i ).getName() );
+        if ( INuPatch::matches( child.getHeader() ) )
+        {
+            INuPatch patch( child, kWrapExisting );
+            INuPatchSchema::Sample samp;
+            patch.getSchema().get( samp );
+            oSamps.push_back( samp );
+        }
+        gatherPatches( child, oSamps );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = argc > 1 ? argv[1] : "nuPatchBenchmark.abc";
+    float32_t tolerance = argc > 2 ?
+        boost::lexical_cast<float32_t>( argv[2] ) : 0.001f;
+    int32_t maxSteps = argc > 3 ?
+        boost::lexical_cast<int32_t>( argv[3] ) : 32;
+
+    if ( argc <= 1 )
+    {
+        writeStandIn( name );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    std::vector<INuPatchSchema::Sample> samples;
+    gatherPatches( archive.getTop(), samples );
+
+    std::cout << "patches: " << samples.size() << " tolerance: "
+              << tolerance << " max steps: " << maxSteps << std::endl;
+
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::local_time();
+    std::vector<NuPatchMesh> meshes( samples.size() );
+    for ( size_t i = 0; i < samples.size(); ++i )
+    {
+        TessellateNuPatch( samples[i], tolerance, maxSteps, meshes[i] );
+    }
+    double serial = secondsSince( start );
+
+    size_t numTriangles = 0;
+    for ( size_t i = 0; i < meshes.size(); ++i )
+    {
+        numTriangles += meshes[i].triangles.size() / 3;
+    }
+
+    start = boost::posix_time::microsec_clock::local_time();
+    TessellateNuPatches( samples, tolerance, maxSteps, meshes );
+    double threaded = secondsSince( start );
+
+    std::cout << "triangles: " << numTriangles << std::endl;
+    std::cout << "one at a time: " << serial << "s" << std::endl;
+    std::cout << "threaded:      " << threaded << "s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,393 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+#include <map>
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A flat bicubic patch whose evenly spaced control points make it the
+// plane P( u, v ) = ( u, v, 0 ).
+static const float32_t g_cubicKnot[] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+//-*****************************************************************************
+// Square trim loops of five linear vertices: the whole domain, and a hole
+// from 0.3 to 0.7.
+static const int32_t g_squareOrder[] = { 2, 2 };
+static const int32_t g_squareN[] = { 5, 5 };
+static const float32_t g_squareKnot[] = { 0, 0, 1, 2, 3, 4, 4,
+                                          0, 0, 1, 2, 3, 4, 4 };
+static const float32_t g_squareMin[] = { 0, 0 };
+static const float32_t g_squareMax[] = { 4, 4 };
+static const float32_t g_squareU[] = { 0, 1, 1, 0, 0,
+                                       0.3f, 0.7f, 0.7f, 0.3f, 0.3f };
+static const float32_t g_squareV[] = { 0, 0, 1, 1, 0,
+                                       0.3f, 0.3f, 0.7f, 0.7f, 0.3f };
+static const float32_t g_squareW[] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+//-*****************************************************************************
+// The same domain with a rational circle, which lines up with no grid,
+// trimmed out of it.
+static const float32_t g_circleX = 0.47f;
+static const float32_t g_circleY = 0.53f;
+static const float32_t g_circleR = 0.23f;
+static const int32_t g_circleOrder[] = { 2, 3 };
+static const int32_t g_circleN[] = { 5, 9 };
+static const float32_t g_circleKnot[] = { 0, 0, 1, 2, 3, 4, 4,
+                                          0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4 };
+
+//-*****************************************************************************
+bool near( const V3f &iA, const V3f &iB )
+{
+    return ( iA - iB ).length() < 1e-5f;
+}
+
+//-*****************************************************************************
+void getPlanePoints( std::vector<V3f> &oP )
+{
+    for ( size_t j = 0; j < 4; ++j )
+    {
+        for ( size_t i = 0; i < 4; ++i )
+        {
+            oP.push_back( V3f( i / 3.0f, j / 3.0f, 0.0f ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+void writePlane( OObject &iParent, const std::string &iName,
+                 size_t iFirstLoop, size_t iNumLoops )
+{
+    std::vector<V3f> p;
+    getPlanePoints( p );
+
+    ONuPatch patch( iParent, iName );
+    ONuPatchSchema::Sample samp( P3fArraySample( p ), 4, 4, 4, 4,
+                                 FloatArraySample( g_cubicKnot, 8 ),
+                                 FloatArraySample( g_cubicKnot, 8 ) );
+
+    if ( iNumLoops > 0 )
+    {
+        std::vector<int32_t> numCurves( iNumLoops, 1 );
+        size_t c = iFirstLoop;
+        samp.setTrimCurve( ( int32_t ) iNumLoops,
+            Int32ArraySample( numCurves ),
+            Int32ArraySample( g_squareN + c, iNumLoops ),
+            Int32ArraySample( g_squareOrder + c, iNumLoops ),
+            FloatArraySample( g_squareKnot + c * 7, iNumLoops * 7 ),
+            FloatArraySample( g_squareMin + c, iNumLoops ),
+            FloatArraySample( g_squareMax + c, iNumLoops ),
+            FloatArraySample( g_squareU + c * 5, iNumLoops * 5 ),
+            FloatArraySample( g_squareV + c * 5, iNumLoops * 5 ),
+            FloatArraySample( g_squareW + c * 5, iNumLoops * 5 ) );
+    }
+    patch.getSchema().set( samp );
+}
+
+//-*****************************************************************************
+// A plane whose u knots go back down part way along.
+void writeBadKnots( OObject &iParent )
+{
+    std::vector<V3f> p;
+    getPlanePoints( p );
+
+    static const float32_t badKnot[] = { 0, 0, 0, 0, 1, 0.5f, 1, 1 };
+    ONuPatch patch( iParent, "badKnots" );
+    patch.getSchema().set( ONuPatchSchema::Sample( P3fArraySample( p ),
+        4, 4, 4, 4, FloatArraySample( badKnot, 8 ),
+        FloatArraySample( g_cubicKnot, 8 ) ) );
+}
+
+//-*****************************************************************************
+void writeCircleHoled( OObject &iParent )
+{
+    std::vector<V3f> p;
+    getPlanePoints( p );
+
+    float32_t x = g_circleX;
+    float32_t y = g_circleY;
+    float32_t r = g_circleR;
+    float32_t h = sqrtf( 0.5f );
+    int32_t numCurves[] = { 1, 1 };
+    float32_t min[] = { 0, 0 };
+    float32_t max[] = { 4, 4 };
+    float32_t u[] = { 0, 1, 1, 0, 0,
+                      x + r, x + r, x, x - r, x - r, x - r, x, x + r, x + r };
+    float32_t v[] = { 0, 0, 1, 1, 0,
+                      y, y + r, y + r, y + r, y, y - r, y - r, y - r, y };
+    float32_t w[] = { 1, 1, 1, 1, 1, 1, h, 1, h, 1, h, 1, h, 1 };
+
+    ONuPatch patch( iParent, "circleHoled" );
+    ONuPatchSchema::Sample samp( P3fArraySample( p ), 4, 4, 4, 4,
+                                 FloatArraySample( g_cubicKnot, 8 ),
+                                 FloatArraySample( g_cubicKnot, 8 ) );
+    samp.setTrimCurve( 2, Int32ArraySample( numCurves, 2 ),
+                       Int32ArraySample( g_circleN, 2 ),
+                       Int32ArraySample( g_circleOrder, 2 ),
+                       FloatArraySample( g_circleKnot, 19 ),
+                       FloatArraySample( min, 2 ),
+                       FloatArraySample( max, 2 ),
+                       FloatArraySample( u, 14 ),
+                       FloatArraySample( v, 14 ),
+                       FloatArraySample( w, 14 ) );
+    patch.getSchema().set( samp );
+}
+
+//-*****************************************************************************
+// A rational quarter circle of radius one in u, swept linearly along z.
+void writeCylinder( OObject &iParent )
+{
+    V3f p[] = { V3f( 1, 0, 0 ), V3f( 1, 1, 0 ), V3f( 0, 1, 0 ),
+                V3f( 1, 0, 1 ), V3f( 1, 1, 1 ), V3f( 0, 1, 1 ) };
+    float32_t h = sqrtf( 0.5f );
+    float32_t w[] = { 1, h, 1, 1, h, 1 };
+    float32_t uKnot[] = { 0, 0, 0, 1, 1, 1 };
+    float32_t vKnot[] = { 0, 0, 1, 1 };
+
+    ONuPatch patch( iParent, "cylinder" );
+    patch.getSchema().set( ONuPatchSchema::Sample( P3fArraySample( p, 6 ),
+        3, 2, 3, 2, FloatArraySample( uKnot, 6 ),
+        FloatArraySample( vKnot, 4 ), ON3fGeomParam::Sample(),
+        OV2fGeomParam::Sample(), FloatArraySample( w, 6 ) ) );
+}
+
+//-*****************************************************************************
+INuPatchSchema::Sample readPatch( IObject &iParent, const std::string &iName )
+{
+    INuPatch patch( iParent, iName );
+    INuPatchSchema::Sample samp;
+    patch.getSchema().get( samp );
+    return samp;
+}
+
+//-*****************************************************************************
+// The edges only one triangle has are on the border of the patch, or else
+// on the trimmed edge, which has to be within iBound of the circle.
+// Any other edge is had by two triangles, wound opposite ways, so there are
+// no cracks between the cut cells and the rest.
+void testTrimmedEdge( const INuPatchSchema::Sample &iSample,
+                      float32_t iTolerance, int32_t iMaxSteps,
+                      float32_t iBound )
+{
+    NuPatchMesh mesh;
+    TessellateNuPatch( iSample, iTolerance, iMaxSteps, mesh );
+
+    std::map<std::pair<int32_t, int32_t>, size_t> edges;
+    float32_t area = 0.0f;
+    for ( size_t t = 0; t < mesh.triangles.size(); t += 3 )
+    {
+        for ( size_t k = 0; k < 3; ++k )
+        {
+            std::pair<int32_t, int32_t> edge( mesh.triangles[t + k],
+                mesh.triangles[t + ( k + 1 ) % 3] );
+            TESTING_ASSERT( ++edges[edge] == 1 );
+        }
+
+        const V2f &a = mesh.uvs[mesh.triangles[t]];
+        const V2f &b = mesh.uvs[mesh.triangles[t + 1]];
+        const V2f &c = mesh.uvs[mesh.triangles[t + 2]];
+        area -= 0.5f * ( ( b.x - a.x ) * ( c.y - a.y ) -
+                         ( b.y - a.y ) * ( c.x - a.x ) );
+    }
+
+    size_t trimmed = 0;
+    std::map<std::pair<int32_t, int32_t>, size_t>::iterator it;
+    for ( it = edges.begin(); it != edges.end(); ++it )
+    {
+        int32_t i = it->first.first;
+        int32_t j = it->first.second;
+        if ( edges.count( std::make_pair( j, i ) ) )
+        {
+            continue;
+        }
+
+        const V2f &a = mesh.uvs[i];
+        const V2f &b = mesh.uvs[j];
+        if ( ( a.x == b.x && ( a.x == 0.0f || a.x == 1.0f ) ) ||
+             ( a.y == b.y && ( a.y == 0.0f || a.y == 1.0f ) ) )
+        {
+            continue;
+        }
+
+        V3f center( g_circleX, g_circleY, 0.0f );
+        V3f points[] = { mesh.positions[i], mesh.positions[j],
+                         ( mesh.positions[i] + mesh.positions[j] ) * 0.5f };
+        for ( size_t k = 0; k < 3; ++k )
+        {
+            TESTING_ASSERT( std::abs( ( points[k] - center ).length() -
+                                      g_circleR ) <= iBound );
+        }
+        ++trimmed;
+    }
+    TESTING_ASSERT( trimmed > 8 );
+
+    float32_t expected = 1.0f - ( float32_t ) M_PI * g_circleR * g_circleR;
+    TESTING_ASSERT( std::abs( area - expected ) < 2.0f * iBound );
+}
+
+//-*****************************************************************************
+void testPatches()
+{
+    std::string name = "nuPatchTessellation.abc";
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OObject top( archive, kTop );
+        writePlane( top, "plane", 0, 0 );
+        writePlane( top, "holed", 0, 2 );
+        writePlane( top, "hole", 1, 1 );
+        writeCircleHoled( top );
+        writeCylinder( top );
+        writeBadKnots( top );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject top( archive, kTop );
+
+    // without a tolerance every span gets the most steps
+    NuPatchMesh mesh;
+    INuPatchSchema::Sample plane = readPatch( top, "plane" );
+    TessellateNuPatch( plane, 0.0f, 10, mesh );
+    TESTING_ASSERT( mesh.positions.size() == 121 );
+    TESTING_ASSERT( mesh.uvs.size() == 121 );
+    TESTING_ASSERT( mesh.triangles.size() == 200 * 3 );
+    for ( size_t i = 0; i < mesh.positions.size(); ++i )
+    {
+        TESTING_ASSERT( near( mesh.positions[i],
+            V3f( mesh.uvs[i].x, mesh.uvs[i].y, 0.0f ) ) );
+    }
+
+    // and the triangles face along dS/du x dS/dv
+    std::vector<int32_t> counts( mesh.triangles.size() / 3, 3 );
+    MeshTopology topo( ( Int32ArraySample( counts ) ),
+                       ( Int32ArraySample( mesh.triangles ) ) );
+    std::vector<N3f> normals;
+    ComputeFaceNormals( topo, Int32ArraySample( mesh.triangles ),
+                        P3fArraySample( mesh.positions ), normals );
+    for ( size_t i = 0; i < normals.size(); ++i )
+    {
+        TESTING_ASSERT( near( normals[i], V3f( 0.0f, 0.0f, 1.0f ) ) );
+    }
+
+    // a flat patch needs no more than one step
+    TessellateNuPatch( plane, 0.01f, 10, mesh );
+    TESTING_ASSERT( mesh.positions.size() == 4 );
+    TESTING_ASSERT( mesh.triangles.size() == 6 );
+
+    // the 4 by 4 cells in the hole are cut out
+    TessellateNuPatch( readPatch( top, "holed" ), 0.0f, 10, mesh );
+    TESTING_ASSERT( mesh.triangles.size() == 84 * 2 * 3 );
+    TESTING_ASSERT( mesh.positions.size() == 121 - 9 );
+
+    // and on its own only the hole is left
+    TessellateNuPatch( readPatch( top, "hole" ), 0.0f, 10, mesh );
+    TESTING_ASSERT( mesh.triangles.size() == 16 * 2 * 3 );
+    TESTING_ASSERT( mesh.positions.size() == 25 );
+    for ( size_t i = 0; i < mesh.uvs.size(); ++i )
+    {
+        TESTING_ASSERT( mesh.uvs[i].x > 0.25f && mesh.uvs[i].x < 0.75f );
+    }
+
+    // a hole that no grid line follows is cut along the trim, both when
+    // the flat patch is a single cell and when it is split into 10 by 10,
+    // where ten steps a quarter keep the circle within 0.001
+    INuPatchSchema::Sample circleHoled = readPatch( top, "circleHoled" );
+    testTrimmedEdge( circleHoled, 0.001f, 64, 0.001f );
+    testTrimmedEdge( circleHoled, 0.0005f, 64, 0.0005f );
+    testTrimmedEdge( circleHoled, 0.0f, 10, 0.001f );
+
+    // the weights make it exactly round
+    TessellateNuPatch( readPatch( top, "cylinder" ), 0.001f, 64, mesh );
+    TESTING_ASSERT( mesh.positions.size() > 4 );
+    for ( size_t i = 0; i < mesh.positions.size(); ++i )
+    {
+        const V3f &p = mesh.positions[i];
+        TESTING_ASSERT( std::abs( p.x * p.x + p.y * p.y - 1.0f ) < 1e-5f );
+    }
+
+    // many at once match one at a time
+    std::vector<INuPatchSchema::Sample> samples;
+    for ( size_t i = 0; i < 16; ++i )
+    {
+        samples.push_back( readPatch( top, "holed" ) );
+        samples.push_back( readPatch( top, "cylinder" ) );
+    }
+    std::vector<NuPatchMesh> meshes;
+    TessellateNuPatches( samples, 0.001f, 16, meshes );
+    TESTING_ASSERT( meshes.size() == samples.size() );
+    for ( size_t i = 0; i < meshes.size(); ++i )
+    {
+        TessellateNuPatch( samples[i], 0.001f, 16, mesh );
+        TESTING_ASSERT( meshes[i].triangles == mesh.triangles );
+        TESTING_ASSERT( meshes[i].positions == mesh.positions );
+    }
+
+    // an empty sample
+    bool threw = false;
+    try
+    {
+        std::vector<INuPatchSchema::Sample> bad( 1 );
+        TessellateNuPatches( bad, 0.001f, 16, meshes );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+
+    // knots that decrease
+    threw = false;
+    try
+    {
+        TessellateNuPatch( readPatch( top, "badKnots" ), 0.001f, 16, mesh );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testPatches();
+    return 0;
+}
@@ -0,0 +1,181 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// Samples are one second apart, and every point has a velocity of one
+// unit a second along y.
+//-*****************************************************************************
+
+//-*****************************************************************************
+void writePoints( OObject iParent, const std::string &iName,
+                  const std::vector< std::vector<uint64_t> > &iIds )
+{
+    uint32_t tsidx = iParent.getArchive().addTimeSampling(
+        TimeSampling( 1.0, 0.0 ) );
+    OPoints points( iParent, iName, tsidx );
+
+    // each point sits at x = id, and y = the sample index * 2
+    for ( size_t s = 0; s < iIds.size(); ++s )
+    {
+        std::vector<V3f> p;
+        std::vector<V3f> v;
+        for ( size_t i = 0; i < iIds[s].size(); ++i )
+        {
+            p.push_back( V3f( ( float ) iIds[s][i], s * 2.0f, 0.0f ) );
+            v.push_back( V3f( 0.0f, 1.0f, 0.0f ) );
+        }
+        points.getSchema().set( OPointsSchema::Sample(
+            P3fArraySample( p ), UInt64ArraySample( iIds[s] ),
+            V3fArraySample( v ) ) );
+    }
+}
+
+//-*****************************************************************************
+void testMatch()
+{
+    uint64_t ids[] = { 5, 6, 7, 8, 9 };
+    uint64_t nextIds[] = { 5, 9, 7, 9, 1, 2 };
+    std::vector<int64_t> matches;
+    MatchPointIds( UInt64ArraySample( ids, 5 ),
+                   UInt64ArraySample( nextIds, 6 ), matches );
+
+    TESTING_ASSERT( matches.size() == 5 );
+    TESTING_ASSERT( matches[0] == 0 );
+    TESTING_ASSERT( matches[1] == -1 );
+    TESTING_ASSERT( matches[2] == 2 );
+    TESTING_ASSERT( matches[3] == -1 );
+    TESTING_ASSERT( matches[4] == 1 );
+}
+
+//-*****************************************************************************
+void testBirthAndDeath( IObject iTop )
+{
+    IPoints pointsObj( iTop, "changing" );
+    std::vector<chrono_t> times;
+    times.push_back( 0.0 );
+    times.push_back( 0.25 );
+    times.push_back( 0.5 );
+
+    std::vector<P3fArraySamplePtr> positions;
+    TESTING_ASSERT( GetPointsMotion( pointsObj.getSchema(), times,
+                                     positions ) == 0 );
+    TESTING_ASSERT( positions.size() == 3 );
+
+    // the reference sample as is at its own time
+    TESTING_ASSERT( positions[0] == pointsObj.getSchema().
+                    getPositionsProperty().getValue(
+                        ISampleSelector( ( index_t ) 0 ) ) );
+
+    // 0 and 2 die, so they only have their velocity to go by, while
+    // 1 and 3 head to where they are in the next sample
+    const P3fArraySample &p = *positions[2];
+    TESTING_ASSERT( p.size() == 4 );
+    TESTING_ASSERT( p[0] == V3f( 0.0f, 0.5f, 0.0f ) );
+    TESTING_ASSERT( p[1] == V3f( 1.0f, 1.0f, 0.0f ) );
+    TESTING_ASSERT( p[2] == V3f( 2.0f, 0.5f, 0.0f ) );
+    TESTING_ASSERT( p[3] == V3f( 3.0f, 1.0f, 0.0f ) );
+    TESTING_ASSERT( ( *positions[1] )[3] == V3f( 3.0f, 0.5f, 0.0f ) );
+
+    // after the last sample everything goes by velocity
+    times.clear();
+    times.push_back( 1.5 );
+    TESTING_ASSERT( GetPointsMotion( pointsObj.getSchema(), times,
+                                     positions ) == 1 );
+    TESTING_ASSERT( ( *positions[0] )[0] == V3f( 3.0f, 2.5f, 0.0f ) );
+}
+
+//-*****************************************************************************
+void testLarge( IObject iTop, size_t iNumPoints )
+{
+    IPoints pointsObj( iTop, "large" );
+    std::vector<chrono_t> times;
+    times.push_back( 0.5 );
+
+    std::vector<P3fArraySamplePtr> positions;
+    GetPointsMotion( pointsObj.getSchema(), times, positions );
+
+    // every other point survives, in the reverse order
+    const P3fArraySample &p = *positions[0];
+    TESTING_ASSERT( p.size() == iNumPoints );
+    for ( size_t i = 0; i < iNumPoints; ++i )
+    {
+        float y = ( i % 2 == 0 ) ? 1.0f : 0.5f;
+        TESTING_ASSERT( p[i] == V3f( ( float ) i, y, 0.0f ) );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "pointsMotion.abc";
+    size_t numLarge = 300000;
+    {
+        OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), name );
+        OObject top( archive, kTop );
+
+        std::vector< std::vector<uint64_t> > ids( 2 );
+        for ( uint64_t i = 0; i < 4; ++i ) { ids[0].push_back( i ); }
+        ids[1].push_back( 3 );
+        ids[1].push_back( 1 );
+        ids[1].push_back( 4 );
+        writePoints( top, "changing", ids );
+
+        ids[0].clear();
+        ids[1].clear();
+        for ( uint64_t i = 0; i < numLarge; ++i )
+        {
+            ids[0].push_back( i );
+            if ( i % 2 == 0 ) { ids[1].push_back( numLarge - 2 - i ); }
+        }
+        writePoints( top, "large", ids );
+    }
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    IObject top( archive, kTop );
+
+    testMatch();
+    testBirthAndDeath( top );
+    testLarge( top, numLarge );
+
+    return 0;
+}
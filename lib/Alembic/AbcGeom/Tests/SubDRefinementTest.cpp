@@ -0,0 +1,310 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreHDF5/All.h>
+
+#include "Assert.h"
+
+using namespace Alembic::AbcGeom;
+
+//-*****************************************************************************
+// A cube from -1 to 1, vertex x + 2y + 4z at the +1 end of each axis set.
+static int32_t g_cubeCounts[] = { 4, 4, 4, 4, 4, 4 };
+static int32_t g_cubeIndices[] = { 0, 2, 3, 1,  4, 5, 7, 6,  0, 1, 5, 4,
+                                   2, 6, 7, 3,  0, 4, 6, 2,  1, 3, 7, 5 };
+static float32_t g_cubePoints[] = { -1, -1, -1,   1, -1, -1,
+                                    -1,  1, -1,   1,  1, -1,
+                                    -1, -1,  1,   1, -1,  1,
+                                    -1,  1,  1,   1,  1,  1 };
+
+//-*****************************************************************************
+bool near( const V3f &iA, const V3f &iB )
+{
+    return ( iA - iB ).length() < 1e-5f;
+}
+
+//-*****************************************************************************
+void checkStencils( const SubDRefinement &iRefinement )
+{
+    const std::vector<int32_t> &offsets = iRefinement.getStencilOffsets();
+    const std::vector<int32_t> &indices = iRefinement.getStencilIndices();
+    const std::vector<float32_t> &weights = iRefinement.getStencilWeights();
+    TESTING_ASSERT( offsets.size() == iRefinement.getNumPoints() + 1 );
+
+    for ( size_t p = 0; p < iRefinement.getNumPoints(); ++p )
+    {
+        float32_t sum = 0.0f;
+        for ( int32_t i = offsets[p]; i < offsets[p + 1]; ++i )
+        {
+            TESTING_ASSERT( indices[i] >= 0 && ( size_t ) indices[i] <
+                            iRefinement.getNumControlPoints() );
+            sum += weights[i];
+        }
+        TESTING_ASSERT( fabsf( sum - 1.0f ) < 1e-5f );
+    }
+}
+
+//-*****************************************************************************
+void writeArchive( const std::string &iName )
+{
+    OArchive archive( Alembic::AbcCoreHDF5::WriteArchive(), iName );
+
+    // the third sample has one more, unused, position
+    OSubD cube( OObject( archive, kTop ), "cube" );
+    for ( size_t s = 0; s < 3; ++s )
+    {
+        std::vector<V3f> p( ( const V3f * ) g_cubePoints,
+                            ( const V3f * ) g_cubePoints + 8 );
+        for ( size_t i = 0; i < p.size(); ++i )
+        {
+            p[i] *= ( float32_t ) ( s + 1 );
+        }
+        if ( s == 2 )
+        {
+            p.push_back( V3f( 0.0f, 0.0f, 0.0f ) );
+        }
+
+        cube.getSchema().set( OSubDSchema::Sample( P3fArraySample( p ),
+            Int32ArraySample( g_cubeIndices, 24 ),
+            Int32ArraySample( g_cubeCounts, 6 ) ) );
+    }
+
+    // every vertex a sharp corner
+    std::vector<int32_t> corners;
+    for ( int32_t i = 0; i < 8; ++i )
+    {
+        corners.push_back( i );
+    }
+    std::vector<float32_t> cornerSharpnesses( 8, 10.0f );
+    OSubD sharpCube( OObject( archive, kTop ), "sharpCube" );
+    sharpCube.getSchema().set( OSubDSchema::Sample(
+        P3fArraySample( ( const V3f * ) g_cubePoints, 8 ),
+        Int32ArraySample( g_cubeIndices, 24 ),
+        Int32ArraySample( g_cubeCounts, 6 ),
+        Int32ArraySample(), Int32ArraySample(), FloatArraySample(),
+        Int32ArraySample( corners ), FloatArraySample( cornerSharpnesses ) ) );
+
+    // 3 by 3 quads on the ground, with a hole in the middle
+    std::vector<V3f> p;
+    std::vector<int32_t> counts( 9, 4 );
+    std::vector<int32_t> indices;
+    for ( int32_t y = 0; y < 4; ++y )
+    {
+        for ( int32_t x = 0; x < 4; ++x )
+        {
+            p.push_back( V3f( ( float32_t ) x, ( float32_t ) y, 0.0f ) );
+            if ( x < 3 && y < 3 )
+            {
+                int32_t v = y * 4 + x;
+                indices.push_back( v );
+                indices.push_back( v + 4 );
+                indices.push_back( v + 5 );
+                indices.push_back( v + 1 );
+            }
+        }
+    }
+    int32_t hole = 4;
+
+    OSubDSchema::Sample gridSamp( P3fArraySample( p ),
+        Int32ArraySample( indices ), Int32ArraySample( counts ),
+        Int32ArraySample(), Int32ArraySample(), FloatArraySample(),
+        Int32ArraySample(), FloatArraySample(),
+        Int32ArraySample( &hole, 1 ) );
+    gridSamp.setInterpolateBoundary( 1 );
+    OSubD grid( OObject( archive, kTop ), "grid" );
+    grid.getSchema().set( gridSamp );
+
+    OSubDSchema::Sample loopSamp( P3fArraySample( p ),
+        Int32ArraySample( indices ), Int32ArraySample( counts ) );
+    loopSamp.setSubdivisionScheme( "loop" );
+    OSubD loop( OObject( archive, kTop ), "loop" );
+    loop.getSchema().set( loopSamp );
+}
+
+//-*****************************************************************************
+void testCube( IArchive &iArchive )
+{
+    ISubD cube( IObject( iArchive, kTop ), "cube" );
+    ISubDSchema::Sample samp;
+    cube.getSchema().get( samp );
+
+    // no levels is just the cage
+    SubDRefinement cage( samp, 0 );
+    TESTING_ASSERT( cage.getNumPoints() == 8 );
+    TESTING_ASSERT( cage.getFaceCounts().size() == 6 );
+    TESTING_ASSERT( cage.getFaceIndices().size() == 24 );
+    checkStencils( cage );
+
+    SubDRefinement once( samp, 1 );
+    TESTING_ASSERT( once.getNumControlPoints() == 8 );
+    TESTING_ASSERT( once.getNumPoints() == 8 + 6 + 12 );
+    TESTING_ASSERT( once.getFaceCounts().size() == 24 );
+    TESTING_ASSERT( once.getFaceIndices().size() == 96 );
+    checkStencils( once );
+
+    // a cube corner moves to ( F + 2R ) / 3, with F = 1/3 and R = 2/3
+    std::vector<V3f> p;
+    once.refine( *samp.getPositions(), p );
+    TESTING_ASSERT( p.size() == 26 );
+    float32_t c = 5.0f / 9.0f;
+    TESTING_ASSERT( near( p[7], V3f( c, c, c ) ) );
+    TESTING_ASSERT( near( p[0], V3f( -c, -c, -c ) ) );
+
+    // the face points are the face centers
+    TESTING_ASSERT( near( p[8], V3f( 0.0f, 0.0f, -1.0f ) ) );
+
+    SubDRefinement twice( samp, 2 );
+    TESTING_ASSERT( twice.getNumPoints() == 26 + 24 + 48 );
+    TESTING_ASSERT( twice.getFaceCounts().size() == 96 );
+    checkStencils( twice );
+
+    // the wrong number of positions for the stencils
+    bool threw = false;
+    try
+    {
+        once.refine( P3fArraySample( ( const V3f * ) g_cubePoints, 4 ), p );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+
+    ISubD sharpCube( IObject( iArchive, kTop ), "sharpCube" );
+    sharpCube.getSchema().get( samp );
+    SubDRefinement sharp( samp, 2 );
+    checkStencils( sharp );
+    sharp.refine( *samp.getPositions(), p );
+    TESTING_ASSERT( near( p[7], V3f( 1.0f, 1.0f, 1.0f ) ) );
+    TESTING_ASSERT( near( p[0], V3f( -1.0f, -1.0f, -1.0f ) ) );
+}
+
+//-*****************************************************************************
+void testGrid( IArchive &iArchive )
+{
+    ISubD grid( IObject( iArchive, kTop ), "grid" );
+    ISubDSchema::Sample samp;
+    grid.getSchema().get( samp );
+
+    SubDRefinement refinement( samp, 1 );
+    TESTING_ASSERT( refinement.getNumPoints() == 16 + 9 + 24 );
+
+    // the hole's children are left out
+    TESTING_ASSERT( refinement.getFaceCounts().size() == 32 );
+    checkStencils( refinement );
+
+    std::vector<V3f> p;
+    refinement.refine( *samp.getPositions(), p );
+    for ( size_t i = 0; i < p.size(); ++i )
+    {
+        TESTING_ASSERT( fabsf( p[i].z ) < 1e-6f );
+    }
+
+    // the boundary is interpolated, so its corners stay put and its edges
+    // stay on the edge
+    TESTING_ASSERT( near( p[0], V3f( 0.0f, 0.0f, 0.0f ) ) );
+    TESTING_ASSERT( near( p[15], V3f( 3.0f, 3.0f, 0.0f ) ) );
+    TESTING_ASSERT( fabsf( p[1].y ) < 1e-6f );
+
+    ISubD loop( IObject( iArchive, kTop ), "loop" );
+    loop.getSchema().get( samp );
+    bool threw = false;
+    try
+    {
+        SubDRefinement bad( samp, 1 );
+    }
+    catch ( std::exception &e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+}
+
+//-*****************************************************************************
+// One refinement shared by every frame of a deforming subd.
+void testCache( IArchive &iArchive )
+{
+    ISubD cube( IObject( iArchive, kTop ), "cube" );
+    ISubDSchema &schema = cube.getSchema();
+
+    SubDRefinementCache cache;
+    index_t firstFrame = 0;
+    index_t secondFrame = 1;
+    SubDRefinementPtr first = cache.get( schema, 1, firstFrame );
+    SubDRefinementPtr second = cache.get( schema, 1, secondFrame );
+    TESTING_ASSERT( first == second );
+    TESTING_ASSERT( cache.size() == 1 );
+    TESTING_ASSERT( cache.getMemoryUsage() == first->getMemoryUsage() );
+
+    ISubDSchema::Sample samp;
+    schema.get( samp, secondFrame );
+    std::vector<V3f> p;
+    second->refine( *samp.getPositions(), p );
+    float32_t c = 10.0f / 9.0f;
+    TESTING_ASSERT( near( p[7], V3f( c, c, c ) ) );
+
+    // other levels are other refinements
+    SubDRefinementPtr twice = cache.get( schema, 2, firstFrame );
+    TESTING_ASSERT( twice != first );
+    TESTING_ASSERT( cache.size() == 2 );
+
+    // so is the same topology with another number of positions
+    index_t thirdFrame = 2;
+    SubDRefinementPtr third = cache.get( schema, 1, thirdFrame );
+    TESTING_ASSERT( third != first );
+    TESTING_ASSERT( third->getNumControlPoints() == 9 );
+    TESTING_ASSERT( cache.size() == 3 );
+    schema.get( samp, thirdFrame );
+    third->refine( *samp.getPositions(), p );
+
+    cache.setMaxBytes( 0 );
+    TESTING_ASSERT( cache.size() == 0 );
+    TESTING_ASSERT( cache.getMemoryUsage() == 0 );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string name = "subdRefinement.abc";
+    writeArchive( name );
+
+    IArchive archive( Alembic::AbcCoreHDF5::ReadArchive(), name );
+    testCube( archive );
+    testGrid( archive );
+    testCache( archive );
+    return 0;
+}
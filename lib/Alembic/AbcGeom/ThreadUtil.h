@@ -0,0 +1,159 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2011,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_ThreadUtil_h_
+#define _Alembic_AbcGeom_ThreadUtil_h_
+
+#include <Alembic/AbcGeom/Foundation.h>
+
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Internal to the library, and not installed, see CMakeLists.txt.
+//-*****************************************************************************
+
+//-*****************************************************************************
+// How many slices RunSlices splits iNumItems into: one per thread, with no
+// thread given fewer than iMinPerThread items, and never less than one.
+// Slice t is [t * ( iNumItems / numSlices ), ( t + 1 ) * ( iNumItems /
+// numSlices )), except that the last one runs on to iNumItems.
+inline size_t NumSlices( size_t iNumItems, size_t iMinPerThread )
+{
+    size_t numSlices = std::min( iNumItems / iMinPerThread,
+        ( size_t ) boost::thread::hardware_concurrency() );
+    return std::max( numSlices, ( size_t ) 1 );
+}
+
+//-*****************************************************************************
+// Runs one slice of a task on its own thread. A thread can't let an
+// exception out, so whatever the slice throws is kept for RunSlices to
+// rethrow. Alembic's exceptions are copied as they are, so they keep their
+// messages.
+template <class TASK>
+class SliceRunner
+{
+public:
+    SliceRunner( const TASK &iTask, size_t iBegin, size_t iEnd,
+                 boost::exception_ptr &oError )
+      : m_task( iTask )
+      , m_begin( iBegin )
+      , m_end( iEnd )
+      , m_error( oError )
+    {}
+
+    void operator()() const
+    {
+        try
+        {
+            m_task( m_begin, m_end );
+        }
+        catch ( Alembic::Util::Exception &e )
+        {
+            m_error = boost::copy_exception( e );
+        }
+        catch ( ... )
+        {
+            m_error = boost::current_exception();
+        }
+    }
+
+private:
+    const TASK &m_task;
+    size_t m_begin;
+    size_t m_end;
+    boost::exception_ptr &m_error;
+};
+
+//-*****************************************************************************
+// Calls iTask( begin, end ) over the slices above, each on its own thread,
+// with the calling thread taking the last one itself. Nothing is rethrown
+// until every thread has finished, since they all still hold iTask; then
+// the calling thread's exception wins, and otherwise the first slice's
+// that threw.
+template <class TASK>
+void RunSlices( size_t iNumItems, size_t iMinPerThread, const TASK &iTask )
+{
+    size_t numSlices = NumSlices( iNumItems, iMinPerThread );
+    if ( numSlices < 2 )
+    {
+        iTask( 0, iNumItems );
+        return;
+    }
+
+    size_t slice = iNumItems / numSlices;
+    std::vector<boost::exception_ptr> errors( numSlices - 1 );
+    boost::thread_group threads;
+    try
+    {
+        for ( size_t t = 0; t + 1 < numSlices; ++t )
+        {
+            threads.create_thread( SliceRunner<TASK>( iTask, t * slice,
+                ( t + 1 ) * slice, errors[t] ) );
+        }
+        iTask( ( numSlices - 1 ) * slice, iNumItems );
+    }
+    catch ( ... )
+    {
+        threads.join_all();
+        throw;
+    }
+    threads.join_all();
+
+    for ( size_t t = 0; t < errors.size(); ++t )
+    {
+        if ( errors[t] )
+        {
+            boost::rethrow_exception( errors[t] );
+        }
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
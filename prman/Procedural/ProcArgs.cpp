@@ -49,6 +49,7 @@ ProcArgs::ProcArgs( RtString paramStr )
   , shutterOpen(0)
   , shutterClose(0)
   , excludeXform(false)
+  , cullHidden(false)
 {
     typedef boost::char_separator<char> Separator;
     typedef boost::tokenizer<Separator> Tokenizer;
@@ -125,6 +126,18 @@ ProcArgs::ProcArgs( RtString paramStr )
             excludeXform = true;
             
         }
+        else if ( token == "-cullcamera" )
+        {
+            ++i;
+            if ( i < tokens.size() )
+            {
+                cullCamera = tokens[i];
+            }
+        }
+        else if ( token == "-cullhidden" )
+        {
+            cullHidden = true;
+        }
         
     }
     
@@ -200,5 +213,25 @@ void ProcArgs::usage()
                  "is to write all transformations and include AttributeBegin "
                  "blocks around each level of the hierarchy.";
     std::cerr << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "-cullcamera /path/to/camera" << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "If specified, the path of a camera within the archive. "
+                 "Objects whose bounds are outside its view over the shutter "
+                 "window are skipped along with everything below them, as "
+                 "are hidden objects. The view is taken from the archive's "
+                 "own transformations, even with -excludexform.";
+    std::cerr << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "-cullhidden" << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "If specified, objects whose visibility property says they "
+                 "are hidden, or whose nearest ancestor with one says so, "
+                 "are skipped. This is implied by -cullcamera.";
+    std::cerr << std::endl;
 }
 
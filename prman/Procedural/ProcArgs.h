@@ -56,6 +56,8 @@ struct ProcArgs
     , shutterOpen( rhs.shutterOpen )
     , shutterClose( rhs.shutterClose )
     , excludeXform( false )
+    , cullCamera( rhs.cullCamera )
+    , cullHidden( rhs.cullHidden )
     {}
     
     void usage();
@@ -69,6 +71,9 @@ struct ProcArgs
     double shutterClose;
 
     bool excludeXform;
+
+    std::string cullCamera;
+    bool cullHidden;
 };
 
 #endif
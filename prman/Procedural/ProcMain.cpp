@@ -69,8 +69,25 @@ typedef std::auto_ptr<AttributeBlockHelper> AttributeBlockHelperAutoPtr;
 
 //-*****************************************************************************
 void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
-                 PathList::const_iterator I, PathList::const_iterator E )
+                 PathList::const_iterator I, PathList::const_iterator E,
+                 ObjectCuller *culler, const ObjectCuller::State &cullState )
 {
+    // Skip what's out of view before writing anything for it. Hidden
+    // objects are still walked, for any explicitly visible children.
+    ObjectCuller::State nextCullState = cullState;
+    bool emit = true;
+    if ( culler )
+    {
+        ObjectCuller::CullResult cullResult = culler->cull(
+            IObject( parent, ohead.getName() ), cullState, nextCullState );
+
+        if ( cullResult == ObjectCuller::kCullSubtree )
+        {
+            return;
+        }
+        emit = cullResult == ObjectCuller::kKeep;
+    }
+
     // Only add an enclosing AttributeBegin/name/AttributeEnd if we're
     // not excluding xforms. If we're not adding it here, we're adding for
     // the individual primitives.
@@ -121,7 +138,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             }
         }
 
-        ProcessSubD( subd, args, faceSetName );
+        if ( emit )
+        {
+            ProcessSubD( subd, args, faceSetName );
+        }
 
         //if we found a matching faceset, don't traverse below
         if ( faceSetName.empty() )
@@ -137,7 +157,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
         }
         
         IPolyMesh polymesh( parent, ohead.getName() );
-        ProcessPolyMesh( polymesh, args );
+        if ( emit )
+        {
+            ProcessPolyMesh( polymesh, args );
+        }
 
         nextParentObject = polymesh;
     }
@@ -149,7 +172,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
         }
         
         INuPatch patch( parent, ohead.getName() );
-        ProcessNuPatch( patch, args );
+        if ( emit )
+        {
+            ProcessNuPatch( patch, args );
+        }
         
         nextParentObject = patch;
     }
@@ -161,7 +187,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
         }
         
         IPoints points( parent, ohead.getName() );
-        ProcessPoints( points, args );
+        if ( emit )
+        {
+            ProcessPoints( points, args );
+        }
         
         nextParentObject = points;
     }
@@ -173,7 +202,10 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
         }
         
         ICurves curves( parent, ohead.getName() );
-        ProcessCurves( curves, args );
+        if ( emit )
+        {
+            ProcessCurves( curves, args );
+        }
         
         nextParentObject = curves;
     }
@@ -198,7 +230,7 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
             {
                 WalkObject( nextParentObject,
                             nextParentObject.getChildHeader( i ),
-                            args, I, E );
+                            args, I, E, culler, nextCullState );
             }
         }
         else
@@ -208,7 +240,8 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
 
             if ( nextChildHeader != NULL )
             {
-                WalkObject( nextParentObject, *nextChildHeader, args, I+1, E );
+                WalkObject( nextParentObject, *nextChildHeader, args, I+1, E,
+                            culler, nextCullState );
             }
         }
     }
@@ -217,6 +250,48 @@ void WalkObject( IObject parent, const ObjectHeader &ohead, ProcArgs &args,
     // if set.
 }
 
+//-*****************************************************************************
+// The culler asked for by -cullcamera or -cullhidden, if either was.
+std::auto_ptr<ObjectCuller> MakeCuller( IObject root, const ProcArgs &args )
+{
+    std::auto_ptr<ObjectCuller> culler;
+    chrono_t frameTime = args.frame / args.fps;
+
+    if ( !args.cullCamera.empty() )
+    {
+        PathList cameraPath;
+        TokenizePath( args.cullCamera, cameraPath );
+
+        IObject cameraObject = root;
+        for ( PathList::const_iterator I = cameraPath.begin();
+              I != cameraPath.end() && cameraObject.valid(); ++I )
+        {
+            cameraObject = cameraObject.getChild( *I );
+        }
+
+        if ( cameraObject.valid() &&
+             ICamera::matches( cameraObject.getHeader() ) )
+        {
+            ICamera camera( cameraObject, kWrapExisting );
+            culler.reset( new ObjectCuller(
+                GetWorldFrustum( camera, ISampleSelector( frameTime ) ),
+                ( args.frame + args.shutterOpen ) / args.fps,
+                ( args.frame + args.shutterClose ) / args.fps ) );
+            return culler;
+        }
+
+        std::cerr << "could not find a camera at " << args.cullCamera
+                  << ", culling hidden objects only" << std::endl;
+    }
+
+    if ( !args.cullCamera.empty() || args.cullHidden )
+    {
+        culler.reset( new ObjectCuller( frameTime ) );
+    }
+
+    return culler;
+}
+
 //-*****************************************************************************
 extern "C" RtPointer
 ConvertParameters( RtString paramstr )
@@ -266,12 +341,20 @@ Subdivide( RtPointer data, RtFloat detail )
         PathList path;
         TokenizePath( args->objectpath, path );
 
+        std::auto_ptr<ObjectCuller> culler = MakeCuller( root, *args );
+        ObjectCuller::State cullState;
+        if ( culler.get() )
+        {
+            cullState = culler->getTopState();
+        }
+
         if ( path.empty() ) //walk the entire scene
         {
             for ( size_t i = 0; i < root.getNumChildren(); ++i )
             {
                 WalkObject( root, root.getChildHeader(i), *args,
-                            path.end(), path.end() );
+                            path.end(), path.end(), culler.get(),
+                            cullState );
             }
         }
         else //walk to a location + its children
@@ -282,9 +365,19 @@ Subdivide( RtPointer data, RtFloat detail )
                     root.getChildHeader( *I );
             if ( nextChildHeader != NULL )
             {
-                WalkObject( root, *nextChildHeader, *args, I+1, path.end() );
+                WalkObject( root, *nextChildHeader, *args, I+1, path.end(),
+                            culler.get(), cullState );
             }
         }
+
+        if ( culler.get() )
+        {
+            std::cerr << "AlembicRiProcedural: " << args->filename
+                      << " culled " << culler->getNumOutside()
+                      << " out of view and " << culler->getNumHidden()
+                      << " hidden, kept " << culler->getNumKept()
+                      << std::endl;
+        }
     }
     catch ( const std::exception &e )
     {